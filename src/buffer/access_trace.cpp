@@ -0,0 +1,45 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// access_trace.cpp
+//
+// Identification: src/buffer/access_trace.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/access_trace.h"
+
+#include "common/exception.h"
+
+namespace bustub {
+
+AccessTrace::AccessTrace(const std::string &file_name) : out_(file_name, std::ios::out | std::ios::trunc) {
+  if (!out_.is_open()) {
+    throw Exception("can't open trace file " + file_name);
+  }
+}
+
+AccessTrace::~AccessTrace() { out_.close(); }
+
+void AccessTrace::Record(page_id_t page_id) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  out_ << page_id << '\n';
+}
+
+auto AccessTrace::Load(const std::string &file_name) -> std::vector<page_id_t> {
+  std::ifstream in(file_name);
+  if (!in.is_open()) {
+    throw Exception("can't open trace file " + file_name);
+  }
+  std::vector<page_id_t> trace;
+  page_id_t page_id;
+  while (in >> page_id) {
+    trace.push_back(page_id);
+  }
+  return trace;
+}
+
+}  // namespace bustub
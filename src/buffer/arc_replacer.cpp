@@ -0,0 +1,165 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// arc_replacer.cpp
+//
+// Identification: src/buffer/arc_replacer.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/arc_replacer.h"
+
+#include <algorithm>
+
+namespace bustub {
+
+void ARCReplacer::GhostList::PushFront(page_id_t page_id) {
+  pages_.push_front(page_id);
+  index_[page_id] = pages_.begin();
+}
+
+void ARCReplacer::GhostList::Erase(page_id_t page_id) {
+  auto it = index_.find(page_id);
+  pages_.erase(it->second);
+  index_.erase(it);
+}
+
+void ARCReplacer::GhostList::PopBack() {
+  index_.erase(pages_.back());
+  pages_.pop_back();
+}
+
+ARCReplacer::ARCReplacer(size_t num_frames) : capacity_(num_frames), frames_(num_frames) {}
+
+auto ARCReplacer::Evict(frame_id_t *frame_id) -> bool {
+  std::scoped_lock<std::mutex> lock(latch_);
+  // prefer the list that is over its target, fall back to the other one if all its frames are pinned
+  const bool prefer_t1 = !t1_.empty() && t1_.size() > target_t1_size_;
+  if (prefer_t1 ? EvictFrom(&t1_, &b1_, frame_id) || EvictFrom(&t2_, &b2_, frame_id)
+                : EvictFrom(&t2_, &b2_, frame_id) || EvictFrom(&t1_, &b1_, frame_id)) {
+    TrimGhosts();
+    return true;
+  }
+  return false;
+}
+
+auto ARCReplacer::EvictFrom(std::list<frame_id_t> *list, GhostList *ghost, frame_id_t *frame_id) -> bool {
+  for (auto it = list->rbegin(); it != list->rend(); ++it) {
+    auto &entry = frames_[*it];
+    if (entry.evictable_) {
+      *frame_id = *it;
+      ghost->PushFront(entry.page_id_);
+      list->erase(std::next(it).base());
+      entry = FrameEntry{};
+      curr_size_--;
+      return true;
+    }
+  }
+  return false;
+}
+
+void ARCReplacer::TrimGhosts() {
+  while (b1_.Size() > 0 && t1_.size() + b1_.Size() > capacity_) {
+    b1_.PopBack();
+  }
+  while (t1_.size() + t2_.size() + b1_.Size() + b2_.Size() > 2 * capacity_) {
+    if (b2_.Size() > 0) {
+      b2_.PopBack();
+    } else {
+      b1_.PopBack();
+    }
+  }
+}
+
+void ARCReplacer::RecordAccess(frame_id_t frame_id, page_id_t page_id) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  BUSTUB_ASSERT(frame_id >= 0 && static_cast<size_t>(frame_id) < capacity_, "invalid frame id");
+  auto &entry = frames_[frame_id];
+  if (entry.list_ != ListId::NONE) {
+    // a hit: the page has now been seen at least twice
+    (entry.list_ == ListId::T1 ? t1_ : t2_).erase(entry.pos_);
+  } else {
+    entry.evictable_ = true;
+    curr_size_++;
+    if (b1_.Contains(page_id)) {
+      // T1 evicted a page that was still useful, give T1 more room
+      target_t1_size_ = std::min(capacity_, target_t1_size_ + std::max<size_t>(1, b2_.Size() / b1_.Size()));
+      b1_.Erase(page_id);
+    } else if (b2_.Contains(page_id)) {
+      // T2 evicted a page that was still useful, give T2 more room
+      const size_t delta = std::max<size_t>(1, b1_.Size() / b2_.Size());
+      target_t1_size_ = target_t1_size_ > delta ? target_t1_size_ - delta : 0;
+      b2_.Erase(page_id);
+    } else {
+      entry.list_ = ListId::T1;
+      entry.page_id_ = page_id;
+      t1_.push_front(frame_id);
+      entry.pos_ = t1_.begin();
+      TrimGhosts();
+      return;
+    }
+  }
+  entry.list_ = ListId::T2;
+  entry.page_id_ = page_id;
+  t2_.push_front(frame_id);
+  entry.pos_ = t2_.begin();
+}
+
+void ARCReplacer::SetEvictable(frame_id_t frame_id, bool set_evictable) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  BUSTUB_ASSERT(frame_id >= 0 && static_cast<size_t>(frame_id) < capacity_, "invalid frame id");
+  auto &entry = frames_[frame_id];
+  if (entry.list_ == ListId::NONE || entry.evictable_ == set_evictable) {
+    return;
+  }
+  entry.evictable_ = set_evictable;
+  if (set_evictable) {
+    curr_size_++;
+  } else {
+    curr_size_--;
+  }
+}
+
+void ARCReplacer::Remove(frame_id_t frame_id) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  BUSTUB_ASSERT(frame_id >= 0 && static_cast<size_t>(frame_id) < capacity_, "invalid frame id");
+  auto &entry = frames_[frame_id];
+  if (entry.list_ == ListId::NONE || !entry.evictable_) {
+    return;
+  }
+  (entry.list_ == ListId::T1 ? t1_ : t2_).erase(entry.pos_);
+  entry = FrameEntry{};
+  curr_size_--;
+}
+
+void ARCReplacer::Resize(size_t num_frames) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  capacity_ = num_frames;
+  frames_.resize(num_frames);
+  target_t1_size_ = std::min(target_t1_size_, capacity_);
+  // a smaller cache remembers fewer evicted pages
+  TrimGhosts();
+}
+
+auto ARCReplacer::GetPriorityOrder() -> std::vector<frame_id_t> {
+  std::scoped_lock<std::mutex> lock(latch_);
+  // pages seen at least twice first, each list from its most recently used frame
+  std::vector<frame_id_t> order(t2_.begin(), t2_.end());
+  order.insert(order.end(), t1_.begin(), t1_.end());
+  return order;
+}
+
+auto ARCReplacer::Size() -> size_t {
+  std::scoped_lock<std::mutex> lock(latch_);
+  return curr_size_;
+}
+
+auto ARCReplacer::GetTargetT1Size() -> size_t {
+  std::scoped_lock<std::mutex> lock(latch_);
+  return target_t1_size_;
+}
+
+}  // namespace bustub
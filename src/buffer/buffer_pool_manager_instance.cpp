@@ -12,22 +12,51 @@
 
 #include "buffer/buffer_pool_manager_instance.h"
 
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <cstring>
+#include <future>  // NOLINT
+#include <thread>  // NOLINT
+#include <utility>
+#include <vector>
+
 #include "common/config.h"
 #include "common/exception.h"
+#include "common/logger.h"
 #include "common/macros.h"
 
 namespace bustub {
 
 BufferPoolManagerInstance::BufferPoolManagerInstance(size_t pool_size, DiskManager *disk_manager, size_t replacer_k,
-                                                     LogManager *log_manager)
-    : pool_size_(pool_size), disk_manager_(disk_manager), log_manager_(log_manager) {
-  // we allocate a consecutive memory space for the buffer pool
-  pages_ = new Page[pool_size_];
-  page_table_ = new ExtendibleHashTable<page_id_t, frame_id_t>(bucket_size_);
-  replacer_ = new LRUKReplacer(pool_size, replacer_k);
+                                                     LogManager *log_manager, PageAllocator *page_allocator,
+                                                     ReplacerType replacer_type)
+    : BufferPoolManagerInstance(pool_size, 1, 0, disk_manager, replacer_k, log_manager, page_allocator,
+                                replacer_type) {}
+
+BufferPoolManagerInstance::BufferPoolManagerInstance(size_t pool_size, uint32_t num_instances, uint32_t instance_index,
+                                                     DiskManager *disk_manager, size_t replacer_k,
+                                                     LogManager *log_manager, PageAllocator *page_allocator,
+                                                     ReplacerType replacer_type)
+    : pool_size_(pool_size),
+      num_instances_(num_instances),
+      instance_index_(instance_index),
+      next_page_id_(static_cast<page_id_t>(instance_index)),
+      disk_manager_(disk_manager),
+      log_manager_(log_manager),
+      page_allocator_(page_allocator) {
+  BUSTUB_ASSERT(num_instances > 0, "If BPI is not part of a pool, then the pool size should just be 1");
+  BUSTUB_ASSERT(
+      instance_index < num_instances,
+      "BPI index cannot be greater than the number of BPIs in the pool. In non-parallel case, index should just be 0.");
+
+  // we allocate a consecutive memory space for the frames of the buffer pool, with the frame metadata kept apart
+  // from the page-aligned frame data
+  AddFrameSegment(pool_size);
+  page_table_ = new LockFreePageTable(pool_size);
+  replacer_ = Replacer::Create(replacer_type, pool_size, replacer_k);
 
   // Initially, every page is in the free list.
-  for (size_t i = 0; i < pool_size_; ++i) {
+  for (size_t i = 0; i < pool_size; ++i) {
     free_list_.emplace_back(static_cast<int>(i));
   }
 
@@ -38,83 +67,233 @@ BufferPoolManagerInstance::BufferPoolManagerInstance(size_t pool_size, DiskManag
 }
 
 BufferPoolManagerInstance::~BufferPoolManagerInstance() {
-  delete[] pages_;
+  StopBackgroundFlusher();
+  {
+    std::scoped_lock<std::mutex> lock(latch_);
+    prefetch_running_ = false;
+    prefetch_cv_.notify_all();
+  }
+  for (auto &thread : prefetch_threads_) {
+    thread.join();
+  }
   delete page_table_;
-  delete replacer_;
 }
 
-auto BufferPoolManagerInstance::NewPgImp(page_id_t *page_id) -> Page * {
-  std::scoped_lock<std::mutex> lock(latch_);
+auto BufferPoolManagerInstance::NewPgImp(page_id_t *page_id) -> Page * { return NewPgStrategyImp(page_id, nullptr); }
+
+auto BufferPoolManagerInstance::NewPgStrategyImp(page_id_t *page_id, BufferAccessStrategy *strategy) -> Page * {
+  return NewPgSegmentImp(page_id, nullptr, strategy);
+}
+
+auto BufferPoolManagerInstance::NewPgSegmentImp(page_id_t *page_id, PageSegment *segment,
+                                                BufferAccessStrategy *strategy) -> Page * {
+  BUSTUB_ASSERT(segment == nullptr || num_instances_ == 1, "the parallel BPM allocates the pages of a segment");
+  return CreatePage(page_id, [&] { return AllocatePage(segment); }, strategy);
+}
+
+auto BufferPoolManagerInstance::NewAllocatedPage(page_id_t page_id, BufferAccessStrategy *strategy) -> Page * {
+  ValidatePageId(page_id);
+  return CreatePage(&page_id, [&] { return page_id; }, strategy);
+}
+
+auto BufferPoolManagerInstance::ReservePageIds(page_id_t end_page_id) -> page_id_t {
+  auto lock = LockLatch();
+  const page_id_t next_page_id = next_page_id_;
+  if (next_page_id < end_page_id) {
+    // round up to the next page id of this instance
+    const auto num_instances = static_cast<page_id_t>(num_instances_);
+    const auto instance_index = static_cast<page_id_t>(instance_index_);
+    next_page_id_ = end_page_id + (instance_index + num_instances - end_page_id % num_instances) % num_instances;
+  }
+  return next_page_id;
+}
+
+auto BufferPoolManagerInstance::CreatePage(page_id_t *page_id, const std::function<page_id_t()> &allocate_page,
+                                           BufferAccessStrategy *strategy) -> Page * {
+  auto lock = LockLatch();
   frame_id_t fid;
-  if (!free_list_.empty()) {
-    fid = free_list_.front();
-    free_list_.pop_front();
-  } else if (replacer_->Evict(&fid)) {
-    if (pages_[fid].IsDirty()) {
-      disk_manager_->WritePage(pages_[fid].GetPageId(), pages_[fid].GetData());
-    }
-    page_table_->Remove(pages_[fid].GetPageId());
-  } else {
+  page_id_t victim_page_id;
+  if (!AcquireFrame(&fid, &victim_page_id, strategy)) {
     return nullptr;
   }
-  *page_id = AllocatePage();
-  pages_[fid].page_id_ = *page_id;
-  pages_[fid].is_dirty_ = false;
-  pages_[fid].pin_count_ = 1;
-  pages_[fid].ResetMemory();
-  replacer_->RecordAccess(fid);
+  *page_id = allocate_page();
+  stats_.RecordNewPage();
+  if (AccessTrace *trace = access_trace_; trace != nullptr) {
+    trace->Record(*page_id);
+  }
+  if (strategy != nullptr) {
+    strategy->AddPage(*page_id);
+  }
+  prefetched_[fid] = false;
+  pages_[fid]->page_id_ = *page_id;
+  pages_[fid]->is_dirty_ = false;
+  replacer_->RecordAccess(fid, *page_id);
   replacer_->SetEvictable(fid, false);
   page_table_->Insert(*page_id, fid);
-  return &pages_[fid];
+  if (victim_page_id != INVALID_PAGE_ID) {
+    // nobody else knows the new page id yet, but FlushAllPgs() may still run into the frame
+    pages_[fid]->frame_state_ = FrameState::READING;
+  }
+  pages_[fid]->Publish(1);
+  if (victim_page_id != INVALID_PAGE_ID) {
+    WriteBackVictim(fid, victim_page_id, lock);
+    FinishIo(fid);
+  }
+  // the victim may have been a page lent by the disk manager
+  pages_[fid]->data_ = pages_[fid]->frame_data_;
+  pages_[fid]->ResetMemory();
+  return pages_[fid];
 }
 
-auto BufferPoolManagerInstance::FetchPgImp(page_id_t page_id) -> Page * {
-  std::scoped_lock<std::mutex> lock(latch_);
+auto BufferPoolManagerInstance::FetchPgImp(page_id_t page_id) -> Page * { return FetchPgStrategyImp(page_id, nullptr); }
+
+auto BufferPoolManagerInstance::FetchPgStrategyImp(page_id_t page_id, BufferAccessStrategy *strategy) -> Page * {
+  return FetchFrame(page_id, strategy, false);
+}
+
+auto BufferPoolManagerInstance::FetchPgReadOnlyImp(page_id_t page_id, BufferAccessStrategy *strategy) -> Page * {
+  return FetchFrame(page_id, strategy, true);
+}
+
+auto BufferPoolManagerInstance::FetchFrame(page_id_t page_id, BufferAccessStrategy *strategy, bool read_only)
+    -> Page * {
+  ValidatePageId(page_id);
+  if (strategy == nullptr) {
+    if (Page *page = FetchFast(page_id); page != nullptr) {
+      if (!read_only && page->data_ != page->frame_data_) {
+        auto lock = LockLatch();
+        CopyLentPage(page);
+      }
+      return page;
+    }
+  }
   frame_id_t fid;
-  if (page_table_->Find(page_id, fid)) {
-    replacer_->RecordAccess(fid);
+  // probe the page table before taking the latch, so that a hit only validates the mapping under the latch
+  bool found = page_table_->Find(page_id, &fid);
+  auto lock = LockLatch();
+  if (AccessTrace *trace = access_trace_; trace != nullptr) {
+    trace->Record(page_id);
+  }
+  found = found && pages_[fid]->page_id_ == page_id;
+  while (!found && !(found = page_table_->Find(page_id, &fid))) {
+    auto it = write_back_.find(page_id);
+    if (it == write_back_.end()) {
+      break;
+    }
+    // the page has just been evicted, wait until its contents are on disk before reading it back
+    pages_[it->second]->io_cv_.wait(lock, [&] { return write_back_.count(page_id) == 0; });
+  }
+  if (found) {
+    stats_.RecordHit();
+    if (prefetched_[fid]) {
+      // first fetch of a prefetched page, the prefetch already recorded an access
+      prefetched_[fid] = false;
+      if (strategy != nullptr) {
+        AdoptRingPage(page_id, strategy);
+      }
+    } else {
+      replacer_->RecordAccess(fid, page_id);
+    }
     replacer_->SetEvictable(fid, false);
-    pages_[fid].pin_count_++;
-    return &pages_[fid];
+    pages_[fid]->pin_count_++;
+    // another thread may be reading the page in, the pin keeps the frame mapped to page_id while we wait
+    pages_[fid]->io_cv_.wait(lock, [&] { return pages_[fid]->frame_state_ != FrameState::READING; });
+    if (!read_only) {
+      CopyLentPage(pages_[fid]);
+    }
+    return pages_[fid];
   }
-  if (!free_list_.empty()) {
-    fid = free_list_.front();
-    free_list_.pop_front();
-    pages_[fid].is_dirty_ = false;
-    pages_[fid].pin_count_ = 1;
-    pages_[fid].page_id_ = page_id;
-  } else if (replacer_->Evict(&fid)) {
-    if (pages_[fid].IsDirty()) {
-      disk_manager_->WritePage(pages_[fid].GetPageId(), pages_[fid].GetData());
-    }
-    page_table_->Remove(pages_[fid].GetPageId());
-  } else {
+  page_id_t victim_page_id;
+  if (!AcquireFrame(&fid, &victim_page_id, strategy)) {
     return nullptr;
   }
-  pages_[fid].pin_count_ = 1;
-  pages_[fid].page_id_ = page_id;
-  pages_[fid].is_dirty_ = false;
-  pages_[fid].ResetMemory();
-  disk_manager_->ReadPage(page_id, pages_[fid].data_);
-  replacer_->RecordAccess(fid);
-  replacer_->SetEvictable(fid, false);
-  page_table_->Insert(page_id, fid);
-  return &pages_[fid];
+  stats_.RecordMiss();
+  if (strategy != nullptr) {
+    strategy->AddPage(page_id);
+  }
+  ReadFrame(fid, page_id, victim_page_id, lock, read_only);
+  return pages_[fid];
+}
+
+void BufferPoolManagerInstance::CopyLentPage(Page *page) {
+  if (page->data_ == page->frame_data_) {
+    return;
+  }
+  // readers of the page may still be reading the lent copy, which stays valid and holds the same data until the
+  // page is written
+  memcpy(page->frame_data_, page->data_, BUSTUB_PAGE_SIZE);
+  page->data_ = page->frame_data_;
+}
+
+auto BufferPoolManagerInstance::FetchFast(page_id_t page_id) -> Page * {
+  frame_id_t fid;
+  // every access is traced under the latch
+  if (access_trace_.load(std::memory_order_relaxed) != nullptr || !page_table_->Find(page_id, &fid)) {
+    return nullptr;
+  }
+  Page *page = frame_directory_.load(std::memory_order_acquire)[fid];
+  const uint64_t version = page->version_.load(std::memory_order_acquire);
+  if (version % 2 == 1 || !page->TryPin()) {
+    return nullptr;
+  }
+  // the page table entry may be stale: the frame may have been remapped before the pin, or still be reading the page
+  if (page->version_.load(std::memory_order_acquire) != version || page->page_id_ != page_id ||
+      page->frame_state_ == FrameState::READING) {
+    if (page->TryUnpin() == 0) {
+      // the latch holder may have seen the transient pin and told the replacer the frame is pinned
+      BufferAccess(fid, INVALID_PAGE_ID);
+    }
+    return nullptr;
+  }
+  stats_.RecordHit();
+  BufferAccess(fid, page_id);
+  return page;
+}
+
+auto BufferPoolManagerInstance::UnpinFast(page_id_t page_id, bool is_dirty) -> bool {
+  frame_id_t fid;
+  if (!page_table_->Find(page_id, &fid)) {
+    return false;
+  }
+  Page *page = frame_directory_.load(std::memory_order_acquire)[fid];
+  // without a pin, the frame may be remapped at any time, and the latch holder knows best
+  if (page->pin_count_.load(std::memory_order_acquire) <= 0 || page->page_id_ != page_id ||
+      static_cast<size_t>(fid) >= pool_size_) {
+    return false;
+  }
+  if (is_dirty) {
+    // before the pin is dropped, so that an eviction sees it
+    page->is_dirty_ = true;
+  }
+  const int pin_count = page->TryUnpin();
+  if (pin_count < 0) {
+    return false;
+  }
+  if (pin_count == 0) {
+    BufferAccess(fid, INVALID_PAGE_ID);
+  }
+  return true;
 }
 
 auto BufferPoolManagerInstance::UnpinPgImp(page_id_t page_id, bool is_dirty) -> bool {
-  std::scoped_lock<std::mutex> lock(latch_);
+  if (UnpinFast(page_id, is_dirty)) {
+    return true;
+  }
+  auto lock = LockLatch();
   frame_id_t fid;
-  if (page_table_->Find(page_id, fid)) {
-    if (pages_[fid].pin_count_ == 0) {
+  if (page_table_->Find(page_id, &fid)) {
+    if (pages_[fid]->pin_count_ <= 0) {
       return false;
     }
-    pages_[fid].pin_count_--;
     if (is_dirty) {
-      pages_[fid].is_dirty_ = is_dirty;
+      pages_[fid]->is_dirty_ = is_dirty;
     }
-    if (pages_[fid].pin_count_ == 0) {
+    if (pages_[fid]->TryUnpin() == 0) {
       replacer_->SetEvictable(fid, true);
+      if (static_cast<size_t>(fid) >= pool_size_) {
+        // a shrink is waiting for this frame
+        resize_cv_.notify_all();
+      }
     }
     return true;
   }
@@ -122,46 +301,790 @@ auto BufferPoolManagerInstance::UnpinPgImp(page_id_t page_id, bool is_dirty) ->
 }
 
 auto BufferPoolManagerInstance::FlushPgImp(page_id_t page_id) -> bool {
-  std::scoped_lock<std::mutex> lock(latch_);
+  auto lock = LockLatch();
   if (page_id == INVALID_PAGE_ID) {
     return false;
   }
   frame_id_t fid;
-  if (page_table_->Find(page_id, fid)) {
-    disk_manager_->WritePage(pages_[fid].GetPageId(), pages_[fid].GetData());
+  if (page_table_->Find(page_id, &fid)) {
+    FlushFrame(fid, lock);
     return true;
   }
   return false;
 }
 
 void BufferPoolManagerInstance::FlushAllPgsImp() {
-  std::scoped_lock<std::mutex> lock(latch_);
+  auto lock = LockLatch();
+  std::vector<frame_id_t> dirty_frames;
   for (size_t i = 0; i < pool_size_; i++) {
-    if (pages_[i].page_id_ != INVALID_PAGE_ID) {
-      disk_manager_->WritePage(pages_[i].GetPageId(), pages_[i].GetData());
+    if (pages_[i]->page_id_ != INVALID_PAGE_ID && pages_[i]->is_dirty_) {
+      dirty_frames.push_back(static_cast<frame_id_t>(i));
     }
   }
+  FlushFrames(dirty_frames, lock);
+  if (page_allocator_ != nullptr) {
+    page_allocator_->Flush();
+  }
 }
 
 auto BufferPoolManagerInstance::DeletePgImp(page_id_t page_id) -> bool {
-  std::scoped_lock<std::mutex> lock(latch_);
+  if (page_id < 0) {
+    return true;
+  }
+  auto lock = LockLatch();
   frame_id_t fid;
-  if (page_table_->Find(page_id, fid)) {
-    if (pages_[fid].pin_count_ > 0) {
+  bool found = false;
+  while (!(found = page_table_->Find(page_id, &fid))) {
+    auto it = write_back_.find(page_id);
+    if (it == write_back_.end()) {
+      break;
+    }
+    // the page has just been evicted, and its write-back must not land after the page id is reused
+    pages_[it->second]->io_cv_.wait(lock, [&] { return write_back_.count(page_id) == 0; });
+  }
+  if (found) {
+    // a frame doing I/O is always pinned, so an unpinned frame is READY
+    if (!pages_[fid]->Claim()) {
       return false;
     }
-    replacer_->Remove(fid);
+    RemoveFromReplacer(fid);
     page_table_->Remove(page_id);
-    pages_[fid].ResetMemory();
-    pages_[fid].page_id_ = INVALID_PAGE_ID;
-    pages_[fid].is_dirty_ = false;
-    pages_[fid].pin_count_ = 0;
+    pages_[fid]->ResetMemory();
+    pages_[fid]->page_id_ = INVALID_PAGE_ID;
+    pages_[fid]->is_dirty_ = false;
+    pages_[fid]->Publish(0);
+    prefetched_[fid] = false;
     free_list_.push_back(fid);
+  }
+  if (compressed_cache_ != nullptr) {
+    compressed_cache_->Invalidate(page_id);
+  }
+  DeallocatePage(page_id);
+  stats_.RecordDelete();
+  return true;
+}
+
+auto BufferPoolManagerInstance::AcquireFrame(frame_id_t *frame_id, page_id_t *victim_page_id,
+                                             BufferAccessStrategy *strategy) -> bool {
+  *victim_page_id = INVALID_PAGE_ID;
+  if (strategy != nullptr && strategy->IsFull() && PopRingFrame(strategy, frame_id)) {
+    RemoveFromReplacer(*frame_id);
+    UnmapFrame(*frame_id, victim_page_id);
+    return true;
+  }
+  if (!free_list_.empty()) {
+    *frame_id = free_list_.front();
+    free_list_.pop_front();
+    ClaimFreeFrame(*frame_id);
+    return true;
+  }
+  DrainAccessBuffers();
+  while (replacer_->Evict(frame_id)) {
+    // a frame dropped by a shrink in progress keeps its page until Resize() moves or evicts it
+    if (static_cast<size_t>(*frame_id) >= pool_size_) {
+      continue;
+    }
+    if (!pages_[*frame_id]->Claim()) {
+      // pinned on the hit path since the last drain, keep tracking it: its unpin is buffered like its pin
+      replacer_->RecordAccess(*frame_id, pages_[*frame_id]->page_id_);
+      replacer_->SetEvictable(*frame_id, false);
+      continue;
+    }
+    UnmapFrame(*frame_id, victim_page_id);
     return true;
   }
+  return false;
+}
+
+void BufferPoolManagerInstance::UnmapFrame(frame_id_t frame_id, page_id_t *victim_page_id) {
+  Page &victim = *pages_[frame_id];
+  BUSTUB_ASSERT(victim.pin_count_ == Page::CLAIMED && victim.frame_state_ == FrameState::READY,
+                "evicted a frame in use");
+  page_table_->Remove(victim.page_id_);
+  stats_.RecordEviction(victim.is_dirty_);
+  if (compressed_cache_ != nullptr) {
+    // the cache only holds pages equal to their disk copy, and has nothing to add to a page lent by the disk manager
+    if (victim.is_dirty_) {
+      compressed_cache_->Invalidate(victim.page_id_);
+    } else if (victim.data_ == victim.frame_data_) {
+      compressed_cache_->Insert(victim.page_id_, victim.GetData());
+    }
+  }
+  if (victim.is_dirty_) {
+    *victim_page_id = victim.page_id_;
+    write_back_[victim.page_id_] = frame_id;
+    // the foreground pays for a write, let the background flusher catch up
+    flush_cv_.notify_one();
+  }
+}
+
+auto BufferPoolManagerInstance::PopRingFrame(BufferAccessStrategy *strategy, frame_id_t *frame_id) -> bool {
+  page_id_t page_id;
+  if (!strategy->PopOldestPage(num_instances_, instance_index_, &page_id)) {
+    return false;
+  }
+  // the page may have been evicted, or be pinned by someone else since the bulk operation read it, or be in a frame
+  // that a shrink in progress is dropping
+  return page_table_->Find(page_id, frame_id) && static_cast<size_t>(*frame_id) < pool_size_ &&
+         pages_[*frame_id]->Claim();
+}
+
+void BufferPoolManagerInstance::AdoptRingPage(page_id_t page_id, BufferAccessStrategy *strategy) {
+  frame_id_t fid;
+  // the page took a frame from the shared pool, give a clean ring frame back in exchange
+  if (strategy->IsFull() && PopRingFrame(strategy, &fid)) {
+    if (!pages_[fid]->is_dirty_) {
+      stats_.RecordEviction(false);
+      RemoveFromReplacer(fid);
+      page_table_->Remove(pages_[fid]->page_id_);
+      pages_[fid]->page_id_ = INVALID_PAGE_ID;
+      prefetched_[fid] = false;
+      free_list_.push_back(fid);
+    }
+    pages_[fid]->Publish(0);
+  }
+  strategy->AddPage(page_id);
+}
+
+void BufferPoolManagerInstance::ReadFrame(frame_id_t frame_id, page_id_t page_id, page_id_t victim_page_id,
+                                          std::unique_lock<std::mutex> &lock, bool lend) {
+  MapFrame(frame_id, page_id, victim_page_id, lock);
+  ReadFrames({{frame_id, page_id}}, lock, lend);
+}
+
+void BufferPoolManagerInstance::MapFrame(frame_id_t frame_id, page_id_t page_id, page_id_t victim_page_id,
+                                         std::unique_lock<std::mutex> &lock) {
+  Page &page = *pages_[frame_id];
+  prefetched_[frame_id] = false;
+  page.page_id_ = page_id;
+  page.is_dirty_ = false;
+  page.frame_state_ = FrameState::READING;
+  replacer_->RecordAccess(frame_id, page_id);
+  replacer_->SetEvictable(frame_id, false);
+  page_table_->Insert(page_id, frame_id);
+  page.Publish(1);
+  if (victim_page_id != INVALID_PAGE_ID) {
+    WriteBackVictim(frame_id, victim_page_id, lock);
+  }
+  // the victim may have been a page lent by the disk manager
+  page.data_ = page.frame_data_;
+}
+
+void BufferPoolManagerInstance::ReadFrames(const std::vector<std::pair<frame_id_t, page_id_t>> &frames,
+                                           std::unique_lock<std::mutex> &lock, bool lend) {
+  std::vector<Page *> pages;
+  for (const auto &[fid, page_id] : frames) {
+    pages.push_back(pages_[fid]);
+  }
+  CompressedPageCache *cache = compressed_cache_;
+  DiskScheduler *scheduler = disk_scheduler_;
+  lock.unlock();
+  // with a scheduler, every read is in flight before the first one is waited for
+  std::vector<std::future<bool>> reads(frames.size());
+  const auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < frames.size(); i++) {
+    const page_id_t page_id = frames[i].second;
+    if (const char *view = lend ? disk_manager_->GetPageView(page_id) : nullptr; view != nullptr) {
+      // the page is read-only until a fetch for writing copies it, a write to it faults rather than bypassing the
+      // buffer pool
+      pages[i]->data_ = const_cast<char *>(view);
+      if (cache != nullptr) {
+        cache->Invalidate(page_id);
+      }
+      continue;
+    }
+    if (cache != nullptr && cache->Take(page_id, pages[i]->data_)) {
+      continue;
+    }
+    pages[i]->ResetMemory();
+    if (scheduler != nullptr) {
+      reads[i] = scheduler->ScheduleRead(page_id, pages[i]->data_);
+    } else {
+      const auto read_start = std::chrono::steady_clock::now();
+      disk_manager_->ReadPage(page_id, pages[i]->data_);
+      stats_.RecordRead(std::chrono::steady_clock::now() - read_start);
+    }
+  }
+  for (size_t i = 0; i < frames.size(); i++) {
+    if (!reads[i].valid()) {
+      continue;
+    }
+    if (!reads[i].get()) {
+      // the frame keeps the zeros it was reset to, like a page past the end of the file
+      LOG_WARN("cannot read page %d", frames[i].second);
+      stats_.RecordReadError();
+    }
+    stats_.RecordRead(std::chrono::steady_clock::now() - start);
+  }
+  lock.lock();
+  for (const auto &[fid, page_id] : frames) {
+    FinishIo(fid);
+  }
+}
+
+void BufferPoolManagerInstance::WriteBackVictim(frame_id_t frame_id, page_id_t victim_page_id,
+                                                std::unique_lock<std::mutex> &lock) {
+  Page &page = *pages_[frame_id];
+  lock.unlock();
+  const auto start = std::chrono::steady_clock::now();
+  disk_manager_->WritePage(victim_page_id, page.GetData());
+  stats_.RecordWrite(std::chrono::steady_clock::now() - start);
+  num_foreground_writes_++;
+  lock.lock();
+  write_back_.erase(victim_page_id);
+  pages_[frame_id]->io_cv_.notify_all();
+}
+
+void BufferPoolManagerInstance::FinishIo(frame_id_t frame_id) {
+  pages_[frame_id]->frame_state_ = FrameState::READY;
+  pages_[frame_id]->io_cv_.notify_all();
+}
+
+void BufferPoolManagerInstance::FlushFrame(frame_id_t frame_id, std::unique_lock<std::mutex> &lock, bool background) {
+  Page &page = *pages_[frame_id];
+  page.pin_count_++;
+  replacer_->SetEvictable(frame_id, false);
+  page.io_cv_.wait(lock, [&] { return page.frame_state_ == FrameState::READY; });
+  // clear the dirty flag before writing, so that a concurrent modification marks the page dirty again
+  page.frame_state_ = FrameState::WRITING;
+  page.is_dirty_ = false;
+  const page_id_t page_id = page.page_id_;
+  lock.unlock();
+  const auto start = std::chrono::steady_clock::now();
+  disk_manager_->WritePage(page_id, page.GetData());
+  stats_.RecordWrite(std::chrono::steady_clock::now() - start);
+  (background ? num_background_writes_ : num_foreground_writes_)++;
+  lock.lock();
+  FinishIo(frame_id);
+  if (--page.pin_count_ == 0) {
+    replacer_->SetEvictable(frame_id, true);
+  }
+}
+
+void BufferPoolManagerInstance::FlushFrames(const std::vector<frame_id_t> &frame_ids,
+                                            std::unique_lock<std::mutex> &lock, bool background) {
+  std::vector<frame_id_t> writing;
+  std::vector<std::pair<page_id_t, const char *>> batch;
+  for (const frame_id_t frame_id : frame_ids) {
+    Page &page = *pages_[frame_id];
+    page.pin_count_++;
+    replacer_->SetEvictable(frame_id, false);
+    page.io_cv_.wait(lock, [&] { return page.frame_state_ == FrameState::READY; });
+    // another flush may have written the page while the latch was released
+    if (!page.is_dirty_) {
+      if (--page.pin_count_ == 0) {
+        replacer_->SetEvictable(frame_id, true);
+      }
+      continue;
+    }
+    // clear the dirty flag before writing, so that a concurrent modification marks the page dirty again
+    page.frame_state_ = FrameState::WRITING;
+    page.is_dirty_ = false;
+    writing.push_back(frame_id);
+    batch.emplace_back(page.page_id_, page.GetData());
+  }
+  if (writing.empty()) {
+    return;
+  }
+  lock.unlock();
+  const auto start = std::chrono::steady_clock::now();
+  disk_manager_->WritePages(std::move(batch));
+  const auto latency = (std::chrono::steady_clock::now() - start) / writing.size();
+  for (size_t i = 0; i < writing.size(); i++) {
+    stats_.RecordWrite(latency);
+  }
+  (background ? num_background_writes_ : num_foreground_writes_) += writing.size();
+  lock.lock();
+  for (const frame_id_t frame_id : writing) {
+    FinishIo(frame_id);
+    if (--pages_[frame_id]->pin_count_ == 0) {
+      replacer_->SetEvictable(frame_id, true);
+    }
+  }
+}
+
+auto BufferPoolManagerInstance::Resize(size_t pool_size) -> bool {
+  BUSTUB_ASSERT(pool_size > 0, "the buffer pool needs at least one frame");
+  // the latch is released during write-backs, a concurrent resize must not hand out the frames being dropped
+  std::scoped_lock<std::mutex> resize_lock(resize_latch_);
+  std::unique_lock<std::mutex> lock(latch_);
+  DrainAccessBuffers();
+  const size_t old_pool_size = pool_size_;
+  if (pool_size >= old_pool_size) {
+    if (pool_size > pages_.size()) {
+      AddFrameSegment(pool_size);
+    }
+    replacer_->Resize(pool_size);
+    page_table_->Resize(pool_size);
+    for (size_t i = old_pool_size; i < pool_size; i++) {
+      free_list_.push_back(static_cast<frame_id_t>(i));
+    }
+    pool_size_ = pool_size;
+    return true;
+  }
+
+  // the dropped frames are no longer handed out; AcquireFrame() skips them if the replacer picks one
+  pool_size_ = pool_size;
+  free_list_.remove_if([&](frame_id_t fid) { return static_cast<size_t>(fid) >= pool_size; });
+  const auto deadline = std::chrono::steady_clock::now() + buffer_pool_resize_timeout;
+  while (true) {
+    bool drained = true;
+    std::vector<std::pair<frame_id_t, page_id_t>> write_backs;
+    for (size_t i = pool_size; i < old_pool_size; i++) {
+      const auto fid = static_cast<frame_id_t>(i);
+      Page &page = *pages_[fid];
+      if (page.page_id_ == INVALID_PAGE_ID) {
+        continue;
+      }
+      // a frame doing I/O is always pinned, so an unpinned frame is READY
+      if (!page.Claim()) {
+        drained = false;
+        continue;
+      }
+      // keep the page if a kept frame is free, there is no point in evicting another one in exchange
+      if (!free_list_.empty()) {
+        MoveFrame(fid, free_list_.front());
+        free_list_.pop_front();
+        continue;
+      }
+      page_id_t victim_page_id = INVALID_PAGE_ID;
+      RemoveFromReplacer(fid);
+      UnmapFrame(fid, &victim_page_id);
+      prefetched_[fid] = false;
+      page.page_id_ = INVALID_PAGE_ID;
+      page.is_dirty_ = false;
+      if (victim_page_id != INVALID_PAGE_ID) {
+        // keep the dropped frame busy until its page is on disk
+        page.frame_state_ = FrameState::WRITING;
+        write_backs.emplace_back(fid, victim_page_id);
+      }
+      page.Publish(victim_page_id != INVALID_PAGE_ID ? 1 : 0);
+    }
+    for (const auto &[fid, victim_page_id] : write_backs) {
+      WriteBackVictim(fid, victim_page_id, lock);
+      pages_[fid]->TryUnpin();
+      FinishIo(fid);
+    }
+    if (drained) {
+      break;
+    }
+    if (std::chrono::steady_clock::now() >= deadline) {
+      // give the frames that were emptied back, the pinned ones never stopped being part of the pool; their buffered
+      // unpins were dropped while they were out of it
+      for (size_t i = pool_size; i < old_pool_size; i++) {
+        const auto fid = static_cast<frame_id_t>(i);
+        if (pages_[i]->page_id_ == INVALID_PAGE_ID) {
+          free_list_.push_back(fid);
+        } else {
+          replacer_->SetEvictable(fid, pages_[i]->pin_count_ == 0);
+        }
+      }
+      pool_size_ = old_pool_size;
+      return false;
+    }
+    // UnpinPage() notifies, the timeout covers the frames unpinned by the flusher and the prefetch threads
+    resize_cv_.wait_for(lock, std::chrono::milliseconds(1));
+  }
+
+  for (auto &segment : segments_) {
+    const size_t first = std::max(pool_size, segment.first_frame_id_);
+    const size_t last = std::min(old_pool_size, segment.first_frame_id_ + segment.num_frames_);
+    if (first < last) {
+      segment.arena_->Release(first - segment.first_frame_id_, last - first);
+    }
+  }
+  replacer_->Resize(pool_size);
+  page_table_->Resize(pool_size);
   return true;
 }
 
-auto BufferPoolManagerInstance::AllocatePage() -> page_id_t { return next_page_id_++; }
+void BufferPoolManagerInstance::AddFrameSegment(size_t num_frames) {
+  FrameSegment segment;
+  segment.first_frame_id_ = pages_.size();
+  segment.num_frames_ = num_frames - pages_.size();
+  segment.pages_ = std::make_unique<Page[]>(segment.num_frames_);
+  segment.arena_ = std::make_unique<FrameArena>(segment.num_frames_, enable_huge_pages);
+  for (size_t i = 0; i < segment.num_frames_; i++) {
+    segment.pages_[i].data_ = segment.pages_[i].frame_data_ = segment.arena_->GetFrameData(i);
+    pages_.push_back(&segment.pages_[i]);
+  }
+  prefetched_.resize(pages_.size(), false);
+  segments_.push_back(std::move(segment));
+  auto directory = std::make_unique<Page *[]>(pages_.size());
+  std::copy(pages_.begin(), pages_.end(), directory.get());
+  frame_directory_.store(directory.get(), std::memory_order_release);
+  frame_directories_.push_back(std::move(directory));
+}
+
+void BufferPoolManagerInstance::MoveFrame(frame_id_t from_frame_id, frame_id_t to_frame_id) {
+  Page &from = *pages_[from_frame_id];
+  Page &to = *pages_[to_frame_id];
+  BUSTUB_ASSERT(from.pin_count_ == Page::CLAIMED && from.frame_state_ == FrameState::READY, "moved a frame in use");
+  ClaimFreeFrame(to_frame_id);
+  if (from.data_ != from.frame_data_) {
+    // a page lent by the disk manager moves without a copy
+    to.data_ = from.data_;
+    from.data_ = from.frame_data_;
+  } else {
+    to.data_ = to.frame_data_;
+    std::memcpy(to.GetData(), from.GetData(), BUSTUB_PAGE_SIZE);
+  }
+  to.page_id_ = from.page_id_;
+  to.is_dirty_ = from.is_dirty_.load();
+  prefetched_[to_frame_id] = prefetched_[from_frame_id];
+  prefetched_[from_frame_id] = false;
+  // the replacer state is per frame, so the page starts over with a single access
+  RemoveFromReplacer(from_frame_id);
+  replacer_->RecordAccess(to_frame_id, to.page_id_);
+  // a lock-free lookup may briefly miss the page, FetchPage() looks it up again under the latch
+  page_table_->Remove(to.page_id_);
+  page_table_->Insert(to.page_id_, to_frame_id);
+  from.page_id_ = INVALID_PAGE_ID;
+  from.is_dirty_ = false;
+  to.Publish(0);
+  from.Publish(0);
+}
+
+void BufferPoolManagerInstance::StartBackgroundFlusher(size_t low_watermark, size_t high_watermark) {
+  BUSTUB_ASSERT(low_watermark <= high_watermark && high_watermark <= pool_size_, "invalid flusher watermarks");
+  std::scoped_lock<std::mutex> lock(latch_);
+  if (flush_thread_running_) {
+    return;
+  }
+  flush_low_watermark_ = low_watermark;
+  flush_high_watermark_ = high_watermark;
+  flush_thread_running_ = true;
+  flush_thread_ = std::thread(&BufferPoolManagerInstance::BackgroundFlush, this);
+}
+
+void BufferPoolManagerInstance::StartBackgroundFlusher() {
+  StartBackgroundFlusher(pool_size_ * BG_FLUSH_LOW_WATERMARK_PCT / 100, pool_size_ * BG_FLUSH_HIGH_WATERMARK_PCT / 100);
+}
+
+void BufferPoolManagerInstance::StopBackgroundFlusher() {
+  {
+    std::scoped_lock<std::mutex> lock(latch_);
+    flush_thread_running_ = false;
+    flush_cv_.notify_one();
+  }
+  if (flush_thread_.joinable()) {
+    flush_thread_.join();
+  }
+}
+
+void BufferPoolManagerInstance::BackgroundFlush() {
+  std::unique_lock<std::mutex> lock(latch_);
+  while (flush_thread_running_) {
+    CleanFrames(lock);
+    flush_cv_.wait_for(lock, bg_flush_interval);
+  }
+}
+
+void BufferPoolManagerInstance::PrefetchPages(page_id_t start_page_id, size_t num_pages) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  if (prefetch_threads_.empty()) {
+    for (int i = 0; i < BUFFER_POOL_PREFETCH_THREADS; i++) {
+      prefetch_threads_.emplace_back(&BufferPoolManagerInstance::Prefetch, this);
+    }
+  }
+  for (size_t i = 0; i < num_pages; i++) {
+    const auto page_id = static_cast<page_id_t>(start_page_id + i);
+    // the queue never holds more pages than the buffer pool, older requests are the least useful
+    if (page_id % num_instances_ == instance_index_ && prefetch_queue_.size() < pool_size_) {
+      prefetch_queue_.push_back(page_id);
+    }
+  }
+  prefetch_cv_.notify_all();
+}
+
+void BufferPoolManagerInstance::Prefetch() {
+  std::unique_lock<std::mutex> lock(latch_);
+  while (true) {
+    prefetch_cv_.wait(lock, [&] { return !prefetch_running_ || !prefetch_queue_.empty(); });
+    if (!prefetch_running_) {
+      return;
+    }
+    // with a scheduler, read a batch of pages at once, without pinning more than a fraction of the buffer pool
+    const size_t batch_size =
+        disk_scheduler_ == nullptr ? 1 : std::clamp<size_t>(pool_size_ / 8, 1, BUFFER_POOL_PREFETCH_BATCH);
+    std::vector<std::pair<frame_id_t, page_id_t>> batch;
+    while (!prefetch_queue_.empty() && batch.size() < batch_size) {
+      const page_id_t page_id = prefetch_queue_.front();
+      prefetch_queue_.pop_front();
+      frame_id_t fid;
+      page_id_t victim_page_id;
+      if (!IsAllocated(page_id) || page_table_->Find(page_id, &fid) || write_back_.count(page_id) > 0 ||
+          !AcquireFrame(&fid, &victim_page_id)) {
+        continue;
+      }
+      MapFrame(fid, page_id, victim_page_id, lock);
+      batch.emplace_back(fid, page_id);
+    }
+    if (batch.empty()) {
+      continue;
+    }
+    // read-ahead serves scans, which fetch pages read-only
+    ReadFrames(batch, lock, true);
+    for (const auto &[fid, page_id] : batch) {
+      prefetched_[fid] = true;
+      num_prefetches_++;
+      // nobody asked for the page yet, leave it unpinned
+      if (pages_[fid]->TryUnpin() == 0) {
+        replacer_->SetEvictable(fid, true);
+      }
+    }
+  }
+}
+
+void BufferPoolManagerInstance::CleanFrames(std::unique_lock<std::mutex> &lock) {
+  const bool wal = enable_logging && log_manager_ != nullptr;
+  size_t num_clean = free_list_.size();
+  std::vector<std::pair<page_id_t, frame_id_t>> candidates;
+  for (size_t i = 0; i < pool_size_; i++) {
+    Page &page = *pages_[i];
+    if (page.page_id_ == INVALID_PAGE_ID || page.pin_count_ > 0) {
+      continue;
+    }
+    if (!page.is_dirty_) {
+      num_clean++;
+    } else if (!wal || page.GetLSN() <= log_manager_->GetPersistentLSN()) {
+      candidates.emplace_back(page.page_id_, static_cast<frame_id_t>(i));
+    }
+  }
+  if (num_clean >= flush_low_watermark_) {
+    return;
+  }
+  // clean the frames of the lowest page ids in one batch, so that the disk sees a few sequential writes
+  std::sort(candidates.begin(), candidates.end());
+  candidates.resize(std::min(candidates.size(), flush_high_watermark_ - num_clean));
+  std::vector<frame_id_t> frame_ids;
+  for (const auto &[page_id, frame_id] : candidates) {
+    frame_ids.push_back(frame_id);
+  }
+  FlushFrames(frame_ids, lock, true);
+}
+
+auto BufferPoolManagerInstance::LoadPages(const std::vector<page_id_t> &page_ids) -> size_t {
+  const auto frames = BeginLoad(page_ids);
+  if (frames.empty()) {
+    return 0;
+  }
+  // only read the span holding the pages that are loaded
+  const page_id_t first_page_id = frames.front().first;
+  std::vector<char> data(static_cast<size_t>(frames.back().first - first_page_id + 1) * BUSTUB_PAGE_SIZE);
+  const auto start = std::chrono::steady_clock::now();
+  disk_manager_->ReadPages(first_page_id, data.size() / BUSTUB_PAGE_SIZE, data.data());
+  stats_.RecordRead(std::chrono::steady_clock::now() - start);
+  FinishLoad(frames, first_page_id, data.data());
+  return frames.size();
+}
+
+auto BufferPoolManagerInstance::BeginLoad(const std::vector<page_id_t> &page_ids)
+    -> std::vector<std::pair<page_id_t, frame_id_t>> {
+  std::scoped_lock<std::mutex> lock(latch_);
+  std::vector<std::pair<page_id_t, frame_id_t>> frames;
+  for (auto it = page_ids.begin(); it != page_ids.end() && !free_list_.empty(); ++it) {
+    const page_id_t page_id = *it;
+    frame_id_t fid;
+    // the disk copy of a page being written back is stale
+    if (page_id % num_instances_ != instance_index_ || !IsAllocated(page_id) || page_table_->Find(page_id, &fid) ||
+        write_back_.count(page_id) > 0) {
+      continue;
+    }
+    fid = free_list_.front();
+    free_list_.pop_front();
+    ClaimFreeFrame(fid);
+    Page &page = *pages_[fid];
+    page.data_ = page.frame_data_;
+    page.page_id_ = page_id;
+    page.is_dirty_ = false;
+    page.frame_state_ = FrameState::READING;
+    replacer_->RecordAccess(fid, page_id);
+    replacer_->SetEvictable(fid, false);
+    page_table_->Insert(page_id, fid);
+    page.Publish(1);
+    if (compressed_cache_ != nullptr) {
+      // the page is read from disk instead, it must not stay cached while resident
+      compressed_cache_->Invalidate(page_id);
+    }
+    frames.emplace_back(page_id, fid);
+  }
+  return frames;
+}
+
+void BufferPoolManagerInstance::FinishLoad(const std::vector<std::pair<page_id_t, frame_id_t>> &frames,
+                                           page_id_t start_page_id, const char *data) {
+  std::vector<Page *> pages;
+  {
+    std::scoped_lock<std::mutex> lock(latch_);
+    for (const auto &[page_id, fid] : frames) {
+      pages.push_back(pages_[fid]);
+    }
+  }
+  // the frames are pinned and READING, nobody else touches their data
+  for (size_t i = 0; i < frames.size(); i++) {
+    std::memcpy(pages[i]->GetData(), data + static_cast<size_t>(frames[i].first - start_page_id) * BUSTUB_PAGE_SIZE,
+                BUSTUB_PAGE_SIZE);
+  }
+  std::scoped_lock<std::mutex> lock(latch_);
+  for (const auto &[page_id, fid] : frames) {
+    // like a prefetched page, the first fetch does not count as a second access
+    prefetched_[fid] = true;
+    FinishIo(fid);
+    if (pages_[fid]->TryUnpin() == 0) {
+      replacer_->SetEvictable(fid, true);
+      if (static_cast<size_t>(fid) >= pool_size_) {
+        resize_cv_.notify_all();
+      }
+    }
+  }
+}
+
+auto BufferPoolManagerInstance::GetResidentPages() -> std::vector<page_id_t> {
+  std::scoped_lock<std::mutex> lock(latch_);
+  DrainAccessBuffers();
+  std::vector<page_id_t> page_ids;
+  for (const auto fid : replacer_->GetPriorityOrder()) {
+    // a frame dropped by a shrink in progress is about to lose its page
+    if (static_cast<size_t>(fid) < pool_size_ && pages_[fid]->page_id_ != INVALID_PAGE_ID) {
+      page_ids.push_back(pages_[fid]->page_id_);
+    }
+  }
+  return page_ids;
+}
+
+void BufferPoolManagerInstance::SetAccessTrace(AccessTrace *trace) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  access_trace_ = trace;
+}
+
+void BufferPoolManagerInstance::SetCompressedPageCache(CompressedPageCache *cache) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  compressed_cache_ = cache;
+}
+
+void BufferPoolManagerInstance::SetDiskScheduler(DiskScheduler *scheduler) {
+  std::unique_lock<std::mutex> lock(latch_);
+  disk_scheduler_ = scheduler;
+  // the reads issued through the previous scheduler are waited for by the threads that issued them, under no latch;
+  // wait until no frame is reading so that the caller may destroy it
+  for (size_t i = 0; i < pages_.size(); i++) {
+    pages_[i]->io_cv_.wait(lock, [&] { return pages_[i]->frame_state_ != FrameState::READING; });
+  }
+}
+
+auto BufferPoolManagerInstance::LockLatch() -> std::unique_lock<std::mutex> {
+  std::unique_lock<std::mutex> lock(latch_, std::try_to_lock);
+  if (lock.owns_lock()) {
+    // the common, uncontended case does not read the clock
+    stats_.RecordLatchAcquire(false, std::chrono::nanoseconds(0));
+  } else {
+    const auto start = std::chrono::steady_clock::now();
+    lock.lock();
+    stats_.RecordLatchAcquire(true, std::chrono::steady_clock::now() - start);
+  }
+  DrainAccessBuffers();
+  return lock;
+}
+
+void BufferPoolManagerInstance::BufferAccess(frame_id_t frame_id, page_id_t page_id) {
+  static std::atomic<size_t> next_shard{0};
+  thread_local const size_t shard_index = next_shard.fetch_add(1, std::memory_order_relaxed) % NUM_ACCESS_SHARDS;
+  AccessShard &shard = access_shards_[shard_index];
+  std::unique_lock<std::mutex> shard_lock(shard.latch_);
+  shard.entries_.push_back({frame_id, page_id});
+  num_buffered_accesses_.fetch_add(1, std::memory_order_relaxed);
+  if (shard.entries_.size() < ACCESS_BUFFER_SIZE) {
+    return;
+  }
+  // the shard latches are taken after latch_, which drains every shard
+  shard_lock.unlock();
+  auto lock = LockLatch();
+}
+
+void BufferPoolManagerInstance::DrainAccessBuffers() {
+  if (num_buffered_accesses_.load(std::memory_order_relaxed) == 0) {
+    return;
+  }
+  std::vector<AccessEntry> entries;
+  for (auto &shard : access_shards_) {
+    {
+      std::scoped_lock<std::mutex> shard_lock(shard.latch_);
+      entries.swap(shard.entries_);
+    }
+    num_buffered_accesses_.fetch_sub(entries.size(), std::memory_order_relaxed);
+    for (const auto &entry : entries) {
+      const frame_id_t fid = entry.frame_id_;
+      // the replacer no longer tracks the frames dropped by a shrink
+      if (static_cast<size_t>(fid) >= pool_size_) {
+        continue;
+      }
+      const Page &page = *pages_[fid];
+      if (entry.page_id_ != INVALID_PAGE_ID) {
+        if (page.page_id_ != entry.page_id_) {
+          // the frame was remapped since, the access is stale
+          continue;
+        }
+        if (prefetched_[fid]) {
+          // first fetch of a prefetched page, the prefetch already recorded an access
+          prefetched_[fid] = false;
+        } else {
+          replacer_->RecordAccess(fid, entry.page_id_);
+        }
+      }
+      // the entries of a frame may be applied out of order, the current pin count is what counts
+      replacer_->SetEvictable(fid, page.pin_count_ == 0);
+    }
+    entries.clear();
+  }
+}
+
+void BufferPoolManagerInstance::ClaimFreeFrame(frame_id_t frame_id) {
+  while (!pages_[frame_id]->Claim()) {
+    std::this_thread::yield();
+  }
+}
+
+void BufferPoolManagerInstance::RemoveFromReplacer(frame_id_t frame_id) {
+  replacer_->SetEvictable(frame_id, true);
+  replacer_->Remove(frame_id);
+}
+
+auto BufferPoolManagerInstance::AllocatePage(PageSegment *segment) -> page_id_t {
+  if (segment != nullptr) {
+    return segment->AllocatePage([&] {
+      if (page_allocator_ != nullptr) {
+        return page_allocator_->AllocateExtent();
+      }
+      const page_id_t first_page_id = next_page_id_;
+      next_page_id_ += EXTENT_SIZE;
+      return first_page_id;
+    });
+  }
+  if (page_allocator_ != nullptr) {
+    return page_allocator_->AllocatePage(num_instances_, instance_index_);
+  }
+  const page_id_t next_page_id = next_page_id_;
+  next_page_id_ += num_instances_;
+  ValidatePageId(next_page_id);
+  return next_page_id;
+}
+
+void BufferPoolManagerInstance::DeallocatePage(page_id_t page_id) {
+  if (page_allocator_ != nullptr) {
+    page_allocator_->DeallocatePage(page_id);
+  }
+}
+
+auto BufferPoolManagerInstance::IsAllocated(page_id_t page_id) -> bool {
+  if (page_allocator_ != nullptr) {
+    return page_allocator_->IsAllocated(page_id);
+  }
+  return page_id >= 0 && page_id < next_page_id_;
+}
+
+void BufferPoolManagerInstance::ValidatePageId(const page_id_t page_id) const {
+  assert(page_id % num_instances_ == instance_index_);  // allocated pages mod back to this BPI
+}
 
 }  // namespace bustub
@@ -0,0 +1,154 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// buffer_pool_stats.cpp
+//
+// Identification: src/buffer/buffer_pool_stats.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/buffer_pool_stats.h"
+
+#include <algorithm>
+
+#include "fmt/format.h"
+
+namespace bustub {
+
+auto LatencyHistogram::BucketOf(uint64_t latency_us) -> size_t {
+  size_t bucket = 0;
+  while (latency_us > 0 && bucket < NUM_BUCKETS - 1) {
+    latency_us >>= 1;
+    bucket++;
+  }
+  return bucket;
+}
+
+auto LatencyHistogram::Count() const -> uint64_t {
+  uint64_t count = 0;
+  for (auto bucket : buckets_) {
+    count += bucket;
+  }
+  return count;
+}
+
+auto LatencyHistogram::Percentile(double percentile) const -> uint64_t {
+  const uint64_t count = Count();
+  if (count == 0) {
+    return 0;
+  }
+  // the rank of the percentile among the recorded latencies, at least the first one
+  auto rank = static_cast<uint64_t>(percentile / 100 * static_cast<double>(count));
+  rank = std::max<uint64_t>(rank, 1);
+  uint64_t seen = 0;
+  for (size_t i = 0; i < NUM_BUCKETS; i++) {
+    seen += buckets_[i];
+    if (seen >= rank) {
+      return uint64_t{1} << i;
+    }
+  }
+  return uint64_t{1} << (NUM_BUCKETS - 1);
+}
+
+auto LatencyHistogram::operator+=(const LatencyHistogram &other) -> LatencyHistogram & {
+  for (size_t i = 0; i < NUM_BUCKETS; i++) {
+    buckets_[i] += other.buckets_[i];
+  }
+  return *this;
+}
+
+auto BufferPoolStatsSnapshot::HitRatio() const -> double {
+  const uint64_t fetches = hits_ + misses_;
+  return fetches == 0 ? 0 : static_cast<double>(hits_) / static_cast<double>(fetches);
+}
+
+auto BufferPoolStatsSnapshot::operator+=(const BufferPoolStatsSnapshot &other) -> BufferPoolStatsSnapshot & {
+  hits_ += other.hits_;
+  misses_ += other.misses_;
+  clean_evictions_ += other.clean_evictions_;
+  dirty_evictions_ += other.dirty_evictions_;
+  new_pages_ += other.new_pages_;
+  deletes_ += other.deletes_;
+  latch_acquires_ += other.latch_acquires_;
+  latch_contended_ += other.latch_contended_;
+  latch_wait_ns_ += other.latch_wait_ns_;
+  read_errors_ += other.read_errors_;
+  read_latency_ += other.read_latency_;
+  write_latency_ += other.write_latency_;
+  return *this;
+}
+
+void BufferPoolStats::RecordLatchAcquire(bool contended, std::chrono::nanoseconds wait) {
+  auto &shard = LocalShard();
+  shard.latch_acquires_.fetch_add(1, std::memory_order_relaxed);
+  if (contended) {
+    shard.latch_contended_.fetch_add(1, std::memory_order_relaxed);
+    shard.latch_wait_ns_.fetch_add(wait.count(), std::memory_order_relaxed);
+  }
+}
+
+void BufferPoolStats::RecordRead(std::chrono::nanoseconds latency) {
+  auto us = std::chrono::duration_cast<std::chrono::microseconds>(latency).count();
+  LocalShard().read_latency_[LatencyHistogram::BucketOf(us)].fetch_add(1, std::memory_order_relaxed);
+}
+
+void BufferPoolStats::RecordWrite(std::chrono::nanoseconds latency) {
+  auto us = std::chrono::duration_cast<std::chrono::microseconds>(latency).count();
+  LocalShard().write_latency_[LatencyHistogram::BucketOf(us)].fetch_add(1, std::memory_order_relaxed);
+}
+
+auto BufferPoolStats::LocalShard() -> Shard & {
+  // threads are spread round-robin over the shards on their first update
+  static std::atomic<size_t> next_shard{0};
+  thread_local const size_t shard = next_shard.fetch_add(1, std::memory_order_relaxed) % NUM_SHARDS;
+  return shards_[shard];
+}
+
+auto BufferPoolStats::Snapshot() const -> BufferPoolStatsSnapshot {
+  BufferPoolStatsSnapshot snapshot;
+  for (const auto &shard : shards_) {
+    snapshot.hits_ += shard.hits_.load(std::memory_order_relaxed);
+    snapshot.misses_ += shard.misses_.load(std::memory_order_relaxed);
+    snapshot.clean_evictions_ += shard.clean_evictions_.load(std::memory_order_relaxed);
+    snapshot.dirty_evictions_ += shard.dirty_evictions_.load(std::memory_order_relaxed);
+    snapshot.new_pages_ += shard.new_pages_.load(std::memory_order_relaxed);
+    snapshot.deletes_ += shard.deletes_.load(std::memory_order_relaxed);
+    snapshot.latch_acquires_ += shard.latch_acquires_.load(std::memory_order_relaxed);
+    snapshot.latch_contended_ += shard.latch_contended_.load(std::memory_order_relaxed);
+    snapshot.latch_wait_ns_ += shard.latch_wait_ns_.load(std::memory_order_relaxed);
+    snapshot.read_errors_ += shard.read_errors_.load(std::memory_order_relaxed);
+    for (size_t i = 0; i < LatencyHistogram::NUM_BUCKETS; i++) {
+      snapshot.read_latency_.buckets_[i] += shard.read_latency_[i].load(std::memory_order_relaxed);
+      snapshot.write_latency_.buckets_[i] += shard.write_latency_[i].load(std::memory_order_relaxed);
+    }
+  }
+  return snapshot;
+}
+
+auto BufferPoolStats::ToRows(const BufferPoolStatsSnapshot &snapshot)
+    -> std::vector<std::pair<std::string, std::string>> {
+  std::vector<std::pair<std::string, std::string>> result;
+  auto append = [&](const std::string &name, const std::string &value) { result.emplace_back(name, value); };
+  append("hits", fmt::format("{}", snapshot.hits_));
+  append("misses", fmt::format("{}", snapshot.misses_));
+  append("hit ratio", fmt::format("{:.2f}%", snapshot.HitRatio() * 100));
+  append("clean evictions", fmt::format("{}", snapshot.clean_evictions_));
+  append("dirty evictions", fmt::format("{}", snapshot.dirty_evictions_));
+  append("new pages", fmt::format("{}", snapshot.new_pages_));
+  append("deletes", fmt::format("{}", snapshot.deletes_));
+  append("latch acquires", fmt::format("{}", snapshot.latch_acquires_));
+  append("latch contended", fmt::format("{}", snapshot.latch_contended_));
+  append("latch wait", fmt::format("{:.3f} ms", static_cast<double>(snapshot.latch_wait_ns_) / 1e6));
+  for (const auto &[name, histogram] : {std::make_pair("reads", &snapshot.read_latency_),
+                                        std::make_pair("writes", &snapshot.write_latency_)}) {
+    append(name, fmt::format("{} (p50 < {} us, p99 < {} us)", histogram->Count(), histogram->Percentile(50),
+                             histogram->Percentile(99)));
+  }
+  append("read errors", fmt::format("{}", snapshot.read_errors_));
+  return result;
+}
+
+}  // namespace bustub
@@ -0,0 +1,148 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// buffer_pool_warmer.cpp
+//
+// Identification: src/buffer/buffer_pool_warmer.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/buffer_pool_warmer.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <utility>
+
+#include "common/logger.h"
+
+namespace bustub {
+
+BufferPoolWarmer::BufferPoolWarmer(BufferPoolManager *bpm, std::string file_name)
+    : bpm_(bpm), file_name_(std::move(file_name)) {}
+
+BufferPoolWarmer::~BufferPoolWarmer() {
+  StopPeriodicDump();
+  StopWarmUp();
+}
+
+auto BufferPoolWarmer::Dump() -> bool {
+  if (warming_up_) {
+    return false;
+  }
+  std::scoped_lock<std::mutex> lock(file_latch_);
+  const auto page_ids = bpm_->GetResidentPages();
+  const std::string tmp_file_name = file_name_ + ".tmp";
+  std::ofstream out(tmp_file_name, std::ios::out | std::ios::trunc);
+  for (const auto page_id : page_ids) {
+    out << page_id << '\n';
+  }
+  out.close();
+  if (!out || std::rename(tmp_file_name.c_str(), file_name_.c_str()) != 0) {
+    LOG_DEBUG("can't save the resident page set");
+    std::remove(tmp_file_name.c_str());
+    return false;
+  }
+  return true;
+}
+
+void BufferPoolWarmer::StartPeriodicDump(std::chrono::milliseconds interval) {
+  std::scoped_lock<std::mutex> lock(dump_latch_);
+  if (dump_running_) {
+    return;
+  }
+  dump_running_ = true;
+  dump_thread_ = std::thread(&BufferPoolWarmer::PeriodicDump, this, interval);
+}
+
+void BufferPoolWarmer::StopPeriodicDump() {
+  {
+    std::scoped_lock<std::mutex> lock(dump_latch_);
+    dump_running_ = false;
+    dump_cv_.notify_one();
+  }
+  if (dump_thread_.joinable()) {
+    dump_thread_.join();
+  }
+}
+
+void BufferPoolWarmer::PeriodicDump(std::chrono::milliseconds interval) {
+  std::unique_lock<std::mutex> lock(dump_latch_);
+  while (!dump_cv_.wait_for(lock, interval, [&] { return !dump_running_; })) {
+    lock.unlock();
+    Dump();
+    lock.lock();
+  }
+}
+
+void BufferPoolWarmer::StartWarmUp() {
+  if (warm_up_thread_.joinable()) {
+    return;
+  }
+  warming_up_ = true;
+  stop_warm_up_ = false;
+  warm_up_thread_ = std::thread(&BufferPoolWarmer::WarmUp, this);
+}
+
+void BufferPoolWarmer::StopWarmUp() {
+  stop_warm_up_ = true;
+  WaitForWarmUp();
+}
+
+void BufferPoolWarmer::WaitForWarmUp() {
+  if (warm_up_thread_.joinable()) {
+    warm_up_thread_.join();
+  }
+}
+
+void BufferPoolWarmer::WarmUp() {
+  auto page_ids = ReadPageList(file_name_);
+  // the pages beyond the pool size would only evict each other
+  page_ids.resize(std::min(page_ids.size(), bpm_->GetPoolSize()));
+  for (const auto &run : PlanRuns(std::move(page_ids), WARMUP_MAX_RUN_PAGES, WARMUP_MAX_GAP_PAGES)) {
+    if (stop_warm_up_) {
+      // an interrupted warm-up must not overwrite the list with a partial one
+      return;
+    }
+    num_pages_loaded_ += bpm_->LoadPages(run);
+  }
+  warming_up_ = false;
+}
+
+auto BufferPoolWarmer::ReadPageList(const std::string &file_name) -> std::vector<page_id_t> {
+  std::vector<page_id_t> page_ids;
+  std::ifstream in(file_name);
+  page_id_t page_id;
+  while (in >> page_id) {
+    page_ids.push_back(page_id);
+  }
+  return page_ids;
+}
+
+auto BufferPoolWarmer::PlanRuns(std::vector<page_id_t> page_ids, size_t max_run_pages, size_t max_gap_pages)
+    -> std::vector<std::vector<page_id_t>> {
+  std::sort(page_ids.begin(), page_ids.end());
+  page_ids.erase(std::unique(page_ids.begin(), page_ids.end()), page_ids.end());
+  std::vector<std::vector<page_id_t>> runs;
+  for (const auto page_id : page_ids) {
+    if (page_id < 0) {
+      continue;
+    }
+    if (!runs.empty()) {
+      auto &run = runs.back();
+      const auto gap = static_cast<size_t>(page_id - run.back() - 1);
+      const auto run_pages = static_cast<size_t>(page_id - run.front() + 1);
+      if (gap <= max_gap_pages && run_pages <= max_run_pages) {
+        run.push_back(page_id);
+        continue;
+      }
+    }
+    runs.push_back({page_id});
+  }
+  return runs;
+}
+
+}  // namespace bustub
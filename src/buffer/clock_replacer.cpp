@@ -12,18 +12,103 @@
 
 #include "buffer/clock_replacer.h"
 
+#include "common/macros.h"
+
 namespace bustub {
 
-ClockReplacer::ClockReplacer(size_t num_pages) {}
+ClockReplacer::ClockReplacer(size_t num_pages) : frames_(num_pages) {}
 
 ClockReplacer::~ClockReplacer() = default;
 
-auto ClockReplacer::Victim(frame_id_t *frame_id) -> bool { return false; }
+auto ClockReplacer::Evict(frame_id_t *frame_id) -> bool {
+  std::scoped_lock<std::mutex> lock(latch_);
+  if (curr_size_ == 0) {
+    return false;
+  }
+  // the first sweep clears the reference bits, so the second one finds a victim
+  for (size_t i = 0; i < 2 * frames_.size(); i++) {
+    auto &entry = frames_[hand_];
+    const auto fid = static_cast<frame_id_t>(hand_);
+    hand_ = (hand_ + 1) % frames_.size();
+    if (!entry.tracked_ || !entry.evictable_) {
+      continue;
+    }
+    if (entry.referenced_) {
+      entry.referenced_ = false;
+      continue;
+    }
+    entry = FrameEntry{};
+    curr_size_--;
+    *frame_id = fid;
+    return true;
+  }
+  return false;
+}
+
+void ClockReplacer::RecordAccess(frame_id_t frame_id, page_id_t page_id) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  BUSTUB_ASSERT(frame_id >= 0 && static_cast<size_t>(frame_id) < frames_.size(), "invalid frame id");
+  auto &entry = frames_[frame_id];
+  if (!entry.tracked_) {
+    entry.tracked_ = true;
+    entry.evictable_ = true;
+    curr_size_++;
+  }
+  entry.referenced_ = true;
+}
+
+void ClockReplacer::SetEvictable(frame_id_t frame_id, bool set_evictable) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  BUSTUB_ASSERT(frame_id >= 0 && static_cast<size_t>(frame_id) < frames_.size(), "invalid frame id");
+  auto &entry = frames_[frame_id];
+  if (!entry.tracked_ || entry.evictable_ == set_evictable) {
+    return;
+  }
+  entry.evictable_ = set_evictable;
+  if (set_evictable) {
+    curr_size_++;
+  } else {
+    curr_size_--;
+  }
+}
+
+void ClockReplacer::Remove(frame_id_t frame_id) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  BUSTUB_ASSERT(frame_id >= 0 && static_cast<size_t>(frame_id) < frames_.size(), "invalid frame id");
+  auto &entry = frames_[frame_id];
+  if (!entry.tracked_ || !entry.evictable_) {
+    return;
+  }
+  entry = FrameEntry{};
+  curr_size_--;
+}
 
-void ClockReplacer::Pin(frame_id_t frame_id) {}
+void ClockReplacer::Resize(size_t num_frames) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  frames_.resize(num_frames);
+  if (hand_ >= num_frames) {
+    hand_ = 0;
+  }
+}
 
-void ClockReplacer::Unpin(frame_id_t frame_id) {}
+auto ClockReplacer::GetPriorityOrder() -> std::vector<frame_id_t> {
+  std::scoped_lock<std::mutex> lock(latch_);
+  // referenced frames survive the next sweep; within each group, the hand reaches the frames just behind it last
+  std::vector<frame_id_t> referenced;
+  std::vector<frame_id_t> unreferenced;
+  for (size_t i = 1; i <= frames_.size(); i++) {
+    const size_t fid = (hand_ + frames_.size() - i) % frames_.size();
+    if (frames_[fid].tracked_) {
+      (frames_[fid].referenced_ ? referenced : unreferenced).push_back(static_cast<frame_id_t>(fid));
+    }
+  }
+  referenced.insert(referenced.end(), unreferenced.begin(), unreferenced.end());
+  return referenced;
+}
 
-auto ClockReplacer::Size() -> size_t { return 0; }
+auto ClockReplacer::Size() -> size_t {
+  std::scoped_lock<std::mutex> lock(latch_);
+  return curr_size_;
+}
 
 }  // namespace bustub
@@ -0,0 +1,136 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// compressed_page_cache.cpp
+//
+// Identification: src/buffer/compressed_page_cache.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/compressed_page_cache.h"
+
+#include <array>
+#include <cstring>
+
+#include "common/util/lz_codec.h"
+#include "fmt/format.h"
+
+namespace bustub {
+
+auto CompressedPageCacheStats::HitRatio() const -> double {
+  const uint64_t lookups = hits_ + misses_;
+  return lookups == 0 ? 0 : static_cast<double>(hits_) / static_cast<double>(lookups);
+}
+
+auto CompressedPageCacheStats::CompressionRatio() const -> double {
+  return compressed_bytes_ == 0 ? 0 : static_cast<double>(uncompressed_bytes_) / static_cast<double>(compressed_bytes_);
+}
+
+CompressedPageCache::CompressedPageCache(size_t capacity)
+    : capacity_(capacity), region_(std::make_unique<char[]>(capacity)) {}
+
+void CompressedPageCache::Insert(page_id_t page_id, const char *data) {
+  std::array<char, MAX_COMPRESSED_PAGE_SIZE> buffer;
+  // a page that does not compress well gives up as soon as it overflows the buffer
+  const size_t size = LZCodec::Compress(data, BUSTUB_PAGE_SIZE, buffer.data(), buffer.size());
+  std::scoped_lock<std::mutex> lock(latch_);
+  Erase(page_id);
+  if (size == 0 || size > capacity_) {
+    stats_.rejections_++;
+    return;
+  }
+  const Slot slot{page_id, Allocate(size), size};
+  std::memcpy(region_.get() + slot.offset_, buffer.data(), size);
+  slots_.push_back(slot);
+  index_.emplace(page_id, slot);
+  stats_.insertions_++;
+  stats_.uncompressed_bytes_ += BUSTUB_PAGE_SIZE;
+  stats_.compressed_bytes_ += size;
+  stats_.num_pages_++;
+  stats_.used_bytes_ += size;
+}
+
+auto CompressedPageCache::Take(page_id_t page_id, char *data) -> bool {
+  std::scoped_lock<std::mutex> lock(latch_);
+  auto it = index_.find(page_id);
+  if (it == index_.end()) {
+    stats_.misses_++;
+    return false;
+  }
+  const size_t size = LZCodec::Decompress(region_.get() + it->second.offset_, it->second.size_, data, BUSTUB_PAGE_SIZE);
+  BUSTUB_ASSERT(size == BUSTUB_PAGE_SIZE, "corrupt compressed page");
+  Erase(page_id);
+  stats_.hits_++;
+  return true;
+}
+
+void CompressedPageCache::Invalidate(page_id_t page_id) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  Erase(page_id);
+}
+
+auto CompressedPageCache::GetStats() -> CompressedPageCacheStats {
+  std::scoped_lock<std::mutex> lock(latch_);
+  return stats_;
+}
+
+auto CompressedPageCache::IsLive(const Slot &slot) const -> bool {
+  auto it = index_.find(slot.page_id_);
+  return it != index_.end() && it->second.offset_ == slot.offset_;
+}
+
+void CompressedPageCache::Erase(page_id_t page_id) {
+  auto it = index_.find(page_id);
+  if (it == index_.end()) {
+    return;
+  }
+  // the slot stays in slots_ as a hole
+  stats_.num_pages_--;
+  stats_.used_bytes_ -= it->second.size_;
+  index_.erase(it);
+}
+
+auto CompressedPageCache::Allocate(size_t size) -> size_t {
+  auto drop_oldest = [&] {
+    const Slot slot = slots_.front();
+    slots_.pop_front();
+    if (IsLive(slot)) {
+      Erase(slot.page_id_);
+      stats_.evictions_++;
+    }
+  };
+  if (head_ + size > capacity_) {
+    // the end of the region is too short, and the slots there are the oldest ones
+    while (!slots_.empty() && slots_.front().offset_ >= head_) {
+      drop_oldest();
+    }
+    head_ = 0;
+  }
+  // the slots of the previous pass over the region start at or after head_, the newer ones before it
+  while (!slots_.empty() && slots_.front().offset_ >= head_ && slots_.front().offset_ < head_ + size) {
+    drop_oldest();
+  }
+  const size_t offset = head_;
+  head_ += size;
+  return offset;
+}
+
+auto CompressedPageCache::ToRows(const CompressedPageCacheStats &stats)
+    -> std::vector<std::pair<std::string, std::string>> {
+  std::vector<std::pair<std::string, std::string>> result;
+  auto append = [&](const std::string &name, const std::string &value) { result.emplace_back(name, value); };
+  append("compressed cache hits", fmt::format("{}", stats.hits_));
+  append("compressed cache misses", fmt::format("{}", stats.misses_));
+  append("compressed cache hit ratio", fmt::format("{:.2f}%", stats.HitRatio() * 100));
+  append("compressed cache pages", fmt::format("{} ({} bytes)", stats.num_pages_, stats.used_bytes_));
+  append("compressed cache insertions", fmt::format("{}", stats.insertions_));
+  append("compressed cache rejections", fmt::format("{}", stats.rejections_));
+  append("compressed cache evictions", fmt::format("{}", stats.evictions_));
+  append("compression ratio", fmt::format("{:.2f}", stats.CompressionRatio()));
+  return result;
+}
+
+}  // namespace bustub
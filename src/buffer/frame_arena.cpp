@@ -0,0 +1,57 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// frame_arena.cpp
+//
+// Identification: src/buffer/frame_arena.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/frame_arena.h"
+
+#include <sys/mman.h>
+#include <algorithm>
+
+#include "common/exception.h"
+
+namespace bustub {
+
+FrameArena::FrameArena(size_t num_frames, bool huge_pages) {
+  size_t size = std::max<size_t>(num_frames, 1) * BUSTUB_PAGE_SIZE;
+  void *data = MAP_FAILED;
+#ifdef MAP_HUGETLB
+  if (huge_pages) {
+    // a huge page mapping must be a multiple of the huge page size
+    mapped_size_ = (size + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE;
+    data = mmap(nullptr, mapped_size_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    huge_tlb_ = data != MAP_FAILED;
+  }
+#endif
+  if (data == MAP_FAILED) {
+    mapped_size_ = size;
+    data = mmap(nullptr, mapped_size_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (data == MAP_FAILED) {
+      throw Exception(ExceptionType::OUT_OF_MEMORY, "cannot map the buffer pool frames");
+    }
+#ifdef MADV_HUGEPAGE
+    if (huge_pages) {
+      // best effort: the kernel may or may not back the arena with transparent huge pages
+      madvise(data, mapped_size_, MADV_HUGEPAGE);
+    }
+#endif
+  }
+  // anonymous mappings are zero-filled, which is what a fresh frame should contain
+  data_ = static_cast<char *>(data);
+}
+
+FrameArena::~FrameArena() { munmap(data_, mapped_size_); }
+
+void FrameArena::Release(size_t first_frame_id, size_t num_frames) {
+  // the kernel drops the pages of a private anonymous mapping, and maps the zero page on the next read
+  madvise(GetFrameData(first_frame_id), num_frames * BUSTUB_PAGE_SIZE, MADV_DONTNEED);
+}
+
+}  // namespace bustub
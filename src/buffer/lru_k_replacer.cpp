@@ -12,108 +12,149 @@
 
 #include "buffer/lru_k_replacer.h"
 
+#include <algorithm>
+
 namespace bustub {
 
-LRUKReplacer::LRUKReplacer(size_t num_frames, size_t k) : replacer_size_(num_frames), k_(k) {}
+LRUKReplacer::LRUKReplacer(size_t num_frames, size_t k)
+    : replacer_size_(num_frames), k_(k), frames_(num_frames), history_(num_frames * k) {
+  BUSTUB_ASSERT(k > 0, "k must be positive");
+}
 
 auto LRUKReplacer::Evict(frame_id_t *frame_id) -> bool {
   std::scoped_lock<std::mutex> lock(latch_);
-  if (!fifo_.empty()) {
-    for (auto iter = fifo_.begin(); iter != fifo_.end(); iter++) {
-      if (frame_info_[*iter].set_evictable_) {
-        *frame_id = *iter;
-        fifo_.erase(iter);
-        frame_info_.erase(*frame_id);
-        curr_size_--;
-        // LOG_DEBUG("fifo Evict %d", *frame_id);
-        return true;
-      }
-    }
+  for (auto fid : pending_) {
+    heap_.emplace(EvictionKey(fid), fid);
   }
-  if (!lru_.empty()) {
-    for (auto iter = lru_.begin(); iter != lru_.end(); iter++) {
-      if (frame_info_[*iter].set_evictable_) {
-        *frame_id = *iter;
-        lru_.erase(iter);
-        frame_info_.erase(*frame_id);
-        curr_size_--;
-        // LOG_DEBUG("lru Evict %d", *frame_id);
-        return true;
-      }
+  pending_.clear();
+  while (!heap_.empty()) {
+    auto [key, fid] = heap_.top();
+    heap_.pop();
+    auto &entry = frames_[fid];
+    if (!entry.tracked_ || !entry.evictable_) {
+      // The frame was removed or pinned after it was queued. It is queued again once it becomes evictable.
+      entry.queued_ = false;
+      continue;
+    }
+    auto current_key = EvictionKey(fid);
+    if (current_key != key) {
+      // The frame was accessed after it was queued, so its k-distance shrank.
+      heap_.emplace(current_key, fid);
+      continue;
     }
+    entry = FrameEntry{};
+    curr_size_--;
+    *frame_id = fid;
+    return true;
   }
   return false;
 }
 
 void LRUKReplacer::RecordAccess(frame_id_t frame_id) {
   std::scoped_lock<std::mutex> lock(latch_);
-  auto iter_map = frame_info_.find(frame_id);
-  if (iter_map == frame_info_.end()) {
-    FrameEntry temp;
-    temp.set_evictable_ = true;
-    auto insert_res = frame_info_.insert(std::make_pair(frame_id, temp));
-    iter_map = insert_res.first;
+  BUSTUB_ASSERT(frame_id >= 0 && static_cast<size_t>(frame_id) < replacer_size_, "invalid frame id");
+  auto &entry = frames_[frame_id];
+  if (!entry.tracked_) {
+    entry.tracked_ = true;
+    entry.evictable_ = true;
     curr_size_++;
+    Enqueue(frame_id);
   }
-  iter_map->second.hit_count_++;
-  if (iter_map->second.hit_count_ < k_) {
-    auto iter_fifo = std::find(fifo_.begin(), fifo_.end(), frame_id);
-    if (iter_fifo == fifo_.end()) {
-      fifo_.push_back(frame_id);
-    }
-  } else if (iter_map->second.hit_count_ == k_) {
-    fifo_.remove(frame_id);
-    lru_.push_back(frame_id);
+  auto *ring = &history_[frame_id * k_];
+  if (entry.history_size_ < k_) {
+    ring[(entry.history_head_ + entry.history_size_) % k_] = current_timestamp_++;
+    entry.history_size_++;
   } else {
-    iter_map->second.hit_count_ = k_;
-    auto iter_lru = std::find(lru_.begin(), lru_.end(), frame_id);
-    if (iter_lru != fifo_.end()) {
-      lru_.erase(iter_lru);
-    }
-    lru_.push_back(frame_id);
+    // Overwrite the oldest timestamp; the next one becomes the k-th most recent access.
+    ring[entry.history_head_] = current_timestamp_++;
+    entry.history_head_ = (entry.history_head_ + 1) % k_;
   }
 }
 
 void LRUKReplacer::SetEvictable(frame_id_t frame_id, bool set_evictable) {
   std::scoped_lock<std::mutex> lock(latch_);
-  if (frame_info_.find(frame_id) != frame_info_.end()) {
-    if (frame_info_[frame_id].set_evictable_ && !set_evictable) {
-      curr_size_--;
-    } else if (!frame_info_[frame_id].set_evictable_ && set_evictable) {
-      curr_size_++;
-    }
-    frame_info_[frame_id].set_evictable_ = set_evictable;
+  BUSTUB_ASSERT(frame_id >= 0 && static_cast<size_t>(frame_id) < replacer_size_, "invalid frame id");
+  auto &entry = frames_[frame_id];
+  if (!entry.tracked_ || entry.evictable_ == set_evictable) {
+    return;
+  }
+  entry.evictable_ = set_evictable;
+  if (set_evictable) {
+    curr_size_++;
+    Enqueue(frame_id);
+  } else {
+    curr_size_--;
   }
 }
 
 void LRUKReplacer::Remove(frame_id_t frame_id) {
   std::scoped_lock<std::mutex> lock(latch_);
-  auto iter_map = frame_info_.find(frame_id);
-  if (iter_map == frame_info_.end()) {
+  BUSTUB_ASSERT(frame_id >= 0 && static_cast<size_t>(frame_id) < replacer_size_, "invalid frame id");
+  auto &entry = frames_[frame_id];
+  if (!entry.tracked_ || !entry.evictable_) {
     return;
   }
-  if (iter_map->second.set_evictable_) {
-    if (iter_map->second.hit_count_ < k_) {
-      fifo_.remove(frame_id);
-    } else {
-      lru_.remove(frame_id);
+  // A queued entry stays in the heap and is dropped by Evict() once it sees the frame is untracked.
+  bool queued = entry.queued_;
+  entry = FrameEntry{};
+  entry.queued_ = queued;
+  curr_size_--;
+}
+
+void LRUKReplacer::Resize(size_t num_frames) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  // the dropped frames were removed, but may still have stale entries in the heap
+  std::vector<HeapEntry> entries;
+  while (!heap_.empty()) {
+    if (static_cast<size_t>(heap_.top().second) < num_frames) {
+      entries.push_back(heap_.top());
+    }
+    heap_.pop();
+  }
+  heap_ = decltype(heap_)(std::greater<>(), std::move(entries));
+  pending_.erase(std::remove_if(pending_.begin(), pending_.end(),
+                                [&](frame_id_t fid) { return static_cast<size_t>(fid) >= num_frames; }),
+                 pending_.end());
+  replacer_size_ = num_frames;
+  frames_.resize(num_frames);
+  history_.resize(num_frames * k_);
+}
+
+auto LRUKReplacer::GetPriorityOrder() -> std::vector<frame_id_t> {
+  std::scoped_lock<std::mutex> lock(latch_);
+  std::vector<HeapEntry> entries;
+  for (size_t fid = 0; fid < replacer_size_; fid++) {
+    if (frames_[fid].tracked_) {
+      entries.emplace_back(EvictionKey(static_cast<frame_id_t>(fid)), static_cast<frame_id_t>(fid));
     }
-    frame_info_.erase(frame_id);
-    curr_size_--;
   }
+  // the largest key is the one Evict() would pick last
+  std::sort(entries.begin(), entries.end(), std::greater<>());
+  std::vector<frame_id_t> order;
+  order.reserve(entries.size());
+  for (const auto &entry : entries) {
+    order.push_back(entry.second);
+  }
+  return order;
 }
 
 auto LRUKReplacer::Size() -> size_t {
   std::scoped_lock<std::mutex> lock(latch_);
-  // size_t num_frames = 0;
-  // for (auto iter : frame_info_) {
-  //   if (iter.second.set_evictable_) {
-  //     num_frames++;
-  //   }
-  // }
-  // replacer_size_ = num_frames;
-  // return num_frames;
   return curr_size_;
 }
 
+auto LRUKReplacer::EvictionKey(frame_id_t frame_id) const -> size_t {
+  const auto &entry = frames_[frame_id];
+  auto oldest = history_[frame_id * k_ + entry.history_head_];
+  return entry.history_size_ < k_ ? oldest : (oldest | FULL_HISTORY_BIT);
+}
+
+void LRUKReplacer::Enqueue(frame_id_t frame_id) {
+  auto &entry = frames_[frame_id];
+  if (!entry.queued_) {
+    entry.queued_ = true;
+    pending_.push_back(frame_id);
+  }
+}
+
 }  // namespace bustub
@@ -12,18 +12,84 @@
 
 #include "buffer/lru_replacer.h"
 
+#include "common/macros.h"
+
 namespace bustub {
 
-LRUReplacer::LRUReplacer(size_t num_pages) {}
+LRUReplacer::LRUReplacer(size_t num_pages) : frames_(num_pages) {}
 
 LRUReplacer::~LRUReplacer() = default;
 
-auto LRUReplacer::Victim(frame_id_t *frame_id) -> bool { return false; }
+auto LRUReplacer::Evict(frame_id_t *frame_id) -> bool {
+  std::scoped_lock<std::mutex> lock(latch_);
+  // pinned frames are skipped; there are usually few of them at the cold end of the list
+  for (auto it = lru_list_.rbegin(); it != lru_list_.rend(); ++it) {
+    if (frames_[*it].evictable_) {
+      *frame_id = *it;
+      lru_list_.erase(std::next(it).base());
+      frames_[*frame_id] = FrameEntry{};
+      curr_size_--;
+      return true;
+    }
+  }
+  return false;
+}
+
+void LRUReplacer::RecordAccess(frame_id_t frame_id, page_id_t page_id) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  BUSTUB_ASSERT(frame_id >= 0 && static_cast<size_t>(frame_id) < frames_.size(), "invalid frame id");
+  auto &entry = frames_[frame_id];
+  if (entry.tracked_) {
+    lru_list_.erase(entry.pos_);
+  } else {
+    entry.tracked_ = true;
+    entry.evictable_ = true;
+    curr_size_++;
+  }
+  lru_list_.push_front(frame_id);
+  entry.pos_ = lru_list_.begin();
+}
+
+void LRUReplacer::SetEvictable(frame_id_t frame_id, bool set_evictable) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  BUSTUB_ASSERT(frame_id >= 0 && static_cast<size_t>(frame_id) < frames_.size(), "invalid frame id");
+  auto &entry = frames_[frame_id];
+  if (!entry.tracked_ || entry.evictable_ == set_evictable) {
+    return;
+  }
+  entry.evictable_ = set_evictable;
+  if (set_evictable) {
+    curr_size_++;
+  } else {
+    curr_size_--;
+  }
+}
+
+void LRUReplacer::Remove(frame_id_t frame_id) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  BUSTUB_ASSERT(frame_id >= 0 && static_cast<size_t>(frame_id) < frames_.size(), "invalid frame id");
+  auto &entry = frames_[frame_id];
+  if (!entry.tracked_ || !entry.evictable_) {
+    return;
+  }
+  lru_list_.erase(entry.pos_);
+  entry = FrameEntry{};
+  curr_size_--;
+}
 
-void LRUReplacer::Pin(frame_id_t frame_id) {}
+void LRUReplacer::Resize(size_t num_frames) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  frames_.resize(num_frames);
+}
 
-void LRUReplacer::Unpin(frame_id_t frame_id) {}
+auto LRUReplacer::GetPriorityOrder() -> std::vector<frame_id_t> {
+  std::scoped_lock<std::mutex> lock(latch_);
+  return {lru_list_.begin(), lru_list_.end()};
+}
 
-auto LRUReplacer::Size() -> size_t { return 0; }
+auto LRUReplacer::Size() -> size_t {
+  std::scoped_lock<std::mutex> lock(latch_);
+  return curr_size_;
+}
 
 }  // namespace bustub
@@ -0,0 +1,240 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// parallel_buffer_pool_manager.cpp
+//
+// Identification: src/buffer/parallel_buffer_pool_manager.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/parallel_buffer_pool_manager.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "common/macros.h"
+
+namespace bustub {
+
+ParallelBufferPoolManager::ParallelBufferPoolManager(size_t num_instances, size_t pool_size, DiskManager *disk_manager,
+                                                     size_t replacer_k, LogManager *log_manager,
+                                                     PageAllocator *page_allocator, ReplacerType replacer_type)
+    : disk_manager_(disk_manager), page_allocator_(page_allocator) {
+  BUSTUB_ASSERT(num_instances > 0, "a parallel BPM needs at least one instance");
+  instances_.reserve(num_instances);
+  for (size_t i = 0; i < num_instances; i++) {
+    instances_.emplace_back(std::make_unique<BufferPoolManagerInstance>(
+        pool_size, static_cast<uint32_t>(num_instances), static_cast<uint32_t>(i), disk_manager, replacer_k,
+        log_manager, page_allocator, replacer_type));
+  }
+}
+
+ParallelBufferPoolManager::~ParallelBufferPoolManager() = default;
+
+auto ParallelBufferPoolManager::GetPoolSize() -> size_t {
+  size_t pool_size = 0;
+  for (auto &instance : instances_) {
+    pool_size += instance->GetPoolSize();
+  }
+  return pool_size;
+}
+
+auto ParallelBufferPoolManager::Resize(size_t pool_size) -> bool {
+  BUSTUB_ASSERT(pool_size >= instances_.size(), "every instance needs at least one frame");
+  bool resized = true;
+  for (size_t i = 0; i < instances_.size(); i++) {
+    const size_t instance_size = pool_size / instances_.size() + (i < pool_size % instances_.size() ? 1 : 0);
+    resized = instances_[i]->Resize(instance_size) && resized;
+  }
+  return resized;
+}
+
+void ParallelBufferPoolManager::PrefetchPages(page_id_t start_page_id, size_t num_pages) {
+  for (auto &instance : instances_) {
+    instance->PrefetchPages(start_page_id, num_pages);
+  }
+}
+
+auto ParallelBufferPoolManager::LoadPages(const std::vector<page_id_t> &page_ids) -> size_t {
+  std::vector<std::vector<std::pair<page_id_t, frame_id_t>>> frames;
+  page_id_t first_page_id = INVALID_PAGE_ID;
+  page_id_t last_page_id = INVALID_PAGE_ID;
+  for (auto &instance : instances_) {
+    frames.push_back(instance->BeginLoad(page_ids));
+    if (!frames.back().empty()) {
+      const page_id_t first = frames.back().front().first;
+      const page_id_t last = frames.back().back().first;
+      first_page_id = first_page_id == INVALID_PAGE_ID ? first : std::min(first_page_id, first);
+      last_page_id = std::max(last_page_id, last);
+    }
+  }
+  if (first_page_id == INVALID_PAGE_ID) {
+    return 0;
+  }
+  std::vector<char> data(static_cast<size_t>(last_page_id - first_page_id + 1) * BUSTUB_PAGE_SIZE);
+  disk_manager_->ReadPages(first_page_id, data.size() / BUSTUB_PAGE_SIZE, data.data());
+  size_t num_loaded = 0;
+  for (size_t i = 0; i < instances_.size(); i++) {
+    instances_[i]->FinishLoad(frames[i], first_page_id, data.data());
+    num_loaded += frames[i].size();
+  }
+  return num_loaded;
+}
+
+auto ParallelBufferPoolManager::GetResidentPages() -> std::vector<page_id_t> {
+  std::vector<std::vector<page_id_t>> page_ids;
+  size_t longest = 0;
+  for (auto &instance : instances_) {
+    page_ids.push_back(instance->GetResidentPages());
+    longest = std::max(longest, page_ids.back().size());
+  }
+  // every instance has its own replacer, the i-th hottest pages of the instances are about as hot as each other
+  std::vector<page_id_t> merged;
+  for (size_t i = 0; i < longest; i++) {
+    for (const auto &instance_page_ids : page_ids) {
+      if (i < instance_page_ids.size()) {
+        merged.push_back(instance_page_ids[i]);
+      }
+    }
+  }
+  return merged;
+}
+
+void ParallelBufferPoolManager::StartBackgroundFlusher() {
+  for (auto &instance : instances_) {
+    instance->StartBackgroundFlusher();
+  }
+}
+
+void ParallelBufferPoolManager::StopBackgroundFlusher() {
+  for (auto &instance : instances_) {
+    instance->StopBackgroundFlusher();
+  }
+}
+
+auto ParallelBufferPoolManager::GetForegroundWriteCount() const -> size_t {
+  size_t count = 0;
+  for (const auto &instance : instances_) {
+    count += instance->GetForegroundWriteCount();
+  }
+  return count;
+}
+
+auto ParallelBufferPoolManager::GetBackgroundWriteCount() const -> size_t {
+  size_t count = 0;
+  for (const auto &instance : instances_) {
+    count += instance->GetBackgroundWriteCount();
+  }
+  return count;
+}
+
+auto ParallelBufferPoolManager::GetStats() -> BufferPoolStatsSnapshot {
+  BufferPoolStatsSnapshot snapshot;
+  for (auto &instance : instances_) {
+    snapshot += instance->GetStats();
+  }
+  return snapshot;
+}
+
+void ParallelBufferPoolManager::SetAccessTrace(AccessTrace *trace) {
+  for (auto &instance : instances_) {
+    instance->SetAccessTrace(trace);
+  }
+}
+
+void ParallelBufferPoolManager::SetCompressedPageCache(CompressedPageCache *cache) {
+  for (auto &instance : instances_) {
+    instance->SetCompressedPageCache(cache);
+  }
+}
+
+void ParallelBufferPoolManager::SetDiskScheduler(DiskScheduler *scheduler) {
+  for (auto &instance : instances_) {
+    instance->SetDiskScheduler(scheduler);
+  }
+}
+
+auto ParallelBufferPoolManager::GetBufferPoolManager(page_id_t page_id) -> BufferPoolManagerInstance * {
+  return instances_[static_cast<size_t>(page_id) % instances_.size()].get();
+}
+
+auto ParallelBufferPoolManager::FetchPgImp(page_id_t page_id) -> Page * {
+  return GetBufferPoolManager(page_id)->FetchPage(page_id);
+}
+
+auto ParallelBufferPoolManager::FetchPgStrategyImp(page_id_t page_id, BufferAccessStrategy *strategy) -> Page * {
+  return GetBufferPoolManager(page_id)->FetchPageWithStrategy(page_id, strategy);
+}
+
+auto ParallelBufferPoolManager::FetchPgReadOnlyImp(page_id_t page_id, BufferAccessStrategy *strategy) -> Page * {
+  return GetBufferPoolManager(page_id)->FetchPageReadOnly(page_id, strategy);
+}
+
+auto ParallelBufferPoolManager::UnpinPgImp(page_id_t page_id, bool is_dirty) -> bool {
+  return GetBufferPoolManager(page_id)->UnpinPage(page_id, is_dirty);
+}
+
+auto ParallelBufferPoolManager::FlushPgImp(page_id_t page_id) -> bool {
+  return GetBufferPoolManager(page_id)->FlushPage(page_id);
+}
+
+auto ParallelBufferPoolManager::NewPgImp(page_id_t *page_id) -> Page * { return NewPgStrategyImp(page_id, nullptr); }
+
+auto ParallelBufferPoolManager::NewPgStrategyImp(page_id_t *page_id, BufferAccessStrategy *strategy) -> Page * {
+  // Only the starting point is shared between threads; each call then probes every instance at most once.
+  size_t start = next_instance_.fetch_add(1) % instances_.size();
+  for (size_t i = 0; i < instances_.size(); i++) {
+    auto *page = instances_[(start + i) % instances_.size()]->NewPageWithStrategy(page_id, strategy);
+    if (page != nullptr) {
+      return page;
+    }
+  }
+  return nullptr;
+}
+
+auto ParallelBufferPoolManager::NewPgSegmentImp(page_id_t *page_id, PageSegment *segment,
+                                                BufferAccessStrategy *strategy) -> Page * {
+  *page_id = segment->AllocatePage([&] { return AllocateExtent(); });
+  auto *page = GetBufferPoolManager(*page_id)->NewAllocatedPage(*page_id, strategy);
+  if (page == nullptr && page_allocator_ != nullptr) {
+    // the page is left out of the extent
+    page_allocator_->DeallocatePage(*page_id);
+  }
+  return page;
+}
+
+auto ParallelBufferPoolManager::AllocateExtent() -> page_id_t {
+  if (page_allocator_ != nullptr) {
+    return page_allocator_->AllocateExtent();
+  }
+  std::scoped_lock<std::mutex> lock(extent_latch_);
+  const auto num_instances = static_cast<page_id_t>(instances_.size());
+  page_id_t first_page_id = 0;
+  while (true) {
+    // every instance skips the extent; it is free if none of them had allocated a page in it already
+    page_id_t first_free_page_id = first_page_id;
+    for (auto &instance : instances_) {
+      const page_id_t next_page_id = instance->ReservePageIds(first_page_id + EXTENT_SIZE);
+      first_free_page_id = std::max(first_free_page_id, next_page_id - num_instances + 1);
+    }
+    if (first_free_page_id == first_page_id) {
+      return first_page_id;
+    }
+    first_page_id = first_free_page_id;
+  }
+}
+
+auto ParallelBufferPoolManager::DeletePgImp(page_id_t page_id) -> bool {
+  return GetBufferPoolManager(page_id)->DeletePage(page_id);
+}
+
+void ParallelBufferPoolManager::FlushAllPgsImp() {
+  for (auto &instance : instances_) {
+    instance->FlushAllPages();
+  }
+}
+
+}  // namespace bustub
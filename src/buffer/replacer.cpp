@@ -0,0 +1,40 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// replacer.cpp
+//
+// Identification: src/buffer/replacer.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/replacer.h"
+
+#include "buffer/arc_replacer.h"
+#include "buffer/clock_replacer.h"
+#include "buffer/lru_k_replacer.h"
+#include "buffer/lru_replacer.h"
+#include "buffer/two_queue_replacer.h"
+#include "common/exception.h"
+
+namespace bustub {
+
+auto Replacer::Create(ReplacerType type, size_t num_frames, size_t k) -> std::unique_ptr<Replacer> {
+  switch (type) {
+    case ReplacerType::LRU:
+      return std::make_unique<LRUReplacer>(num_frames);
+    case ReplacerType::CLOCK:
+      return std::make_unique<ClockReplacer>(num_frames);
+    case ReplacerType::LRU_K:
+      return std::make_unique<LRUKReplacer>(num_frames, k);
+    case ReplacerType::ARC:
+      return std::make_unique<ARCReplacer>(num_frames);
+    case ReplacerType::TWO_Q:
+      return std::make_unique<TwoQueueReplacer>(num_frames);
+  }
+  throw Exception(ExceptionType::INVALID, "unknown replacer type");
+}
+
+}  // namespace bustub
@@ -0,0 +1,134 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// two_queue_replacer.cpp
+//
+// Identification: src/buffer/two_queue_replacer.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/two_queue_replacer.h"
+
+#include <algorithm>
+
+namespace bustub {
+
+TwoQueueReplacer::TwoQueueReplacer(size_t num_frames)
+    : kin_(std::max<size_t>(1, num_frames / 4)), kout_(std::max<size_t>(1, num_frames / 2)), frames_(num_frames) {}
+
+auto TwoQueueReplacer::Evict(frame_id_t *frame_id) -> bool {
+  std::scoped_lock<std::mutex> lock(latch_);
+  // trim A1in while it is over Kin, fall back to the other list if all the frames of the preferred one are pinned
+  const bool prefer_a1in = a1in_.size() > kin_ || am_.empty();
+  return prefer_a1in ? EvictFrom(&a1in_, frame_id) || EvictFrom(&am_, frame_id)
+                     : EvictFrom(&am_, frame_id) || EvictFrom(&a1in_, frame_id);
+}
+
+auto TwoQueueReplacer::EvictFrom(std::list<frame_id_t> *list, frame_id_t *frame_id) -> bool {
+  for (auto it = list->rbegin(); it != list->rend(); ++it) {
+    auto &entry = frames_[*it];
+    if (!entry.evictable_) {
+      continue;
+    }
+    if (entry.list_ == ListId::A1IN) {
+      // remember the page, so that a quick return promotes it to Am
+      a1out_.push_front(entry.page_id_);
+      a1out_index_[entry.page_id_] = a1out_.begin();
+      if (a1out_.size() > kout_) {
+        a1out_index_.erase(a1out_.back());
+        a1out_.pop_back();
+      }
+    }
+    *frame_id = *it;
+    list->erase(std::next(it).base());
+    entry = FrameEntry{};
+    curr_size_--;
+    return true;
+  }
+  return false;
+}
+
+void TwoQueueReplacer::RecordAccess(frame_id_t frame_id, page_id_t page_id) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  BUSTUB_ASSERT(frame_id >= 0 && static_cast<size_t>(frame_id) < frames_.size(), "invalid frame id");
+  auto &entry = frames_[frame_id];
+  if (entry.list_ == ListId::A1IN) {
+    // correlated reference, the page keeps its place in the FIFO
+    return;
+  }
+  if (entry.list_ == ListId::AM) {
+    am_.erase(entry.pos_);
+  } else {
+    entry.evictable_ = true;
+    entry.page_id_ = page_id;
+    curr_size_++;
+    auto it = a1out_index_.find(page_id);
+    if (it == a1out_index_.end()) {
+      entry.list_ = ListId::A1IN;
+      a1in_.push_front(frame_id);
+      entry.pos_ = a1in_.begin();
+      return;
+    }
+    a1out_.erase(it->second);
+    a1out_index_.erase(it);
+  }
+  entry.list_ = ListId::AM;
+  am_.push_front(frame_id);
+  entry.pos_ = am_.begin();
+}
+
+void TwoQueueReplacer::SetEvictable(frame_id_t frame_id, bool set_evictable) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  BUSTUB_ASSERT(frame_id >= 0 && static_cast<size_t>(frame_id) < frames_.size(), "invalid frame id");
+  auto &entry = frames_[frame_id];
+  if (entry.list_ == ListId::NONE || entry.evictable_ == set_evictable) {
+    return;
+  }
+  entry.evictable_ = set_evictable;
+  if (set_evictable) {
+    curr_size_++;
+  } else {
+    curr_size_--;
+  }
+}
+
+void TwoQueueReplacer::Remove(frame_id_t frame_id) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  BUSTUB_ASSERT(frame_id >= 0 && static_cast<size_t>(frame_id) < frames_.size(), "invalid frame id");
+  auto &entry = frames_[frame_id];
+  if (entry.list_ == ListId::NONE || !entry.evictable_) {
+    return;
+  }
+  (entry.list_ == ListId::A1IN ? a1in_ : am_).erase(entry.pos_);
+  entry = FrameEntry{};
+  curr_size_--;
+}
+
+void TwoQueueReplacer::Resize(size_t num_frames) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  kin_ = std::max<size_t>(1, num_frames / 4);
+  kout_ = std::max<size_t>(1, num_frames / 2);
+  frames_.resize(num_frames);
+  while (a1out_.size() > kout_) {
+    a1out_index_.erase(a1out_.back());
+    a1out_.pop_back();
+  }
+}
+
+auto TwoQueueReplacer::GetPriorityOrder() -> std::vector<frame_id_t> {
+  std::scoped_lock<std::mutex> lock(latch_);
+  // the hot pages of Am first, then A1in from its newest frame
+  std::vector<frame_id_t> order(am_.begin(), am_.end());
+  order.insert(order.end(), a1in_.begin(), a1in_.end());
+  return order;
+}
+
+auto TwoQueueReplacer::Size() -> size_t {
+  std::scoped_lock<std::mutex> lock(latch_);
+  return curr_size_;
+}
+
+}  // namespace bustub
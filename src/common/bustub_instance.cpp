@@ -9,6 +9,8 @@
 #include "binder/statement/index_statement.h"
 #include "binder/statement/select_statement.h"
 #include "buffer/buffer_pool_manager_instance.h"
+#include "buffer/buffer_pool_warmer.h"
+#include "buffer/compressed_page_cache.h"
 #include "catalog/schema.h"
 #include "catalog/table_generator.h"
 #include "common/bustub_instance.h"
@@ -29,6 +31,8 @@
 #include "recovery/log_manager.h"
 #include "storage/disk/disk_manager.h"
 #include "storage/disk/disk_manager_memory.h"
+#include "storage/disk/disk_scheduler.h"
+#include "storage/disk/page_allocator.h"
 #include "type/value_factory.h"
 
 namespace bustub {
@@ -44,6 +48,7 @@ BustubInstance::BustubInstance(const std::string &db_file_name) {
 
   // Storage related.
   disk_manager_ = new DiskManager(db_file_name);
+  page_allocator_ = new PageAllocator(disk_manager_);
 
   // Log related.
   log_manager_ = new LogManager(disk_manager_);
@@ -51,11 +56,26 @@ BustubInstance::BustubInstance(const std::string &db_file_name) {
   // We need more frames for GenerateTestTable to work. Therefore, we use 128 instead of the default
   // buffer pool size specified in `config.h`.
   try {
-    buffer_pool_manager_ = new BufferPoolManagerInstance(128, disk_manager_, LRUK_REPLACER_K, log_manager_);
+    buffer_pool_manager_ =
+        new BufferPoolManagerInstance(128, disk_manager_, LRUK_REPLACER_K, log_manager_, page_allocator_);
   } catch (NotImplementedException &e) {
     std::cerr << "BufferPoolManager is not implemented, only mock tables are supported." << std::endl;
     buffer_pool_manager_ = nullptr;
   }
+  if (buffer_pool_manager_ != nullptr && compressed_page_cache_size > 0) {
+    compressed_page_cache_ = new CompressedPageCache(compressed_page_cache_size);
+    buffer_pool_manager_->SetCompressedPageCache(compressed_page_cache_);
+  }
+  if (buffer_pool_manager_ != nullptr && enable_async_disk_io) {
+    disk_scheduler_ = new DiskScheduler(disk_manager_);
+    buffer_pool_manager_->SetDiskScheduler(disk_scheduler_);
+  }
+  if (buffer_pool_manager_ != nullptr) {
+    // bring back the pages that were hot at the last shutdown, the database is usable meanwhile
+    buffer_pool_warmer_ = new BufferPoolWarmer(buffer_pool_manager_, db_file_name + ".warmup");
+    buffer_pool_warmer_->StartWarmUp();
+    buffer_pool_warmer_->StartPeriodicDump(buffer_pool_dump_interval);
+  }
 
   // Transaction (txn) related.
   lock_manager_ = new LockManager();
@@ -112,6 +132,67 @@ void BustubInstance::CmdDisplayIndices(ResultWriter &writer) {
   writer.EndTable();
 }
 
+void BustubInstance::CmdDisplayStats(ResultWriter &writer) {
+  if (buffer_pool_manager_ == nullptr) {
+    throw Exception("buffer pool manager is not available");
+  }
+  writer.BeginTable(false);
+  writer.BeginHeader();
+  writer.WriteHeaderCell("counter");
+  writer.WriteHeaderCell("value");
+  writer.EndHeader();
+  for (const auto &[name, value] : BufferPoolStats::ToRows(buffer_pool_manager_->GetStats())) {
+    writer.BeginRow();
+    writer.WriteCell(name);
+    writer.WriteCell(value);
+    writer.EndRow();
+  }
+  if (compressed_page_cache_ != nullptr) {
+    for (const auto &[name, value] : CompressedPageCache::ToRows(compressed_page_cache_->GetStats())) {
+      writer.BeginRow();
+      writer.WriteCell(name);
+      writer.WriteCell(value);
+      writer.EndRow();
+    }
+  }
+  writer.EndTable();
+}
+
+void BustubInstance::CmdResize(const std::string &args, ResultWriter &writer) {
+  if (buffer_pool_manager_ == nullptr) {
+    throw Exception("buffer pool manager is not available");
+  }
+  size_t pool_size = 0;
+  try {
+    pool_size = std::stoul(args);
+  } catch (const std::logic_error &) {
+    throw Exception(fmt::format("invalid number of frames: {}", args));
+  }
+  if (pool_size == 0) {
+    throw Exception("the buffer pool needs at least one frame");
+  }
+  if (!buffer_pool_manager_->Resize(pool_size)) {
+    throw Exception("cannot resize the buffer pool now, some of the frames to drop are pinned");
+  }
+  WriteOneCell(fmt::format("Buffer pool resized to {} frames", buffer_pool_manager_->GetPoolSize()), writer);
+}
+
+void BustubInstance::CmdTrace(const std::string &args, ResultWriter &writer) {
+  if (buffer_pool_manager_ == nullptr) {
+    throw Exception("buffer pool manager is not available");
+  }
+  buffer_pool_manager_->SetAccessTrace(nullptr);
+  delete access_trace_;
+  access_trace_ = nullptr;
+  if (args == "off") {
+    WriteOneCell("Stopped recording page accesses", writer);
+    return;
+  }
+  access_trace_ = new AccessTrace(args);
+  buffer_pool_manager_->SetAccessTrace(access_trace_);
+  WriteOneCell(fmt::format("Recording page accesses to {}", args), writer);
+}
+
 void BustubInstance::WriteOneCell(const std::string &cell, ResultWriter &writer) {
   writer.BeginTable(true);
   writer.BeginRow();
@@ -125,6 +206,10 @@ void BustubInstance::CmdDisplayHelp(ResultWriter &writer) {
 
 \\dt: show all tables
 \\di: show all indices
+\\stats: show buffer pool statistics
+\\trace <file>: record the pages accessed by the buffer pool into a file, see bustub-replacer-bench
+\\trace off: stop recording
+\\resize <frames>: grow or shrink the buffer pool
 \\help: show this message again
 
 BusTub shell currently only supports a small set of Postgres queries. We'll set
@@ -149,6 +234,18 @@ void BustubInstance::ExecuteSql(const std::string &sql, ResultWriter &writer) {
       CmdDisplayIndices(writer);
       return;
     }
+    if (sql == "\\stats") {
+      CmdDisplayStats(writer);
+      return;
+    }
+    if (StringUtil::StartsWith(sql, "\\resize ")) {
+      CmdResize(sql.substr(std::string("\\resize ").size()), writer);
+      return;
+    }
+    if (StringUtil::StartsWith(sql, "\\trace ")) {
+      CmdTrace(sql.substr(std::string("\\trace ").size()), writer);
+      return;
+    }
     if (sql == "\\help") {
       CmdDisplayHelp(writer);
       return;
@@ -317,15 +414,36 @@ void BustubInstance::GenerateMockTable() {
   delete txn;
 }
 
+void BustubInstance::WaitForWarmUp() {
+  if (buffer_pool_warmer_ != nullptr) {
+    buffer_pool_warmer_->WaitForWarmUp();
+  }
+}
+
 BustubInstance::~BustubInstance() {
   if (enable_logging) {
     log_manager_->StopFlushThread();
   }
+  if (buffer_pool_warmer_ != nullptr) {
+    buffer_pool_warmer_->StopPeriodicDump();
+    buffer_pool_warmer_->StopWarmUp();
+    buffer_pool_warmer_->Dump();
+    delete buffer_pool_warmer_;
+  }
+  if (buffer_pool_manager_ != nullptr) {
+    buffer_pool_manager_->SetAccessTrace(nullptr);
+    buffer_pool_manager_->SetCompressedPageCache(nullptr);
+    buffer_pool_manager_->SetDiskScheduler(nullptr);
+  }
+  delete disk_scheduler_;
+  delete compressed_page_cache_;
+  delete access_trace_;
   delete execution_engine_;
   delete catalog_;
   delete checkpoint_manager_;
   delete log_manager_;
   delete buffer_pool_manager_;
+  delete page_allocator_;
   delete lock_manager_;
   delete transaction_manager_;
   delete disk_manager_;
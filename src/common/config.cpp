@@ -20,4 +20,18 @@ std::chrono::duration<int64_t> log_timeout = std::chrono::seconds(1);
 
 std::chrono::milliseconds cycle_detection_interval = std::chrono::milliseconds(50);
 
+std::chrono::milliseconds bg_flush_interval = std::chrono::milliseconds(100);
+
+std::atomic<bool> enable_huge_pages(false);
+
+std::chrono::milliseconds buffer_pool_resize_timeout = std::chrono::milliseconds(1000);
+
+std::chrono::milliseconds buffer_pool_dump_interval = std::chrono::seconds(60);
+
+size_t compressed_page_cache_size = 0;
+
+std::atomic<bool> enable_async_disk_io(false);
+
+size_t index_build_sort_memory = 64 << 20;
+
 }  // namespace bustub
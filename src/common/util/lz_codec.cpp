@@ -0,0 +1,179 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// lz_codec.cpp
+//
+// Identification: src/common/util/lz_codec.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "common/util/lz_codec.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+
+namespace bustub {
+
+namespace {
+
+constexpr size_t HASH_BITS = 12;
+constexpr size_t MAX_OFFSET = 65535;
+constexpr size_t NIBBLE_MAX = 15;
+
+inline auto Read32(const unsigned char *p) -> uint32_t {
+  uint32_t value;
+  std::memcpy(&value, p, sizeof(value));
+  return value;
+}
+
+inline auto Hash(uint32_t sequence) -> size_t { return (sequence * 2654435761U) >> (32 - HASH_BITS); }
+
+/** Write the extra bytes of a length that did not fit in its nibble. */
+auto WriteLength(size_t length, unsigned char **out, const unsigned char *end) -> bool {
+  for (; length >= 255; length -= 255) {
+    if (*out == end) {
+      return false;
+    }
+    *(*out)++ = 255;
+  }
+  if (*out == end) {
+    return false;
+  }
+  *(*out)++ = static_cast<unsigned char>(length);
+  return true;
+}
+
+/** Add the extra bytes of a length to it. */
+auto ReadLength(const unsigned char **in, const unsigned char *end, size_t *length) -> bool {
+  unsigned char byte;
+  do {
+    if (*in == end) {
+      return false;
+    }
+    byte = *(*in)++;
+    *length += byte;
+  } while (byte == 255);
+  return true;
+}
+
+/** Write a sequence; a match length of 0 makes it the last one. */
+auto WriteSequence(const unsigned char *literals, size_t num_literals, size_t offset, size_t match_length,
+                   unsigned char **out, const unsigned char *end) -> bool {
+  if (*out == end) {
+    return false;
+  }
+  unsigned char *token = (*out)++;
+  const size_t extra_match_length = match_length == 0 ? 0 : match_length - LZCodec::MIN_MATCH;
+  *token =
+      static_cast<unsigned char>(std::min(num_literals, NIBBLE_MAX) << 4 | std::min(extra_match_length, NIBBLE_MAX));
+  if (num_literals >= NIBBLE_MAX && !WriteLength(num_literals - NIBBLE_MAX, out, end)) {
+    return false;
+  }
+  if (static_cast<size_t>(end - *out) < num_literals) {
+    return false;
+  }
+  std::memcpy(*out, literals, num_literals);
+  *out += num_literals;
+  if (match_length == 0) {
+    return true;
+  }
+  if (end - *out < 2) {
+    return false;
+  }
+  *(*out)++ = static_cast<unsigned char>(offset & 0xff);
+  *(*out)++ = static_cast<unsigned char>(offset >> 8);
+  return extra_match_length < NIBBLE_MAX || WriteLength(extra_match_length - NIBBLE_MAX, out, end);
+}
+
+}  // namespace
+
+auto LZCodec::Compress(const char *src, size_t size, char *dst, size_t capacity) -> size_t {
+  const auto *in = reinterpret_cast<const unsigned char *>(src);
+  auto *out = reinterpret_cast<unsigned char *>(dst);
+  const auto *out_end = out + capacity;
+  // the last position of every hashed 4-byte sequence; a stale or colliding entry is caught by comparing the bytes
+  std::array<uint32_t, 1 << HASH_BITS> table{};
+  size_t anchor = 0;
+  size_t pos = 0;
+  while (pos + MIN_MATCH <= size) {
+    const uint32_t sequence = Read32(in + pos);
+    const size_t hash = Hash(sequence);
+    const size_t candidate = table[hash];
+    table[hash] = static_cast<uint32_t>(pos);
+    if (candidate < pos && pos - candidate <= MAX_OFFSET && Read32(in + candidate) == sequence) {
+      size_t length = MIN_MATCH;
+      while (pos + length < size && in[candidate + length] == in[pos + length]) {
+        length++;
+      }
+      if (!WriteSequence(in + anchor, pos - anchor, pos - candidate, length, &out, out_end)) {
+        return 0;
+      }
+      pos += length;
+      anchor = pos;
+      continue;
+    }
+    // skip faster through data that does not compress
+    pos += 1 + ((pos - anchor) >> 6);
+  }
+  if (!WriteSequence(in + anchor, size - anchor, 0, 0, &out, out_end)) {
+    return 0;
+  }
+  return out - reinterpret_cast<unsigned char *>(dst);
+}
+
+auto LZCodec::Decompress(const char *src, size_t size, char *dst, size_t capacity) -> size_t {
+  const auto *in = reinterpret_cast<const unsigned char *>(src);
+  const auto *in_end = in + size;
+  auto *out_begin = reinterpret_cast<unsigned char *>(dst);
+  auto *out = out_begin;
+  const auto *out_end = out + capacity;
+  while (in < in_end) {
+    const unsigned char token = *in++;
+    size_t num_literals = token >> 4;
+    if (num_literals == NIBBLE_MAX && !ReadLength(&in, in_end, &num_literals)) {
+      return 0;
+    }
+    if (static_cast<size_t>(in_end - in) < num_literals || static_cast<size_t>(out_end - out) < num_literals) {
+      return 0;
+    }
+    std::memcpy(out, in, num_literals);
+    in += num_literals;
+    out += num_literals;
+    if (in == in_end) {
+      // the last sequence has no match
+      break;
+    }
+    if (in_end - in < 2) {
+      return 0;
+    }
+    const size_t offset = in[0] | static_cast<size_t>(in[1]) << 8;
+    in += 2;
+    size_t match_length = token & NIBBLE_MAX;
+    if (match_length == NIBBLE_MAX && !ReadLength(&in, in_end, &match_length)) {
+      return 0;
+    }
+    match_length += MIN_MATCH;
+    if (offset == 0 || offset > static_cast<size_t>(out - out_begin) ||
+        static_cast<size_t>(out_end - out) < match_length) {
+      return 0;
+    }
+    const unsigned char *match = out - offset;
+    if (offset >= match_length) {
+      std::memcpy(out, match, match_length);
+      out += match_length;
+    } else {
+      // the match overlaps the bytes it produces, e.g. a run of a single byte
+      for (size_t i = 0; i < match_length; i++) {
+        *out++ = *match++;
+      }
+    }
+  }
+  return out - out_begin;
+}
+
+}  // namespace bustub
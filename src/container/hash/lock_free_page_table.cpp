@@ -0,0 +1,173 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// lock_free_page_table.cpp
+//
+// Identification: src/container/hash/lock_free_page_table.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "container/hash/lock_free_page_table.h"
+
+#include <new>
+
+namespace bustub {
+
+LockFreePageTable::LockFreePageTable(size_t num_frames) : table_(NewTable(num_frames)) {}
+
+LockFreePageTable::~LockFreePageTable() {
+  DeleteTable(table_.load());
+  for (auto *table : retired_) {
+    DeleteTable(table);
+  }
+}
+
+auto LockFreePageTable::NewTable(size_t num_frames) -> Table * {
+  auto *table = new Table;
+  size_t capacity = 8;
+  table->shift_ = 64 - 3;
+  while (capacity < 2 * num_frames) {
+    capacity <<= 1;
+    table->shift_--;
+  }
+  table->mask_ = capacity - 1;
+  table->slots_ = static_cast<std::atomic<uint64_t> *>(
+      ::operator new[](capacity * sizeof(std::atomic<uint64_t>), std::align_val_t{CACHE_LINE_SIZE}));
+  for (size_t i = 0; i < capacity; i++) {
+    new (&table->slots_[i]) std::atomic<uint64_t>(EMPTY);
+  }
+  return table;
+}
+
+void LockFreePageTable::DeleteTable(Table *table) {
+  ::operator delete[](table->slots_, std::align_val_t{CACHE_LINE_SIZE});
+  delete table;
+}
+
+auto LockFreePageTable::Table::HomeSlot(page_id_t page_id) const -> size_t {
+  // Fibonacci hashing spreads the consecutive page ids of a scan over the whole table
+  return (static_cast<uint64_t>(static_cast<uint32_t>(page_id)) * 0x9E3779B97F4A7C15ULL) >> shift_;
+}
+
+void LockFreePageTable::Resize(size_t num_frames) {
+  Table *old_table = table_.load(std::memory_order_relaxed);
+  Table *new_table = NewTable(num_frames);
+  if (new_table->mask_ == old_table->mask_) {
+    DeleteTable(new_table);
+    return;
+  }
+  // writers are serialized by the caller, so the old table cannot change while it is copied
+  for (size_t i = 0; i <= old_table->mask_; i++) {
+    const uint64_t slot = old_table->slots_[i].load(std::memory_order_relaxed);
+    if (slot == EMPTY || slot == TOMBSTONE) {
+      continue;
+    }
+    size_t j = new_table->HomeSlot(PageOf(slot));
+    while (new_table->slots_[j].load(std::memory_order_relaxed) != EMPTY) {
+      j = (j + 1) & new_table->mask_;
+    }
+    new_table->slots_[j].store(slot, std::memory_order_relaxed);
+  }
+  table_.store(new_table, std::memory_order_release);
+  retired_.push_back(old_table);
+  new_tombstones_ = 0;
+}
+
+auto LockFreePageTable::Find(page_id_t page_id, frame_id_t *frame_id) const -> bool {
+  const Table *table = table_.load(std::memory_order_acquire);
+  for (size_t i = table->HomeSlot(page_id), probes = 0; probes <= table->mask_; i = (i + 1) & table->mask_, probes++) {
+    const uint64_t slot = table->slots_[i].load(std::memory_order_acquire);
+    if (slot == EMPTY) {
+      return false;
+    }
+    if (slot != TOMBSTONE && PageOf(slot) == page_id) {
+      *frame_id = FrameOf(slot);
+      return true;
+    }
+  }
+  return false;
+}
+
+auto LockFreePageTable::Insert(page_id_t page_id, frame_id_t frame_id) -> bool {
+  BUSTUB_ASSERT(page_id != INVALID_PAGE_ID && frame_id >= 0, "invalid mapping");
+  const uint64_t mapping = Pack(page_id, frame_id);
+  Table *table = table_.load(std::memory_order_relaxed);
+  for (size_t i = table->HomeSlot(page_id), probes = 0; probes <= table->mask_; i = (i + 1) & table->mask_, probes++) {
+    uint64_t slot = table->slots_[i].load(std::memory_order_relaxed);
+    // reuse the first tombstone of the chain, so that churn does not grow probe chains
+    if ((slot == EMPTY || slot == TOMBSTONE) &&
+        table->slots_[i].compare_exchange_strong(slot, mapping, std::memory_order_release, std::memory_order_relaxed)) {
+      return true;
+    }
+    BUSTUB_ASSERT(slot == EMPTY || slot == TOMBSTONE || PageOf(slot) != page_id, "page is already in the table");
+  }
+  return false;
+}
+
+auto LockFreePageTable::Remove(page_id_t page_id) -> bool {
+  Table *table = table_.load(std::memory_order_relaxed);
+  for (size_t i = table->HomeSlot(page_id), probes = 0; probes <= table->mask_; i = (i + 1) & table->mask_, probes++) {
+    uint64_t slot = table->slots_[i].load(std::memory_order_relaxed);
+    if (slot == EMPTY) {
+      return false;
+    }
+    if (slot == TOMBSTONE || PageOf(slot) != page_id) {
+      continue;
+    }
+    // no chain goes through this slot if the next one is empty, so it can become empty again
+    const bool chain_ends = table->slots_[(i + 1) & table->mask_].load(std::memory_order_relaxed) == EMPTY;
+    if (!table->slots_[i].compare_exchange_strong(slot, chain_ends ? EMPTY : TOMBSTONE, std::memory_order_release,
+                                                  std::memory_order_relaxed)) {
+      return false;
+    }
+    if (!chain_ends && ++new_tombstones_ > table->mask_ / 4) {
+      PurgeTombstones(table);
+    } else if (chain_ends) {
+      // Nor through the tombstones right before it any more. Emptying them from the back keeps every mapping reachable
+      // from its home slot at all times, so concurrent readers never miss one.
+      for (size_t j = (i - 1) & table->mask_; j != i; j = (j - 1) & table->mask_) {
+        if (table->slots_[j].load(std::memory_order_relaxed) != TOMBSTONE) {
+          break;
+        }
+        table->slots_[j].store(EMPTY, std::memory_order_release);
+      }
+    }
+    return true;
+  }
+  return false;
+}
+
+void LockFreePageTable::PurgeTombstones(Table *table) {
+  // a tombstone must stay as long as some mapping lies further along the chain of its home slot
+  std::vector<bool> crossed(table->mask_ + 1, false);
+  for (size_t i = 0; i <= table->mask_; i++) {
+    const uint64_t slot = table->slots_[i].load(std::memory_order_relaxed);
+    if (slot == EMPTY || slot == TOMBSTONE) {
+      continue;
+    }
+    for (size_t j = table->HomeSlot(PageOf(slot)); j != i; j = (j + 1) & table->mask_) {
+      crossed[j] = true;
+    }
+  }
+  // no reader can be looking for a mapping past the others, so they can become empty in any order
+  for (size_t i = 0; i <= table->mask_; i++) {
+    if (!crossed[i] && table->slots_[i].load(std::memory_order_relaxed) == TOMBSTONE) {
+      table->slots_[i].store(EMPTY, std::memory_order_release);
+    }
+  }
+  new_tombstones_ = 0;
+}
+
+auto LockFreePageTable::GetNumTombstones() const -> size_t {
+  const Table *table = table_.load(std::memory_order_acquire);
+  size_t num_tombstones = 0;
+  for (size_t i = 0; i <= table->mask_; i++) {
+    num_tombstones += table->slots_[i].load(std::memory_order_relaxed) == TOMBSTONE ? 1 : 0;
+  }
+  return num_tombstones;
+}
+
+}  // namespace bustub
@@ -36,7 +36,8 @@ auto InsertExecutor::Next([[maybe_unused]] Tuple *tuple, RID *rid) -> bool {
     }
     cnt_=0;
     while(child_executor_->Next(tuple,rid)){
-        table_info_->table_->InsertTuple(*tuple, rid, exec_ctx_->GetTransaction());
+        table_info_->table_->InsertTuple(*tuple, rid, exec_ctx_->GetTransaction(),
+                                         exec_ctx_->GetBufferAccessStrategy());
         for(auto index_info:table_indexes_){
             auto key=tuple->KeyFromTuple(table_info_->schema_, index_info->key_schema_,index_info->index_->GetKeyAttrs());
             index_info->index_->InsertEntry(key, *rid, exec_ctx_->GetTransaction());
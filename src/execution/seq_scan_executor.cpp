@@ -20,7 +20,7 @@ SeqScanExecutor::SeqScanExecutor(ExecutorContext *exec_ctx, const SeqScanPlanNod
 
 void SeqScanExecutor::Init() { 
     // throw NotImplementedException("SeqScanExecutor is not implemented"); 
-    iter_=table_info_->table_->Begin(exec_ctx_->GetTransaction());
+    iter_=table_info_->table_->Begin(exec_ctx_->GetTransaction(), exec_ctx_->GetBufferAccessStrategy());
 }
 
 auto SeqScanExecutor::Next(Tuple *tuple, RID *rid) -> bool {
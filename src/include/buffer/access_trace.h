@@ -0,0 +1,57 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// access_trace.h
+//
+// Identification: src/include/buffer/access_trace.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <fstream>
+#include <mutex>  // NOLINT
+#include <string>
+#include <vector>
+
+#include "common/config.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+/**
+ * AccessTrace records the sequence of pages accessed through a buffer pool, one page id per line, so that the
+ * replacement policies can be compared offline on the same workload (see tools/replacer_bench).
+ */
+class AccessTrace {
+ public:
+  /**
+   * @brief Open a trace file for writing, truncating it.
+   * @param file_name the trace file
+   */
+  explicit AccessTrace(const std::string &file_name);
+
+  DISALLOW_COPY_AND_MOVE(AccessTrace);
+
+  /** @brief Flush and close the trace file. */
+  ~AccessTrace();
+
+  /** @brief Append an access to the trace. Thread-safe. */
+  void Record(page_id_t page_id);
+
+  /**
+   * @brief Read a trace file.
+   * @param file_name the trace file
+   * @return the page ids of the trace, in order
+   */
+  static auto Load(const std::string &file_name) -> std::vector<page_id_t>;
+
+ private:
+  std::mutex latch_;
+  std::ofstream out_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,114 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// arc_replacer.h
+//
+// Identification: src/include/buffer/arc_replacer.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <list>
+#include <mutex>  // NOLINT
+#include <unordered_map>
+#include <vector>
+
+#include "buffer/replacer.h"
+#include "common/config.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+/**
+ * ARCReplacer implements the Adaptive Replacement Cache policy (Megiddo and Modha, FAST 2003).
+ *
+ * Resident frames are split between T1 (pages accessed once since they entered the buffer pool) and T2 (pages
+ * accessed at least twice). The ghost lists B1 and B2 remember the ids of the pages recently evicted from T1 and T2.
+ * A page that comes back while in B1 means T1 was too small, so the target size p of T1 grows; a page that comes back
+ * while in B2 shrinks it. Evict() takes the least recently used evictable frame of T1 if T1 is larger than p, and of
+ * T2 otherwise, so that a scan only ever churns T1.
+ *
+ * The buffer pool manager evicts before it knows which page will be read, so the replacement decision cannot look at
+ * the incoming page as in the paper; the adaptation of p happens when the page is recorded instead.
+ */
+class ARCReplacer : public Replacer {
+ public:
+  /**
+   * @brief Create a new ARCReplacer.
+   * @param num_frames the number of frames of the buffer pool, which is also the size of the ghost lists
+   */
+  explicit ARCReplacer(size_t num_frames);
+
+  DISALLOW_COPY_AND_MOVE(ARCReplacer);
+
+  ~ARCReplacer() override = default;
+
+  auto Evict(frame_id_t *frame_id) -> bool override;
+
+  void RecordAccess(frame_id_t frame_id, page_id_t page_id) override;
+
+  void SetEvictable(frame_id_t frame_id, bool set_evictable) override;
+
+  void Remove(frame_id_t frame_id) override;
+
+  auto Size() -> size_t override;
+
+  void Resize(size_t num_frames) override;
+
+  auto GetPriorityOrder() -> std::vector<frame_id_t> override;
+
+  /** @return the current target size of T1, for tests */
+  auto GetTargetT1Size() -> size_t;
+
+ private:
+  enum class ListId : uint8_t { NONE, T1, T2 };
+
+  struct FrameEntry {
+    ListId list_{ListId::NONE};
+    bool evictable_{false};
+    page_id_t page_id_{INVALID_PAGE_ID};
+    /** Position of the frame in t1_ or t2_, valid if list_ is not NONE. */
+    std::list<frame_id_t>::iterator pos_;
+  };
+
+  /** A list of the ids of evicted pages, most recently evicted first, with an index for lookups. */
+  struct GhostList {
+    auto Contains(page_id_t page_id) const -> bool { return index_.count(page_id) > 0; }
+    void PushFront(page_id_t page_id);
+    void Erase(page_id_t page_id);
+    void PopBack();
+    auto Size() const -> size_t { return pages_.size(); }
+
+    std::list<page_id_t> pages_;
+    std::unordered_map<page_id_t, std::list<page_id_t>::iterator> index_;
+  };
+
+  /**
+   * Evicts the least recently used evictable frame of a resident list and remembers its page in the ghost list.
+   * @return false if the list has no evictable frame
+   */
+  auto EvictFrom(std::list<frame_id_t> *list, GhostList *ghost, frame_id_t *frame_id) -> bool;
+
+  /** Trims the ghost lists so that |T1| + |B1| <= c and |T1| + |T2| + |B1| + |B2| <= 2c. */
+  void TrimGhosts();
+
+  std::mutex latch_;
+  size_t curr_size_{0};
+  /** The number of frames c. */
+  size_t capacity_;
+  /** The target size of T1, in [0, c]. */
+  size_t target_t1_size_{0};
+  /** Frame state, indexed by frame id. */
+  std::vector<FrameEntry> frames_;
+  /** Resident frames, most recently used first. */
+  std::list<frame_id_t> t1_;
+  std::list<frame_id_t> t2_;
+  GhostList b1_;
+  GhostList b2_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,79 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// buffer_access_strategy.h
+//
+// Identification: src/include/buffer/buffer_access_strategy.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstddef>
+#include <deque>
+
+#include "common/config.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+/**
+ * BufferAccessStrategy keeps a bulk operation (e.g. a large sequential scan or a bulk insert) from cycling the whole
+ * buffer pool through the replacer. The strategy remembers the last ring_size pages the operation read into the pool.
+ * Once the ring is full, a miss reuses the frame of the oldest page of the ring instead of evicting a page from the
+ * shared pool, so the operation only ever occupies about ring_size frames.
+ *
+ * A strategy belongs to a single query and is not thread-safe. The buffer pool manager calls it under its latch.
+ */
+class BufferAccessStrategy {
+ public:
+  /**
+   * @brief Create a new BufferAccessStrategy.
+   * @param ring_size the number of frames the bulk operation may occupy
+   */
+  explicit BufferAccessStrategy(size_t ring_size = BUFFER_ACCESS_STRATEGY_RING_SIZE) : ring_size_(ring_size) {
+    BUSTUB_ASSERT(ring_size > 0, "the ring must hold at least one page");
+  }
+
+  DISALLOW_COPY_AND_MOVE(BufferAccessStrategy);
+
+  /** @return the number of frames the bulk operation may occupy */
+  auto GetRingSize() const -> size_t { return ring_size_; }
+
+  /** @return true if new pages should replace the pages of the ring */
+  auto IsFull() const -> bool { return ring_.size() >= ring_size_; }
+
+  /**
+   * @brief Record that a page was read into the buffer pool on behalf of the bulk operation.
+   * @param page_id id of the page
+   */
+  void AddPage(page_id_t page_id) { ring_.push_back(page_id); }
+
+  /**
+   * @brief Remove the oldest page of the ring that belongs to the given buffer pool manager instance.
+   * @param num_instances number of instances of the parallel buffer pool manager (1 if there is none)
+   * @param instance_index index of the instance
+   * @param[out] page_id the oldest page of the instance
+   * @return false if no page of the ring belongs to the instance
+   */
+  auto PopOldestPage(uint32_t num_instances, uint32_t instance_index, page_id_t *page_id) -> bool {
+    for (auto it = ring_.begin(); it != ring_.end(); ++it) {
+      if (static_cast<uint32_t>(*it) % num_instances == instance_index) {
+        *page_id = *it;
+        ring_.erase(it);
+        return true;
+      }
+    }
+    return false;
+  }
+
+ private:
+  const size_t ring_size_;
+  /** Pages read into the buffer pool by the bulk operation, oldest first. */
+  std::deque<page_id_t> ring_;
+};
+
+}  // namespace bustub
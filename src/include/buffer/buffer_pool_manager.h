@@ -15,10 +15,17 @@
 #include <list>
 #include <mutex>  // NOLINT
 #include <unordered_map>
+#include <vector>
 
 #include "buffer/lru_replacer.h"
+#include "buffer/access_trace.h"
+#include "buffer/buffer_access_strategy.h"
+#include "buffer/buffer_pool_stats.h"
+#include "buffer/compressed_page_cache.h"
 #include "recovery/log_manager.h"
 #include "storage/disk/disk_manager.h"
+#include "storage/disk/disk_scheduler.h"
+#include "storage/disk/page_segment.h"
 #include "storage/page/page.h"
 
 namespace bustub {
@@ -84,9 +91,106 @@ class BufferPoolManager {
     GradingCallback(callback, CallbackType::AFTER, INVALID_PAGE_ID);
   }
 
+  /**
+   * Fetch a page on behalf of a bulk operation. A miss recycles the frames of the strategy's ring once it is full
+   * instead of evicting pages from the shared pool. A nullptr strategy makes this the same as FetchPage().
+   * @param page_id id of page to be fetched
+   * @param strategy the access strategy of the bulk operation, or nullptr
+   * @return nullptr if page_id cannot be fetched, otherwise pointer to the requested page
+   */
+  auto FetchPageWithStrategy(page_id_t page_id, BufferAccessStrategy *strategy) -> Page * {
+    return FetchPgStrategyImp(page_id, strategy);
+  }
+
+  /**
+   * Fetch a page that will only be read. The buffer pool may then point the page at a read-only copy the disk manager
+   * lends instead of reading it into the frame, see DiskManager::GetPageView(), so the data must not be written and
+   * the page must be unpinned clean. A later FetchPage() of the same page gives it a writable copy.
+   * @param page_id id of page to be fetched
+   * @param strategy the access strategy of a bulk operation, or nullptr
+   * @return nullptr if page_id cannot be fetched, otherwise pointer to the requested page
+   */
+  auto FetchPageReadOnly(page_id_t page_id, BufferAccessStrategy *strategy = nullptr) -> Page * {
+    return FetchPgReadOnlyImp(page_id, strategy);
+  }
+
+  /**
+   * Create a new page on behalf of a bulk operation, see FetchPageWithStrategy().
+   * @param[out] page_id id of created page
+   * @param strategy the access strategy of the bulk operation, or nullptr
+   * @return nullptr if no new pages could be created, otherwise pointer to new page
+   */
+  auto NewPageWithStrategy(page_id_t *page_id, BufferAccessStrategy *strategy) -> Page * {
+    return NewPgStrategyImp(page_id, strategy);
+  }
+
+  /**
+   * Create a new page of a table heap or an index, allocated from the extent its segment is filling so that the pages
+   * of the object end up next to each other on disk.
+   * @param[out] page_id id of created page
+   * @param segment the segment of the table heap or index
+   * @param strategy the access strategy of a bulk operation, or nullptr
+   * @return nullptr if no new pages could be created, otherwise pointer to new page
+   */
+  auto NewPageInSegment(page_id_t *page_id, PageSegment *segment, BufferAccessStrategy *strategy = nullptr) -> Page * {
+    return NewPgSegmentImp(page_id, segment, strategy);
+  }
+
   /** @return size of the buffer pool */
   virtual auto GetPoolSize() -> size_t = 0;
 
+  /**
+   * Grow or shrink the buffer pool while it is in use.
+   * @param pool_size the new number of frames
+   * @return false if the buffer pool cannot be resized (now, or at all)
+   */
+  virtual auto Resize(__attribute__((unused)) size_t pool_size) -> bool { return false; }
+
+  /**
+   * Asynchronously read pages [start_page_id, start_page_id + num_pages) into the buffer pool without pinning them.
+   * This is only a hint: pages that are already resident, or for which no frame can be freed, are skipped.
+   * @param start_page_id id of the first page to read
+   * @param num_pages number of pages to read
+   */
+  virtual void PrefetchPages(__attribute__((unused)) page_id_t start_page_id,
+                             __attribute__((unused)) size_t num_pages) {}
+
+  /**
+   * Read pages from disk with one sequential read, from the lowest to the highest page id, and put the ones that are
+   * allocated but not resident into free frames, unpinned. The pages in between are read but not kept. Unlike
+   * PrefetchPages() this is synchronous and never evicts a page, so that warming up the buffer pool cannot push out
+   * pages the workload already brought in.
+   * @param page_ids the pages to load, in increasing order
+   * @return the number of pages put into the buffer pool
+   */
+  virtual auto LoadPages(__attribute__((unused)) const std::vector<page_id_t> &page_ids) -> size_t { return 0; }
+
+  /** @return the ids of the resident pages, from the one the replacer would keep longest to the next victim */
+  virtual auto GetResidentPages() -> std::vector<page_id_t> { return {}; }
+
+  /** @return a snapshot of the buffer pool counters, all zero if the buffer pool does not keep any */
+  virtual auto GetStats() -> BufferPoolStatsSnapshot { return {}; }
+
+  /**
+   * Record every page fetched or created from now on into a trace, or stop recording.
+   * @param trace the trace to record into, or nullptr to stop recording. Must outlive the recording.
+   */
+  virtual void SetAccessTrace(__attribute__((unused)) AccessTrace *trace) {}
+
+  /**
+   * Keep the clean pages evicted from now on in a compressed cache, and look up misses there before reading the disk.
+   * @param cache the cache, or nullptr to stop using one. Must outlive the buffer pool or be detached first.
+   */
+  virtual void SetCompressedPageCache(__attribute__((unused)) CompressedPageCache *cache) {}
+
+  /**
+   * Read the pages missed from now on through a scheduler, so that the reads of concurrent misses and of the
+   * read-ahead are in flight at the same time instead of taking turns on the disk manager.
+   * @param scheduler the scheduler, on the disk manager of the buffer pool, or nullptr to stop using one. Must outlive
+   * the buffer pool or be detached first.
+   */
+  virtual void SetDiskScheduler(__attribute__((unused)) DiskScheduler *scheduler) {}
+
  protected:
   /**
    * Grading function. Do not modify!
@@ -108,6 +212,27 @@ class BufferPoolManager {
    */
   virtual auto FetchPgImp(page_id_t page_id) -> Page * = 0;
 
+  /**
+   * Fetch the requested page from the buffer pool on behalf of a bulk operation. Ignores the strategy by default.
+   * @param page_id id of page to be fetched
+   * @param strategy the access strategy of the bulk operation, or nullptr
+   * @return the requested page
+   */
+  virtual auto FetchPgStrategyImp(page_id_t page_id, __attribute__((unused)) BufferAccessStrategy *strategy)
+      -> Page * {
+    return FetchPgImp(page_id);
+  }
+
+  /**
+   * Fetch a page that will only be read. Same as FetchPgStrategyImp() by default.
+   * @param page_id id of page to be fetched
+   * @param strategy the access strategy of a bulk operation, or nullptr
+   * @return the requested page
+   */
+  virtual auto FetchPgReadOnlyImp(page_id_t page_id, BufferAccessStrategy *strategy) -> Page * {
+    return FetchPgStrategyImp(page_id, strategy);
+  }
+
   /**
    * Unpin the target page from the buffer pool.
    * @param page_id id of page to be unpinned
@@ -130,6 +255,29 @@ class BufferPoolManager {
    */
   virtual auto NewPgImp(page_id_t *page_id) -> Page * = 0;
 
+  /**
+   * Creates a new page in the buffer pool on behalf of a bulk operation. Ignores the strategy by default.
+   * @param[out] page_id id of created page
+   * @param strategy the access strategy of the bulk operation, or nullptr
+   * @return nullptr if no new pages could be created, otherwise pointer to new page
+   */
+  virtual auto NewPgStrategyImp(page_id_t *page_id, __attribute__((unused)) BufferAccessStrategy *strategy)
+      -> Page * {
+    return NewPgImp(page_id);
+  }
+
+  /**
+   * Creates a new page of a table heap or an index in the buffer pool. Ignores the segment by default.
+   * @param[out] page_id id of created page
+   * @param segment the segment of the table heap or index
+   * @param strategy the access strategy of a bulk operation, or nullptr
+   * @return nullptr if no new pages could be created, otherwise pointer to new page
+   */
+  virtual auto NewPgSegmentImp(page_id_t *page_id, __attribute__((unused)) PageSegment *segment,
+                               BufferAccessStrategy *strategy) -> Page * {
+    return NewPgStrategyImp(page_id, strategy);
+  }
+
   /**
    * Deletes a page from the buffer pool.
    * @param page_id id of page to be deleted
@@ -12,16 +12,28 @@
 
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <condition_variable>  // NOLINT
+#include <deque>
+#include <functional>
 #include <list>
+#include <memory>
 #include <mutex>  // NOLINT
+#include <thread>  // NOLINT
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include "buffer/buffer_pool_manager.h"
-#include "buffer/lru_k_replacer.h"
+#include "buffer/frame_arena.h"
+#include "buffer/replacer.h"
 #include "common/config.h"
-#include "container/hash/extendible_hash_table.h"
+#include "container/hash/lock_free_page_table.h"
 #include "recovery/log_manager.h"
 #include "storage/disk/disk_manager.h"
+#include "storage/disk/disk_scheduler.h"
+#include "storage/disk/page_allocator.h"
 #include "storage/page/page.h"
 
 namespace bustub {
@@ -35,11 +47,30 @@ class BufferPoolManagerInstance : public BufferPoolManager {
    * @brief Creates a new BufferPoolManagerInstance.
    * @param pool_size the size of the buffer pool
    * @param disk_manager the disk manager
-   * @param replacer_k the lookback constant k for the LRU-K replacer
+   * @param replacer_k the lookback constant k, if the replacement policy is LRU-K
    * @param log_manager the log manager (for testing only: nullptr = disable logging). Please ignore this for P1.
+   * @param page_allocator the free-space bitmap of the database file (nullptr = allocate page ids sequentially)
+   * @param replacer_type the replacement policy
    */
   BufferPoolManagerInstance(size_t pool_size, DiskManager *disk_manager, size_t replacer_k = LRUK_REPLACER_K,
-                            LogManager *log_manager = nullptr);
+                            LogManager *log_manager = nullptr, PageAllocator *page_allocator = nullptr,
+                            ReplacerType replacer_type = ReplacerType::LRU_K);
+
+  /**
+   * @brief Creates a new BufferPoolManagerInstance that is one shard of a ParallelBufferPoolManager.
+   * @param pool_size the size of the buffer pool
+   * @param num_instances total number of BPIs in the parallel BPM
+   * @param instance_index index of this BPI in the parallel BPM
+   * @param disk_manager the disk manager
+   * @param replacer_k the lookback constant k, if the replacement policy is LRU-K
+   * @param log_manager the log manager (for testing only: nullptr = disable logging). Please ignore this for P1.
+   * @param page_allocator the free-space bitmap of the database file (nullptr = allocate page ids sequentially)
+   * @param replacer_type the replacement policy
+   */
+  BufferPoolManagerInstance(size_t pool_size, uint32_t num_instances, uint32_t instance_index,
+                            DiskManager *disk_manager, size_t replacer_k = LRUK_REPLACER_K,
+                            LogManager *log_manager = nullptr, PageAllocator *page_allocator = nullptr,
+                            ReplacerType replacer_type = ReplacerType::LRU_K);
 
   /**
    * @brief Destroy an existing BufferPoolManagerInstance.
@@ -49,8 +80,120 @@ class BufferPoolManagerInstance : public BufferPoolManager {
   /** @brief Return the size (number of frames) of the buffer pool. */
   auto GetPoolSize() -> size_t override { return pool_size_; }
 
-  /** @brief Return the pointer to all the pages in the buffer pool. */
-  auto GetPages() -> Page * { return pages_; }
+  /** @brief Return the page held by a frame, for frame ids in [0, GetPoolSize()). */
+  auto GetFrame(frame_id_t frame_id) -> Page * {
+    std::scoped_lock<std::mutex> lock(latch_);
+    return pages_[frame_id];
+  }
+
+  /** @brief Return the arena holding the data of the frames the buffer pool was created with. */
+  auto GetFrameArena() -> FrameArena * { return segments_.front().arena_.get(); }
+
+  /**
+   * @brief Grow or shrink the buffer pool to pool_size frames while it is in use.
+   *
+   * Growing maps a new segment of frames if needed and adds the new frames to the free list. Shrinking drops the frames
+   * [pool_size, GetPoolSize()): they are no longer handed out, and as soon as each of them is unpinned its page is
+   * moved to a free frame that is kept if there is one, or evicted (and written back if dirty) otherwise. The memory of
+   * the dropped frames is then returned to the OS, but their metadata is kept for a later growth. Pages in dropped
+   * frames can be fetched until they are moved, and the latch is released while waiting for pins and during
+   * write-backs, so other threads only see short pauses.
+   *
+   * @param pool_size the new number of frames, at least 1
+   * @return false if the pool should shrink but a frame to drop stayed pinned for buffer_pool_resize_timeout, in which
+   * case the pool keeps its size (the pages that were already moved or evicted stay so)
+   */
+  auto Resize(size_t pool_size) -> bool override;
+
+  /**
+   * @brief Start the background flusher. Every bg_flush_interval, or when a foreground thread had to write back a
+   * dirty victim, the flusher counts the clean frames (free, or unpinned and not dirty). If there are fewer than
+   * low_watermark of them, it writes unpinned dirty pages in page id order until high_watermark frames are clean.
+   * When logging is enabled, pages whose LSN is not yet persistent are skipped (WAL).
+   * @param low_watermark number of clean frames below which the flusher starts writing
+   * @param high_watermark number of clean frames the flusher writes up to
+   */
+  void StartBackgroundFlusher(size_t low_watermark, size_t high_watermark);
+
+  /** @brief Start the background flusher with the watermarks from config.h. */
+  void StartBackgroundFlusher();
+
+  /** @brief Stop and join the background flusher. Does nothing if it is not running. */
+  void StopBackgroundFlusher();
+
+  /** @return the number of pages written by foreground threads, i.e. dirty victims and explicit flushes */
+  auto GetForegroundWriteCount() const -> size_t { return num_foreground_writes_; }
+
+  /** @return the number of pages written by the background flusher */
+  auto GetBackgroundWriteCount() const -> size_t { return num_background_writes_; }
+
+  /**
+   * @brief Queue pages [start_page_id, start_page_id + num_pages) that belong to this instance for read-ahead. The
+   * pages are read by a pool of prefetch threads, started on first use, and left unpinned in the buffer pool. A page
+   * is skipped if it is resident, has never been allocated, or if no frame can be evicted for it. With a DiskScheduler,
+   * each thread keeps a batch of up to BUFFER_POOL_PREFETCH_BATCH reads in flight.
+   */
+  void PrefetchPages(page_id_t start_page_id, size_t num_pages) override;
+
+  /**
+   * @brief Load the pages that belong to this instance, see BufferPoolManager::LoadPages(). Only the span of the
+   * pages that are missing is read.
+   */
+  auto LoadPages(const std::vector<page_id_t> &page_ids) -> size_t override;
+
+  /**
+   * @brief First half of LoadPages(): map the missing pages that belong to this instance to free frames, pinned and
+   * marked READING so that fetchers wait for the data. Stops when the free list is empty.
+   * @param page_ids the pages to load, in increasing order
+   * @return the (page id, frame id) pairs to pass to FinishLoad(), in increasing page id order
+   */
+  auto BeginLoad(const std::vector<page_id_t> &page_ids) -> std::vector<std::pair<page_id_t, frame_id_t>>;
+
+  /**
+   * @brief Second half of LoadPages(): copy the pages reserved by BeginLoad() out of the run and unpin them.
+   * @param frames the pairs returned by BeginLoad()
+   * @param start_page_id id of the first page of the run
+   * @param data the run, as read by DiskManager::ReadPages()
+   */
+  void FinishLoad(const std::vector<std::pair<page_id_t, frame_id_t>> &frames, page_id_t start_page_id,
+                  const char *data);
+
+  /**
+   * @brief Create a new page whose id the parallel buffer pool manager allocated for this instance, the page of a
+   * segment's extent. Same as NewPgStrategyImp() otherwise.
+   * @param page_id id of the page to create, which must belong to this instance
+   * @param strategy the access strategy of a bulk operation, or nullptr
+   * @return nullptr if no frame is available, otherwise pointer to new page
+   */
+  auto NewAllocatedPage(page_id_t page_id, BufferAccessStrategy *strategy) -> Page *;
+
+  /**
+   * @brief Skip the page ids of this instance below end_page_id, so that the parallel buffer pool manager can hand
+   * them out as an extent. Only used without a page allocator.
+   * @return the next page id of the instance before the call; the instance has allocated no page above it
+   */
+  auto ReservePageIds(page_id_t end_page_id) -> page_id_t;
+
+  /** @brief Return the ids of the resident pages, in the priority order of the replacer. */
+  auto GetResidentPages() -> std::vector<page_id_t> override;
+
+  /** @return the number of pages read from disk by the prefetch threads */
+  auto GetPrefetchCount() const -> size_t { return num_prefetches_; }
+
+  /** @return a snapshot of the hit, eviction, latch and I/O counters of this instance */
+  auto GetStats() -> BufferPoolStatsSnapshot override { return stats_.Snapshot(); }
+
+  /** @brief Record every page fetched or created by this instance into a trace, or stop recording if nullptr. */
+  void SetAccessTrace(AccessTrace *trace) override;
+
+  /** @brief Keep the clean pages evicted by this instance in a compressed cache, or stop if nullptr. */
+  void SetCompressedPageCache(CompressedPageCache *cache) override;
+
+  /**
+   * @brief Read the pages missed by this instance through a scheduler, or through the disk manager again if nullptr.
+   * Returns once no read goes through the previous scheduler.
+   */
+  void SetDiskScheduler(DiskScheduler *scheduler) override;
 
  protected:
   /**
@@ -72,6 +215,20 @@ class BufferPoolManagerInstance : public BufferPoolManager {
    */
   auto NewPgImp(page_id_t *page_id) -> Page * override;
 
+  /**
+   * @brief Create a new page on behalf of a bulk operation. Same as NewPgImp(), except that once the strategy's ring
+   * is full, the frame of its oldest page is reused (if it is still resident and unpinned) instead of a frame from the
+   * free list or the replacer.
+   */
+  auto NewPgStrategyImp(page_id_t *page_id, BufferAccessStrategy *strategy) -> Page * override;
+
+  /**
+   * @brief Create a new page of a table heap or an index. Same as NewPgStrategyImp(), except that the page id is the
+   * next one of the segment's extent, see AllocatePage(). An instance of a parallel buffer pool manager is handed the
+   * pages of a segment through NewAllocatedPage() instead.
+   */
+  auto NewPgSegmentImp(page_id_t *page_id, PageSegment *segment, BufferAccessStrategy *strategy) -> Page * override;
+
   /**
    * TODO(P1): Add implementation
    *
@@ -90,6 +247,19 @@ class BufferPoolManagerInstance : public BufferPoolManager {
    */
   auto FetchPgImp(page_id_t page_id) -> Page * override;
 
+  /**
+   * @brief Fetch a page on behalf of a bulk operation. Same as FetchPgImp(), except that a miss reuses the frame of the
+   * oldest page of a full ring, see NewPgStrategyImp(). A hit on a page that was prefetched for the bulk operation adds
+   * it to the ring, and frees a clean page of the ring in exchange.
+   */
+  auto FetchPgStrategyImp(page_id_t page_id, BufferAccessStrategy *strategy) -> Page * override;
+
+  /**
+   * @brief Fetch a page that will only be read. Same as FetchPgStrategyImp(), except that a miss points the frame at
+   * the page the disk manager lends, if it does, instead of reading the page, see ReadFrames().
+   */
+  auto FetchPgReadOnlyImp(page_id_t page_id, BufferAccessStrategy *strategy) -> Page * override;
+
   /**
    * TODO(P1): Add implementation
    *
@@ -140,42 +310,313 @@ class BufferPoolManagerInstance : public BufferPoolManager {
    */
   auto DeletePgImp(page_id_t page_id) -> bool override;
 
-  /** Number of pages in the buffer pool. */
-  const size_t pool_size_;
+  /** Number of frames in the buffer pool, i.e. frames [0, pool_size_) are in use. Updated under latch_. */
+  std::atomic<size_t> pool_size_;
+  /** How many instances are in the parallel BPM (if present, otherwise just 1 BPI) */
+  const uint32_t num_instances_ = 1;
+  /** Index of this BPI in the parallel BPM (if present, otherwise just 0) */
+  const uint32_t instance_index_ = 0;
   /** The next page id to be allocated  */
-  std::atomic<page_id_t> next_page_id_ = 0;
-  /** Bucket size for the extendible hash table */
-  const size_t bucket_size_ = 4;
+  std::atomic<page_id_t> next_page_id_;
+
+  /** A batch of frames mapped at once, by the constructor or by a Resize() that grows the pool. */
+  struct FrameSegment {
+    std::unique_ptr<Page[]> pages_;
+    std::unique_ptr<FrameArena> arena_;
+    /** Id of the first frame of the segment. */
+    size_t first_frame_id_;
+    size_t num_frames_;
+  };
 
-  /** Array of buffer pool pages. */
-  Page *pages_;
+  /** The frame segments, in frame id order. Segments are never unmapped, so Page pointers stay valid. */
+  std::vector<FrameSegment> segments_;
+  /**
+   * The page of every frame, indexed by frame id, including the frames dropped by a shrink. Grows (and may move)
+   * under latch_, so it must not be indexed without the latch.
+   */
+  std::vector<Page *> pages_;
+  /**
+   * A copy of pages_ for the lock-free paths, replaced when a segment is added. The older copies are kept in
+   * frame_directories_ until destruction, since a reader may still be indexing one.
+   */
+  std::atomic<Page **> frame_directory_{nullptr};
+  std::vector<std::unique_ptr<Page *[]>> frame_directories_;
   /** Pointer to the disk manager. */
   DiskManager *disk_manager_ __attribute__((__unused__));
   /** Pointer to the log manager. Please ignore this for P1. */
   LogManager *log_manager_ __attribute__((__unused__));
-  /** Page table for keeping track of buffer pool pages. */
-  ExtendibleHashTable<page_id_t, frame_id_t> *page_table_;
+  /** Pointer to the free-space bitmap, or nullptr if page ids are allocated sequentially from next_page_id_. */
+  PageAllocator *page_allocator_;
+  /** Page table for keeping track of buffer pool pages. Lookups are lock-free, updates happen under latch_. */
+  LockFreePageTable *page_table_;
   /** Replacer to find unpinned pages for replacement. */
-  LRUKReplacer *replacer_;
+  std::unique_ptr<Replacer> replacer_;
   /** List of free frames that don't have any pages on them. */
   std::list<frame_id_t> free_list_;
-  /** This latch protects shared data structures. We recommend updating this comment to describe what it protects. */
+  /**
+   * Evicted dirty pages whose write-back is still in flight, mapped to the frame doing the write-back. A fetch of such
+   * a page must wait for the write-back to complete before reading the page from disk.
+   */
+  std::unordered_map<page_id_t, frame_id_t> write_back_;
+  /**
+   * This latch protects the page table updates, the free list, the replacer, the write-back table and the metadata of
+   * every frame (page id, pin count, dirty flag and I/O state). It is never held across disk I/O: a frame doing I/O is
+   * pinned and marked READING or WRITING instead, and waiters block on the frame's condition variable. The hit path
+   * and unpins pin and unpin frames without it; a frame is claimed (see Page::Claim()) for as long as the latch holder
+   * changes its page, so that they can tell.
+   */
   std::mutex latch_;
+  /** Serializes Resize() calls. Taken before latch_. */
+  std::mutex resize_latch_;
+  /** Wakes up a shrinking Resize() when one of the frames it drops is unpinned. Waited on with latch_. */
+  std::condition_variable resize_cv_;
+
+  /** The background flusher thread, see StartBackgroundFlusher(). */
+  std::thread flush_thread_;
+  /** True while the background flusher should keep running. Protected by latch_. */
+  bool flush_thread_running_ = false;
+  /** Wakes up the background flusher. Waited on with latch_. */
+  std::condition_variable flush_cv_;
+  /** The watermarks of the background flusher, in frames. Protected by latch_. */
+  size_t flush_low_watermark_ = 0;
+  size_t flush_high_watermark_ = 0;
+  /** Number of pages written by foreground threads. */
+  std::atomic<size_t> num_foreground_writes_{0};
+  /** Number of pages written by the background flusher. */
+  std::atomic<size_t> num_background_writes_{0};
+
+  /** Pages waiting to be read by the prefetch threads. Protected by latch_. */
+  std::deque<page_id_t> prefetch_queue_;
+  /** The prefetch threads, see PrefetchPages(). */
+  std::vector<std::thread> prefetch_threads_;
+  /** False once the prefetch threads should exit. Protected by latch_. */
+  bool prefetch_running_ = true;
+  /** Wakes up the prefetch threads. Waited on with latch_. */
+  std::condition_variable prefetch_cv_;
+  /** Number of pages read by the prefetch threads. */
+  std::atomic<size_t> num_prefetches_{0};
+  /** Whether each frame holds a prefetched page that nobody fetched yet. Protected by latch_. */
+  std::vector<bool> prefetched_;
+
+  /** Hit, eviction, latch and I/O counters, see GetStats(). */
+  BufferPoolStats stats_;
+  /** The trace recording the page accesses, or nullptr. Set under latch_; the hit path is skipped while tracing. */
+  std::atomic<AccessTrace *> access_trace_{nullptr};
+  /** The second-level cache of the clean pages evicted, or nullptr. Protected by latch_. */
+  CompressedPageCache *compressed_cache_{nullptr};
+  /** The scheduler the pages are read through, or nullptr to read them with the disk manager. Protected by latch_. */
+  DiskScheduler *disk_scheduler_{nullptr};
+
+  /** Number of replacer updates a shard of access_shards_ holds before the thread filling it drains them. */
+  static constexpr size_t ACCESS_BUFFER_SIZE = 64;
+  static constexpr size_t NUM_ACCESS_SHARDS = 16;
+
+  /**
+   * A replacer update from a path that does not take latch_: an access to a page (or, if page_id_ is INVALID_PAGE_ID,
+   * just a pin count that dropped to 0). Applying it re-reads the pin count, so updates can be applied in any order.
+   */
+  struct AccessEntry {
+    frame_id_t frame_id_;
+    page_id_t page_id_;
+  };
+
+  /** A buffer of replacer updates, filled by the threads that were assigned to it. */
+  struct alignas(BufferPoolStats::CACHE_LINE_SIZE) AccessShard {
+    std::mutex latch_;
+    std::vector<AccessEntry> entries_;
+  };
+
+  /** Replacer updates of the hit path, applied under latch_ by DrainAccessBuffers(). Taken after latch_. */
+  std::array<AccessShard, NUM_ACCESS_SHARDS> access_shards_;
+  /** Number of entries in access_shards_, so that draining them is free when there are none. */
+  std::atomic<size_t> num_buffered_accesses_{0};
+
+  /**
+   * @brief Acquire latch_ on behalf of a foreground operation, recording in stats_ how long it had to wait. The
+   * buffered replacer updates are applied first, so that the replacer sees the accesses in order.
+   * @return the lock holding latch_
+   */
+  auto LockLatch() -> std::unique_lock<std::mutex>;
+
+  /**
+   * @brief The hit path: pin a resident page without taking latch_. The frame is found with a lock-free page table
+   * probe and pinned with a CAS, then the pin is validated: the frame must not have been claimed in between (same
+   * version) and must hold the page. The replacer update is buffered.
+   * @return the pinned page, or nullptr if the page must be fetched under the latch
+   */
+  auto FetchFast(page_id_t page_id) -> Page *;
+
+  /**
+   * @brief Body of FetchPgStrategyImp() and FetchPgReadOnlyImp(). A page fetched for writing whose frame points to a
+   * page lent by the disk manager gets a copy of it first, see CopyLentPage().
+   */
+  auto FetchFrame(page_id_t page_id, BufferAccessStrategy *strategy, bool read_only) -> Page *;
+
+  /**
+   * @brief Copy the page a frame points to into the frame's own memory if the disk manager lent it, so that it can be
+   * written. The frame keeps its copy until it gets another page. Caller should hold the latch and pin the page.
+   */
+  void CopyLentPage(Page *page);
+
+  /**
+   * @brief Unpin a page without taking latch_. The caller's pin keeps the frame mapped to the page.
+   * @return false if the page must be unpinned under the latch
+   */
+  auto UnpinFast(page_id_t page_id, bool is_dirty) -> bool;
+
+  /** @brief Buffer a replacer update for the next DrainAccessBuffers(). Caller must not hold the latch. */
+  void BufferAccess(frame_id_t frame_id, page_id_t page_id);
+
+  /** @brief Apply the buffered replacer updates of every shard. Caller should hold the latch. */
+  void DrainAccessBuffers();
+
+  /**
+   * @brief Claim a frame taken from the free list. A reader of a stale page table entry may hold a transient pin on
+   * it, so this spins until the pin is dropped. Caller should hold the latch.
+   */
+  void ClaimFreeFrame(frame_id_t frame_id);
+
+  /**
+   * @brief Stop tracking a claimed frame in the replacer. The replacer may not have heard that the frame was unpinned
+   * yet, so the frame is made evictable first. Caller should hold the latch.
+   */
+  void RemoveFromReplacer(frame_id_t frame_id);
 
   /**
-   * @brief Allocate a page on disk. Caller should acquire the latch before calling this function.
+   * @brief Allocate a page on disk: the lowest free page of this instance if there is a page allocator, the next page
+   * id otherwise. A page of a segment comes from the extent the segment is filling, and a new extent is allocated the
+   * same way. Caller should acquire the latch before calling this function.
+   * @param segment the segment of the table heap or index the page belongs to, or nullptr
    * @return the id of the allocated page
    */
-  auto AllocatePage() -> page_id_t;
+  auto AllocatePage(PageSegment *segment = nullptr) -> page_id_t;
 
   /**
-   * @brief Deallocate a page on disk. Caller should acquire the latch before calling this function.
+   * @brief Body of NewPgSegmentImp() and NewAllocatedPage(): find a frame, then map the page allocate_page() returns
+   * to it. allocate_page() is called under the latch.
+   */
+  auto CreatePage(page_id_t *page_id, const std::function<page_id_t()> &allocate_page, BufferAccessStrategy *strategy)
+      -> Page *;
+
+  /**
+   * @brief Deallocate a page on disk, so that the page allocator (if any) can reuse it. Caller should acquire the latch
+   * before calling this function.
    * @param page_id id of the page to deallocate
    */
-  void DeallocatePage(__attribute__((unused)) page_id_t page_id) {
-    // This is a no-nop right now without a more complex data structure to track deallocated pages
-  }
+  void DeallocatePage(page_id_t page_id);
+
+  /** @return true if the page has been allocated, i.e. it may exist on disk */
+  auto IsAllocated(page_id_t page_id) -> bool;
+
+  /**
+   * @brief Validate that the page_id being used is accessible to this BPI. This can be used in all of the functions to
+   * validate input data and ensure that a parallel BPM is routing requests to the BPIs correctly.
+   * @param page_id id of the page to validate
+   */
+  void ValidatePageId(page_id_t page_id) const;
+
+  /**
+   * @brief Find a frame for a new page: from the ring of a full access strategy, then from the free list, then from
+   * the replacer. If the evicted page is dirty, it is registered in the write-back table and the caller must write it
+   * back (outside the latch) before reusing the frame. The frame is returned claimed, see Page::Claim(), and the
+   * caller must publish it before releasing the latch. Caller should hold the latch.
+   * @param[out] frame_id the frame to reuse
+   * @param[out] victim_page_id the dirty page to write back, or INVALID_PAGE_ID if there is none
+   * @param strategy the access strategy of a bulk operation, or nullptr
+   * @return false if all frames are pinned
+   */
+  auto AcquireFrame(frame_id_t *frame_id, page_id_t *victim_page_id, BufferAccessStrategy *strategy = nullptr)
+      -> bool;
+
+  /**
+   * @brief Remove the page of a claimed frame from the page table, registering it for write-back if it is dirty.
+   * Caller should hold the latch.
+   */
+  void UnmapFrame(frame_id_t frame_id, page_id_t *victim_page_id);
 
-  // TODO(student): You may add additional private members and helper functions
+  /**
+   * @brief Pop the oldest page of the strategy's ring that belongs to this instance. Caller should hold the latch.
+   * @param[out] frame_id the frame holding the page
+   * @return true if the page is still resident and unpinned, in which case its frame is claimed
+   */
+  auto PopRingFrame(BufferAccessStrategy *strategy, frame_id_t *frame_id) -> bool;
+
+  /**
+   * @brief Add a prefetched page to the strategy's ring. If the ring is full, the oldest page of the ring is dropped
+   * and, if it is clean, its frame goes back to the free list. Caller should hold the latch.
+   */
+  void AdoptRingPage(page_id_t page_id, BufferAccessStrategy *strategy);
+
+  /**
+   * @brief Map a frame returned by AcquireFrame() to page_id and read the page into it, see MapFrame() and
+   * ReadFrames(). Caller should hold the latch, which is released during I/O.
+   */
+  void ReadFrame(frame_id_t frame_id, page_id_t page_id, page_id_t victim_page_id, std::unique_lock<std::mutex> &lock,
+                 bool lend = false);
+
+  /**
+   * @brief Map a frame returned by AcquireFrame() to page_id and write back its dirty victim, if any. The frame is
+   * published pinned once and marked READING, so that concurrent fetchers of page_id wait for the read instead of
+   * issuing their own. Caller should hold the latch, which is released during I/O.
+   */
+  void MapFrame(frame_id_t frame_id, page_id_t page_id, page_id_t victim_page_id, std::unique_lock<std::mutex> &lock);
+
+  /**
+   * @brief Read the pages of frames mapped by MapFrame(), from the compressed cache or the disk, then mark the frames
+   * READY. With a DiskScheduler all the reads are in flight at once. With lend, a page the disk manager lends is not
+   * read: the frame points to it instead, see DiskManager::GetPageView(). Caller should hold the latch, which is
+   * released during I/O.
+   * @param frames the (frame id, page id) pairs
+   * @param lend whether the pages are only read, by FetchPgReadOnlyImp() or the read-ahead
+   */
+  void ReadFrames(const std::vector<std::pair<frame_id_t, page_id_t>> &frames, std::unique_lock<std::mutex> &lock,
+                  bool lend = false);
+
+  /**
+   * @brief Write back the dirty victim of a frame that has been reserved by AcquireFrame(), then mark the write-back
+   * as complete. The frame should be pinned and not READY. Caller should hold the latch, which is released during I/O.
+   */
+  void WriteBackVictim(frame_id_t frame_id, page_id_t victim_page_id, std::unique_lock<std::mutex> &lock);
+
+  /**
+   * @brief Mark the frame as READY and wake up the threads waiting on it. Caller should hold the latch.
+   */
+  void FinishIo(frame_id_t frame_id);
+
+  /**
+   * @brief Write a resident frame to disk without holding the latch. The frame is pinned for the duration of the
+   * write so that it cannot be evicted. Caller should hold the latch.
+   */
+  void FlushFrame(frame_id_t frame_id, std::unique_lock<std::mutex> &lock, bool background = false);
+
+  /**
+   * @brief Write the dirty frames among frame_ids to disk with a single DiskManager::WritePages() batch, without
+   * holding the latch. The frames are pinned for the duration of the write. Caller should hold the latch.
+   */
+  void FlushFrames(const std::vector<frame_id_t> &frame_ids, std::unique_lock<std::mutex> &lock,
+                   bool background = false);
+
+  /**
+   * @brief Map a new segment of frames, so that there are at least num_frames of them. Caller should hold the latch.
+   */
+  void AddFrameSegment(size_t num_frames);
+
+  /**
+   * @brief Move the page of a claimed frame to a free frame, keeping its contents and dirty flag. Both frames are
+   * published unpinned. Caller should hold the latch.
+   */
+  void MoveFrame(frame_id_t from_frame_id, frame_id_t to_frame_id);
+
+  /** @brief Main loop of the background flusher. */
+  void BackgroundFlush();
+
+  /** @brief Main loop of a prefetch thread. */
+  void Prefetch();
+
+  /**
+   * @brief Write unpinned dirty pages in page id order if fewer than flush_low_watermark_ frames are clean. Caller
+   * should hold the latch, which is released during I/O.
+   */
+  void CleanFrames(std::unique_lock<std::mutex> &lock);
 };
 }  // namespace bustub
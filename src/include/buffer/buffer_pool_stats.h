@@ -0,0 +1,138 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// buffer_pool_stats.h
+//
+// Identification: src/include/buffer/buffer_pool_stats.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "common/macros.h"
+
+namespace bustub {
+
+/**
+ * LatencyHistogram counts latencies in power-of-two buckets of microseconds: bucket 0 holds latencies below 1 us and
+ * bucket i holds latencies in [2^(i-1), 2^i) us. The last bucket also holds everything above.
+ */
+struct LatencyHistogram {
+  static constexpr size_t NUM_BUCKETS = 24;
+
+  /** @return the bucket of a latency in microseconds */
+  static auto BucketOf(uint64_t latency_us) -> size_t;
+
+  /** @return the number of latencies recorded */
+  auto Count() const -> uint64_t;
+
+  /** @return an upper bound, in microseconds, of the given percentile (in [0, 100]) of the recorded latencies */
+  auto Percentile(double percentile) const -> uint64_t;
+
+  auto operator+=(const LatencyHistogram &other) -> LatencyHistogram &;
+
+  std::array<uint64_t, NUM_BUCKETS> buckets_{};
+};
+
+/** A point-in-time copy of the counters of one or more buffer pool manager instances. */
+struct BufferPoolStatsSnapshot {
+  /** @return hits / (hits + misses), or 0 if there were no fetches */
+  auto HitRatio() const -> double;
+
+  auto operator+=(const BufferPoolStatsSnapshot &other) -> BufferPoolStatsSnapshot &;
+
+  /** Fetches of a resident page. */
+  uint64_t hits_{0};
+  /** Fetches that had to read the page from disk. */
+  uint64_t misses_{0};
+  /** Evictions of a page that did not have to be written back. */
+  uint64_t clean_evictions_{0};
+  /** Evictions of a dirty page, written back by the evicting thread. */
+  uint64_t dirty_evictions_{0};
+  /** Pages created with NewPage. */
+  uint64_t new_pages_{0};
+  /** Pages deleted with DeletePage. */
+  uint64_t deletes_{0};
+  /** Acquisitions of the buffer pool latch by foreground operations. */
+  uint64_t latch_acquires_{0};
+  /** Acquisitions of the buffer pool latch that had to wait for another thread. */
+  uint64_t latch_contended_{0};
+  /** Total time spent waiting for the buffer pool latch, in nanoseconds. */
+  uint64_t latch_wait_ns_{0};
+  /** Page reads that failed, leaving the page zeroed. */
+  uint64_t read_errors_{0};
+  /** Latency of the page reads issued by the buffer pool. */
+  LatencyHistogram read_latency_;
+  /** Latency of the page writes issued by the buffer pool. */
+  LatencyHistogram write_latency_;
+};
+
+/**
+ * BufferPoolStats holds the counters of a buffer pool manager instance. Every thread updates one of NUM_SHARDS
+ * cache-line aligned shards with relaxed atomic increments, so recording never takes a lock and threads rarely share
+ * a cache line. Snapshot() sums the shards; it is not atomic with respect to concurrent updates, but every counter is
+ * monotonic.
+ */
+class BufferPoolStats {
+ public:
+  BufferPoolStats() = default;
+  DISALLOW_COPY_AND_MOVE(BufferPoolStats);
+
+  void RecordHit() { Add(&Shard::hits_); }
+  void RecordMiss() { Add(&Shard::misses_); }
+  void RecordEviction(bool dirty) { Add(dirty ? &Shard::dirty_evictions_ : &Shard::clean_evictions_); }
+  void RecordNewPage() { Add(&Shard::new_pages_); }
+  void RecordDelete() { Add(&Shard::deletes_); }
+  void RecordReadError() { Add(&Shard::read_errors_); }
+
+  /** Records a latch acquisition, and the time it waited if the latch was contended. */
+  void RecordLatchAcquire(bool contended, std::chrono::nanoseconds wait);
+
+  void RecordRead(std::chrono::nanoseconds latency);
+  void RecordWrite(std::chrono::nanoseconds latency);
+
+  /** @return the sum of all the shards */
+  auto Snapshot() const -> BufferPoolStatsSnapshot;
+
+  /** @return the counters of a snapshot as human-readable (name, value) pairs */
+  static auto ToRows(const BufferPoolStatsSnapshot &snapshot) -> std::vector<std::pair<std::string, std::string>>;
+
+  static constexpr size_t NUM_SHARDS = 16;
+  static constexpr size_t CACHE_LINE_SIZE = 64;
+
+ private:
+  struct alignas(CACHE_LINE_SIZE) Shard {
+    std::atomic<uint64_t> hits_{0};
+    std::atomic<uint64_t> misses_{0};
+    std::atomic<uint64_t> clean_evictions_{0};
+    std::atomic<uint64_t> dirty_evictions_{0};
+    std::atomic<uint64_t> new_pages_{0};
+    std::atomic<uint64_t> deletes_{0};
+    std::atomic<uint64_t> latch_acquires_{0};
+    std::atomic<uint64_t> latch_contended_{0};
+    std::atomic<uint64_t> latch_wait_ns_{0};
+    std::atomic<uint64_t> read_errors_{0};
+    std::array<std::atomic<uint64_t>, LatencyHistogram::NUM_BUCKETS> read_latency_{};
+    std::array<std::atomic<uint64_t>, LatencyHistogram::NUM_BUCKETS> write_latency_{};
+  };
+
+  /** @return the shard of the calling thread */
+  auto LocalShard() -> Shard &;
+
+  void Add(std::atomic<uint64_t> Shard::*counter) { (LocalShard().*counter).fetch_add(1, std::memory_order_relaxed); }
+
+  std::array<Shard, NUM_SHARDS> shards_;
+};
+
+}  // namespace bustub
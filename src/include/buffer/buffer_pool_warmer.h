@@ -0,0 +1,117 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// buffer_pool_warmer.h
+//
+// Identification: src/include/buffer/buffer_pool_warmer.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <chrono>              // NOLINT
+#include <condition_variable>  // NOLINT
+#include <mutex>               // NOLINT
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "common/config.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+/**
+ * BufferPoolWarmer saves the set of pages resident in a buffer pool to a small sidecar file, and preloads them after a
+ * restart so that the buffer pool does not have to refill one random read at a time.
+ *
+ * The file lists one page id per line, from the page the replacer would keep longest to its next victim. Warming up
+ * keeps as many of the first pages as the buffer pool has frames, sorts them by page id and reads them in runs of
+ * consecutive pages, reading through short gaps so that nearby runs merge into one sequential read. The pages only go
+ * to free frames, so the warm-up runs in the background while the buffer pool is already in use.
+ */
+class BufferPoolWarmer {
+ public:
+  /**
+   * @brief Create a new BufferPoolWarmer.
+   * @param bpm the buffer pool to save and warm up
+   * @param file_name the file holding the resident page set
+   */
+  BufferPoolWarmer(BufferPoolManager *bpm, std::string file_name);
+
+  DISALLOW_COPY_AND_MOVE(BufferPoolWarmer);
+
+  /** @brief Stop the periodic dump and the warm-up, without saving the resident page set. */
+  ~BufferPoolWarmer();
+
+  /**
+   * @brief Save the resident page set. The list goes to a temporary file that is then renamed over the old one, so a
+   * crash never leaves a truncated list behind. Nothing is saved while a warm-up has not completed: the pool only holds
+   * part of the pages then, and the previous list is a better picture of the working set.
+   * @return true if the resident page set was saved
+   */
+  auto Dump() -> bool;
+
+  /** @brief Save the resident page set every interval in a background thread. */
+  void StartPeriodicDump(std::chrono::milliseconds interval);
+
+  /** @brief Stop and join the periodic dump thread. Does nothing if it is not running. */
+  void StopPeriodicDump();
+
+  /** @brief Load the pages listed in the file in a background thread. Without a file, there is nothing to load. */
+  void StartWarmUp();
+
+  /** @brief Ask the warm-up to stop after the run it is reading, and join it. Dump() stays disabled afterwards. */
+  void StopWarmUp();
+
+  /** @brief Wait until the warm-up has loaded every page it could. */
+  void WaitForWarmUp();
+
+  /** @return the number of pages loaded by the warm-up so far */
+  auto GetNumPagesLoaded() const -> size_t { return num_pages_loaded_; }
+
+  /**
+   * @brief Read a resident page set.
+   * @param file_name the file written by Dump()
+   * @return the page ids, hottest first, or nothing if the file does not exist
+   */
+  static auto ReadPageList(const std::string &file_name) -> std::vector<page_id_t>;
+
+  /**
+   * @brief Group pages into sequential reads.
+   * @param page_ids the pages to read, in any order
+   * @param max_run_pages the longest read, in pages
+   * @param max_gap_pages the number of unwanted pages a read may span to join two runs
+   * @return the pages of each read in increasing order, the reads in page id order
+   */
+  static auto PlanRuns(std::vector<page_id_t> page_ids, size_t max_run_pages, size_t max_gap_pages)
+      -> std::vector<std::vector<page_id_t>>;
+
+ private:
+  void WarmUp();
+  void PeriodicDump(std::chrono::milliseconds interval);
+
+  BufferPoolManager *bpm_;
+  std::string file_name_;
+  /** Serializes Dump(). */
+  std::mutex file_latch_;
+
+  std::thread warm_up_thread_;
+  /** True from StartWarmUp() until the warm-up has gone through the whole page list. */
+  std::atomic<bool> warming_up_{false};
+  std::atomic<bool> stop_warm_up_{false};
+  std::atomic<size_t> num_pages_loaded_{0};
+
+  std::thread dump_thread_;
+  /** True while the periodic dump should keep running. Protected by dump_latch_. */
+  bool dump_running_{false};
+  std::mutex dump_latch_;
+  std::condition_variable dump_cv_;
+};
+
+}  // namespace bustub
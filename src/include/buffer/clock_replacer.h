@@ -12,7 +12,6 @@
 
 #pragma once
 
-#include <list>
 #include <mutex>  // NOLINT
 #include <vector>
 
@@ -23,6 +22,10 @@ namespace bustub {
 
 /**
  * ClockReplacer implements the clock replacement policy, which approximates the Least Recently Used policy.
+ *
+ * Every tracked frame has a reference bit, set on each access. The clock hand sweeps over the frames in frame id
+ * order: an evictable frame with its reference bit set gets a second chance (the bit is cleared), the first one
+ * without is evicted.
  */
 class ClockReplacer : public Replacer {
  public:
@@ -37,16 +40,33 @@ class ClockReplacer : public Replacer {
    */
   ~ClockReplacer() override;
 
-  auto Victim(frame_id_t *frame_id) -> bool override;
+  auto Evict(frame_id_t *frame_id) -> bool override;
 
-  void Pin(frame_id_t frame_id) override;
+  void RecordAccess(frame_id_t frame_id, page_id_t page_id) override;
 
-  void Unpin(frame_id_t frame_id) override;
+  void SetEvictable(frame_id_t frame_id, bool set_evictable) override;
+
+  void Remove(frame_id_t frame_id) override;
 
   auto Size() -> size_t override;
 
+  void Resize(size_t num_frames) override;
+
+  auto GetPriorityOrder() -> std::vector<frame_id_t> override;
+
  private:
-  // TODO(student): implement me!
+  struct FrameEntry {
+    bool tracked_{false};
+    bool evictable_{false};
+    bool referenced_{false};
+  };
+
+  std::mutex latch_;
+  size_t curr_size_{0};
+  /** The next frame the clock hand looks at. */
+  size_t hand_{0};
+  /** Frame state, indexed by frame id. */
+  std::vector<FrameEntry> frames_;
 };
 
 }  // namespace bustub
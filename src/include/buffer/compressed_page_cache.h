@@ -0,0 +1,138 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// compressed_page_cache.h
+//
+// Identification: src/include/buffer/compressed_page_cache.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "common/config.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+/** A point-in-time copy of the counters of a CompressedPageCache. */
+struct CompressedPageCacheStats {
+  /** @return hits / (hits + misses), or 0 if there were no lookups */
+  auto HitRatio() const -> double;
+
+  /** @return the size of the pages stored over their compressed size, or 0 if none was stored */
+  auto CompressionRatio() const -> double;
+
+  /** Misses of the buffer pool served from the cache. */
+  uint64_t hits_{0};
+  /** Misses of the buffer pool that had to read the page from disk. */
+  uint64_t misses_{0};
+  /** Pages compressed and stored. */
+  uint64_t insertions_{0};
+  /** Pages not stored because they did not compress well enough. */
+  uint64_t rejections_{0};
+  /** Pages dropped to make room for newer ones. */
+  uint64_t evictions_{0};
+  /** Sum of the uncompressed and compressed sizes of the pages stored. */
+  uint64_t uncompressed_bytes_{0};
+  uint64_t compressed_bytes_{0};
+  /** Pages currently cached, and the bytes of the region they use. */
+  uint64_t num_pages_{0};
+  uint64_t used_bytes_{0};
+};
+
+/**
+ * CompressedPageCache is a second-level cache between the buffer pool and the disk. The buffer pool hands it the clean
+ * pages it evicts; they are compressed with LZCodec into a fixed-size memory region, and a later miss on one of them
+ * decompresses it instead of reading the disk.
+ *
+ * The cache is exclusive: a page leaves it when it goes back to the buffer pool, so a page is never both resident and
+ * cached, and the buffer pool only needs to drop the cached copy of a page whose disk copy changes without it being
+ * fetched (deleted or written back dirty). Since a page is read back at most once, the region is a ring written in
+ * insertion order: making room drops the oldest pages, and a page taken out leaves a hole until the ring comes back.
+ *
+ * A single cache may be shared by the instances of a parallel buffer pool. All methods are thread-safe.
+ */
+class CompressedPageCache {
+ public:
+  /** Pages that compress to more than this are not worth the CPU of decompressing them, see Insert(). */
+  static constexpr size_t MAX_COMPRESSED_PAGE_SIZE = BUSTUB_PAGE_SIZE - BUSTUB_PAGE_SIZE / 8;
+
+  /**
+   * @brief Create a new CompressedPageCache.
+   * @param capacity the size of the memory region holding the compressed pages, in bytes
+   */
+  explicit CompressedPageCache(size_t capacity);
+
+  DISALLOW_COPY_AND_MOVE(CompressedPageCache);
+
+  /**
+   * @brief Store a clean page evicted from the buffer pool, dropping the oldest pages if the region is full. A page
+   * that compresses to more than MAX_COMPRESSED_PAGE_SIZE is not stored. The compression runs outside the cache latch.
+   * @param page_id the page
+   * @param data the contents of the page, equal to its disk copy
+   */
+  void Insert(page_id_t page_id, const char *data);
+
+  /**
+   * @brief Take a page out of the cache.
+   * @param page_id the page
+   * @param[out] data the contents of the page, if it was cached
+   * @return true if the page was cached
+   */
+  auto Take(page_id_t page_id, char *data) -> bool;
+
+  /** @brief Drop the cached copy of a page, if any, because its disk copy is about to change. */
+  void Invalidate(page_id_t page_id);
+
+  /** @return the size of the memory region, in bytes */
+  auto GetCapacity() const -> size_t { return capacity_; }
+
+  /** @return a snapshot of the counters */
+  auto GetStats() -> CompressedPageCacheStats;
+
+  /** @return the counters as (name, value) rows, for display */
+  static auto ToRows(const CompressedPageCacheStats &stats) -> std::vector<std::pair<std::string, std::string>>;
+
+ private:
+  /** Where a page is stored in the region. */
+  struct Slot {
+    page_id_t page_id_;
+    size_t offset_;
+    size_t size_;
+  };
+
+  /** @return true if the slot still holds its page, rather than a hole left by Take() or Invalidate() */
+  auto IsLive(const Slot &slot) const -> bool;
+
+  /** @brief Drop the cached copy of a page. Caller should hold the latch. */
+  void Erase(page_id_t page_id);
+
+  /** @return the offset of size free bytes, dropping the oldest pages in the way. Caller should hold the latch. */
+  auto Allocate(size_t size) -> size_t;
+
+  const size_t capacity_;
+  std::unique_ptr<char[]> region_;
+
+  std::mutex latch_;
+  /** Where the next page is written. */
+  size_t head_{0};
+  /** Every slot written since the ring last passed over it, oldest first. */
+  std::deque<Slot> slots_;
+  /** The live slot of every cached page. */
+  std::unordered_map<page_id_t, Slot> index_;
+  CompressedPageCacheStats stats_;
+};
+
+}  // namespace bustub
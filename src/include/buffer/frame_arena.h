@@ -0,0 +1,68 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// frame_arena.h
+//
+// Identification: src/include/buffer/frame_arena.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstddef>
+
+#include "common/config.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+/**
+ * FrameArena is the single block of memory holding the data of every frame of a buffer pool. It is mapped anonymously,
+ * so every frame is aligned to BUSTUB_PAGE_SIZE and can be the target of O_DIRECT I/O. The frame metadata (the Page
+ * objects) lives separately, so that the data of consecutive frames is contiguous.
+ *
+ * If huge pages are requested, the arena is first mapped with MAP_HUGETLB. When no huge pages are reserved, it falls
+ * back to a regular mapping and asks for transparent huge pages instead.
+ */
+class FrameArena {
+ public:
+  /**
+   * @brief Maps the arena.
+   * @param num_frames number of frames in the arena
+   * @param huge_pages whether to back the arena with huge pages
+   */
+  FrameArena(size_t num_frames, bool huge_pages);
+
+  /** @brief Unmaps the arena. */
+  ~FrameArena();
+
+  DISALLOW_COPY_AND_MOVE(FrameArena);
+
+  /** @return the data of the given frame */
+  inline auto GetFrameData(size_t frame_id) -> char * { return data_ + frame_id * BUSTUB_PAGE_SIZE; }
+
+  /**
+   * @brief Give the memory of frames [first_frame_id, first_frame_id + num_frames) back to the OS. The frames stay
+   * mapped and read as zeroes until they are written again. Best effort: huge pages are only released whole.
+   */
+  void Release(size_t first_frame_id, size_t num_frames);
+
+  /** @return true if the arena is mapped with MAP_HUGETLB */
+  inline auto IsHugeTlb() const -> bool { return huge_tlb_; }
+
+  /** @return the size of the mapping in bytes */
+  inline auto GetMappedSize() const -> size_t { return mapped_size_; }
+
+  /** The size of a huge page on x86-64 and aarch64 with 4 KB base pages. */
+  static constexpr size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+ private:
+  char *data_;
+  size_t mapped_size_;
+  bool huge_tlb_{false};
+};
+
+}  // namespace bustub
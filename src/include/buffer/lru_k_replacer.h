@@ -12,14 +12,14 @@
 
 #pragma once
 
-#include <algorithm>
 #include <cstddef>
-#include <limits>
-#include <list>
+#include <functional>
 #include <mutex>  // NOLINT
-#include <unordered_map>
+#include <queue>
+#include <utility>
 #include <vector>
 
+#include "buffer/replacer.h"
 #include "common/config.h"
 #include "common/logger.h"
 #include "common/macros.h"
@@ -36,8 +36,14 @@ namespace bustub {
  * A frame with less than k historical references is given
  * +inf as its backward k-distance. When multiple frames have +inf backward k-distance,
  * classical LRU algorithm is used to choose victim.
+ *
+ * Frame state lives in flat arrays indexed by frame id: each frame keeps a ring of its last k access timestamps, so
+ * the oldest entry of the ring is either its first access (fewer than k accesses) or its k-th most recent access.
+ * Evictable frames are ordered in a min-heap on that timestamp, with +inf frames ahead of all others. The heap is
+ * maintained lazily: RecordAccess, SetEvictable and Remove only touch the frame's own state in O(1), and Evict
+ * discards or re-keys stale heap entries as it pops them, which keeps it at amortized O(log n).
  */
-class LRUKReplacer {
+class LRUKReplacer : public Replacer {
  public:
   /**
    *
@@ -55,7 +61,7 @@ class LRUKReplacer {
    *
    * @brief Destroys the LRUReplacer.
    */
-  ~LRUKReplacer() = default;
+  ~LRUKReplacer() override = default;
 
   /**
    * TODO(P1): Add implementation
@@ -73,7 +79,7 @@ class LRUKReplacer {
    * @param[out] frame_id id of frame that is evicted.
    * @return true if a frame is evicted successfully, false if no frames can be evicted.
    */
-  auto Evict(frame_id_t *frame_id) -> bool;
+  auto Evict(frame_id_t *frame_id) -> bool override;
 
   /**
    * TODO(P1): Add implementation
@@ -88,6 +94,9 @@ class LRUKReplacer {
    */
   void RecordAccess(frame_id_t frame_id);
 
+  /** @brief Record an access to a frame. LRU-K only looks at the frame's own history, so the page id is ignored. */
+  void RecordAccess(frame_id_t frame_id, page_id_t page_id) override { RecordAccess(frame_id); }
+
   /**
    * TODO(P1): Add implementation
    *
@@ -105,7 +114,7 @@ class LRUKReplacer {
    * @param frame_id id of frame whose 'evictable' status will be modified
    * @param set_evictable whether the given frame is evictable or not
    */
-  void SetEvictable(frame_id_t frame_id, bool set_evictable);
+  void SetEvictable(frame_id_t frame_id, bool set_evictable) override;
 
   /**
    * TODO(P1): Add implementation
@@ -124,7 +133,7 @@ class LRUKReplacer {
    *
    * @param frame_id id of frame to be removed
    */
-  void Remove(frame_id_t frame_id);
+  void Remove(frame_id_t frame_id) override;
 
   /**
    * TODO(P1): Add implementation
@@ -133,23 +142,55 @@ class LRUKReplacer {
    *
    * @return size_t
    */
-  auto Size() -> size_t;
+  auto Size() -> size_t override;
+
+  /**
+   * @brief Change the number of frames, keeping the access history of the frames that are kept. Frames being dropped
+   * must have been removed.
+   */
+  void Resize(size_t num_frames) override;
+
+  auto GetPriorityOrder() -> std::vector<frame_id_t> override;
+
+ private:
+  /** Per-frame replacement state. The frame's access timestamps live in `history_`. */
   struct FrameEntry {
-    size_t hit_count_{0};
-    bool set_evictable_{true};
+    /** Number of access timestamps kept for the frame, at most k. */
+    size_t history_size_{0};
+    /** Position of the oldest kept timestamp in the frame's ring. */
+    size_t history_head_{0};
+    /** True if the frame has access history in the replacer. */
+    bool tracked_{false};
+    bool evictable_{false};
+    /** True if the frame has exactly one (possibly stale) entry in `heap_` or `pending_`. */
+    bool queued_{false};
   };
 
- private:
-  // TODO(student): implement me! You can replace these member variables as you like.
-  // Remove maybe_unused if you start using them.
-  [[maybe_unused]] size_t current_timestamp_{0};
+  /** Heap entries are (eviction key, frame id); the smallest key is evicted first. */
+  using HeapEntry = std::pair<size_t, frame_id_t>;
+
+  /** Keys of frames with k accesses have this bit set, so that frames with +inf k-distance always sort first. */
+  static constexpr size_t FULL_HISTORY_BIT = size_t{1} << 63;
+
+  /** @return the eviction key of a tracked frame. Caller must hold the latch. */
+  auto EvictionKey(frame_id_t frame_id) const -> size_t;
+
+  /** Queues a tracked, evictable frame for (re-)insertion into the heap unless it is already there. */
+  void Enqueue(frame_id_t frame_id);
+
+  size_t current_timestamp_{0};
   size_t curr_size_{0};
-  [[maybe_unused]] size_t replacer_size_;
-  [[maybe_unused]] size_t k_;
+  size_t replacer_size_;
+  size_t k_;
   std::mutex latch_;
-  std::unordered_map<frame_id_t, FrameEntry> frame_info_;
-  std::list<frame_id_t> fifo_;
-  std::list<frame_id_t> lru_;
+  /** Frame state, indexed by frame id. */
+  std::vector<FrameEntry> frames_;
+  /** Ring buffers of the last k access timestamps of every frame; frame f owns [f * k, (f + 1) * k). */
+  std::vector<size_t> history_;
+  /** Min-heap of evictable frames, keyed by EvictionKey(). Entries may be stale; Evict() revalidates them. */
+  std::priority_queue<HeapEntry, std::vector<HeapEntry>, std::greater<>> heap_;
+  /** Frames that became evictable since the last Evict(), pushed into the heap lazily. */
+  std::vector<frame_id_t> pending_;
 };
 
 }  // namespace bustub
@@ -6,7 +6,7 @@
 //
 // Identification: src/include/buffer/lru_replacer.h
 //
-// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
 //
 //===----------------------------------------------------------------------===//
 
@@ -37,16 +37,34 @@ class LRUReplacer : public Replacer {
    */
   ~LRUReplacer() override;
 
-  auto Victim(frame_id_t *frame_id) -> bool override;
+  auto Evict(frame_id_t *frame_id) -> bool override;
 
-  void Pin(frame_id_t frame_id) override;
+  void RecordAccess(frame_id_t frame_id, page_id_t page_id) override;
 
-  void Unpin(frame_id_t frame_id) override;
+  void SetEvictable(frame_id_t frame_id, bool set_evictable) override;
+
+  void Remove(frame_id_t frame_id) override;
 
   auto Size() -> size_t override;
 
+  void Resize(size_t num_frames) override;
+
+  auto GetPriorityOrder() -> std::vector<frame_id_t> override;
+
  private:
-  // TODO(student): implement me!
+  struct FrameEntry {
+    bool tracked_{false};
+    bool evictable_{false};
+    /** Position of the frame in lru_list_, valid if tracked_. */
+    std::list<frame_id_t>::iterator pos_;
+  };
+
+  std::mutex latch_;
+  size_t curr_size_{0};
+  /** Frame state, indexed by frame id. */
+  std::vector<FrameEntry> frames_;
+  /** Tracked frames, most recently accessed first. */
+  std::list<frame_id_t> lru_list_;
 };
 
 }  // namespace bustub
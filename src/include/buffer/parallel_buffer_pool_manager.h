@@ -0,0 +1,211 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// parallel_buffer_pool_manager.h
+//
+// Identification: src/include/buffer/parallel_buffer_pool_manager.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "buffer/buffer_pool_manager_instance.h"
+#include "recovery/log_manager.h"
+#include "storage/disk/disk_manager.h"
+#include "storage/page/page.h"
+
+namespace bustub {
+
+/**
+ * ParallelBufferPoolManager shards the buffer pool across several BufferPoolManagerInstances so that threads touching
+ * different pages do not contend on a single latch. Page `p` always lives in instance `p % num_instances`; each
+ * instance owns its own page table, replacer and free list.
+ */
+class ParallelBufferPoolManager : public BufferPoolManager {
+ public:
+  /**
+   * Creates a new ParallelBufferPoolManager.
+   * @param num_instances the number of individual BufferPoolManagerInstances to store
+   * @param pool_size the pool size of each BufferPoolManagerInstance
+   * @param disk_manager the disk manager
+   * @param replacer_k the lookback constant k, if the replacement policy is LRU-K
+   * @param log_manager the log manager (for testing only: nullptr = disable logging)
+   * @param page_allocator the free-space bitmap shared by all instances (nullptr = allocate page ids sequentially)
+   * @param replacer_type the replacement policy of each instance
+   */
+  ParallelBufferPoolManager(size_t num_instances, size_t pool_size, DiskManager *disk_manager,
+                            size_t replacer_k = LRUK_REPLACER_K, LogManager *log_manager = nullptr,
+                            PageAllocator *page_allocator = nullptr, ReplacerType replacer_type = ReplacerType::LRU_K);
+
+  /**
+   * Destroys an existing ParallelBufferPoolManager.
+   */
+  ~ParallelBufferPoolManager() override;
+
+  /** @return size of the buffer pool, i.e. the sum of the pool sizes of all instances */
+  auto GetPoolSize() -> size_t override;
+
+  /**
+   * Resize every instance so that their pool sizes add up to pool_size, spread as evenly as possible.
+   * @param pool_size the new total number of frames, at least the number of instances
+   * @return false if an instance could not shrink because of pinned frames; the other instances are still resized
+   */
+  auto Resize(size_t pool_size) -> bool override;
+
+  /** @return the number of instances the pages are sharded across */
+  auto GetNumInstances() const -> size_t { return instances_.size(); }
+
+  /**
+   * @param page_id id of page
+   * @return pointer to the BufferPoolManagerInstance responsible for handling given page id
+   */
+  auto GetBufferPoolManager(page_id_t page_id) -> BufferPoolManagerInstance *;
+
+  /**
+   * Queue pages [start_page_id, start_page_id + num_pages) for read-ahead; each instance reads the pages it owns.
+   * @param start_page_id id of the first page to read
+   * @param num_pages number of pages to read
+   */
+  void PrefetchPages(page_id_t start_page_id, size_t num_pages) override;
+
+  /**
+   * Load the missing pages into the instances that own them, with one read for all instances.
+   * @param page_ids the pages to load, in increasing order
+   * @return the number of pages put into the buffer pool
+   */
+  auto LoadPages(const std::vector<page_id_t> &page_ids) -> size_t override;
+
+  /** @return the resident pages of all instances, interleaving their priority orders */
+  auto GetResidentPages() -> std::vector<page_id_t> override;
+
+  /** @brief Start the background flusher of every instance, with the watermarks from config.h. */
+  void StartBackgroundFlusher();
+
+  /** @brief Stop the background flusher of every instance. */
+  void StopBackgroundFlusher();
+
+  /** @return the number of pages written by foreground threads, summed over all instances */
+  auto GetForegroundWriteCount() const -> size_t;
+
+  /** @return the number of pages written by the background flushers, summed over all instances */
+  auto GetBackgroundWriteCount() const -> size_t;
+
+  /** @return the counters of all instances, summed */
+  auto GetStats() -> BufferPoolStatsSnapshot override;
+
+  /** Record the page accesses of every instance into the same trace, or stop recording if nullptr. */
+  void SetAccessTrace(AccessTrace *trace) override;
+
+  /** Share a compressed page cache between every instance, or stop using it if nullptr. */
+  void SetCompressedPageCache(CompressedPageCache *cache) override;
+
+  /** Read the pages missed by every instance through the same scheduler, or stop using it if nullptr. */
+  void SetDiskScheduler(DiskScheduler *scheduler) override;
+
+ protected:
+  /**
+   * Fetch the requested page from the buffer pool.
+   * @param page_id id of page to be fetched
+   * @return the requested page
+   */
+  auto FetchPgImp(page_id_t page_id) -> Page * override;
+
+  /**
+   * Fetch the requested page from the buffer pool on behalf of a bulk operation.
+   * @param page_id id of page to be fetched
+   * @param strategy the access strategy of the bulk operation, or nullptr
+   * @return the requested page
+   */
+  auto FetchPgStrategyImp(page_id_t page_id, BufferAccessStrategy *strategy) -> Page * override;
+
+  /**
+   * Fetch a page that will only be read.
+   * @param page_id id of page to be fetched
+   * @param strategy the access strategy of a bulk operation, or nullptr
+   * @return the requested page
+   */
+  auto FetchPgReadOnlyImp(page_id_t page_id, BufferAccessStrategy *strategy) -> Page * override;
+
+  /**
+   * Unpin the target page from the buffer pool.
+   * @param page_id id of page to be unpinned
+   * @param is_dirty true if the page should be marked as dirty, false otherwise
+   * @return false if the page pin count is <= 0 before this call, true otherwise
+   */
+  auto UnpinPgImp(page_id_t page_id, bool is_dirty) -> bool override;
+
+  /**
+   * Flushes the target page to disk.
+   * @param page_id id of page to be flushed, cannot be INVALID_PAGE_ID
+   * @return false if the page could not be found in the page table, true otherwise
+   */
+  auto FlushPgImp(page_id_t page_id) -> bool override;
+
+  /**
+   * Creates a new page in the buffer pool. Instances are tried in round-robin order, starting one past the instance
+   * that served the previous call, so that allocations are spread evenly across the shards.
+   * @param[out] page_id id of created page
+   * @return nullptr if no new pages could be created, otherwise pointer to new page
+   */
+  auto NewPgImp(page_id_t *page_id) -> Page * override;
+
+  /**
+   * Creates a new page in the buffer pool on behalf of a bulk operation, probing the instances like NewPgImp().
+   * @param[out] page_id id of created page
+   * @param strategy the access strategy of the bulk operation, or nullptr
+   * @return nullptr if no new pages could be created, otherwise pointer to new page
+   */
+  auto NewPgStrategyImp(page_id_t *page_id, BufferAccessStrategy *strategy) -> Page * override;
+
+  /**
+   * Creates a new page of a table heap or an index in the buffer pool. The page is the next one of the segment's
+   * extent, which spans the instances, and is created by the instance it belongs to, see AllocateExtent().
+   * @param[out] page_id id of created page
+   * @param segment the segment of the table heap or index
+   * @param strategy the access strategy of a bulk operation, or nullptr
+   * @return nullptr if no new pages could be created, otherwise pointer to new page
+   */
+  auto NewPgSegmentImp(page_id_t *page_id, PageSegment *segment, BufferAccessStrategy *strategy) -> Page * override;
+
+  /**
+   * Deletes a page from the buffer pool.
+   * @param page_id id of page to be deleted
+   * @return false if the page exists but could not be deleted, true if the page didn't exist or deletion succeeded
+   */
+  auto DeletePgImp(page_id_t page_id) -> bool override;
+
+  /**
+   * Flushes all the pages in the buffer pool to disk.
+   */
+  void FlushAllPgsImp() override;
+
+ private:
+  /**
+   * Allocates EXTENT_SIZE contiguous page ids for a segment, from the page allocator if there is one. Otherwise the
+   * extent starts past the last page any instance has allocated, and every instance skips it.
+   * @return the first page of the extent
+   */
+  auto AllocateExtent() -> page_id_t;
+
+  /** The instances the pages are sharded across. */
+  std::vector<std::unique_ptr<BufferPoolManagerInstance>> instances_;
+  /** Instance that the next NewPgImp call starts probing from. */
+  std::atomic<size_t> next_instance_{0};
+  /** The disk manager shared by the instances, for the reads of LoadPages() that span all of them. */
+  DiskManager *disk_manager_;
+  /** The free-space bitmap shared by the instances, or nullptr. */
+  PageAllocator *page_allocator_;
+  /** Serializes AllocateExtent() without a page allocator. */
+  std::mutex extent_latch_;
+};
+
+}  // namespace bustub
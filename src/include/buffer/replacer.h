@@ -12,12 +12,31 @@
 
 #pragma once
 
+#include <memory>
+#include <vector>
+
 #include "common/config.h"
 
 namespace bustub {
 
+/** The replacement policies a buffer pool manager can be constructed with. */
+enum class ReplacerType {
+  /** Least recently used. */
+  LRU,
+  /** Clock (second chance), an approximation of LRU. */
+  CLOCK,
+  /** LRU-K: evicts the frame whose k-th most recent access is the oldest. */
+  LRU_K,
+  /** Adaptive replacement cache: balances recency and frequency with ghost lists of recently evicted pages. */
+  ARC,
+  /** 2Q: pages seen once go through a FIFO, pages seen again while remembered go to an LRU list. */
+  TWO_Q
+};
+
 /**
- * Replacer is an abstract class that tracks page usage.
+ * Replacer is an abstract class that tracks frame usage and picks the frame to evict. A frame enters the replacer on
+ * its first recorded access and starts out evictable; the buffer pool manager marks it non-evictable while it is
+ * pinned. Implementations are thread-safe.
  */
 class Replacer {
  public:
@@ -25,26 +44,57 @@ class Replacer {
   virtual ~Replacer() = default;
 
   /**
-   * Remove the victim frame as defined by the replacement policy.
-   * @param[out] frame_id id of frame that was removed, nullptr if no victim was found
-   * @return true if a victim frame was found, false otherwise
+   * Evict a frame, as defined by the replacement policy. Only evictable frames are candidates.
+   * @param[out] frame_id id of the evicted frame
+   * @return true if a frame was evicted, false if no frame is evictable
+   */
+  virtual auto Evict(frame_id_t *frame_id) -> bool = 0;
+
+  /**
+   * Record an access to a frame. Policies that remember evicted pages (ARC, 2Q) use the page id to recognize a page
+   * that comes back, whatever frame it lands in.
+   * @param frame_id id of the accessed frame
+   * @param page_id id of the page held by the frame
    */
-  virtual auto Victim(frame_id_t *frame_id) -> bool = 0;
+  virtual void RecordAccess(frame_id_t frame_id, page_id_t page_id) = 0;
 
   /**
-   * Pins a frame, indicating that it should not be victimized until it is unpinned.
-   * @param frame_id the id of the frame to pin
+   * Toggle whether a frame can be evicted. Does nothing if the frame is not in the replacer.
+   * @param frame_id id of the frame
+   * @param set_evictable whether the frame can be evicted
    */
-  virtual void Pin(frame_id_t frame_id) = 0;
+  virtual void SetEvictable(frame_id_t frame_id, bool set_evictable) = 0;
 
   /**
-   * Unpins a frame, indicating that it can now be victimized.
-   * @param frame_id the id of the frame to unpin
+   * Remove an evictable frame from the replacer without evicting it, e.g. because its page was deleted. Unlike
+   * Evict(), the page is not remembered. Does nothing if the frame is not in the replacer.
+   * @param frame_id id of the frame
    */
-  virtual void Unpin(frame_id_t frame_id) = 0;
+  virtual void Remove(frame_id_t frame_id) = 0;
 
-  /** @return the number of elements in the replacer that can be victimized */
+  /** @return the number of evictable frames */
   virtual auto Size() -> size_t = 0;
+
+  /**
+   * Change the number of frames the replacer can track, when the buffer pool is resized. The state of the frames that
+   * are kept is preserved.
+   * @param num_frames the new number of frames; when shrinking, the frames being dropped must not be in the replacer
+   */
+  virtual void Resize(size_t num_frames) = 0;
+
+  /**
+   * @return the tracked frames, pinned or not, from the one the policy would keep longest to the one it would evict
+   * first. Used to persist the hottest pages of the buffer pool across restarts.
+   */
+  virtual auto GetPriorityOrder() -> std::vector<frame_id_t> = 0;
+
+  /**
+   * Create a replacer.
+   * @param type the replacement policy
+   * @param num_frames the number of frames of the buffer pool
+   * @param k the lookback constant k, only used by LRU-K
+   */
+  static auto Create(ReplacerType type, size_t num_frames, size_t k) -> std::unique_ptr<Replacer>;
 };
 
 }  // namespace bustub
@@ -0,0 +1,94 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// two_queue_replacer.h
+//
+// Identification: src/include/buffer/two_queue_replacer.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <list>
+#include <mutex>  // NOLINT
+#include <unordered_map>
+#include <vector>
+
+#include "buffer/replacer.h"
+#include "common/config.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+/**
+ * TwoQueueReplacer implements the full 2Q policy (Johnson and Shasha, VLDB 1994).
+ *
+ * A page that enters the buffer pool goes to the FIFO A1in, where further accesses do not move it: they are assumed
+ * to be correlated with the first one. When A1in holds more than Kin frames it is trimmed first, and the ids of the
+ * pages it evicts are remembered in the ghost FIFO A1out (at most Kout pages). Only a page that comes back while in
+ * A1out is promoted to Am, an LRU list of the pages that proved to be hot.
+ */
+class TwoQueueReplacer : public Replacer {
+ public:
+  /**
+   * @brief Create a new TwoQueueReplacer, with Kin = 25% and Kout = 50% of the frames as recommended by the paper.
+   * @param num_frames the number of frames of the buffer pool
+   */
+  explicit TwoQueueReplacer(size_t num_frames);
+
+  DISALLOW_COPY_AND_MOVE(TwoQueueReplacer);
+
+  ~TwoQueueReplacer() override = default;
+
+  auto Evict(frame_id_t *frame_id) -> bool override;
+
+  void RecordAccess(frame_id_t frame_id, page_id_t page_id) override;
+
+  void SetEvictable(frame_id_t frame_id, bool set_evictable) override;
+
+  void Remove(frame_id_t frame_id) override;
+
+  auto Size() -> size_t override;
+
+  void Resize(size_t num_frames) override;
+
+  auto GetPriorityOrder() -> std::vector<frame_id_t> override;
+
+ private:
+  enum class ListId : uint8_t { NONE, A1IN, AM };
+
+  struct FrameEntry {
+    ListId list_{ListId::NONE};
+    bool evictable_{false};
+    page_id_t page_id_{INVALID_PAGE_ID};
+    /** Position of the frame in a1in_ or am_, valid if list_ is not NONE. */
+    std::list<frame_id_t>::iterator pos_;
+  };
+
+  /**
+   * Evicts the oldest evictable frame of a resident list, remembering its page in A1out if the list is A1in.
+   * @return false if the list has no evictable frame
+   */
+  auto EvictFrom(std::list<frame_id_t> *list, frame_id_t *frame_id) -> bool;
+
+  std::mutex latch_;
+  size_t curr_size_{0};
+  /** Maximum size of A1in before it is trimmed first. */
+  size_t kin_;
+  /** Maximum size of A1out. */
+  size_t kout_;
+  /** Frame state, indexed by frame id. */
+  std::vector<FrameEntry> frames_;
+  /** Resident frames seen once, newest first. */
+  std::list<frame_id_t> a1in_;
+  /** Resident hot frames, most recently used first. */
+  std::list<frame_id_t> am_;
+  /** Ids of the pages recently evicted from A1in, newest first, with an index for lookups. */
+  std::list<page_id_t> a1out_;
+  std::unordered_map<page_id_t, std::list<page_id_t>::iterator> a1out_index_;
+};
+
+}  // namespace bustub
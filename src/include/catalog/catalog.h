@@ -20,9 +20,11 @@
 
 #include "buffer/buffer_pool_manager.h"
 #include "catalog/schema.h"
+#include "common/config.h"
 #include "container/hash/hash_function.h"
 #include "storage/index/b_plus_tree_index.h"
 #include "storage/index/extendible_hash_table_index.h"
+#include "storage/index/external_sorter.h"
 #include "storage/index/index.h"
 #include "storage/table/table_heap.h"
 
@@ -228,12 +230,35 @@ class Catalog {
     // TODO(chi): support both hash index and btree index
     auto index = std::make_unique<BPlusTreeIndex<KeyType, ValueType, KeyComparator>>(std::move(meta), bpm_);
 
-    // Populate the index with all tuples in table heap
+    // Populate the index with all tuples in table heap: sort their keys, spilling to disk if there are too many to
+    // sort in memory, then build the tree bottom up rather than inserting the keys one by one
+    struct Entry {
+      KeyType key_;
+      ValueType value_;
+    };
+    KeyComparator comparator(index->GetKeySchema());
+    auto less = [&comparator](const Entry &a, const Entry &b) { return comparator(a.key_, b.key_) < 0; };
+    ExternalSorter<Entry, decltype(less)> sorter(less, index_build_sort_memory);
     auto *table_meta = GetTable(table_name);
     auto *heap = table_meta->table_.get();
     for (auto tuple = heap->Begin(txn); tuple != heap->End(); ++tuple) {
-      index->InsertEntry(tuple->KeyFromTuple(schema, key_schema, key_attrs), tuple->GetRid(), txn);
+      Entry entry;
+      entry.key_.SetFromKey(tuple->KeyFromTuple(schema, key_schema, key_attrs));
+      entry.value_ = tuple->GetRid();
+      sorter.Add(entry);
     }
+    sorter.Finish();
+    index->BulkLoad(
+        [&sorter](KeyType *key, ValueType *value) {
+          Entry entry;
+          if (!sorter.Next(&entry)) {
+            return false;
+          }
+          *key = entry.key_;
+          *value = entry.value_;
+          return true;
+        },
+        INDEX_BUILD_FILL_FACTOR);
 
     // Get the next OID for the new index
     const auto index_oid = next_index_oid_.fetch_add(1);
@@ -36,6 +36,11 @@ class LogManager;
 class CheckpointManager;
 class Catalog;
 class ExecutionEngine;
+class AccessTrace;
+class BufferPoolWarmer;
+class CompressedPageCache;
+class DiskScheduler;
+class PageAllocator;
 
 class ResultWriter {
  public:
@@ -217,6 +222,11 @@ class BustubInstance {
    */
   void GenerateMockTable();
 
+  /**
+   * Wait until the pages that were resident at the last shutdown are back in the buffer pool, as far as they fit.
+   */
+  void WaitForWarmUp();
+
   // TODO(chi): change to unique_ptr. Currently they're directly referenced by recovery test, so
   // we cannot do anything on them until someone decides to refactor the recovery test.
 
@@ -230,9 +240,22 @@ class BustubInstance {
   ExecutionEngine *execution_engine_;
 
  private:
+  /** The page access trace being recorded by `\trace`, or nullptr. */
+  AccessTrace *access_trace_{nullptr};
+  /** Saves the resident page set of the buffer pool next to the database file and preloads it on startup. */
+  BufferPoolWarmer *buffer_pool_warmer_{nullptr};
+  CompressedPageCache *compressed_page_cache_{nullptr};
+  /** Tracks the pages of the database file in use, so that deleted pages are reused and survive a restart. */
+  PageAllocator *page_allocator_{nullptr};
+  /** Reads the pages missed by the buffer pool if enable_async_disk_io is set, or nullptr. */
+  DiskScheduler *disk_scheduler_{nullptr};
+
   void CmdDisplayTables(ResultWriter &writer);
   void CmdDisplayIndices(ResultWriter &writer);
   void CmdDisplayHelp(ResultWriter &writer);
+  void CmdDisplayStats(ResultWriter &writer);
+  void CmdTrace(const std::string &args, ResultWriter &writer);
+  void CmdResize(const std::string &args, ResultWriter &writer);
   void WriteOneCell(const std::string &cell, ResultWriter &writer);
 };
 
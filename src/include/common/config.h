@@ -16,6 +16,11 @@
 #include <chrono>  // NOLINT
 #include <cstdint>
 
+/** The page size is a build option, see BUSTUB_PAGE_SIZE in CMakeLists.txt. */
+#ifndef BUSTUB_PAGE_SIZE_BYTES
+#define BUSTUB_PAGE_SIZE_BYTES 4096
+#endif
+
 namespace bustub {
 
 /** Cycle detection is performed every CYCLE_DETECTION_INTERVAL milliseconds. */
@@ -27,15 +32,51 @@ extern std::atomic<bool> enable_logging;
 /** If ENABLE_LOGGING is true, the log should be flushed to disk every LOG_TIMEOUT. */
 extern std::chrono::duration<int64_t> log_timeout;
 
+/** The background flusher of the buffer pool checks the number of clean frames every BG_FLUSH_INTERVAL. */
+extern std::chrono::milliseconds bg_flush_interval;
+
+/** Whether buffer pools back their frames with huge pages, see FrameArena. */
+extern std::atomic<bool> enable_huge_pages;
+
+/** How long shrinking a buffer pool waits for the frames it drops to be unpinned before it gives up. */
+extern std::chrono::milliseconds buffer_pool_resize_timeout;
+
+/** How often BustubInstance saves the resident page set of its buffer pool, for the warm-up of the next start. */
+extern std::chrono::milliseconds buffer_pool_dump_interval;
+
+/** Size in bytes of the compressed cache BustubInstance keeps behind its buffer pool, 0 to disable it. */
+extern size_t compressed_page_cache_size;
+
+/** Whether BustubInstance reads the pages of its buffer pool through a DiskScheduler, see DiskScheduler. */
+extern std::atomic<bool> enable_async_disk_io;
+
+/** Memory in bytes the sort of the keys of CREATE INDEX may use before it spills sorted runs to disk. */
+extern size_t index_build_sort_memory;
+
 static constexpr int INVALID_PAGE_ID = -1;                                           // invalid page id
 static constexpr int INVALID_TXN_ID = -1;                                            // invalid transaction id
 static constexpr int INVALID_LSN = -1;                                               // invalid log sequence number
 static constexpr int HEADER_PAGE_ID = 0;                                             // the header page id
-static constexpr int BUSTUB_PAGE_SIZE = 4096;                                        // size of a data page in byte
-static constexpr int BUFFER_POOL_SIZE = 10;                                          // size of buffer pool
+static constexpr int BUSTUB_PAGE_SIZE = BUSTUB_PAGE_SIZE_BYTES;                      // size of a data page in byte
+static constexpr int BUFFER_POOL_SIZE = 10;                                          // initial size of buffer pool
 static constexpr int LOG_BUFFER_SIZE = ((BUFFER_POOL_SIZE + 1) * BUSTUB_PAGE_SIZE);  // size of a log buffer in byte
 static constexpr int BUCKET_SIZE = 50;                                               // size of extendible hash bucket
 static constexpr int LRUK_REPLACER_K = 10;  // lookback window for lru-k replacer
+static constexpr int BG_FLUSH_LOW_WATERMARK_PCT = 10;   // % of clean frames below which the bg flusher kicks in
+static constexpr int BG_FLUSH_HIGH_WATERMARK_PCT = 25;  // % of clean frames the bg flusher cleans up to
+static constexpr int BUFFER_POOL_PREFETCH_THREADS = 4;  // number of read-ahead threads per buffer pool instance
+static constexpr int BUFFER_POOL_PREFETCH_BATCH = 16;  // pages a read-ahead thread reads at once with a DiskScheduler
+static constexpr int TABLE_READ_AHEAD_PAGES = 16;       // read-ahead window of sequential table scans, in pages
+static constexpr int BUFFER_ACCESS_STRATEGY_RING_SIZE = 32;  // frames a bulk scan or insert may occupy
+static constexpr int WARMUP_MAX_RUN_PAGES = 64;  // longest sequential read of the buffer pool warm-up, in pages
+static constexpr int WARMUP_MAX_GAP_PAGES = 8;   // unwanted pages a warm-up read may span to join two runs
+static constexpr int DISK_SCHEDULER_QUEUE_DEPTH = 64;  // default maximum number of page I/Os in flight
+static constexpr int DISK_SCHEDULER_MAX_THREADS = 32;  // I/O threads of a DiskScheduler without io_uring
+static constexpr int EXTENT_SIZE = 64;  // contiguous pages a table or index allocates at a time, see PageSegment
+static constexpr double INDEX_BUILD_FILL_FACTOR = 0.9;  // fraction of the pages a bulk-loaded index fills
+
+static_assert(BUSTUB_PAGE_SIZE >= 4096 && BUSTUB_PAGE_SIZE <= 65536 && (BUSTUB_PAGE_SIZE & (BUSTUB_PAGE_SIZE - 1)) == 0,
+              "the page size must be a power of two between 4 KiB and 64 KiB");
 
 using frame_id_t = int32_t;    // frame id type
 using page_id_t = int32_t;     // page id type
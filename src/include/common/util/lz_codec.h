@@ -0,0 +1,58 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// lz_codec.h
+//
+// Identification: src/include/common/util/lz_codec.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstddef>
+
+namespace bustub {
+
+/**
+ * LZCodec is a small LZ77 codec in the spirit of LZ4, tuned for speed over ratio: a single pass with a hash table of
+ * the last position of every 4-byte sequence, and no entropy coding.
+ *
+ * The output is a series of sequences. Each starts with a token byte, whose high nibble is the number of literals and
+ * whose low nibble is the match length minus MIN_MATCH; a nibble of 15 is continued by extra bytes that are added to
+ * it, each 255 asking for one more. The literals follow, then the 2-byte little-endian offset of the match and the
+ * extra bytes of its length. The last sequence only has literals.
+ */
+class LZCodec {
+ public:
+  /** Shortest match worth encoding, in bytes. */
+  static constexpr size_t MIN_MATCH = 4;
+
+  /** @return the largest size Compress() can produce for size bytes of input */
+  static constexpr auto MaxCompressedSize(size_t size) -> size_t { return size + size / 255 + 16; }
+
+  /**
+   * @brief Compress a buffer.
+   * @param src the data to compress
+   * @param size the size of src
+   * @param[out] dst the compressed data
+   * @param capacity the size of dst
+   * @return the size of the compressed data, or 0 if it does not fit in capacity bytes
+   */
+  static auto Compress(const char *src, size_t size, char *dst, size_t capacity) -> size_t;
+
+  /**
+   * @brief Decompress a buffer written by Compress(). Corrupt input is detected rather than read or written past the
+   * buffers.
+   * @param src the compressed data
+   * @param size the size of src
+   * @param[out] dst the decompressed data
+   * @param capacity the size of dst
+   * @return the size of the decompressed data, or 0 if src is corrupt or does not fit in capacity bytes
+   */
+  static auto Decompress(const char *src, size_t size, char *dst, size_t capacity) -> size_t;
+};
+
+}  // namespace bustub
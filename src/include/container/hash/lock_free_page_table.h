@@ -0,0 +1,132 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// lock_free_page_table.h
+//
+// Identification: src/include/container/hash/lock_free_page_table.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "common/config.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+/**
+ * LockFreePageTable maps the page ids resident in a buffer pool to their frame ids.
+ *
+ * It is a fixed-capacity open-addressing hash table with linear probing. Each slot is a single 64-bit atomic word
+ * packing the page id (high half) and the frame id (low half), so a reader sees either the whole mapping or none of
+ * it. The capacity is the smallest power of two holding twice the number of frames, which bounds the load factor to
+ * 1/2, and the slot array is aligned to a cache line.
+ *
+ * Find() is lock-free and may run concurrently with anything. Insert() and Remove() publish their changes with CAS, but
+ * writers must be serialized by the caller (the buffer pool manager latch), because removes clean up tombstones in
+ * place: when the probe chain ends right after the slot of a removed mapping, that slot and the tombstones before it
+ * become empty again, and once removes have left a quarter of the capacity in tombstones, every tombstone no mapping
+ * lies past becomes empty. Without that, churn would leave tombstones until no empty slot ended the probes of a miss
+ * before it went through the whole table. Mappings are never moved, so a concurrent Find() never misses one.
+ *
+ * Resize() is a writer too. It rehashes the mappings into a new slot array and publishes it with a single pointer
+ * swap. A concurrent Find() may still be probing the old array, so retired arrays are only freed by the destructor;
+ * the buffer pool is resized rarely enough that they cost little.
+ */
+class LockFreePageTable {
+ public:
+  /**
+   * @brief Create a new LockFreePageTable.
+   * @param num_frames the maximum number of mappings the table must hold, i.e. the size of the buffer pool
+   */
+  explicit LockFreePageTable(size_t num_frames);
+
+  ~LockFreePageTable();
+
+  DISALLOW_COPY_AND_MOVE(LockFreePageTable);
+
+  /**
+   * @brief Find the frame holding a page. Lock-free.
+   * @param page_id id of the page
+   * @param[out] frame_id the frame holding the page
+   * @return true if the page is in the table
+   */
+  auto Find(page_id_t page_id, frame_id_t *frame_id) const -> bool;
+
+  /**
+   * @brief Map a page to a frame. The page must not be in the table already.
+   * @param page_id id of the page
+   * @param frame_id the frame holding the page
+   * @return false if the table is full
+   */
+  auto Insert(page_id_t page_id, frame_id_t frame_id) -> bool;
+
+  /**
+   * @brief Remove the mapping of a page.
+   * @param page_id id of the page
+   * @return true if the page was in the table
+   */
+  auto Remove(page_id_t page_id) -> bool;
+
+  /**
+   * @brief Rehash the table for a new number of frames, growing or shrinking it if its capacity changes. Readers are
+   * never blocked. Caller must serialize this with Insert() and Remove().
+   * @param num_frames the maximum number of mappings the table must hold from now on
+   */
+  void Resize(size_t num_frames);
+
+  /** @return the number of slots left as tombstones by removes, which lengthen the probes of misses */
+  auto GetNumTombstones() const -> size_t;
+
+  /** @return the number of slots of the table */
+  auto GetCapacity() const -> size_t { return table_.load(std::memory_order_acquire)->mask_ + 1; }
+
+ private:
+  static constexpr size_t CACHE_LINE_SIZE = 64;
+  /** A slot that ends every probe chain. */
+  static constexpr uint64_t EMPTY = ~uint64_t{0};
+  /** A slot whose mapping was removed, probe chains continue through it. */
+  static constexpr uint64_t TOMBSTONE = ~uint64_t{1};
+
+  static auto Pack(page_id_t page_id, frame_id_t frame_id) -> uint64_t {
+    return (static_cast<uint64_t>(static_cast<uint32_t>(page_id)) << 32) | static_cast<uint32_t>(frame_id);
+  }
+  static auto PageOf(uint64_t slot) -> page_id_t { return static_cast<page_id_t>(slot >> 32); }
+  static auto FrameOf(uint64_t slot) -> frame_id_t { return static_cast<frame_id_t>(slot & 0xFFFFFFFF); }
+
+  /** A slot array, and the parameters of its hash function. */
+  struct Table {
+    /** Bit mask of a slot index, i.e. capacity - 1. */
+    size_t mask_;
+    /** Shift applied to the hash to get the home slot, i.e. 64 - log2(capacity). */
+    int shift_;
+    std::atomic<uint64_t> *slots_;
+
+    /** @return the first slot of the probe chain of a page */
+    auto HomeSlot(page_id_t page_id) const -> size_t;
+  };
+
+  /** @return a new table of empty slots holding up to num_frames mappings at a load factor of at most 1/2 */
+  static auto NewTable(size_t num_frames) -> Table *;
+  static void DeleteTable(Table *table);
+
+  /** @brief Turn every tombstone that no probe chain of a mapping goes through back to empty. */
+  void PurgeTombstones(Table *table);
+
+  /** The current table. Readers load it once per operation. */
+  std::atomic<Table *> table_;
+  /** Tables replaced by Resize(), which a concurrent reader may still be probing. */
+  std::vector<Table *> retired_;
+  /** Tombstones left by removes since the last purge. Only touched by writers. */
+  size_t new_tombstones_{0};
+};
+
+}  // namespace bustub
@@ -17,6 +17,8 @@
 #include <future>  // NOLINT
 #include <mutex>   // NOLINT
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "common/config.h"
 
@@ -31,18 +33,20 @@ class DiskManager {
   /**
    * Creates a new disk manager that writes to the specified database file.
    * @param db_file the file name of the database file to write to
+   * @param direct_io whether to open the database file with O_DIRECT, bypassing the OS page cache so that the buffer
+   * pool is the only cache of the database pages. Falls back to buffered I/O if the file system does not support it.
    */
-  explicit DiskManager(const std::string &db_file);
+  explicit DiskManager(const std::string &db_file, bool direct_io = false);
 
   /** FOR TEST / LEADERBOARD ONLY, used by DiskManagerMemory */
   DiskManager() = default;
 
-  virtual ~DiskManager() = default;
+  virtual ~DiskManager();
 
   /**
    * Shut down the disk manager and close all the file resources.
    */
-  void ShutDown();
+  virtual void ShutDown();
 
   /**
    * Write a page to the database file.
@@ -58,6 +62,35 @@ class DiskManager {
    */
   virtual void ReadPage(page_id_t page_id, char *page_data);
 
+  /**
+   * Read a run of consecutive pages with a single sequential read. Pages past the end of the file read as zeros.
+   * @param start_page_id id of the first page
+   * @param num_pages number of pages to read
+   * @param[out] data output buffer of num_pages * BUSTUB_PAGE_SIZE bytes
+   */
+  virtual void ReadPages(page_id_t start_page_id, size_t num_pages, char *data);
+
+  /**
+   * Write a batch of pages, sorted by page id so that each run of consecutive pages goes out with a single vectored
+   * write, and make them durable with a single sync at the end.
+   * @param pages the ids and the raw data of the pages, each page at most once, in any order
+   */
+  virtual void WritePages(std::vector<std::pair<page_id_t, const char *>> pages);
+
+  /**
+   * Lend the stored copy of a page instead of reading it, if the disk manager keeps the pages in memory. The copy is
+   * read-only, reflects the later writes of the page, and stays valid until the disk manager is destroyed.
+   * @param page_id id of the page
+   * @return the page, or nullptr if it has to be read with ReadPage()
+   */
+  virtual auto GetPageView(__attribute__((unused)) page_id_t page_id) -> const char * { return nullptr; }
+
+  /**
+   * Make the pages written so far durable. DiskManager already hands every write to the OS, and syncs every O_DIRECT
+   * write, so this does nothing; subclasses that defer durability override it.
+   */
+  virtual void Sync() {}
+
   /**
    * Flush the entire log buffer into disk.
    * @param log_data raw log data
@@ -92,20 +125,59 @@ class DiskManager {
   /** Checks if the non-blocking flush future was set. */
   inline auto HasFlushLogFuture() -> bool { return flush_log_f_ != nullptr; }
 
+  /** @return true if the database file is accessed with O_DIRECT */
+  inline auto IsDirectIo() const -> bool { return db_fd_ != -1; }
+
+  /**
+   * @return the file holding page i at offset i * BUSTUB_PAGE_SIZE, which other components may then read and write
+   * directly, or an empty string if the pages are not stored that way
+   */
+  virtual auto GetPageFileName() const -> std::string { return file_name_; }
+
+  /** Alignment of the buffers, file offsets and sizes of O_DIRECT I/O. */
+  static constexpr size_t DIRECT_IO_ALIGNMENT = 4096;
+
  protected:
-  auto GetFileSize(const std::string &file_name) -> int;
+  auto GetFileSize(const std::string &file_name) -> int64_t;
+  /**
+   * Refuse a database file whose header page records another page size than BUSTUB_PAGE_SIZE, since every page layout
+   * depends on it. A file without a header page yet is accepted.
+   * @throws Exception if the page sizes differ
+   */
+  static void CheckPageSize(const std::string &db_file);
+  /**
+   * Derive the log file name from file_name_ and open the log file, creating it if needed.
+   * @return false if file_name_ has no extension, in which case there is no log file
+   */
+  auto OpenLog() -> bool;
+  /**
+   * Sort pages by page id and write them to fd, with one pwritev() per run of consecutive pages.
+   * @return false on an I/O error
+   */
+  auto WriteRuns(int fd, std::vector<std::pair<page_id_t, const char *>> *pages) -> bool;
   // stream to write log file
   std::fstream log_io_;
   std::string log_name_;
   // stream to write db file
   std::fstream db_io_;
   std::string file_name_;
-  int num_flushes_{0};
-  int num_writes_{0};
+  std::atomic<int> num_flushes_{0};
+  std::atomic<int> num_writes_{0};
   bool flush_log_{false};
   std::future<void> *flush_log_f_{nullptr};
   // With multiple buffer pool instances, need to protect file access
   std::mutex db_io_latch_;
+
+ private:
+  void ReadPageDirect(page_id_t page_id, char *page_data);
+  void WritePageDirect(page_id_t page_id, const char *page_data);
+
+  // the O_DIRECT descriptor of the db file, or -1 if the db file is accessed through db_io_
+  int db_fd_{-1};
+  // a descriptor of the db file for the vectored writes of WritePages() next to db_io_, which flushes every write
+  int batch_fd_{-1};
+  // aligned bounce buffer for O_DIRECT I/O on unaligned page buffers, protected by db_io_latch_
+  char *bounce_buffer_{nullptr};
 };
 
 }  // namespace bustub
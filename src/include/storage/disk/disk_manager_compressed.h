@@ -0,0 +1,172 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// disk_manager_compressed.h
+//
+// Identification: src/include/storage/disk/disk_manager_compressed.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <condition_variable>  // NOLINT
+#include <cstdint>
+#include <mutex>  // NOLINT
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "common/config.h"
+#include "storage/disk/disk_manager.h"
+
+namespace bustub {
+
+/**
+ * DiskManagerCompressed stores every page compressed with LZCodec, trading CPU for the bandwidth and the footprint of
+ * the disk. Since pages no longer have a fixed size, the database file is a heap of slots: a slot is a multiple of
+ * SLOT_ALIGNMENT bytes holding the id of its page, the size of its data and the data, compressed or, for a page that
+ * does not compress, raw. The page map, which tells the slot of every page, is kept in memory and saved to its own
+ * file, the database file name followed by ".map", on every Sync().
+ *
+ * A page written again stays in its slot if it still fits, and moves to a slot of the right size otherwise. The slot
+ * it leaves is only reused once the next Sync() saved a map that no longer points to it, so that the saved map always
+ * points to slots holding a version of their pages. Free slots are kept per size; a larger one is split to serve a
+ * smaller page, but they are never merged. The gaps between the slots in use are found again when the map is loaded.
+ *
+ * Reads of consecutive pages whose slots are adjacent in the file, as pages written in order are, go out as a single
+ * read. The pages written become durable together on the next Sync(), like DiskManagerPosix. The log file is handled
+ * by DiskManager.
+ */
+class DiskManagerCompressed : public DiskManager {
+ public:
+  /** Slots are allocated in multiples of this many bytes. */
+  static constexpr size_t SLOT_ALIGNMENT = 512;
+
+  /**
+   * @brief Open or create a database file, its page map and its log file.
+   * @param db_file the file name of the database file
+   * @throws Exception if the page map records another page size than BUSTUB_PAGE_SIZE
+   */
+  explicit DiskManagerCompressed(const std::string &db_file);
+
+  /** @brief Sync and close the database file. */
+  ~DiskManagerCompressed() override;
+
+  /** @brief Sync and close the database file and the log file. */
+  void ShutDown() override;
+
+  /**
+   * @brief Compress a page into its slot, without waiting for it to be durable.
+   * @param page_id id of the page
+   * @param page_data raw page data
+   */
+  void WritePage(page_id_t page_id, const char *page_data) override;
+
+  /**
+   * @brief Write a batch of pages in the order of their slots, and make them durable with Sync().
+   * @param pages the ids and the raw data of the pages, each page at most once, in any order
+   */
+  void WritePages(std::vector<std::pair<page_id_t, const char *>> pages) override;
+
+  /**
+   * @brief Read and decompress a page. A page never written reads as zeros.
+   * @param page_id id of the page
+   * @param[out] page_data output buffer
+   */
+  void ReadPage(page_id_t page_id, char *page_data) override;
+
+  /**
+   * @brief Read a run of consecutive pages, with one read per run of adjacent slots. Pages never written read as zeros.
+   * @param start_page_id id of the first page
+   * @param num_pages number of pages to read
+   * @param[out] data output buffer of num_pages * BUSTUB_PAGE_SIZE bytes
+   */
+  void ReadPages(page_id_t start_page_id, size_t num_pages, char *data) override;
+
+  /**
+   * @brief Make the pages written so far durable with fdatasync(), then save the page map if it changed, and free the
+   * slots the saved map no longer points to. Writes still in flight when the map is taken are waited for first.
+   */
+  void Sync() override;
+
+  /** @return an empty string: pages are not stored at page_id * BUSTUB_PAGE_SIZE */
+  auto GetPageFileName() const -> std::string override { return ""; }
+
+  /** @return the size of the database file, in bytes */
+  auto GetDbFileSize() const -> int64_t;
+
+  /** @return the size of the pages stored over the size of their data in the file, or 0 if none is stored */
+  auto GetCompressionRatio() const -> double;
+
+  /** @return the number of fdatasync() calls made by Sync() */
+  auto GetNumSyncs() const -> int { return num_syncs_; }
+
+ private:
+  /** Where a page is stored. A capacity of 0 means the page was never written. */
+  struct Slot {
+    uint64_t offset_{0};
+    uint32_t capacity_{0};
+    /** Size of the data of the page, BUSTUB_PAGE_SIZE if it is stored raw. */
+    uint32_t size_{0};
+  };
+
+  /** @brief Read the page map saved by the last Sync(), if any, and find the free slots between the slots in use. */
+  void LoadMap();
+
+  /** @brief Write the page map to a new file that replaces the old one. @return false on an I/O error */
+  auto SaveMap(const std::vector<Slot> &map) -> bool;
+
+  /**
+   * @brief Give a page a slot that fits size bytes of data, keeping its current slot if it does. map_latch_ must be
+   * held.
+   * @return the slot of the page
+   */
+  auto AllocateSlot(page_id_t page_id, uint32_t size) -> Slot;
+
+  /**
+   * @brief Count a write whose slots were just allocated as in flight. map_latch_ must be held.
+   * @return the generation of the write
+   */
+  auto BeginWrite() -> size_t;
+
+  /** @brief Count a write as done, once its slots are in the file. */
+  void EndWrite(size_t generation);
+
+  int fd_{-1};
+  std::string map_file_name_;
+
+  /** Serializes Sync(), so that the maps are saved in the order they were taken. */
+  std::mutex sync_latch_;
+  /** Protects the page map, the free slots and the end of the file. */
+  mutable std::mutex map_latch_;
+  /** The slot of every page, indexed by page id. */
+  std::vector<Slot> map_;
+  /** Whether the map changed since it was last saved. */
+  bool map_dirty_{false};
+  /** The offsets of the free slots, indexed by capacity / SLOT_ALIGNMENT. */
+  std::vector<std::vector<uint64_t>> free_slots_;
+  /** Slots left by pages that moved, which the saved map may still point to. */
+  std::vector<Slot> pending_free_;
+  /** Number of Sync() calls that took the map. Its parity is the generation of the writes begun since. */
+  uint64_t sync_epoch_{0};
+  /** Writes whose slots are in the map but not yet in the file, per generation. */
+  std::array<size_t, 2> writes_in_flight_{};
+  /** Signaled when a generation has no write in flight any more. */
+  std::condition_variable writes_cv_;
+  /** Where the next slot is appended when no free slot fits. */
+  uint64_t file_end_{0};
+  /** Sum of the sizes of the data of the pages in the map. */
+  uint64_t stored_bytes_{0};
+  size_t num_pages_{0};
+
+  /** Whether a page was written since the last Sync(). */
+  std::atomic<bool> unsynced_{false};
+  std::atomic<int> num_syncs_{0};
+};
+
+}  // namespace bustub
@@ -9,24 +9,113 @@
 // Copyright (c) 2015-2020, Carnegie Mellon University Database Group
 //
 //===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <cstdint>
 #include <fstream>
 #include <future>  // NOLINT
+#include <memory>
+#include <mutex>  // NOLINT
+#include <random>
+#include <shared_mutex>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "common/config.h"
 #include "storage/disk/disk_manager.h"
 
 namespace bustub {
 
+/**
+ * DiskLatencyModel describes how long a simulated device takes to serve a request of DiskManagerMemory.
+ *
+ * A request first waits for the device to be free, then occupies it for its seek, if it does not start at the page
+ * following the previous request, and for the transfer of its pages at the device bandwidth. Its latency comes on
+ * top and overlaps with the other requests, like the queue of an SSD does. The latency of each request is drawn from
+ * a distribution around the configured mean, with a seeded generator so that runs can be repeated.
+ */
+struct DiskLatencyModel {
+  enum class Distribution {
+    FIXED,       // every request takes the mean latency
+    UNIFORM,     // uniform between 0 and twice the mean
+    EXPONENTIAL  // exponential with the given mean, a long tail of slow requests
+  };
+
+  /** Mean latency of a read request. */
+  std::chrono::nanoseconds read_latency_{0};
+  /** Mean latency of a write request. */
+  std::chrono::nanoseconds write_latency_{0};
+  /** Time the device spends moving to a request that does not follow the previous one. */
+  std::chrono::nanoseconds seek_latency_{0};
+  /** Bytes the device transfers per second, shared by all requests. 0 is unlimited. */
+  uint64_t bandwidth_{0};
+  Distribution distribution_{Distribution::FIXED};
+  uint64_t seed_{42};
+  /**
+   * Whether requests wait for their modeled time. Without waiting, only the device time of the stats adds up, which
+   * is deterministic for a single thread.
+   */
+  bool sleep_{true};
+
+  /** @return a model of an NVMe SSD: fast random reads with a tail, no seeks, high bandwidth */
+  static auto Ssd() -> DiskLatencyModel {
+    DiskLatencyModel model;
+    model.read_latency_ = std::chrono::microseconds(80);
+    model.write_latency_ = std::chrono::microseconds(20);
+    model.bandwidth_ = uint64_t{2} << 30;
+    model.distribution_ = Distribution::EXPONENTIAL;
+    return model;
+  }
+
+  /** @return a model of a hard disk: seeks of a few milliseconds, cheap sequential transfers */
+  static auto Hdd() -> DiskLatencyModel {
+    DiskLatencyModel model;
+    model.seek_latency_ = std::chrono::milliseconds(4);
+    model.bandwidth_ = uint64_t{150} << 20;
+    return model;
+  }
+};
+
+/** Requests served by DiskManagerMemory, see DiskManagerMemory::GetStats(). */
+struct DiskStats {
+  uint64_t reads_{0};
+  uint64_t writes_{0};
+  uint64_t pages_read_{0};
+  uint64_t pages_written_{0};
+  uint64_t seeks_{0};
+  /** Time the requests spent on the device: seeks, transfers and latencies, whether they overlapped or not. */
+  std::chrono::nanoseconds device_time_{0};
+
+  /** @return the requests per second of a run of the given duration */
+  auto Iops(std::chrono::duration<double> elapsed) const -> double {
+    return static_cast<double>(reads_ + writes_) / elapsed.count();
+  }
+};
+
 /**
  * DiskManagerMemory replicates the utility of DiskManager on memory. It is primarily used for
  * data structure performance testing.
+ *
+ * The pages live in chunks of CHUNK_PAGES pages that are allocated the first time one of their pages is written, so
+ * the memory grows with the pages in use, wherever their ids are. Pages that were never written read as zeros.
+ * Requests are served as fast as memory allows unless a DiskLatencyModel slows them down to the speed of a device.
  */
 class DiskManagerMemory : public DiskManager {
  public:
-  explicit DiskManagerMemory(size_t pages);
+  static constexpr size_t CHUNK_PAGES = 256;
+
+  /**
+   * @brief Create a new DiskManagerMemory.
+   * @param pages expected number of pages; the memory grows past it on demand
+   * @param model the device to simulate, by default none
+   */
+  explicit DiskManagerMemory(size_t pages, const DiskLatencyModel &model = {});
 
-  ~DiskManagerMemory() override { delete[] memory_; }
+  ~DiskManagerMemory() override = default;
 
   /**
    * Write a page to the database file.
@@ -35,6 +124,12 @@ class DiskManagerMemory : public DiskManager {
    */
   void WritePage(page_id_t page_id, const char *page_data) override;
 
+  /**
+   * Write a batch of pages as a single request. OnPageWrite() still sees the pages one by one.
+   * @param pages the ids and the raw data of the pages, each page at most once, in any order
+   */
+  void WritePages(std::vector<std::pair<page_id_t, const char *>> pages) override;
+
   /**
    * Read a page from the database file.
    * @param page_id id of the page
@@ -42,8 +137,79 @@ class DiskManagerMemory : public DiskManager {
    */
   void ReadPage(page_id_t page_id, char *page_data) override;
 
+  /**
+   * Read a run of consecutive pages as a single request. OnPageRead() still sees the pages one by one.
+   * @param start_page_id id of the first page
+   * @param num_pages number of pages to read
+   * @param[out] data output buffer of num_pages * BUSTUB_PAGE_SIZE bytes
+   */
+  void ReadPages(page_id_t start_page_id, size_t num_pages, char *data) override;
+
+  /** @brief Simulate another device from now on. */
+  void SetLatencyModel(const DiskLatencyModel &model);
+
+  /** @return the requests served so far */
+  auto GetStats() -> DiskStats;
+
+  /** @brief Count the requests from zero again. */
+  void ResetStats();
+
+  /** @return the bytes of memory holding pages */
+  auto GetAllocatedSize() -> size_t;
+
+ protected:
+  /**
+   * Called before each page is read, alone or as part of a batch. Subclasses override it to instrument the device.
+   * @param page_id id of the page
+   */
+  virtual void OnPageRead(page_id_t page_id) {}
+
+  /**
+   * Called before each page is written, alone or as part of a batch. Subclasses override it to instrument the device.
+   * @param page_id id of the page
+   * @param page_data raw page data
+   */
+  virtual void OnPageWrite(page_id_t page_id, const char *page_data) {}
+
  private:
-  char *memory_;
+  /**
+   * Account for a request, and wait for the modeled time.
+   * @param start_page_id id of the first page of the request
+   * @param num_pages number of pages of the request
+   * @param is_write whether the request is a write
+   */
+  void Serve(page_id_t start_page_id, size_t num_pages, bool is_write);
+
+  /** @brief Copy a page into its chunk, the part of a write that every page of a batch goes through. */
+  void CopyIn(page_id_t page_id, const char *page_data);
+
+  /** @brief Copy a page out of its chunk, or zeros if it was never written. */
+  void CopyOut(page_id_t page_id, char *page_data);
+
+  /** @return the chunk holding a page, created if `create` is set, or nullptr */
+  auto GetChunk(page_id_t page_id, bool create) -> char *;
+
+  /** The chunks of pages, nullptr for the ones never written to. */
+  std::vector<std::unique_ptr<char[]>> chunks_;
+  std::shared_mutex chunks_latch_;
+
+  /** Protects the model, its generator and the state of the device. */
+  std::mutex model_latch_;
+  DiskLatencyModel model_;
+  /** Whether the model costs any time, requests only update the stats otherwise. */
+  std::atomic<bool> timed_{false};
+  std::mt19937_64 gen_;
+  /** The device is busy with seeks and transfers until then. */
+  std::chrono::steady_clock::time_point busy_until_{};
+  /** The page following the previous request, where the next one starts without seeking. */
+  std::atomic<page_id_t> next_page_id_{INVALID_PAGE_ID};
+
+  std::atomic<uint64_t> reads_{0};
+  std::atomic<uint64_t> writes_{0};
+  std::atomic<uint64_t> pages_read_{0};
+  std::atomic<uint64_t> pages_written_{0};
+  std::atomic<uint64_t> seeks_{0};
+  std::atomic<int64_t> device_time_ns_{0};
 };
 
 }  // namespace bustub
@@ -0,0 +1,137 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// disk_manager_mmap.h
+//
+// Identification: src/include/storage/disk/disk_manager_mmap.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>  // NOLINT
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "common/config.h"
+#include "storage/disk/disk_manager.h"
+
+namespace bustub {
+
+/**
+ * DiskManagerMmap stores the pages in the same file format as DiskManager, but maps the database file into memory,
+ * so that reading a page is a copy out of the OS page cache without a system call. It suits read-mostly databases.
+ *
+ * The mapping lives in an address range reserved for max_file_size bytes, so it never moves: the file and the mapping
+ * grow together by GROW_CHUNK_SIZE bytes when a page is written past their end, and the file is truncated back to the
+ * end of the last page on ShutDown(). A write only goes to the page cache: the pages written become durable together on
+ * the next Sync(), which calls msync().
+ *
+ * With zero_copy, the mapping is read-only and pages are written with pwrite() instead, and the disk manager lends the
+ * pages of the mapping to the buffer pool, see GetPageView(): a frame holding a page fetched with FetchPageReadOnly()
+ * points into the mapping instead of holding a copy. FetchPage() still copies the page into the frame, so that it can
+ * be written.
+ */
+class DiskManagerMmap : public DiskManager {
+ public:
+  /** The file and the mapping grow by this many bytes at a time. */
+  static constexpr size_t GROW_CHUNK_SIZE = 16 << 20;
+  static constexpr size_t DEFAULT_MAX_FILE_SIZE = static_cast<size_t>(64) << 30;
+
+  /**
+   * @brief Open or create a database file, and its log file, and map the database file.
+   * @param db_file the file name of the database file
+   * @param zero_copy whether to lend the pages of the mapping to the buffer pool, see GetPageView()
+   * @param max_file_size the size of the address range reserved for the mapping; the file cannot grow past it
+   */
+  explicit DiskManagerMmap(const std::string &db_file, bool zero_copy = false,
+                           size_t max_file_size = DEFAULT_MAX_FILE_SIZE);
+
+  /** @brief Shut down if needed and unmap the database file. */
+  ~DiskManagerMmap() override;
+
+  /** @brief Sync, truncate and close the database file, and close the log file. Lent pages stay valid. */
+  void ShutDown() override;
+
+  /**
+   * @brief Write a page to the database file, growing the file and the mapping if the page is past their end.
+   * @param page_id id of the page
+   * @param page_data raw page data
+   */
+  void WritePage(page_id_t page_id, const char *page_data) override;
+
+  /**
+   * @brief Write a batch of pages, and make them durable with Sync(). A copy into the mapping costs no system call, so
+   * there is nothing to coalesce but the syncs.
+   * @param pages the ids and the raw data of the pages, each page at most once, in any order
+   */
+  void WritePages(std::vector<std::pair<page_id_t, const char *>> pages) override;
+
+  /**
+   * @brief Copy a page out of the mapping. A page past the end of the file reads as zeros.
+   * @param page_id id of the page
+   * @param[out] page_data output buffer
+   */
+  void ReadPage(page_id_t page_id, char *page_data) override;
+
+  /**
+   * @brief Copy a run of consecutive pages out of the mapping. Pages past the end of the file read as zeros.
+   * @param start_page_id id of the first page
+   * @param num_pages number of pages to read
+   * @param[out] data output buffer of num_pages * BUSTUB_PAGE_SIZE bytes
+   */
+  void ReadPages(page_id_t start_page_id, size_t num_pages, char *data) override;
+
+  /**
+   * @brief Lend a page of the mapping, with zero_copy.
+   * @return the page, or nullptr without zero_copy or if the page is past the end of the file
+   */
+  auto GetPageView(page_id_t page_id) -> const char * override;
+
+  /** @brief Make the pages written so far durable with a single msync(), if any was written since the last one. */
+  void Sync() override;
+
+  /**
+   * @return an empty string: the file is larger than its pages while it is mapped, and a page written behind the back
+   * of the disk manager would be past the size it tracks
+   */
+  auto GetPageFileName() const -> std::string override { return ""; }
+
+  /** @return the end of the last page of the database file, in bytes */
+  auto GetDbFileSize() const -> int64_t { return file_size_; }
+
+  /** @return the number of bytes of the file that are mapped */
+  auto GetMappedSize() const -> size_t { return mapped_size_; }
+
+  /** @return the number of msync() calls made by Sync() */
+  auto GetNumSyncs() const -> int { return num_syncs_; }
+
+ private:
+  /** @brief Grow the file and the mapping to cover end bytes. @return false if end is past max_file_size_ */
+  auto Grow(size_t end) -> bool;
+
+  /** @brief Copy size bytes at offset out of the mapping, zero-filling whatever lies past the end of the file. */
+  void ReadAt(char *data, size_t size, int64_t offset);
+
+  const bool zero_copy_;
+  const size_t max_file_size_;
+  int fd_{-1};
+  /** The start of the reserved address range, which the file is mapped at. */
+  char *base_{nullptr};
+  /** The size of the file and of the mapping, a multiple of GROW_CHUNK_SIZE. Only grows, under grow_latch_. */
+  std::atomic<size_t> mapped_size_{0};
+  std::mutex grow_latch_;
+  /** The end of the last page written, i.e. the size of the file once truncated. */
+  std::atomic<int64_t> file_size_{0};
+  /** Whether a page was written since the last Sync(). */
+  std::atomic<bool> unsynced_{false};
+  std::atomic<int> num_syncs_{0};
+};
+
+}  // namespace bustub
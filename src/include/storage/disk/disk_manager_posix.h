@@ -0,0 +1,103 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// disk_manager_posix.h
+//
+// Identification: src/include/storage/disk/disk_manager_posix.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "common/config.h"
+#include "storage/disk/disk_manager.h"
+
+namespace bustub {
+
+/**
+ * DiskManagerPosix stores the pages in the same file format as DiskManager, but accesses the database file with
+ * positional reads and writes on a raw file descriptor instead of seeking a shared file stream under a latch, so
+ * concurrent page I/Os do not serialize. The size of the file is tracked in memory rather than queried on every read.
+ *
+ * A write only hands the page to the OS: the pages written become durable together on the next Sync(), instead of
+ * each write paying for its own. The log file is handled by DiskManager.
+ */
+class DiskManagerPosix : public DiskManager {
+ public:
+  /**
+   * @brief Open or create a database file, and its log file.
+   * @param db_file the file name of the database file
+   */
+  explicit DiskManagerPosix(const std::string &db_file);
+
+  /** @brief Sync and close the database file. */
+  ~DiskManagerPosix() override;
+
+  /** @brief Sync and close the database file and the log file. */
+  void ShutDown() override;
+
+  /**
+   * @brief Write a page to the database file, without waiting for it to be durable.
+   * @param page_id id of the page
+   * @param page_data raw page data
+   */
+  void WritePage(page_id_t page_id, const char *page_data) override;
+
+  /**
+   * @brief Write a batch of pages with one pwritev() per run of consecutive pages, and make them durable with Sync().
+   * @param pages the ids and the raw data of the pages, each page at most once, in any order
+   */
+  void WritePages(std::vector<std::pair<page_id_t, const char *>> pages) override;
+
+  /**
+   * @brief Read a page from the database file. A page past the end of the file reads as zeros.
+   * @param page_id id of the page
+   * @param[out] page_data output buffer
+   */
+  void ReadPage(page_id_t page_id, char *page_data) override;
+
+  /**
+   * @brief Read a run of consecutive pages with a single read. Pages past the end of the file read as zeros.
+   * @param start_page_id id of the first page
+   * @param num_pages number of pages to read
+   * @param[out] data output buffer of num_pages * BUSTUB_PAGE_SIZE bytes
+   */
+  void ReadPages(page_id_t start_page_id, size_t num_pages, char *data) override;
+
+  /** @brief Make the pages written so far durable with a single fdatasync(), if any was written since the last one. */
+  void Sync() override;
+
+  /**
+   * @return an empty string: a page written to the file behind the back of the disk manager would be past the size it
+   * tracks, so other components must go through ReadPage() and WritePage(), which do not serialize anyway
+   */
+  auto GetPageFileName() const -> std::string override { return ""; }
+
+  /** @return the size of the database file, in bytes */
+  auto GetDbFileSize() const -> int64_t { return file_size_; }
+
+  /** @return the number of fdatasync() calls made by Sync() */
+  auto GetNumSyncs() const -> int { return num_syncs_; }
+
+ private:
+  /** @brief Read size bytes at offset, zero-filling whatever lies past the end of the file. */
+  void ReadAt(char *data, size_t size, int64_t offset);
+
+  int fd_{-1};
+  /** The size of the file, which only grows by WritePage(). */
+  std::atomic<int64_t> file_size_{0};
+  /** Whether a page was written since the last Sync(). */
+  std::atomic<bool> unsynced_{false};
+  std::atomic<int> num_syncs_{0};
+};
+
+}  // namespace bustub
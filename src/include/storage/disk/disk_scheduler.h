@@ -0,0 +1,168 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// disk_scheduler.h
+//
+// Identification: src/include/storage/disk/disk_scheduler.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <sys/uio.h>
+
+#include <condition_variable>  // NOLINT
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>  // NOLINT
+#include <mutex>   // NOLINT
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "common/config.h"
+#include "common/macros.h"
+#include "storage/disk/disk_manager.h"
+
+// from <linux/io_uring.h>, which is only needed by the implementation
+struct io_uring_sqe;
+struct io_uring_cqe;
+
+namespace bustub {
+
+/**
+ * DiskScheduler reads and writes the pages of a DiskManager asynchronously, so that many page I/Os can be in flight at
+ * once instead of taking turns on the latch of the DiskManager. A request completes by invoking its callback, or by
+ * making its future ready.
+ *
+ * If the pages of the DiskManager are stored in a file (see DiskManager::GetPageFileName()), the scheduler opens the
+ * file itself, with O_DIRECT if the DiskManager uses it, and submits the requests to an io_uring, falling back to a
+ * pool of threads doing pread()/pwrite() if the kernel does not support io_uring. Otherwise the threads call
+ * DiskManager::ReadPage() and WritePage(). Pages past the end of the file read as zeros, like DiskManager::ReadPage().
+ *
+ * Writes are not synced and are not counted by DiskManager::GetNumWrites(). Requests on the same page complete in no
+ * particular order: the caller must not issue a request on a page before its last write to the page completed. All
+ * methods are thread-safe.
+ */
+class DiskScheduler {
+ public:
+  enum class Backend { IO_URING, THREAD_POOL };
+
+  /**
+   * Invoked with true once a request completed successfully. It runs on an I/O thread of the scheduler, so it should
+   * be short, and must not wait for other requests of the scheduler.
+   */
+  using Callback = std::function<void(bool)>;
+
+  /**
+   * @brief Create a new DiskScheduler.
+   * @param disk_manager the disk manager of the pages
+   * @param queue_depth the maximum number of requests in flight, scheduling more blocks until one completes
+   * @param backend IO_URING to use io_uring when possible, THREAD_POOL to always use threads
+   */
+  explicit DiskScheduler(DiskManager *disk_manager, size_t queue_depth = DISK_SCHEDULER_QUEUE_DEPTH,
+                         Backend backend = Backend::IO_URING);
+
+  /** @brief Wait for the requests in flight to complete and destroy the DiskScheduler. */
+  ~DiskScheduler();
+
+  DISALLOW_COPY_AND_MOVE(DiskScheduler);
+
+  /**
+   * @brief Read a page asynchronously.
+   * @param page_id id of the page
+   * @param[out] data buffer of BUSTUB_PAGE_SIZE bytes, which must stay valid until the callback is invoked
+   * @param callback invoked once the page is read
+   */
+  void ScheduleRead(page_id_t page_id, char *data, Callback callback);
+
+  /**
+   * @brief Write a page asynchronously.
+   * @param page_id id of the page
+   * @param data contents of the page, which must stay valid and unchanged until the callback is invoked
+   * @param callback invoked once the page is written
+   */
+  void ScheduleWrite(page_id_t page_id, const char *data, Callback callback);
+
+  /** @brief Read a page asynchronously. @return a future holding true once the page is read successfully */
+  auto ScheduleRead(page_id_t page_id, char *data) -> std::future<bool>;
+
+  /** @brief Write a page asynchronously. @return a future holding true once the page is written successfully */
+  auto ScheduleWrite(page_id_t page_id, const char *data) -> std::future<bool>;
+
+  /** @return the backend in use, which is THREAD_POOL if io_uring was not requested or is not supported */
+  auto GetBackend() const -> Backend { return ring_fd_ != -1 ? Backend::IO_URING : Backend::THREAD_POOL; }
+
+  /** @return the maximum number of requests in flight */
+  auto GetQueueDepth() const -> size_t { return queue_depth_; }
+
+ private:
+  struct Request {
+    bool is_write_;
+    page_id_t page_id_;
+    char *data_;
+    /** What the I/O goes to: data_, or an aligned bounce buffer if the file uses O_DIRECT and data_ is unaligned. */
+    char *buffer_;
+    /** The vector of the io_uring request, which the kernel may read until the request completes. */
+    struct iovec iov_;
+    Callback callback_;
+  };
+
+  /** @brief Wait for a free slot and hand a request to the backend. */
+  void Submit(bool is_write, page_id_t page_id, char *data, Callback callback);
+
+  /** @brief Release the slot of a request and invoke its callback. @param result bytes transferred, or -errno */
+  void Complete(Request *request, int64_t result);
+
+  /** @return true if an io_uring could be set up on fd_ */
+  auto SetUpRing() -> bool;
+  /** @brief Submit a request to the io_uring, or complete it with the error if the kernel does not take it. */
+  void SubmitToRing(Request *request);
+  /** The completion thread of the io_uring. */
+  void ReapRing();
+
+  /** A thread of the pool. */
+  void Work();
+  /** @return bytes transferred, or -errno */
+  auto DoIo(Request *request) -> int64_t;
+
+  DiskManager *disk_manager_;
+  const size_t queue_depth_;
+  /** The file of the pages, or -1 if they go through disk_manager_. */
+  int fd_{-1};
+  bool direct_io_{false};
+
+  std::mutex latch_;
+  std::condition_variable slot_cv_;
+  size_t in_flight_{0};
+
+  /** io_uring state, only valid if ring_fd_ != -1. The submission queue is protected by sq_latch_. */
+  int ring_fd_{-1};
+  std::mutex sq_latch_;
+  void *sq_ring_{nullptr};
+  size_t sq_ring_size_{0};
+  void *cq_ring_{nullptr};
+  size_t cq_ring_size_{0};
+  struct io_uring_sqe *sqes_{nullptr};
+  size_t sqes_size_{0};
+  unsigned *sq_head_{nullptr};
+  unsigned *sq_tail_{nullptr};
+  unsigned sq_mask_{0};
+  unsigned *sq_array_{nullptr};
+  unsigned *cq_head_{nullptr};
+  unsigned *cq_tail_{nullptr};
+  unsigned cq_mask_{0};
+  struct io_uring_cqe *cqes_{nullptr};
+
+  /** Thread pool state, protected by latch_. */
+  std::deque<Request *> queue_;
+  std::condition_variable queue_cv_;
+  bool stopping_{false};
+
+  std::vector<std::thread> threads_;
+};
+
+}  // namespace bustub
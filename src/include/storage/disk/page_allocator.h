@@ -0,0 +1,121 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// page_allocator.h
+//
+// Identification: src/include/storage/disk/page_allocator.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <vector>
+
+#include "common/config.h"
+#include "common/macros.h"
+#include "storage/disk/disk_manager.h"
+
+namespace bustub {
+
+/**
+ * PageAllocator tracks which pages of the database file are in use with a persistent free-space bitmap, so that the
+ * pages of deleted B+ tree nodes and tables can be reused.
+ *
+ * The file is split into regions of BITS_PER_BITMAP pages. The second page of each region holds the bitmap of the
+ * region (so the first bitmap page directly follows HEADER_PAGE_ID), and bitmap pages are always marked as allocated.
+ * Allocation returns the lowest free page id, which keeps the file compact and scans local. Table heaps and indexes
+ * allocate whole extents instead, see AllocateExtent() and PageSegment.
+ *
+ * Bitmap pages are read from disk when the allocator is created and written back by Flush(), which the buffer pool
+ * manager calls when it flushes all its pages. The allocator may be shared by the instances of a parallel buffer pool
+ * manager, and is thread-safe.
+ *
+ * Bitmap page format (size in byte):
+ *  -----------------------------------------------------------------
+ * | Magic (4) | NumBitmapPages (4) | Bitmap (BUSTUB_PAGE_SIZE - 8) |
+ *  -----------------------------------------------------------------
+ * NumBitmapPages is only meaningful in the first bitmap page.
+ */
+class PageAllocator {
+ public:
+  static constexpr uint32_t MAGIC = 0x42545042;  // "BPTB"
+  static constexpr size_t BITMAP_HEADER_SIZE = 8;
+  static constexpr page_id_t BITS_PER_BITMAP = (BUSTUB_PAGE_SIZE - BITMAP_HEADER_SIZE) * 8;
+
+  /**
+   * @brief Create a new PageAllocator, loading the bitmap pages of the database file if there are any.
+   * @param disk_manager the disk manager of the database file
+   */
+  explicit PageAllocator(DiskManager *disk_manager);
+
+  /** @brief Write back the bitmap pages and destroy the PageAllocator. */
+  ~PageAllocator();
+
+  DISALLOW_COPY_AND_MOVE(PageAllocator);
+
+  /**
+   * @brief Allocate the lowest free page id that belongs to a buffer pool manager instance, i.e. such that
+   * page_id % num_instances == instance_index.
+   * @param num_instances number of instances of the parallel buffer pool manager (1 if there is none)
+   * @param instance_index index of the instance
+   * @return the allocated page id
+   */
+  auto AllocatePage(uint32_t num_instances = 1, uint32_t instance_index = 0) -> page_id_t;
+
+  /**
+   * @brief Allocate the lowest extent of EXTENT_SIZE contiguous free pages. The extent starts on a multiple of
+   * EXTENT_SIZE, and its pages are all marked as allocated, whether the segment that asked for it uses them up or not.
+   * With a parallel buffer pool manager, the pages of an extent belong to every instance.
+   * @return the first page of the extent
+   */
+  auto AllocateExtent() -> page_id_t;
+
+  /**
+   * @brief Mark a page as free, so that it can be allocated again. Ids that are never allocated, i.e. negative ids and
+   * bitmap pages, are ignored.
+   * @param page_id id of the page to deallocate
+   */
+  void DeallocatePage(page_id_t page_id);
+
+  /** @return true if the page is allocated */
+  auto IsAllocated(page_id_t page_id) -> bool;
+
+  /** @brief Write the modified bitmap pages to disk. */
+  void Flush();
+
+  /** @return true if the page holds a bitmap of the allocator */
+  static auto IsBitmapPage(page_id_t page_id) -> bool { return page_id % BITS_PER_BITMAP == 1; }
+
+ private:
+  struct Bitmap {
+    std::unique_ptr<char[]> data_;
+    bool dirty_;
+  };
+
+  /** @return the bitmap of a region, created (and marked dirty) if it does not exist yet */
+  auto GetBitmap(size_t region) -> uint64_t *;
+  auto TestBit(page_id_t page_id) -> bool;
+  void SetBit(page_id_t page_id, bool allocated);
+
+  DiskManager *disk_manager_;
+  /** The bitmap of each region. */
+  std::vector<Bitmap> bitmaps_;
+  /**
+   * For each instance index, every page of the instance below this id is allocated. Kept for the number of instances
+   * AllocatePage() was last called with, so that the instances of a parallel buffer pool manager do not rescan the
+   * pages the others filled.
+   */
+  std::vector<page_id_t> first_free_hints_;
+  uint32_t hint_num_instances_{0};
+  /** No free extent starts below this id. */
+  page_id_t first_extent_hint_{0};
+  std::mutex latch_;
+};
+
+}  // namespace bustub
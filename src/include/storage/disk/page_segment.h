@@ -0,0 +1,57 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// page_segment.h
+//
+// Identification: src/include/storage/disk/page_segment.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <mutex>  // NOLINT
+
+#include "common/config.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+/**
+ * PageSegment hands out the new pages of one table heap or index. Instead of taking the next free page id of the
+ * database file, which interleaves the pages of every object that grows at the same time, the segment allocates
+ * EXTENT_SIZE contiguous page ids at once and gives them out in order. A table heap chain or a B+ tree leaf chain
+ * then sits in runs of consecutive pages, which sequential scans read ahead with large reads.
+ *
+ * Only the extent being filled is tracked, in memory: an object that is opened again starts a new extent the first
+ * time it grows. With a parallel buffer pool manager, the pages of an extent are spread over the instances by page id
+ * like any other page, and the parallel buffer pool manager allocates the extents for all of them.
+ *
+ * A segment is thread-safe.
+ */
+class PageSegment {
+ public:
+  PageSegment() = default;
+
+  DISALLOW_COPY_AND_MOVE(PageSegment);
+
+  /**
+   * @brief Allocate the next page of the extent, starting a new extent once the segment has none or has used it up.
+   * @param allocate_extent allocates EXTENT_SIZE contiguous pages and returns the first one
+   * @return the allocated page id
+   */
+  auto AllocatePage(const std::function<page_id_t()> &allocate_extent) -> page_id_t;
+
+ private:
+  /** The next page of the extent being filled. */
+  page_id_t next_page_id_{INVALID_PAGE_ID};
+  /** The first page past the extent being filled. */
+  page_id_t end_page_id_{INVALID_PAGE_ID};
+  std::mutex latch_;
+};
+
+}  // namespace bustub
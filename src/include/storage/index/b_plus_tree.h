@@ -10,11 +10,17 @@
 //===----------------------------------------------------------------------===//
 #pragma once
 
+#include <atomic>
+#include <functional>
+#include <mutex>  // NOLINT
 #include <queue>
 #include <string>
+#include <utility>
 #include <vector>
 
+#include "common/rwlatch.h"
 #include "concurrency/transaction.h"
+#include "storage/disk/page_segment.h"
 #include "storage/index/index_iterator.h"
 #include "storage/page/b_plus_tree_internal_page.h"
 #include "storage/page/b_plus_tree_leaf_page.h"
@@ -32,6 +38,12 @@ enum class OpType { READ = 0, INSERT, DELETE };
  * (2) support insert & remove
  * (3) The structure should shrink and grow dynamically
  * (4) Implement index iterator for range scan
+ *
+ * The tree is safe to use from many threads. Lookups and iterators descend with read latches, holding the latch of a
+ * node only until the latch of its child is taken. Insert() and Remove() first descend optimistically, with read
+ * latches on the internal pages and a write latch on the leaf only; if the leaf would split or underflow, they descend
+ * again with write latches, keeping those of the ancestors that may change in the page set of the transaction until
+ * the operation is done. The root latch guards root_page_id_ and is recorded in the page set as nullptr.
  */
 INDEX_TEMPLATE_ARGUMENTS
 class BPlusTree {
@@ -39,15 +51,33 @@ class BPlusTree {
   using LeafPage = BPlusTreeLeafPage<KeyType, ValueType, KeyComparator>;
 
  public:
+  /** Yields the entries of a bulk load in ascending key order, and false once there are no more. */
+  using BulkLoadSource = std::function<bool(KeyType *key, ValueType *value)>;
+
   explicit BPlusTree(std::string name, BufferPoolManager *buffer_pool_manager, const KeyComparator &comparator,
                      int leaf_max_size = LEAF_PAGE_SIZE, int internal_max_size = INTERNAL_PAGE_SIZE);
 
+  /** Deletes the pages that were removed from the tree while an iterator still pinned them. */
+  ~BPlusTree();
+
   // Returns true if this B+ tree has no keys and values.
   auto IsEmpty() const -> bool;
 
   // Insert a key-value pair into this B+ tree.
   auto Insert(const KeyType &key, const ValueType &value, Transaction *transaction = nullptr) -> bool;
 
+  /**
+   * Build an empty tree from entries sorted by key, bottom up: the leaves are filled left to right, then each level
+   * of internal pages is built on top of the one below, until a single root is left. Every page but the last of each
+   * level holds fill_factor of what it can hold without splitting, and the last one is evened out with its neighbor,
+   * so that no page underflows. Entries with the key of the previous one are skipped, like Insert() rejects them.
+   * @param source the entries, in ascending key order
+   * @param fill_factor fraction of each page to fill, clamped so that no page underflows
+   * @return false if the tree is not empty, in which case nothing is loaded
+   */
+  auto BulkLoad(const BulkLoadSource &source, double fill_factor = 1.0) -> bool;
+
+  // Find the leaf of a key, pinned but not latched; for tests only.
   auto FindLeafPage(const KeyType &key) -> LeafPage *;
 
   template <typename ClassType>
@@ -59,13 +89,13 @@ class BPlusTree {
   void Remove(const KeyType &key, Transaction *transaction = nullptr);
 
   template <typename ClassType>
-  void DeleteEntry(const KeyType &key, ClassType *delete_node);
+  void DeleteEntry(const KeyType &key, ClassType *delete_node, Transaction *transaction);
 
   template <typename ClassType>
   void Borrow(ClassType *left_node, ClassType *right_node);
 
   template <typename ClassType>
-  void Merge(ClassType *left_node, ClassType *right_node);
+  void Merge(ClassType *left_node, ClassType *right_node, Transaction *transaction);
 
   // return the value associated with a given key
   auto GetValue(const KeyType &key, std::vector<ValueType> *result, Transaction *transaction = nullptr) -> bool;
@@ -74,7 +104,6 @@ class BPlusTree {
   auto GetRootPageId() -> page_id_t;
 
   // index iterator
-  auto FindLeafPage(bool left) -> LeafPage *;
   auto Begin() -> INDEXITERATOR_TYPE;
   auto Begin(const KeyType &key) -> INDEXITERATOR_TYPE;
   auto End() -> INDEXITERATOR_TYPE;
@@ -85,13 +114,48 @@ class BPlusTree {
   // draw the B+ tree
   void Draw(BufferPoolManager *bpm, const std::string &outf);
 
-  // read data from file and insert one by one
+  // read data from file and insert one by one, or bulk load it into an empty tree
   void InsertFromFile(const std::string &file_name, Transaction *transaction = nullptr);
 
   // read data from file and remove one by one
   void RemoveFromFile(const std::string &file_name, Transaction *transaction = nullptr);
 
  private:
+  /** Iterators descend the tree again when they lose their place in the leaves. */
+  friend class IndexIterator<KeyType, ValueType, KeyComparator>;
+
+  /**
+   * Descend to a leaf with read latches, releasing each node once its child is latched.
+   * @param key the key to look for, or nullptr for the leftmost leaf
+   * @return the leaf, read-latched and pinned, or nullptr if the tree is empty
+   */
+  auto FindLeafRead(const KeyType *key) -> Page *;
+
+  /**
+   * Descend to the leaf of a key with read latches on the internal pages, and a write latch on the leaf only.
+   * @return the leaf, write-latched and pinned, or nullptr if the tree is empty
+   */
+  auto FindLeafOptimistic(const KeyType &key) -> Page *;
+
+  /**
+   * Descend to the leaf of a key with write latches. The latches of the nodes that op may change are kept in the page
+   * set of the transaction, the others are released as soon as a safe node below them is latched.
+   * @return the leaf, also the last page of the page set, or nullptr if the tree is empty, with the root latch held
+   */
+  auto FindLeafPessimistic(const KeyType &key, OpType op, Transaction *transaction) -> Page *;
+
+  /** @return whether op cannot split or merge node, and so cannot change its ancestors */
+  auto IsSafe(BPlusTreePage *node, OpType op) -> bool;
+
+  /**
+   * Release the latches of the page set of the transaction and unpin its pages, then delete the pages it removed. A
+   * page an iterator still pins cannot be deleted yet: it is kept with the pending deletes, which are retried here.
+   */
+  void ReleaseLatches(Transaction *transaction, bool is_dirty);
+
+  /** Try to delete the pending pages again, keeping those that are still pinned. Caller holds pending_deletes_latch_. */
+  void DeletePendingPages();
+
   void UpdateRootPageId(int insert_record = 0);
 
   /* Debug Routines for FREE!! */
@@ -102,10 +166,19 @@ class BPlusTree {
   // member variable
   std::string index_name_;
   page_id_t root_page_id_;
+  ReaderWriterLatch root_latch_;
   BufferPoolManager *buffer_pool_manager_;
   KeyComparator comparator_;
   int leaf_max_size_;
   int internal_max_size_;
+  /** Leaves and internal pages fill extents of their own, so that the leaf chain of a range scan stays contiguous. */
+  PageSegment leaf_segment_;
+  PageSegment internal_segment_;
+  /** Pages removed from the tree whose deletion failed because an iterator pinned them. */
+  std::vector<page_id_t> pending_deletes_;
+  /** Whether pending_deletes_ is not empty, so that ReleaseLatches() only takes the latch when there is work. */
+  std::atomic<bool> has_pending_deletes_{false};
+  std::mutex pending_deletes_latch_;
 };
 
 }  // namespace bustub
@@ -35,6 +35,10 @@ class BPlusTreeIndex : public Index {
 
   void ScanKey(const Tuple &key, std::vector<RID> *result, Transaction *transaction) override;
 
+  /** Build the empty index from entries sorted by key, see BPlusTree::BulkLoad(). */
+  auto BulkLoad(const typename BPlusTree<KeyType, ValueType, KeyComparator>::BulkLoadSource &source, double fill_factor)
+      -> bool;
+
   auto GetBeginIterator() -> INDEXITERATOR_TYPE;
 
   auto GetBeginIterator(const KeyType &key) -> INDEXITERATOR_TYPE;
@@ -0,0 +1,172 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// external_sorter.h
+//
+// Identification: src/include/storage/index/external_sorter.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <algorithm>
+#include <cstdio>
+#include <functional>
+#include <queue>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "common/exception.h"
+
+namespace bustub {
+
+/**
+ * ExternalSorter sorts more entries than fit in memory, such as the keys of an index built on a large table.
+ *
+ * Entries are added in any order. Once the entries buffered take memory_limit bytes, they are sorted and spilled to a
+ * temporary file as a run. Finish() sorts the entries left; Next() then returns all the entries in order, straight from
+ * memory if nothing was spilled, or merging the runs with one read buffer per run otherwise. The sort is stable:
+ * entries that compare equal come out in the order they were added.
+ *
+ * @tparam T the type of the entries, which must be trivially copyable
+ * @tparam Less a strict weak ordering of the entries, like the one of std::sort
+ */
+template <typename T, typename Less>
+class ExternalSorter {
+  static_assert(std::is_trivially_copyable_v<T>, "entries are spilled to disk byte by byte");
+
+ public:
+  /**
+   * @param less the order of the entries
+   * @param memory_limit bytes of entries to buffer before a run is spilled
+   */
+  ExternalSorter(Less less, size_t memory_limit)
+      : less_(std::move(less)), max_buffered_(std::max<size_t>(memory_limit / sizeof(T), 2)) {}
+
+  ~ExternalSorter() {
+    for (auto &run : runs_) {
+      // temporary files are removed once closed
+      std::fclose(run.file_);
+    }
+  }
+
+  ExternalSorter(const ExternalSorter &) = delete;
+  auto operator=(const ExternalSorter &) -> ExternalSorter & = delete;
+
+  /** @brief Add an entry, spilling the buffered entries as a run if the memory limit is reached. */
+  void Add(const T &entry) {
+    buffer_.push_back(entry);
+    if (buffer_.size() >= max_buffered_) {
+      Spill();
+    }
+  }
+
+  /** @brief Sort the entries added, after which Next() returns them. */
+  void Finish() {
+    if (runs_.empty()) {
+      std::stable_sort(buffer_.begin(), buffer_.end(), less_);
+      return;
+    }
+    if (!buffer_.empty()) {
+      Spill();
+    }
+    std::vector<T>().swap(buffer_);
+    // the memory of the spilled entries is shared by the read buffers of the runs
+    const size_t run_buffer_size = std::max<size_t>(max_buffered_ / runs_.size(), 1);
+    for (size_t i = 0; i < runs_.size(); i++) {
+      std::rewind(runs_[i].file_);
+      runs_[i].buffer_.resize(run_buffer_size);
+      if (Refill(&runs_[i])) {
+        heap_.push(i);
+      }
+    }
+  }
+
+  /**
+   * @brief Get the next entry in order. Finish() must have been called.
+   * @param[out] entry the next entry
+   * @return false once all the entries were returned
+   */
+  auto Next(T *entry) -> bool {
+    if (runs_.empty()) {
+      if (pos_ == buffer_.size()) {
+        return false;
+      }
+      *entry = buffer_[pos_++];
+      return true;
+    }
+    if (heap_.empty()) {
+      return false;
+    }
+    const size_t i = heap_.top();
+    heap_.pop();
+    Run &run = runs_[i];
+    *entry = run.buffer_[run.pos_++];
+    if (run.pos_ < run.size_ || Refill(&run)) {
+      heap_.push(i);
+    }
+    return true;
+  }
+
+  /** @return the number of runs spilled to disk, 0 if the entries were sorted in memory */
+  auto GetNumRuns() const -> size_t { return runs_.size(); }
+
+ private:
+  /** A sorted run in a temporary file, and the entries of it read but not yet returned. */
+  struct Run {
+    std::FILE *file_;
+    std::vector<T> buffer_;
+    size_t pos_{0};
+    size_t size_{0};
+  };
+
+  /** @brief Sort the buffered entries and write them to a new run. */
+  void Spill() {
+    std::stable_sort(buffer_.begin(), buffer_.end(), less_);
+    std::FILE *file = std::tmpfile();
+    if (file == nullptr) {
+      throw Exception("cannot create a temporary file to sort on");
+    }
+    runs_.push_back(Run{file, {}});
+    if (std::fwrite(buffer_.data(), sizeof(T), buffer_.size(), file) != buffer_.size()) {
+      throw Exception("cannot write a sorted run to a temporary file");
+    }
+    buffer_.clear();
+  }
+
+  /** @brief Read the next entries of a run into its buffer. @return false if the run is exhausted */
+  auto Refill(Run *run) -> bool {
+    run->size_ = std::fread(run->buffer_.data(), sizeof(T), run->buffer_.size(), run->file_);
+    run->pos_ = 0;
+    return run->size_ > 0;
+  }
+
+  /** Orders the runs by their next entry, then by their index, so that equal entries come out as they were added. */
+  struct RunGreater {
+    const ExternalSorter *sorter_;
+    auto operator()(size_t a, size_t b) const -> bool {
+      const T &entry_a = sorter_->runs_[a].buffer_[sorter_->runs_[a].pos_];
+      const T &entry_b = sorter_->runs_[b].buffer_[sorter_->runs_[b].pos_];
+      if (sorter_->less_(entry_b, entry_a)) {
+        return true;
+      }
+      return !sorter_->less_(entry_a, entry_b) && a > b;
+    }
+  };
+
+  Less less_;
+  size_t max_buffered_;
+  /** The entries not yet spilled, or all of them if none were. */
+  std::vector<T> buffer_;
+  /** Next entry of buffer_ that Next() returns when nothing was spilled. */
+  size_t pos_{0};
+  std::vector<Run> runs_;
+  /** The runs that still have entries, by their next entry. */
+  std::priority_queue<size_t, std::vector<size_t>, RunGreater> heap_{RunGreater{this}};
+};
+
+}  // namespace bustub
@@ -13,35 +13,79 @@
  * For range scan of b+ tree
  */
 #pragma once
+#include "buffer/buffer_pool_manager.h"
 #include "storage/page/b_plus_tree_leaf_page.h"
 
 namespace bustub {
 
+template <typename KeyType, typename ValueType, typename KeyComparator>
+class BPlusTree;
+
 #define INDEXITERATOR_TYPE IndexIterator<KeyType, ValueType, KeyComparator>
 
+/**
+ * IndexIterator walks the leaves of a B+ tree in key order. It holds a read latch and a pin on its current leaf only.
+ * It moves on to the next leaf by read-latching it before letting go of the current one, so that no merge or borrow
+ * can move entries between the two in between. Latching leaves right to left would deadlock with writers, so the
+ * iterator only tries the latch of the next leaf. If a writer holds it, the iterator lets go of both leaves, waits for
+ * the writer, and descends the tree again to the first entry after the last one it returned. A scan thus returns
+ * every entry that is in the tree for the whole scan, once and in order.
+ *
+ * The iterator past the last entry is the default-constructed one, which holds nothing.
+ */
 INDEX_TEMPLATE_ARGUMENTS
 class IndexIterator {
  public:
-  // you may define your own constructor based on your member variables
   IndexIterator();
-  explicit IndexIterator(BPlusTreeLeafPage<KeyType, ValueType, KeyComparator> *leaf_node, int pos);
+  /**
+   * @param tree the tree walked
+   * @param page the leaf to start from, read-latched and pinned, which the iterator takes over
+   * @param pos the entry of the leaf to start from; past the end of the leaf starts from the next one
+   * @param start_key the key the scan starts from, which pos is the first entry not less than, or nullptr if the scan
+   * starts from the first entry of the tree
+   */
+  IndexIterator(BPlusTree<KeyType, ValueType, KeyComparator> *tree, Page *page, int pos,
+                const KeyType *start_key = nullptr);
   ~IndexIterator();  // NOLINT
 
+  IndexIterator(const IndexIterator &) = delete;
+  auto operator=(const IndexIterator &) -> IndexIterator & = delete;
+  IndexIterator(IndexIterator &&other) noexcept;
+  auto operator=(IndexIterator &&other) noexcept -> IndexIterator &;
+
   auto IsEnd() -> bool;
 
   auto operator*() -> const MappingType &;
 
   auto operator++() -> IndexIterator &;
 
-  auto operator==(const IndexIterator &itr) const -> bool { return leaf_node_ == itr.leaf_node_ && pos_ == itr.pos_; }
+  auto operator==(const IndexIterator &itr) const -> bool { return page_ == itr.page_ && pos_ == itr.pos_; }
 
-  auto operator!=(const IndexIterator &itr) const -> bool { return leaf_node_ != itr.leaf_node_ || pos_ != itr.pos_; }
+  auto operator!=(const IndexIterator &itr) const -> bool { return !(*this == itr); }
 
  private:
-  // add your own private member variables here
-  BPlusTreeLeafPage<KeyType, ValueType, KeyComparator> *leaf_node_;
-  int pos_;
-  BufferPoolManager *buffer_pool_manager_;
+  auto Leaf() -> BPlusTreeLeafPage<KeyType, ValueType, KeyComparator> *;
+
+  /** Move on to the next leaves while pos_ is past the end of the current one. */
+  void SkipToEntry();
+
+  /** Descend the tree again to the entry where the scan resumes. The iterator must hold no leaf. */
+  void Restart();
+
+  /** Release the current leaf and become the end iterator. */
+  void Release();
+
+  BPlusTree<KeyType, ValueType, KeyComparator> *tree_{nullptr};
+  BufferPoolManager *buffer_pool_manager_{nullptr};
+  Page *page_{nullptr};
+  int pos_{0};
+  /**
+   * Where a restart resumes: from the first entry of the tree, or from the first one not less than resume_key_, or
+   * greater than it once resume_after_ is set, i.e. once resume_key_ is the last key returned.
+   */
+  bool has_resume_key_{false};
+  bool resume_after_{false};
+  KeyType resume_key_{};
 };
 
 }  // namespace bustub
@@ -19,16 +19,23 @@ namespace bustub {
 /**
  * Database use the first page (page_id = 0) as header page to store metadata, in
  * our case, we will contain information about table/index name (length less than
- * 32 bytes) and their corresponding root_id
+ * 32 bytes) and their corresponding root_id. The header page also records the page
+ * size the database file was created with, since the page layouts depend on it.
  *
  * Format (size in byte):
- *  -----------------------------------------------------------------
- * | RecordCount (4) | Entry_1 name (32) | Entry_1 root_id (4) | ... |
- *  -----------------------------------------------------------------
+ *  ---------------------------------------------------------------------------------------------------
+ * | RecordCount (4) | Magic (4) | PageSize (4) | Entry_1 name (32) | Entry_1 root_id (4) | ... |
+ *  ---------------------------------------------------------------------------------------------------
+ * A header page created by NewPage() is all zeros, it gets its magic and page size with its first record.
  */
 class HeaderPage : public Page {
  public:
-  void Init() { SetRecordCount(0); }
+  static constexpr uint32_t MAGIC = 0x50485442;  // "BTHP"
+
+  void Init() {
+    SetRecordCount(0);
+    SetPageSize();
+  }
   /**
    * Record related
    */
@@ -40,6 +47,20 @@ class HeaderPage : public Page {
   auto GetRootId(const std::string &name, page_id_t *root_id) -> bool;
   auto GetRecordCount() -> int;
 
+  /** @return the page size recorded in the header page, or 0 if none was recorded yet */
+  auto GetPageSize() -> int { return GetPageSize(GetData()); }
+
+  /**
+   * @param data the first bytes of the header page, at least HEADER_SIZE of them
+   * @return the page size recorded in the header page, or 0 if the page holds no header
+   */
+  static auto GetPageSize(const char *data) -> int;
+
+  static constexpr size_t HEADER_SIZE = 12;
+  static constexpr size_t RECORD_SIZE = 36;
+  /** The number of records a header page holds. */
+  static constexpr int MAX_RECORDS = (BUSTUB_PAGE_SIZE - HEADER_SIZE) / RECORD_SIZE;
+
  private:
   /**
    * helper functions
@@ -47,5 +68,8 @@ class HeaderPage : public Page {
   auto FindRecord(const std::string &name) -> int;
 
   void SetRecordCount(int record_count);
+
+  /** Record the magic and the page size of this build. */
+  void SetPageSize();
 };
 }  // namespace bustub
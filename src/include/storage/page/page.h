@@ -12,6 +12,9 @@
 
 #pragma once
 
+#include <atomic>
+#include <condition_variable>  // NOLINT
+#include <cstdint>
 #include <cstring>
 #include <iostream>
 
@@ -20,6 +23,19 @@
 
 namespace bustub {
 
+/**
+ * The state of the disk I/O on a buffer pool frame. The buffer pool manager performs disk I/O without holding its
+ * latch, so a frame can be mapped to a page whose contents are still in flight.
+ */
+enum class FrameState : uint8_t {
+  /** The frame contents are valid. */
+  READY,
+  /** The page is being read into the frame (possibly after writing back the frame's previous page). */
+  READING,
+  /** The frame contents are being written to disk. */
+  WRITING
+};
+
 /**
  * Page is the basic unit of storage within the database system. Page provides a wrapper for actual data pages being
  * held in main memory. Page also contains book-keeping information that is used by the buffer pool manager, e.g.
@@ -30,8 +46,8 @@ class Page {
   friend class BufferPoolManagerInstance;
 
  public:
-  /** Constructor. Zeros out the page data. */
-  Page() { ResetMemory(); }
+  /** Constructor. The page data is assigned by the buffer pool manager, see FrameArena. */
+  Page() = default;
 
   /** Default destructor. */
   ~Page() = default;
@@ -43,7 +59,7 @@ class Page {
   inline auto GetPageId() -> page_id_t { return page_id_; }
 
   /** @return the pin count of this page */
-  inline auto GetPinCount() -> int { return pin_count_; }
+  inline auto GetPinCount() -> int { return pin_count_.load(std::memory_order_relaxed); }
 
   /** @return true if the page in memory has been modified from the page on disk, false otherwise */
   inline auto IsDirty() -> bool { return is_dirty_; }
@@ -57,6 +73,9 @@ class Page {
   /** Acquire the page read latch. */
   inline void RLatch() { rwlatch_.RLock(); }
 
+  /** Acquire the page read latch if no writer holds it. @return true if it was acquired */
+  inline auto TryRLatch() -> bool { return rwlatch_.TryRLock(); }
+
   /** Release the page read latch. */
   inline void RUnlatch() { rwlatch_.RUnlock(); }
 
@@ -75,17 +94,83 @@ class Page {
   static constexpr size_t OFFSET_LSN = 4;
 
  private:
+  /** Pin count of a frame that the buffer pool manager is remapping, see Claim(). */
+  static constexpr int CLAIMED = -1;
+
   /** Zeroes out the data that is held within the page. */
   inline void ResetMemory() { memset(data_, OFFSET_PAGE_START, BUSTUB_PAGE_SIZE); }
 
-  /** The actual data that is stored within a page. */
-  char data_[BUSTUB_PAGE_SIZE]{};
-  /** The ID of this page. */
+  /**
+   * Pin the frame unless it is claimed.
+   * @return false if the buffer pool manager is remapping the frame
+   */
+  inline auto TryPin() -> bool {
+    int pin_count = pin_count_.load(std::memory_order_relaxed);
+    do {
+      if (pin_count == CLAIMED) {
+        return false;
+      }
+    } while (!pin_count_.compare_exchange_weak(pin_count, pin_count + 1, std::memory_order_acquire));
+    return true;
+  }
+
+  /**
+   * Drop a pin of the frame.
+   * @return the new pin count, or -1 if the frame was not pinned
+   */
+  inline auto TryUnpin() -> int {
+    int pin_count = pin_count_.load(std::memory_order_relaxed);
+    do {
+      if (pin_count <= 0) {
+        return -1;
+      }
+    } while (!pin_count_.compare_exchange_weak(pin_count, pin_count - 1, std::memory_order_release));
+    return pin_count - 1;
+  }
+
+  /**
+   * Take exclusive ownership of an unpinned frame before changing the page it holds: the pin count goes from 0 to
+   * CLAIMED, so that optimistic readers can no longer pin it, and the version becomes odd.
+   * @return false if the frame is pinned
+   */
+  inline auto Claim() -> bool {
+    int pin_count = 0;
+    if (!pin_count_.compare_exchange_strong(pin_count, CLAIMED, std::memory_order_acquire)) {
+      return false;
+    }
+    version_.fetch_add(1, std::memory_order_relaxed);
+    return true;
+  }
+
+  /** End a Claim(): the version becomes even again and the frame gets its new pin count. */
+  inline void Publish(int pin_count) {
+    version_.fetch_add(1, std::memory_order_release);
+    pin_count_.store(pin_count, std::memory_order_release);
+  }
+
+  /**
+   * The actual data that is stored within a page. Points into the frame arena of the buffer pool, or to the read-only
+   * copy of the page lent by the disk manager while the page is only fetched read-only, see
+   * BufferPoolManager::FetchPageReadOnly().
+   */
+  char *data_{nullptr};
+  /** The memory of the frame in the frame arena, which data_ points back to when the frame gets another page. */
+  char *frame_data_{nullptr};
+  /** The ID of this page. Only changes while the frame is claimed, see Claim(). */
   page_id_t page_id_ = INVALID_PAGE_ID;
-  /** The pin count of this page. */
-  int pin_count_ = 0;
+  /** The pin count of this page, or CLAIMED. Pinned without the buffer pool manager's latch on the hit path. */
+  std::atomic<int> pin_count_{0};
+  /**
+   * Incremented when the frame is claimed and again when it is published, so it is odd while the page it holds
+   * changes. A reader that sees the same even version before and after pinning the frame can trust page_id_.
+   */
+  std::atomic<uint64_t> version_{0};
   /** True if the page is dirty, i.e. it is different from its corresponding page on disk. */
-  bool is_dirty_ = false;
+  std::atomic<bool> is_dirty_{false};
+  /** The state of the disk I/O on this frame. Changes under the buffer pool manager's latch. */
+  std::atomic<FrameState> frame_state_{FrameState::READY};
+  /** Notified by the buffer pool manager when the disk I/O on this frame completes. */
+  std::condition_variable io_cv_;
   /** Page latch. */
   ReaderWriterLatch rwlatch_;
 };
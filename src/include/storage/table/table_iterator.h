@@ -20,6 +20,7 @@
 
 namespace bustub {
 
+class BufferAccessStrategy;
 class TableHeap;
 
 /**
@@ -29,10 +30,14 @@ class TableIterator {
   friend class Cursor;
 
  public:
-  TableIterator(TableHeap *table_heap, RID rid, Transaction *txn);
+  TableIterator(TableHeap *table_heap, RID rid, Transaction *txn, BufferAccessStrategy *strategy = nullptr);
 
   TableIterator(const TableIterator &other)
-      : table_heap_(other.table_heap_), tuple_(new Tuple(*other.tuple_)), txn_(other.txn_) {}
+      : table_heap_(other.table_heap_),
+        tuple_(new Tuple(*other.tuple_)),
+        txn_(other.txn_),
+        strategy_(other.strategy_),
+        read_ahead_until_(other.read_ahead_until_) {}
 
   ~TableIterator() { delete tuple_; }
 
@@ -54,13 +59,25 @@ class TableIterator {
     table_heap_ = other.table_heap_;
     *tuple_ = *other.tuple_;
     txn_ = other.txn_;
+    strategy_ = other.strategy_;
+    read_ahead_until_ = other.read_ahead_until_;
     return *this;
   }
 
  private:
+  /**
+   * Called when the scan moves from one table page to the next. If the next page directly follows the current one on
+   * disk, the scan is likely sequential, so keep the table heap's read-ahead window of pages in flight.
+   */
+  void ReadAhead(page_id_t cur_page_id, page_id_t next_page_id);
+
   TableHeap *table_heap_;
   Tuple *tuple_;
   Transaction *txn_;
+  /** The buffer access strategy used to fetch the pages of the table, or nullptr. */
+  BufferAccessStrategy *strategy_{nullptr};
+  /** Pages before this one have already been requested for read-ahead. */
+  page_id_t read_ahead_until_{INVALID_PAGE_ID};
 };
 
 }  // namespace bustub
@@ -10,31 +10,80 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <fcntl.h>
 #include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include <algorithm>
 #include <cassert>
+#include <cerrno>
+#include <climits>
+#include <cstdint>
 #include <cstring>
+#include <fstream>
 #include <iostream>
 #include <mutex>  // NOLINT
+#include <new>
 #include <string>
 #include <thread>  // NOLINT
 
 #include "common/exception.h"
 #include "common/logger.h"
 #include "storage/disk/disk_manager.h"
+#include "storage/page/header_page.h"
 
 namespace bustub {
 
 static char *buffer_used;
 
+static_assert(BUSTUB_PAGE_SIZE % DiskManager::DIRECT_IO_ALIGNMENT == 0, "O_DIRECT needs whole aligned pages");
+
 /**
  * Constructor: open/create a single database file & log file
  * @input db_file: database file name
  */
-DiskManager::DiskManager(const std::string &db_file) : file_name_(db_file) {
+DiskManager::DiskManager(const std::string &db_file, bool direct_io) : file_name_(db_file) {
+  CheckPageSize(db_file);
+  if (!OpenLog()) {
+    return;
+  }
+
+  std::scoped_lock scoped_db_io_latch(db_io_latch_);
+#ifdef O_DIRECT
+  if (direct_io) {
+    db_fd_ = open(db_file.c_str(), O_RDWR | O_CREAT | O_DIRECT, 0644);
+    if (db_fd_ != -1) {
+      bounce_buffer_ = static_cast<char *>(::operator new[](BUSTUB_PAGE_SIZE, std::align_val_t{DIRECT_IO_ALIGNMENT}));
+      return;
+    }
+    // e.g. tmpfs rejects O_DIRECT with EINVAL
+    LOG_WARN("cannot open db file with O_DIRECT (errno %d), falling back to buffered I/O", errno);
+  }
+#endif
+  db_io_.open(db_file, std::ios::binary | std::ios::in | std::ios::out);
+  // directory or file does not exist
+  if (!db_io_.is_open()) {
+    db_io_.clear();
+    // create a new file
+    db_io_.open(db_file, std::ios::binary | std::ios::trunc | std::ios::out | std::ios::in);
+    if (!db_io_.is_open()) {
+      throw Exception("can't open db file");
+    }
+  }
+  batch_fd_ = open(db_file.c_str(), O_RDWR);
+  if (batch_fd_ == -1) {
+    throw Exception("can't open db file");
+  }
+}
+
+/**
+ * Open/create the log file next to the database file
+ */
+auto DiskManager::OpenLog() -> bool {
   std::string::size_type n = file_name_.rfind('.');
   if (n == std::string::npos) {
     LOG_DEBUG("wrong file format");
-    return;
+    return false;
   }
   log_name_ = file_name_.substr(0, n) + ".log";
 
@@ -48,19 +97,20 @@ DiskManager::DiskManager(const std::string &db_file) : file_name_(db_file) {
       throw Exception("can't open dblog file");
     }
   }
+  buffer_used = nullptr;
+  return true;
+}
 
-  std::scoped_lock scoped_db_io_latch(db_io_latch_);
-  db_io_.open(db_file, std::ios::binary | std::ios::in | std::ios::out);
-  // directory or file does not exist
-  if (!db_io_.is_open()) {
-    db_io_.clear();
-    // create a new file
-    db_io_.open(db_file, std::ios::binary | std::ios::trunc | std::ios::out | std::ios::in);
-    if (!db_io_.is_open()) {
-      throw Exception("can't open db file");
-    }
+DiskManager::~DiskManager() {
+  if (db_fd_ != -1) {
+    close(db_fd_);
+  }
+  if (batch_fd_ != -1) {
+    close(batch_fd_);
+  }
+  if (bounce_buffer_ != nullptr) {
+    ::operator delete[](bounce_buffer_, std::align_val_t{DIRECT_IO_ALIGNMENT});
   }
-  buffer_used = nullptr;
 }
 
 /**
@@ -70,6 +120,14 @@ void DiskManager::ShutDown() {
   {
     std::scoped_lock scoped_db_io_latch(db_io_latch_);
     db_io_.close();
+    if (db_fd_ != -1) {
+      close(db_fd_);
+      db_fd_ = -1;
+    }
+    if (batch_fd_ != -1) {
+      close(batch_fd_);
+      batch_fd_ = -1;
+    }
   }
   log_io_.close();
 }
@@ -79,6 +137,10 @@ void DiskManager::ShutDown() {
  */
 void DiskManager::WritePage(page_id_t page_id, const char *page_data) {
   std::scoped_lock scoped_db_io_latch(db_io_latch_);
+  if (db_fd_ != -1) {
+    WritePageDirect(page_id, page_data);
+    return;
+  }
   size_t offset = static_cast<size_t>(page_id) * BUSTUB_PAGE_SIZE;
   // set write cursor to offset
   num_writes_ += 1;
@@ -98,7 +160,11 @@ void DiskManager::WritePage(page_id_t page_id, const char *page_data) {
  */
 void DiskManager::ReadPage(page_id_t page_id, char *page_data) {
   std::scoped_lock scoped_db_io_latch(db_io_latch_);
-  int offset = page_id * BUSTUB_PAGE_SIZE;
+  if (db_fd_ != -1) {
+    ReadPageDirect(page_id, page_data);
+    return;
+  }
+  int64_t offset = static_cast<int64_t>(page_id) * BUSTUB_PAGE_SIZE;
   // check if read beyond file length
   if (offset > GetFileSize(file_name_)) {
     LOG_DEBUG("I/O error reading past end of file");
@@ -122,6 +188,162 @@ void DiskManager::ReadPage(page_id_t page_id, char *page_data) {
   }
 }
 
+/**
+ * Read a run of consecutive pages with one read, zero-filling whatever lies past the end of the file
+ */
+void DiskManager::ReadPages(page_id_t start_page_id, size_t num_pages, char *data) {
+  std::scoped_lock scoped_db_io_latch(db_io_latch_);
+  const size_t size = num_pages * BUSTUB_PAGE_SIZE;
+  const off_t offset = static_cast<off_t>(start_page_id) * BUSTUB_PAGE_SIZE;
+  if (db_fd_ != -1) {
+    // the bounce buffer only holds one page, an unaligned run goes through a bounce buffer of its own
+    const bool aligned = reinterpret_cast<uintptr_t>(data) % DIRECT_IO_ALIGNMENT == 0;
+    char *buffer = aligned ? data : static_cast<char *>(::operator new[](size, std::align_val_t{DIRECT_IO_ALIGNMENT}));
+    const ssize_t read_count = pread(db_fd_, buffer, size, offset);
+    if (read_count < 0) {
+      LOG_DEBUG("I/O error while reading");
+    } else {
+      memset(buffer + read_count, 0, size - static_cast<size_t>(read_count));
+    }
+    if (!aligned) {
+      memcpy(data, buffer, size);
+      ::operator delete[](buffer, std::align_val_t{DIRECT_IO_ALIGNMENT});
+    }
+    return;
+  }
+  size_t read_count = 0;
+  if (offset < GetFileSize(file_name_)) {
+    db_io_.seekp(offset);
+    db_io_.read(data, static_cast<std::streamsize>(size));
+    if (db_io_.bad()) {
+      LOG_DEBUG("I/O error while reading");
+      return;
+    }
+    read_count = db_io_.gcount();
+    if (read_count < size) {
+      db_io_.clear();
+    }
+  }
+  memset(data + read_count, 0, size - read_count);
+}
+
+/**
+ * Write a batch of pages with one vectored write per run of consecutive pages, and a single sync
+ */
+void DiskManager::WritePages(std::vector<std::pair<page_id_t, const char *>> pages) {
+  if (pages.empty()) {
+    return;
+  }
+  std::scoped_lock scoped_db_io_latch(db_io_latch_);
+  if (db_fd_ == -1) {
+    // db_io_ is flushed after every write and seeks before every read, so it holds no stale data of the file
+    if (!WriteRuns(batch_fd_, &pages) || fdatasync(batch_fd_) != 0) {
+      LOG_DEBUG("I/O error while writing");
+    }
+    return;
+  }
+  // O_DIRECT writes aligned buffers only, the unaligned pages go through a bounce buffer of their own
+  const auto unaligned = std::count_if(pages.begin(), pages.end(), [](const auto &page) {
+    return reinterpret_cast<uintptr_t>(page.second) % DIRECT_IO_ALIGNMENT != 0;
+  });
+  char *buffer = nullptr;
+  if (unaligned > 0) {
+    buffer = static_cast<char *>(::operator new[](unaligned * BUSTUB_PAGE_SIZE, std::align_val_t{DIRECT_IO_ALIGNMENT}));
+    char *next = buffer;
+    for (auto &page : pages) {
+      if (reinterpret_cast<uintptr_t>(page.second) % DIRECT_IO_ALIGNMENT != 0) {
+        memcpy(next, page.second, BUSTUB_PAGE_SIZE);
+        page.second = next;
+        next += BUSTUB_PAGE_SIZE;
+      }
+    }
+  }
+  if (!WriteRuns(db_fd_, &pages) || fdatasync(db_fd_) != 0) {
+    LOG_DEBUG("I/O error while writing");
+  }
+  if (buffer != nullptr) {
+    ::operator delete[](buffer, std::align_val_t{DIRECT_IO_ALIGNMENT});
+  }
+}
+
+/**
+ * Sort the pages and write each run of consecutive pages with pwritev(), resuming short writes
+ */
+auto DiskManager::WriteRuns(int fd, std::vector<std::pair<page_id_t, const char *>> *pages) -> bool {
+  std::sort(pages->begin(), pages->end(), [](const auto &a, const auto &b) { return a.first < b.first; });
+  std::vector<iovec> iovs;
+  size_t start = 0;
+  while (start < pages->size()) {
+    size_t end = start + 1;
+    while (end < pages->size() && end - start < IOV_MAX && (*pages)[end].first == (*pages)[end - 1].first + 1) {
+      end++;
+    }
+    iovs.clear();
+    for (size_t i = start; i < end; i++) {
+      iovs.push_back({const_cast<char *>((*pages)[i].second), BUSTUB_PAGE_SIZE});
+    }
+    off_t offset = static_cast<off_t>((*pages)[start].first) * BUSTUB_PAGE_SIZE;
+    iovec *iov = iovs.data();
+    int iov_count = static_cast<int>(iovs.size());
+    while (iov_count > 0) {
+      ssize_t count = pwritev(fd, iov, iov_count, offset);
+      if (count < 0 && errno == EINTR) {
+        continue;
+      }
+      if (count <= 0) {
+        return false;
+      }
+      offset += count;
+      for (; iov_count > 0 && static_cast<size_t>(count) >= iov->iov_len; iov++, iov_count--) {
+        count -= static_cast<ssize_t>(iov->iov_len);
+      }
+      if (count > 0) {
+        iov->iov_base = static_cast<char *>(iov->iov_base) + count;
+        iov->iov_len -= count;
+      }
+    }
+    num_writes_ += static_cast<int>(end - start);
+    start = end;
+  }
+  return true;
+}
+
+/**
+ * Write a page with O_DIRECT, going through the bounce buffer if the page buffer is not aligned
+ */
+void DiskManager::WritePageDirect(page_id_t page_id, const char *page_data) {
+  off_t offset = static_cast<off_t>(page_id) * BUSTUB_PAGE_SIZE;
+  num_writes_ += 1;
+  if (reinterpret_cast<uintptr_t>(page_data) % DIRECT_IO_ALIGNMENT != 0) {
+    memcpy(bounce_buffer_, page_data, BUSTUB_PAGE_SIZE);
+    page_data = bounce_buffer_;
+  }
+  // O_DIRECT bypasses the page cache, but the device cache still has to be flushed to keep the file in sync
+  if (pwrite(db_fd_, page_data, BUSTUB_PAGE_SIZE, offset) != BUSTUB_PAGE_SIZE || fdatasync(db_fd_) != 0) {
+    LOG_DEBUG("I/O error while writing");
+  }
+}
+
+/**
+ * Read a page with O_DIRECT, going through the bounce buffer if the page buffer is not aligned
+ */
+void DiskManager::ReadPageDirect(page_id_t page_id, char *page_data) {
+  off_t offset = static_cast<off_t>(page_id) * BUSTUB_PAGE_SIZE;
+  char *buffer = reinterpret_cast<uintptr_t>(page_data) % DIRECT_IO_ALIGNMENT == 0 ? page_data : bounce_buffer_;
+  ssize_t read_count = pread(db_fd_, buffer, BUSTUB_PAGE_SIZE, offset);
+  if (read_count < 0) {
+    LOG_DEBUG("I/O error while reading");
+    return;
+  }
+  // reading past the end of the file yields a zeroed page, like the buffered path
+  if (read_count < BUSTUB_PAGE_SIZE) {
+    memset(buffer + read_count, 0, BUSTUB_PAGE_SIZE - read_count);
+  }
+  if (buffer != page_data) {
+    memcpy(page_data, buffer, BUSTUB_PAGE_SIZE);
+  }
+}
+
 /**
  * Write the contents of the log into disk file
  * Only return when sync is done, and only perform sequence write
@@ -202,10 +424,27 @@ auto DiskManager::GetFlushState() const -> bool { return flush_log_; }
 /**
  * Private helper function to get disk file size
  */
-auto DiskManager::GetFileSize(const std::string &file_name) -> int {
+auto DiskManager::GetFileSize(const std::string &file_name) -> int64_t {
   struct stat stat_buf;
   int rc = stat(file_name.c_str(), &stat_buf);
-  return rc == 0 ? static_cast<int>(stat_buf.st_size) : -1;
+  return rc == 0 ? static_cast<int64_t>(stat_buf.st_size) : -1;
+}
+
+/**
+ * Compare the page size recorded in the header page of the database file, if any, with the one of this build
+ */
+void DiskManager::CheckPageSize(const std::string &db_file) {
+  std::ifstream file(db_file, std::ios::binary);
+  char header[HeaderPage::HEADER_SIZE];
+  if (!file.read(header, sizeof(header))) {
+    // the file does not exist yet, or is too short to hold a header page
+    return;
+  }
+  const int page_size = HeaderPage::GetPageSize(header);
+  if (page_size != 0 && page_size != BUSTUB_PAGE_SIZE) {
+    throw Exception("db file " + db_file + " has pages of " + std::to_string(page_size) +
+                    " bytes, this build uses pages of " + std::to_string(BUSTUB_PAGE_SIZE) + " bytes");
+  }
 }
 
 }  // namespace bustub
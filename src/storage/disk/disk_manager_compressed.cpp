@@ -0,0 +1,426 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// disk_manager_compressed.cpp
+//
+// Identification: src/storage/disk/disk_manager_compressed.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/disk/disk_manager_compressed.h"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "common/exception.h"
+#include "common/logger.h"
+#include "common/util/lz_codec.h"
+
+namespace bustub {
+
+namespace {
+
+/** The first bytes of every slot. */
+struct SlotHeader {
+  page_id_t page_id_;
+  uint32_t size_;
+};
+
+/** The first bytes of the page map file, followed by one slot per page. */
+struct MapHeader {
+  uint32_t magic_;
+  uint32_t page_size_;
+  uint64_t num_pages_;
+};
+
+constexpr uint32_t MAP_MAGIC = 0x4D505442;  // "BTPM"
+
+/** Bytes of a slot holding a raw page, the largest there is. */
+constexpr size_t MAX_SLOT_SIZE = sizeof(SlotHeader) + BUSTUB_PAGE_SIZE;
+
+auto RoundUp(size_t size, size_t multiple) -> size_t { return (size + multiple - 1) / multiple * multiple; }
+
+/**
+ * Compress a page into a slot, or copy it raw if it does not compress below BUSTUB_PAGE_SIZE.
+ * @param[out] slot_data at least MAX_SLOT_SIZE bytes
+ * @return the size of the data of the slot
+ */
+auto EncodeSlot(page_id_t page_id, const char *page_data, char *slot_data) -> uint32_t {
+  size_t size = LZCodec::Compress(page_data, BUSTUB_PAGE_SIZE, slot_data + sizeof(SlotHeader), BUSTUB_PAGE_SIZE - 1);
+  if (size == 0) {
+    memcpy(slot_data + sizeof(SlotHeader), page_data, BUSTUB_PAGE_SIZE);
+    size = BUSTUB_PAGE_SIZE;
+  }
+  const SlotHeader header{page_id, static_cast<uint32_t>(size)};
+  memcpy(slot_data, &header, sizeof(header));
+  return size;
+}
+
+/**
+ * Copy a slot out to a page. The size comes from the slot rather than the map, which may have been saved before the
+ * page was written again in place.
+ * @param available the bytes of the slot that could be read
+ * @return false if the slot does not hold the page
+ */
+auto DecodeSlot(page_id_t page_id, const char *slot_data, size_t available, char *page_data) -> bool {
+  SlotHeader header;
+  if (available < sizeof(header)) {
+    return false;
+  }
+  memcpy(&header, slot_data, sizeof(header));
+  if (header.page_id_ != page_id || header.size_ > BUSTUB_PAGE_SIZE || sizeof(header) + header.size_ > available) {
+    return false;
+  }
+  if (header.size_ == BUSTUB_PAGE_SIZE) {
+    memcpy(page_data, slot_data + sizeof(header), BUSTUB_PAGE_SIZE);
+    return true;
+  }
+  return LZCodec::Decompress(slot_data + sizeof(header), header.size_, page_data, BUSTUB_PAGE_SIZE) == BUSTUB_PAGE_SIZE;
+}
+
+/** @return false on an I/O error */
+auto WriteFully(int fd, const char *data, size_t size, uint64_t offset) -> bool {
+  size_t written = 0;
+  while (written < size) {
+    const ssize_t count = pwrite(fd, data + written, size - written, offset + written);
+    if (count < 0 && errno == EINTR) {
+      continue;
+    }
+    if (count <= 0) {
+      return false;
+    }
+    written += count;
+  }
+  return true;
+}
+
+/** @return the number of bytes read, fewer than size at the end of the file or on an I/O error */
+auto ReadFully(int fd, char *data, size_t size, uint64_t offset) -> size_t {
+  size_t read_count = 0;
+  while (read_count < size) {
+    const ssize_t count = pread(fd, data + read_count, size - read_count, offset + read_count);
+    if (count < 0 && errno == EINTR) {
+      continue;
+    }
+    if (count <= 0) {
+      break;
+    }
+    read_count += count;
+  }
+  return read_count;
+}
+
+}  // namespace
+
+DiskManagerCompressed::DiskManagerCompressed(const std::string &db_file)
+    : map_file_name_(db_file + ".map"), free_slots_(RoundUp(MAX_SLOT_SIZE, SLOT_ALIGNMENT) / SLOT_ALIGNMENT + 1) {
+  file_name_ = db_file;
+  if (!OpenLog()) {
+    return;
+  }
+  fd_ = open(db_file.c_str(), O_RDWR | O_CREAT, 0644);
+  if (fd_ == -1) {
+    throw Exception("can't open db file");
+  }
+  struct stat stat_buf;
+  if (fstat(fd_, &stat_buf) == 0) {
+    file_end_ = RoundUp(stat_buf.st_size, SLOT_ALIGNMENT);
+  }
+  LoadMap();
+}
+
+DiskManagerCompressed::~DiskManagerCompressed() {
+  if (fd_ != -1) {
+    Sync();
+    close(fd_);
+  }
+}
+
+void DiskManagerCompressed::ShutDown() {
+  if (fd_ != -1) {
+    Sync();
+    close(fd_);
+    fd_ = -1;
+  }
+  DiskManager::ShutDown();
+}
+
+void DiskManagerCompressed::LoadMap() {
+  std::ifstream file(map_file_name_, std::ios::binary);
+  if (!file.is_open()) {
+    // a new database
+    return;
+  }
+  MapHeader header;
+  if (!file.read(reinterpret_cast<char *>(&header), sizeof(header)) || header.magic_ != MAP_MAGIC) {
+    throw Exception("page map " + map_file_name_ + " is corrupt");
+  }
+  if (header.page_size_ != BUSTUB_PAGE_SIZE) {
+    throw Exception("db file " + file_name_ + " has pages of " + std::to_string(header.page_size_) +
+                    " bytes, this build uses pages of " + std::to_string(BUSTUB_PAGE_SIZE) + " bytes");
+  }
+  map_.resize(header.num_pages_);
+  if (!file.read(reinterpret_cast<char *>(map_.data()), map_.size() * sizeof(Slot))) {
+    throw Exception("page map " + map_file_name_ + " is corrupt");
+  }
+
+  std::vector<Slot> used;
+  for (const auto &slot : map_) {
+    if (slot.capacity_ != 0) {
+      used.push_back(slot);
+      stored_bytes_ += slot.size_;
+      num_pages_++;
+    }
+  }
+  std::sort(used.begin(), used.end(), [](const Slot &a, const Slot &b) { return a.offset_ < b.offset_; });
+  // every offset and capacity is a multiple of SLOT_ALIGNMENT, so are the gaps
+  const uint64_t max_capacity = (free_slots_.size() - 1) * SLOT_ALIGNMENT;
+  auto free_gap = [&](uint64_t start, uint64_t end) {
+    while (start < end) {
+      const uint64_t capacity = std::min(end - start, max_capacity);
+      free_slots_[capacity / SLOT_ALIGNMENT].push_back(start);
+      start += capacity;
+    }
+  };
+  uint64_t end = 0;
+  for (const auto &slot : used) {
+    free_gap(end, slot.offset_);
+    end = slot.offset_ + slot.capacity_;
+  }
+  // the last slot may not be written up to its capacity
+  file_end_ = std::max(file_end_, end);
+  free_gap(end, file_end_);
+}
+
+auto DiskManagerCompressed::SaveMap(const std::vector<Slot> &map) -> bool {
+  // write the new map aside and rename it over the old one, so that a crash leaves either of them
+  const std::string tmp_file_name = map_file_name_ + ".tmp";
+  const int fd = open(tmp_file_name.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd == -1) {
+    return false;
+  }
+  const MapHeader header{MAP_MAGIC, static_cast<uint32_t>(BUSTUB_PAGE_SIZE), map.size()};
+  const bool written = WriteFully(fd, reinterpret_cast<const char *>(&header), sizeof(header), 0) &&
+                       WriteFully(fd, reinterpret_cast<const char *>(map.data()), map.size() * sizeof(Slot),
+                                  sizeof(header)) &&
+                       fdatasync(fd) == 0;
+  close(fd);
+  return written && rename(tmp_file_name.c_str(), map_file_name_.c_str()) == 0;
+}
+
+auto DiskManagerCompressed::AllocateSlot(page_id_t page_id, uint32_t size) -> Slot {
+  const uint64_t capacity = RoundUp(sizeof(SlotHeader) + size, SLOT_ALIGNMENT);
+  if (static_cast<size_t>(page_id) >= map_.size()) {
+    map_.resize(page_id + 1);
+  }
+  Slot &slot = map_[page_id];
+  map_dirty_ = true;
+  if (slot.capacity_ >= capacity) {
+    stored_bytes_ += size;
+    stored_bytes_ -= slot.size_;
+    slot.size_ = size;
+    return slot;
+  }
+  if (slot.capacity_ != 0) {
+    stored_bytes_ -= slot.size_;
+    pending_free_.push_back(slot);
+  } else {
+    num_pages_++;
+  }
+  stored_bytes_ += size;
+  slot.capacity_ = capacity;
+  slot.size_ = size;
+  for (size_t i = capacity / SLOT_ALIGNMENT; i < free_slots_.size(); i++) {
+    if (!free_slots_[i].empty()) {
+      slot.offset_ = free_slots_[i].back();
+      free_slots_[i].pop_back();
+      if (i * SLOT_ALIGNMENT > capacity) {
+        free_slots_[i - capacity / SLOT_ALIGNMENT].push_back(slot.offset_ + capacity);
+      }
+      return slot;
+    }
+  }
+  slot.offset_ = file_end_;
+  file_end_ += capacity;
+  return slot;
+}
+
+auto DiskManagerCompressed::BeginWrite() -> size_t {
+  const size_t generation = sync_epoch_ & 1;
+  writes_in_flight_[generation]++;
+  return generation;
+}
+
+void DiskManagerCompressed::EndWrite(size_t generation) {
+  unsynced_ = true;
+  std::scoped_lock lock(map_latch_);
+  if (--writes_in_flight_[generation] == 0) {
+    writes_cv_.notify_all();
+  }
+}
+
+void DiskManagerCompressed::WritePage(page_id_t page_id, const char *page_data) {
+  thread_local std::vector<char> slot_data(MAX_SLOT_SIZE);
+  const uint32_t size = EncodeSlot(page_id, page_data, slot_data.data());
+  Slot slot;
+  size_t generation;
+  {
+    std::scoped_lock lock(map_latch_);
+    slot = AllocateSlot(page_id, size);
+    generation = BeginWrite();
+  }
+  num_writes_ += 1;
+  if (!WriteFully(fd_, slot_data.data(), sizeof(SlotHeader) + size, slot.offset_)) {
+    LOG_DEBUG("I/O error while writing");
+  }
+  EndWrite(generation);
+}
+
+void DiskManagerCompressed::WritePages(std::vector<std::pair<page_id_t, const char *>> pages) {
+  if (pages.empty()) {
+    return;
+  }
+  std::vector<char> slot_data(pages.size() * MAX_SLOT_SIZE);
+  std::vector<uint32_t> sizes(pages.size());
+  for (size_t i = 0; i < pages.size(); i++) {
+    sizes[i] = EncodeSlot(pages[i].first, pages[i].second, slot_data.data() + i * MAX_SLOT_SIZE);
+  }
+  std::vector<std::pair<uint64_t, size_t>> writes(pages.size());
+  size_t generation;
+  {
+    std::scoped_lock lock(map_latch_);
+    for (size_t i = 0; i < pages.size(); i++) {
+      writes[i] = {AllocateSlot(pages[i].first, sizes[i]).offset_, i};
+    }
+    generation = BeginWrite();
+  }
+  // in the order of the file, so that slots appended together go out as a sequential write
+  std::sort(writes.begin(), writes.end());
+  for (const auto &[offset, i] : writes) {
+    if (!WriteFully(fd_, slot_data.data() + i * MAX_SLOT_SIZE, sizeof(SlotHeader) + sizes[i], offset)) {
+      LOG_DEBUG("I/O error while writing");
+      break;
+    }
+  }
+  num_writes_ += pages.size();
+  EndWrite(generation);
+  Sync();
+}
+
+void DiskManagerCompressed::ReadPage(page_id_t page_id, char *page_data) {
+  ReadPages(page_id, 1, page_data);
+}
+
+void DiskManagerCompressed::ReadPages(page_id_t start_page_id, size_t num_pages, char *data) {
+  std::vector<Slot> slots(num_pages);
+  {
+    std::scoped_lock lock(map_latch_);
+    for (size_t i = 0; i < num_pages && start_page_id + i < map_.size(); i++) {
+      slots[i] = map_[start_page_id + i];
+    }
+  }
+  thread_local std::vector<char> buffer;
+  size_t i = 0;
+  while (i < num_pages) {
+    if (slots[i].capacity_ == 0) {
+      memset(data + i * BUSTUB_PAGE_SIZE, 0, BUSTUB_PAGE_SIZE);
+      i++;
+      continue;
+    }
+    // extend the read over the following pages as long as their slots follow in the file
+    const uint64_t start = slots[i].offset_;
+    uint64_t end = start + slots[i].capacity_;
+    size_t last = i + 1;
+    while (last < num_pages && slots[last].capacity_ != 0 && slots[last].offset_ == end) {
+      end += slots[last].capacity_;
+      last++;
+    }
+    buffer.resize(end - start);
+    const size_t read_count = ReadFully(fd_, buffer.data(), end - start, start);
+    for (; i < last; i++) {
+      const uint64_t offset = slots[i].offset_ - start;
+      const size_t available = read_count > offset ? std::min<size_t>(read_count - offset, slots[i].capacity_) : 0;
+      char *page_data = data + i * BUSTUB_PAGE_SIZE;
+      if (!DecodeSlot(start_page_id + i, buffer.data() + offset, available, page_data)) {
+        LOG_DEBUG("I/O error while reading");
+        memset(page_data, 0, BUSTUB_PAGE_SIZE);
+      }
+    }
+  }
+}
+
+void DiskManagerCompressed::Sync() {
+  std::scoped_lock sync_lock(sync_latch_);
+  if (fd_ == -1) {
+    return;
+  }
+  std::vector<Slot> map;
+  std::vector<Slot> released;
+  bool map_dirty;
+  {
+    std::unique_lock lock(map_latch_);
+    map_dirty = map_dirty_;
+    if (map_dirty_) {
+      map = map_;
+      released.swap(pending_free_);
+      map_dirty_ = false;
+    }
+    // The map taken points to the slots of the writes begun so far, which may not have reached the file yet. Later
+    // writes count in the other generation, so that a stream of them cannot hold off the sync.
+    const size_t generation = sync_epoch_++ & 1;
+    writes_cv_.wait(lock, [&] { return writes_in_flight_[generation] == 0; });
+  }
+  // the slots the new map points to must be durable before the map is
+  bool synced = true;
+  if (unsynced_.exchange(false)) {
+    num_syncs_++;
+    synced = fdatasync(fd_) == 0;
+  }
+  if (!map_dirty) {
+    if (!synced) {
+      LOG_DEBUG("I/O error while syncing");
+      unsynced_ = true;
+    }
+    return;
+  }
+  const bool saved = synced && SaveMap(map);
+  std::scoped_lock lock(map_latch_);
+  if (!saved) {
+    LOG_DEBUG("I/O error while syncing or saving the page map");
+    unsynced_ = unsynced_ || !synced;
+    map_dirty_ = true;
+    pending_free_.insert(pending_free_.end(), released.begin(), released.end());
+    return;
+  }
+  for (const auto &slot : released) {
+    free_slots_[slot.capacity_ / SLOT_ALIGNMENT].push_back(slot.offset_);
+  }
+}
+
+auto DiskManagerCompressed::GetDbFileSize() const -> int64_t {
+  std::scoped_lock lock(map_latch_);
+  return file_end_;
+}
+
+auto DiskManagerCompressed::GetCompressionRatio() const -> double {
+  std::scoped_lock lock(map_latch_);
+  if (stored_bytes_ == 0) {
+    return 0;
+  }
+  return static_cast<double>(num_pages_ * BUSTUB_PAGE_SIZE) / stored_bytes_;
+}
+
+}  // namespace bustub
@@ -12,6 +12,7 @@
 
 #include "storage/disk/disk_manager_memory.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cstddef>
 #include <cstring>
@@ -27,24 +28,158 @@ namespace bustub {
 /**
  * Constructor: used for memory based manager
  */
-DiskManagerMemory::DiskManagerMemory(size_t pages) { memory_ = new char[pages * BUSTUB_PAGE_SIZE]; }
+DiskManagerMemory::DiskManagerMemory(size_t pages, const DiskLatencyModel &model) {
+  chunks_.reserve((pages + CHUNK_PAGES - 1) / CHUNK_PAGES);
+  SetLatencyModel(model);
+}
+
+auto DiskManagerMemory::GetChunk(page_id_t page_id, bool create) -> char * {
+  const auto chunk = static_cast<size_t>(page_id) / CHUNK_PAGES;
+  {
+    std::shared_lock<std::shared_mutex> lock(chunks_latch_);
+    if (chunk < chunks_.size() && chunks_[chunk] != nullptr) {
+      return chunks_[chunk].get();
+    }
+  }
+  if (!create) {
+    return nullptr;
+  }
+  std::unique_lock<std::shared_mutex> lock(chunks_latch_);
+  if (chunk >= chunks_.size()) {
+    chunks_.resize(chunk + 1);
+  }
+  if (chunks_[chunk] == nullptr) {
+    chunks_[chunk] = std::make_unique<char[]>(CHUNK_PAGES * BUSTUB_PAGE_SIZE);
+  }
+  // chunks are never freed, the memory stays valid once the latch is released
+  return chunks_[chunk].get();
+}
+
+void DiskManagerMemory::Serve(page_id_t start_page_id, size_t num_pages, bool is_write) {
+  (is_write ? writes_ : reads_)++;
+  (is_write ? pages_written_ : pages_read_) += num_pages;
+  const bool seek = next_page_id_.exchange(start_page_id + static_cast<page_id_t>(num_pages)) != start_page_id;
+  seeks_ += seek ? 1 : 0;
+  if (!timed_) {
+    return;
+  }
+  std::chrono::steady_clock::time_point done;
+  bool sleep;
+  {
+    std::scoped_lock<std::mutex> lock(model_latch_);
+    std::chrono::nanoseconds latency = is_write ? model_.write_latency_ : model_.read_latency_;
+    if (latency.count() > 0 && model_.distribution_ != DiskLatencyModel::Distribution::FIXED) {
+      const auto mean = static_cast<double>(latency.count());
+      const double drawn = model_.distribution_ == DiskLatencyModel::Distribution::UNIFORM
+                               ? std::uniform_real_distribution<double>(0, 2 * mean)(gen_)
+                               : std::exponential_distribution<double>(1 / mean)(gen_);
+      latency = std::chrono::nanoseconds(static_cast<int64_t>(drawn));
+    }
+    std::chrono::nanoseconds occupancy = seek ? model_.seek_latency_ : std::chrono::nanoseconds(0);
+    if (model_.bandwidth_ > 0) {
+      occupancy += std::chrono::nanoseconds(num_pages * BUSTUB_PAGE_SIZE * 1000000000 / model_.bandwidth_);
+    }
+    // seeks and transfers take turns on the device, latencies overlap
+    busy_until_ = std::max(busy_until_, std::chrono::steady_clock::now()) + occupancy;
+    done = busy_until_ + latency;
+    sleep = model_.sleep_;
+    device_time_ns_ += (occupancy + latency).count();
+  }
+  if (sleep) {
+    std::this_thread::sleep_until(done);
+  }
+}
 
 /**
  * Write the contents of the specified page into disk file
  */
 void DiskManagerMemory::WritePage(page_id_t page_id, const char *page_data) {
-  size_t offset = static_cast<size_t>(page_id) * BUSTUB_PAGE_SIZE;
+  Serve(page_id, 1, true);
+  CopyIn(page_id, page_data);
+}
+
+void DiskManagerMemory::CopyIn(page_id_t page_id, const char *page_data) {
+  OnPageWrite(page_id, page_data);
+  char *chunk = GetChunk(page_id, true);
   // set write cursor to offset
   num_writes_ += 1;
-  memcpy(memory_ + offset, page_data, BUSTUB_PAGE_SIZE);
+  memcpy(chunk + static_cast<size_t>(page_id) % CHUNK_PAGES * BUSTUB_PAGE_SIZE, page_data, BUSTUB_PAGE_SIZE);
+}
+
+void DiskManagerMemory::WritePages(std::vector<std::pair<page_id_t, const char *>> pages) {
+  if (pages.empty()) {
+    return;
+  }
+  std::sort(pages.begin(), pages.end(), [](const auto &a, const auto &b) { return a.first < b.first; });
+  // the batch goes out as one request per run of consecutive pages, like the vectored writes of DiskManager
+  for (size_t start = 0, end = 1; start < pages.size(); start = end++) {
+    while (end < pages.size() && pages[end].first == pages[end - 1].first + 1) {
+      end++;
+    }
+    Serve(pages[start].first, end - start, true);
+  }
+  for (const auto &[page_id, page_data] : pages) {
+    CopyIn(page_id, page_data);
+  }
 }
 
 /**
  * Read the contents of the specified page into the given memory area
  */
 void DiskManagerMemory::ReadPage(page_id_t page_id, char *page_data) {
-  int64_t offset = static_cast<int64_t>(page_id) * BUSTUB_PAGE_SIZE;
-  memcpy(page_data, memory_ + offset, BUSTUB_PAGE_SIZE);
+  Serve(page_id, 1, false);
+  CopyOut(page_id, page_data);
+}
+
+void DiskManagerMemory::CopyOut(page_id_t page_id, char *page_data) {
+  OnPageRead(page_id);
+  const char *chunk = GetChunk(page_id, false);
+  if (chunk == nullptr) {
+    memset(page_data, 0, BUSTUB_PAGE_SIZE);
+    return;
+  }
+  memcpy(page_data, chunk + static_cast<size_t>(page_id) % CHUNK_PAGES * BUSTUB_PAGE_SIZE, BUSTUB_PAGE_SIZE);
+}
+
+void DiskManagerMemory::ReadPages(page_id_t start_page_id, size_t num_pages, char *data) {
+  Serve(start_page_id, num_pages, false);
+  for (size_t i = 0; i < num_pages; i++) {
+    CopyOut(static_cast<page_id_t>(start_page_id + i), data + i * BUSTUB_PAGE_SIZE);
+  }
+}
+
+void DiskManagerMemory::SetLatencyModel(const DiskLatencyModel &model) {
+  std::scoped_lock<std::mutex> lock(model_latch_);
+  model_ = model;
+  gen_.seed(model.seed_);
+  timed_ = model.read_latency_.count() > 0 || model.write_latency_.count() > 0 || model.seek_latency_.count() > 0 ||
+           model.bandwidth_ > 0;
+}
+
+auto DiskManagerMemory::GetStats() -> DiskStats {
+  DiskStats stats;
+  stats.reads_ = reads_;
+  stats.writes_ = writes_;
+  stats.pages_read_ = pages_read_;
+  stats.pages_written_ = pages_written_;
+  stats.seeks_ = seeks_;
+  stats.device_time_ = std::chrono::nanoseconds(device_time_ns_);
+  return stats;
+}
+
+void DiskManagerMemory::ResetStats() {
+  reads_ = 0;
+  writes_ = 0;
+  pages_read_ = 0;
+  pages_written_ = 0;
+  seeks_ = 0;
+  device_time_ns_ = 0;
+}
+
+auto DiskManagerMemory::GetAllocatedSize() -> size_t {
+  std::shared_lock<std::shared_mutex> lock(chunks_latch_);
+  return std::count_if(chunks_.begin(), chunks_.end(), [](const auto &chunk) { return chunk != nullptr; }) *
+         CHUNK_PAGES * BUSTUB_PAGE_SIZE;
 }
 
 }  // namespace bustub
@@ -0,0 +1,189 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// disk_manager_mmap.cpp
+//
+// Identification: src/storage/disk/disk_manager_mmap.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/disk/disk_manager_mmap.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "common/exception.h"
+#include "common/logger.h"
+
+namespace bustub {
+
+namespace {
+
+auto RoundUp(size_t size, size_t multiple) -> size_t { return (size + multiple - 1) / multiple * multiple; }
+
+}  // namespace
+
+DiskManagerMmap::DiskManagerMmap(const std::string &db_file, bool zero_copy, size_t max_file_size)
+    : zero_copy_(zero_copy), max_file_size_(RoundUp(max_file_size, GROW_CHUNK_SIZE)) {
+  CheckPageSize(db_file);
+  file_name_ = db_file;
+  if (!OpenLog()) {
+    return;
+  }
+  fd_ = open(db_file.c_str(), O_RDWR | O_CREAT, 0644);
+  if (fd_ == -1) {
+    throw Exception("can't open db file");
+  }
+  struct stat stat_buf;
+  if (fstat(fd_, &stat_buf) != 0 || static_cast<size_t>(stat_buf.st_size) > max_file_size_) {
+    close(fd_);
+    throw Exception("db file is larger than the mapping");
+  }
+  file_size_ = stat_buf.st_size;
+  // reserve the address range of the largest file, without memory behind it, so that the mapping never moves
+  void *base = mmap(nullptr, max_file_size_, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+  if (base == MAP_FAILED) {
+    close(fd_);
+    throw Exception("can't reserve the mapping of the db file");
+  }
+  base_ = static_cast<char *>(base);
+  if (file_size_ > 0 && !Grow(file_size_)) {
+    munmap(base_, max_file_size_);
+    close(fd_);
+    throw Exception("can't map db file");
+  }
+}
+
+DiskManagerMmap::~DiskManagerMmap() {
+  if (fd_ != -1) {
+    ShutDown();
+  }
+  if (base_ != nullptr) {
+    munmap(base_, max_file_size_);
+  }
+}
+
+void DiskManagerMmap::ShutDown() {
+  if (fd_ != -1) {
+    Sync();
+    // drop the unused end of the last chunk; the mapping past the file is never touched again
+    if (ftruncate(fd_, file_size_) != 0) {
+      LOG_DEBUG("I/O error while truncating");
+    }
+    close(fd_);
+    fd_ = -1;
+  }
+  DiskManager::ShutDown();
+}
+
+auto DiskManagerMmap::Grow(size_t end) -> bool {
+  std::scoped_lock<std::mutex> lock(grow_latch_);
+  const size_t mapped_size = mapped_size_;
+  if (end <= mapped_size) {
+    return true;
+  }
+  const size_t new_size = RoundUp(end, GROW_CHUNK_SIZE);
+  if (new_size > max_file_size_) {
+    return false;
+  }
+  // the file has to cover the mapping, touching a mapped page past the end of the file faults
+  if (ftruncate(fd_, new_size) != 0) {
+    LOG_DEBUG("I/O error while growing the db file");
+    return false;
+  }
+  const int prot = zero_copy_ ? PROT_READ : PROT_READ | PROT_WRITE;
+  if (mmap(base_ + mapped_size, new_size - mapped_size, prot, MAP_SHARED | MAP_FIXED, fd_,
+           static_cast<off_t>(mapped_size)) == MAP_FAILED) {
+    LOG_DEBUG("can't map db file (errno %d)", errno);
+    return false;
+  }
+  mapped_size_.store(new_size, std::memory_order_release);
+  return true;
+}
+
+void DiskManagerMmap::WritePage(page_id_t page_id, const char *page_data) {
+  const size_t offset = static_cast<size_t>(page_id) * BUSTUB_PAGE_SIZE;
+  const size_t end = offset + BUSTUB_PAGE_SIZE;
+  if (end > mapped_size_.load(std::memory_order_acquire) && !Grow(end)) {
+    LOG_DEBUG("I/O error while writing");
+    return;
+  }
+  num_writes_ += 1;
+  if (zero_copy_) {
+    // the mapping is read-only, the write goes through the page cache it maps
+    size_t written = 0;
+    while (written < BUSTUB_PAGE_SIZE) {
+      const ssize_t count = pwrite(fd_, page_data + written, BUSTUB_PAGE_SIZE - written, offset + written);
+      if (count < 0 && errno == EINTR) {
+        continue;
+      }
+      if (count <= 0) {
+        LOG_DEBUG("I/O error while writing");
+        return;
+      }
+      written += count;
+    }
+  } else if (page_data != base_ + offset) {
+    memcpy(base_ + offset, page_data, BUSTUB_PAGE_SIZE);
+  }
+  unsynced_ = true;
+  int64_t size = file_size_;
+  while (size < static_cast<int64_t>(end) && !file_size_.compare_exchange_weak(size, end)) {
+  }
+}
+
+void DiskManagerMmap::WritePages(std::vector<std::pair<page_id_t, const char *>> pages) {
+  for (const auto &[page_id, page_data] : pages) {
+    WritePage(page_id, page_data);
+  }
+  Sync();
+}
+
+void DiskManagerMmap::ReadPage(page_id_t page_id, char *page_data) {
+  ReadAt(page_data, BUSTUB_PAGE_SIZE, static_cast<int64_t>(page_id) * BUSTUB_PAGE_SIZE);
+}
+
+void DiskManagerMmap::ReadPages(page_id_t start_page_id, size_t num_pages, char *data) {
+  ReadAt(data, num_pages * BUSTUB_PAGE_SIZE, static_cast<int64_t>(start_page_id) * BUSTUB_PAGE_SIZE);
+}
+
+void DiskManagerMmap::ReadAt(char *data, size_t size, int64_t offset) {
+  // the file is mapped at least up to file_size_
+  const int64_t file_size = file_size_;
+  const size_t available = offset < file_size ? std::min<size_t>(size, file_size - offset) : 0;
+  memcpy(data, base_ + offset, available);
+  memset(data + available, 0, size - available);
+}
+
+auto DiskManagerMmap::GetPageView(page_id_t page_id) -> const char * {
+  const int64_t offset = static_cast<int64_t>(page_id) * BUSTUB_PAGE_SIZE;
+  if (!zero_copy_ || offset + BUSTUB_PAGE_SIZE > file_size_) {
+    return nullptr;
+  }
+  return base_ + offset;
+}
+
+void DiskManagerMmap::Sync() {
+  // a write racing with the sync sets the flag again, and is synced next time
+  if (fd_ == -1 || !unsynced_.exchange(false)) {
+    return;
+  }
+  num_syncs_++;
+  if (msync(base_, mapped_size_, MS_SYNC) != 0) {
+    LOG_DEBUG("I/O error while syncing");
+  }
+}
+
+}  // namespace bustub
@@ -0,0 +1,144 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// disk_manager_posix.cpp
+//
+// Identification: src/storage/disk/disk_manager_posix.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/disk/disk_manager_posix.h"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "common/exception.h"
+#include "common/logger.h"
+
+namespace bustub {
+
+DiskManagerPosix::DiskManagerPosix(const std::string &db_file) {
+  CheckPageSize(db_file);
+  file_name_ = db_file;
+  if (!OpenLog()) {
+    return;
+  }
+  fd_ = open(db_file.c_str(), O_RDWR | O_CREAT, 0644);
+  if (fd_ == -1) {
+    throw Exception("can't open db file");
+  }
+  struct stat stat_buf;
+  if (fstat(fd_, &stat_buf) == 0) {
+    file_size_ = stat_buf.st_size;
+  }
+}
+
+DiskManagerPosix::~DiskManagerPosix() {
+  if (fd_ != -1) {
+    Sync();
+    close(fd_);
+  }
+}
+
+void DiskManagerPosix::ShutDown() {
+  if (fd_ != -1) {
+    Sync();
+    close(fd_);
+    fd_ = -1;
+  }
+  DiskManager::ShutDown();
+}
+
+void DiskManagerPosix::WritePage(page_id_t page_id, const char *page_data) {
+  const int64_t offset = static_cast<int64_t>(page_id) * BUSTUB_PAGE_SIZE;
+  num_writes_ += 1;
+  size_t written = 0;
+  while (written < BUSTUB_PAGE_SIZE) {
+    const ssize_t count = pwrite(fd_, page_data + written, BUSTUB_PAGE_SIZE - written, offset + written);
+    if (count < 0 && errno == EINTR) {
+      continue;
+    }
+    if (count <= 0) {
+      LOG_DEBUG("I/O error while writing");
+      return;
+    }
+    written += count;
+  }
+  unsynced_ = true;
+  // the file only grows, publish the new end unless a concurrent write went further
+  const int64_t end = offset + BUSTUB_PAGE_SIZE;
+  int64_t size = file_size_;
+  while (size < end && !file_size_.compare_exchange_weak(size, end)) {
+  }
+}
+
+void DiskManagerPosix::WritePages(std::vector<std::pair<page_id_t, const char *>> pages) {
+  if (pages.empty()) {
+    return;
+  }
+  if (!WriteRuns(fd_, &pages)) {
+    LOG_DEBUG("I/O error while writing");
+    return;
+  }
+  unsynced_ = true;
+  // the pages are sorted now
+  const int64_t end = (static_cast<int64_t>(pages.back().first) + 1) * BUSTUB_PAGE_SIZE;
+  int64_t size = file_size_;
+  while (size < end && !file_size_.compare_exchange_weak(size, end)) {
+  }
+  Sync();
+}
+
+void DiskManagerPosix::ReadPage(page_id_t page_id, char *page_data) {
+  ReadAt(page_data, BUSTUB_PAGE_SIZE, static_cast<int64_t>(page_id) * BUSTUB_PAGE_SIZE);
+}
+
+void DiskManagerPosix::ReadPages(page_id_t start_page_id, size_t num_pages, char *data) {
+  ReadAt(data, num_pages * BUSTUB_PAGE_SIZE, static_cast<int64_t>(start_page_id) * BUSTUB_PAGE_SIZE);
+}
+
+void DiskManagerPosix::ReadAt(char *data, size_t size, int64_t offset) {
+  // nothing to read past the end of the file, no need to ask the OS
+  const int64_t file_size = file_size_;
+  size_t read_count = 0;
+  const size_t available = offset < file_size ? std::min<size_t>(size, file_size - offset) : 0;
+  while (read_count < available) {
+    const ssize_t count = pread(fd_, data + read_count, available - read_count, offset + read_count);
+    if (count < 0 && errno == EINTR) {
+      continue;
+    }
+    if (count < 0) {
+      LOG_DEBUG("I/O error while reading");
+      return;
+    }
+    if (count == 0) {
+      break;
+    }
+    read_count += count;
+  }
+  memset(data + read_count, 0, size - read_count);
+}
+
+void DiskManagerPosix::Sync() {
+  // a write racing with the sync sets the flag again, and is synced next time
+  if (fd_ == -1 || !unsynced_.exchange(false)) {
+    return;
+  }
+  num_syncs_++;
+  if (fdatasync(fd_) != 0) {
+    LOG_DEBUG("I/O error while syncing");
+  }
+}
+
+}  // namespace bustub
@@ -0,0 +1,340 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// disk_scheduler.cpp
+//
+// Identification: src/storage/disk/disk_scheduler.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/disk/disk_scheduler.h"
+
+#include <fcntl.h>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <string>
+#include <utility>
+
+#include "common/logger.h"
+
+namespace bustub {
+
+namespace {
+
+/** The user data of the request that wakes up the completion thread to stop it. */
+constexpr uint64_t STOP_USER_DATA = 0;
+
+auto IoUringSetup(unsigned entries, struct io_uring_params *params) -> int {
+  return static_cast<int>(syscall(__NR_io_uring_setup, entries, params));
+}
+
+auto IoUringEnter(int ring_fd, unsigned to_submit, unsigned min_complete, unsigned flags) -> int {
+  return static_cast<int>(syscall(__NR_io_uring_enter, ring_fd, to_submit, min_complete, flags, nullptr, 0));
+}
+
+auto AllocateAligned() -> char * {
+  return static_cast<char *>(::operator new[](BUSTUB_PAGE_SIZE, std::align_val_t{DiskManager::DIRECT_IO_ALIGNMENT}));
+}
+
+void FreeAligned(char *buffer) { ::operator delete[](buffer, std::align_val_t{DiskManager::DIRECT_IO_ALIGNMENT}); }
+
+}  // namespace
+
+DiskScheduler::DiskScheduler(DiskManager *disk_manager, size_t queue_depth, Backend backend)
+    : disk_manager_(disk_manager), queue_depth_(std::max<size_t>(queue_depth, 1)) {
+  const std::string file_name = disk_manager->GetPageFileName();
+  if (!file_name.empty()) {
+#ifdef O_DIRECT
+    if (disk_manager->IsDirectIo()) {
+      fd_ = open(file_name.c_str(), O_RDWR | O_DIRECT);
+      direct_io_ = fd_ != -1;
+    }
+#endif
+    if (fd_ == -1) {
+      fd_ = open(file_name.c_str(), O_RDWR);
+    }
+    if (fd_ == -1) {
+      LOG_WARN("cannot open %s (errno %d), going through the disk manager", file_name.c_str(), errno);
+    }
+  }
+  if (fd_ != -1 && backend == Backend::IO_URING && SetUpRing()) {
+    threads_.emplace_back(&DiskScheduler::ReapRing, this);
+    return;
+  }
+  const size_t num_threads = std::min<size_t>(queue_depth_, DISK_SCHEDULER_MAX_THREADS);
+  for (size_t i = 0; i < num_threads; i++) {
+    threads_.emplace_back(&DiskScheduler::Work, this);
+  }
+}
+
+DiskScheduler::~DiskScheduler() {
+  {
+    std::unique_lock<std::mutex> lock(latch_);
+    slot_cv_.wait(lock, [&] { return in_flight_ == 0; });
+    stopping_ = true;
+    queue_cv_.notify_all();
+  }
+  if (ring_fd_ != -1) {
+    // the completion thread may be waiting in the kernel, wake it up with a request of its own
+    std::scoped_lock<std::mutex> sq_lock(sq_latch_);
+    const unsigned tail = *sq_tail_;
+    const unsigned index = tail & sq_mask_;
+    struct io_uring_sqe *sqe = &sqes_[index];
+    std::memset(sqe, 0, sizeof(*sqe));
+    sqe->opcode = IORING_OP_NOP;
+    sqe->user_data = STOP_USER_DATA;
+    sq_array_[index] = index;
+    __atomic_store_n(sq_tail_, tail + 1, __ATOMIC_RELEASE);
+    IoUringEnter(ring_fd_, 1, 0, 0);
+  }
+  for (auto &thread : threads_) {
+    thread.join();
+  }
+  if (ring_fd_ != -1) {
+    munmap(sqes_, sqes_size_);
+    if (cq_ring_ != sq_ring_) {
+      munmap(cq_ring_, cq_ring_size_);
+    }
+    munmap(sq_ring_, sq_ring_size_);
+    close(ring_fd_);
+  }
+  if (fd_ != -1) {
+    close(fd_);
+  }
+}
+
+void DiskScheduler::ScheduleRead(page_id_t page_id, char *data, Callback callback) {
+  Submit(false, page_id, data, std::move(callback));
+}
+
+void DiskScheduler::ScheduleWrite(page_id_t page_id, const char *data, Callback callback) {
+  // the data is only read, the request keeps a single pointer for both directions
+  Submit(true, page_id, const_cast<char *>(data), std::move(callback));
+}
+
+auto DiskScheduler::ScheduleRead(page_id_t page_id, char *data) -> std::future<bool> {
+  auto promise = std::make_shared<std::promise<bool>>();
+  auto future = promise->get_future();
+  ScheduleRead(page_id, data, [promise](bool success) { promise->set_value(success); });
+  return future;
+}
+
+auto DiskScheduler::ScheduleWrite(page_id_t page_id, const char *data) -> std::future<bool> {
+  auto promise = std::make_shared<std::promise<bool>>();
+  auto future = promise->get_future();
+  ScheduleWrite(page_id, data, [promise](bool success) { promise->set_value(success); });
+  return future;
+}
+
+void DiskScheduler::Submit(bool is_write, page_id_t page_id, char *data, Callback callback) {
+  auto *request = new Request{is_write, page_id, data, data, {}, std::move(callback)};
+  if (direct_io_ && reinterpret_cast<uintptr_t>(data) % DiskManager::DIRECT_IO_ALIGNMENT != 0) {
+    request->buffer_ = AllocateAligned();
+    if (is_write) {
+      std::memcpy(request->buffer_, data, BUSTUB_PAGE_SIZE);
+    }
+  }
+  request->iov_.iov_base = request->buffer_;
+  request->iov_.iov_len = BUSTUB_PAGE_SIZE;
+  std::unique_lock<std::mutex> lock(latch_);
+  slot_cv_.wait(lock, [&] { return in_flight_ < queue_depth_; });
+  in_flight_++;
+  if (ring_fd_ == -1) {
+    queue_.push_back(request);
+    queue_cv_.notify_one();
+    return;
+  }
+  lock.unlock();
+  SubmitToRing(request);
+}
+
+void DiskScheduler::Complete(Request *request, int64_t result) {
+  bool success;
+  if (request->is_write_) {
+    success = result == BUSTUB_PAGE_SIZE;
+  } else {
+    success = result >= 0;
+    // reading past the end of the file yields a zeroed page, like DiskManager::ReadPage()
+    if (success && result < BUSTUB_PAGE_SIZE) {
+      std::memset(request->buffer_ + result, 0, BUSTUB_PAGE_SIZE - result);
+    }
+    if (request->buffer_ != request->data_) {
+      std::memcpy(request->data_, request->buffer_, BUSTUB_PAGE_SIZE);
+    }
+  }
+  if (!success) {
+    LOG_DEBUG("I/O error on page %d: %ld", request->page_id_, static_cast<long>(result));  // NOLINT
+  }
+  if (request->buffer_ != request->data_) {
+    FreeAligned(request->buffer_);
+  }
+  // free the slot first, so that the callback may schedule another request
+  {
+    std::scoped_lock<std::mutex> lock(latch_);
+    in_flight_--;
+  }
+  slot_cv_.notify_all();
+  request->callback_(success);
+  delete request;
+}
+
+auto DiskScheduler::SetUpRing() -> bool {
+  struct io_uring_params params;
+  std::memset(&params, 0, sizeof(params));
+  // the kernel rounds the entries up to a power of two, the completion queue gets twice as many
+  const int ring_fd = IoUringSetup(static_cast<unsigned>(queue_depth_), &params);
+  if (ring_fd < 0) {
+    // e.g. ENOSYS on old kernels, EPERM if io_uring is disabled
+    LOG_INFO("io_uring is not available (errno %d), using a thread pool", errno);
+    return false;
+  }
+  sq_ring_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+  cq_ring_size_ = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+  const bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+  if (single_mmap) {
+    sq_ring_size_ = cq_ring_size_ = std::max(sq_ring_size_, cq_ring_size_);
+  }
+  sq_ring_ =
+      mmap(nullptr, sq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_SQ_RING);
+  if (sq_ring_ == MAP_FAILED) {
+    close(ring_fd);
+    return false;
+  }
+  cq_ring_ = single_mmap ? sq_ring_
+                         : mmap(nullptr, cq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd,
+                                IORING_OFF_CQ_RING);
+  sqes_size_ = params.sq_entries * sizeof(struct io_uring_sqe);
+  void *sqes = cq_ring_ == MAP_FAILED ? MAP_FAILED
+                                      : mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                                             ring_fd, IORING_OFF_SQES);
+  if (sqes == MAP_FAILED) {
+    if (cq_ring_ != MAP_FAILED && cq_ring_ != sq_ring_) {
+      munmap(cq_ring_, cq_ring_size_);
+    }
+    munmap(sq_ring_, sq_ring_size_);
+    close(ring_fd);
+    return false;
+  }
+  sqes_ = static_cast<struct io_uring_sqe *>(sqes);
+  auto *sq = static_cast<char *>(sq_ring_);
+  auto *cq = static_cast<char *>(cq_ring_);
+  sq_head_ = reinterpret_cast<unsigned *>(sq + params.sq_off.head);
+  sq_tail_ = reinterpret_cast<unsigned *>(sq + params.sq_off.tail);
+  sq_mask_ = *reinterpret_cast<unsigned *>(sq + params.sq_off.ring_mask);
+  sq_array_ = reinterpret_cast<unsigned *>(sq + params.sq_off.array);
+  cq_head_ = reinterpret_cast<unsigned *>(cq + params.cq_off.head);
+  cq_tail_ = reinterpret_cast<unsigned *>(cq + params.cq_off.tail);
+  cq_mask_ = *reinterpret_cast<unsigned *>(cq + params.cq_off.ring_mask);
+  cqes_ = reinterpret_cast<struct io_uring_cqe *>(cq + params.cq_off.cqes);
+  ring_fd_ = ring_fd;
+  return true;
+}
+
+void DiskScheduler::SubmitToRing(Request *request) {
+  std::unique_lock<std::mutex> sq_lock(sq_latch_);
+  // the slots bound the requests in flight by the size of the submission queue, it never overflows
+  const unsigned tail = *sq_tail_;
+  const unsigned index = tail & sq_mask_;
+  struct io_uring_sqe *sqe = &sqes_[index];
+  std::memset(sqe, 0, sizeof(*sqe));
+  // the vectored operations are the ones every kernel with io_uring supports
+  sqe->opcode = request->is_write_ ? IORING_OP_WRITEV : IORING_OP_READV;
+  sqe->fd = fd_;
+  sqe->off = static_cast<uint64_t>(request->page_id_) * BUSTUB_PAGE_SIZE;
+  sqe->addr = reinterpret_cast<uint64_t>(&request->iov_);
+  sqe->len = 1;
+  sqe->user_data = reinterpret_cast<uint64_t>(request);
+  sq_array_[index] = index;
+  __atomic_store_n(sq_tail_, tail + 1, __ATOMIC_RELEASE);
+  int rc;
+  do {
+    rc = IoUringEnter(ring_fd_, 1, 0, 0);
+  } while (rc < 0 && (errno == EINTR || errno == EAGAIN));
+  if (rc >= 0) {
+    return;
+  }
+  const int error = errno;
+  LOG_WARN("io_uring_enter failed on page %d (errno %d)", request->page_id_, error);
+  if (__atomic_load_n(sq_head_, __ATOMIC_ACQUIRE) != tail) {
+    // the kernel consumed the entry after all, its completion reports the outcome
+    return;
+  }
+  // take the entry back, so that it is neither submitted by a later call nor left without a completion
+  __atomic_store_n(sq_tail_, tail, __ATOMIC_RELEASE);
+  sq_lock.unlock();
+  Complete(request, -error);
+}
+
+void DiskScheduler::ReapRing() {
+  while (true) {
+    const unsigned head = *cq_head_;
+    if (head == __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE)) {
+      IoUringEnter(ring_fd_, 0, 1, IORING_ENTER_GETEVENTS);
+      continue;
+    }
+    const struct io_uring_cqe cqe = cqes_[head & cq_mask_];
+    __atomic_store_n(cq_head_, head + 1, __ATOMIC_RELEASE);
+    if (cqe.user_data == STOP_USER_DATA) {
+      return;
+    }
+    Complete(reinterpret_cast<Request *>(cqe.user_data), cqe.res);
+  }
+}
+
+void DiskScheduler::Work() {
+  std::unique_lock<std::mutex> lock(latch_);
+  while (true) {
+    queue_cv_.wait(lock, [&] { return stopping_ || !queue_.empty(); });
+    if (queue_.empty()) {
+      return;
+    }
+    Request *request = queue_.front();
+    queue_.pop_front();
+    lock.unlock();
+    Complete(request, DoIo(request));
+    lock.lock();
+  }
+}
+
+auto DiskScheduler::DoIo(Request *request) -> int64_t {
+  if (fd_ == -1) {
+    if (request->is_write_) {
+      disk_manager_->WritePage(request->page_id_, request->buffer_);
+    } else {
+      disk_manager_->ReadPage(request->page_id_, request->buffer_);
+    }
+    return BUSTUB_PAGE_SIZE;
+  }
+  const off_t offset = static_cast<off_t>(request->page_id_) * BUSTUB_PAGE_SIZE;
+  size_t done = 0;
+  while (done < BUSTUB_PAGE_SIZE) {
+    const ssize_t count =
+        request->is_write_ ? pwrite(fd_, request->buffer_ + done, BUSTUB_PAGE_SIZE - done, offset + done)
+                           : pread(fd_, request->buffer_ + done, BUSTUB_PAGE_SIZE - done, offset + done);
+    if (count < 0 && errno == EINTR) {
+      continue;
+    }
+    if (count < 0) {
+      return -errno;
+    }
+    if (count == 0) {
+      // the end of the file
+      break;
+    }
+    done += count;
+  }
+  return static_cast<int64_t>(done);
+}
+
+}  // namespace bustub
@@ -0,0 +1,168 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// page_allocator.cpp
+//
+// Identification: src/storage/disk/page_allocator.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/disk/page_allocator.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace bustub {
+
+PageAllocator::PageAllocator(DiskManager *disk_manager) : disk_manager_(disk_manager) {
+  auto first = std::make_unique<char[]>(BUSTUB_PAGE_SIZE);
+  disk_manager_->ReadPage(1, first.get());
+  uint32_t magic;
+  uint32_t num_bitmap_pages;
+  memcpy(&magic, first.get(), sizeof(uint32_t));
+  memcpy(&num_bitmap_pages, first.get() + sizeof(uint32_t), sizeof(uint32_t));
+  if (magic != MAGIC) {
+    // a new database file, bitmap pages are created on demand
+    return;
+  }
+  bitmaps_.push_back({std::move(first), false});
+  for (uint32_t region = 1; region < num_bitmap_pages; region++) {
+    auto data = std::make_unique<char[]>(BUSTUB_PAGE_SIZE);
+    disk_manager_->ReadPage(static_cast<page_id_t>(region) * BITS_PER_BITMAP + 1, data.get());
+    memcpy(&magic, data.get(), sizeof(uint32_t));
+    BUSTUB_ASSERT(magic == MAGIC, "corrupted free-space bitmap");
+    bitmaps_.push_back({std::move(data), false});
+  }
+}
+
+PageAllocator::~PageAllocator() { Flush(); }
+
+auto PageAllocator::GetBitmap(size_t region) -> uint64_t * {
+  while (bitmaps_.size() <= region) {
+    auto data = std::make_unique<char[]>(BUSTUB_PAGE_SIZE);
+    memset(data.get(), 0, BUSTUB_PAGE_SIZE);
+    memcpy(data.get(), &MAGIC, sizeof(uint32_t));
+    bitmaps_.push_back({std::move(data), true});
+    // the bitmap page allocates itself
+    SetBit(static_cast<page_id_t>(bitmaps_.size() - 1) * BITS_PER_BITMAP + 1, true);
+  }
+  return reinterpret_cast<uint64_t *>(bitmaps_[region].data_.get() + BITMAP_HEADER_SIZE);
+}
+
+auto PageAllocator::TestBit(page_id_t page_id) -> bool {
+  const auto region = static_cast<size_t>(page_id / BITS_PER_BITMAP);
+  if (region >= bitmaps_.size()) {
+    return false;
+  }
+  const page_id_t bit = page_id % BITS_PER_BITMAP;
+  return (GetBitmap(region)[bit / 64] >> (bit % 64) & 1) != 0;
+}
+
+void PageAllocator::SetBit(page_id_t page_id, bool allocated) {
+  const auto region = static_cast<size_t>(page_id / BITS_PER_BITMAP);
+  const page_id_t bit = page_id % BITS_PER_BITMAP;
+  uint64_t *words = GetBitmap(region);
+  if (allocated) {
+    words[bit / 64] |= uint64_t{1} << (bit % 64);
+  } else {
+    words[bit / 64] &= ~(uint64_t{1} << (bit % 64));
+  }
+  bitmaps_[region].dirty_ = true;
+}
+
+auto PageAllocator::AllocatePage(uint32_t num_instances, uint32_t instance_index) -> page_id_t {
+  std::scoped_lock<std::mutex> lock(latch_);
+  // round a page id up to the next page id of the instance
+  auto align = [&](page_id_t page_id) {
+    return page_id + static_cast<page_id_t>((instance_index + num_instances - page_id % num_instances) % num_instances);
+  };
+  if (num_instances != hint_num_instances_) {
+    // the hints of another instance layout say nothing about this one
+    first_free_hints_.assign(num_instances, 0);
+    hint_num_instances_ = num_instances;
+  }
+  page_id_t page_id = align(first_free_hints_[instance_index]);
+  while (true) {
+    const auto region = static_cast<size_t>(page_id / BITS_PER_BITMAP);
+    const page_id_t bit = page_id % BITS_PER_BITMAP;
+    if (region < bitmaps_.size() && GetBitmap(region)[bit / 64] == ~uint64_t{0}) {
+      // skip the rest of a word of allocated pages
+      page_id = align(page_id - bit % 64 + 64);
+      continue;
+    }
+    // the bitmap page of a region that does not exist yet is not marked
+    if (!IsBitmapPage(page_id) && !TestBit(page_id)) {
+      break;
+    }
+    page_id += static_cast<page_id_t>(num_instances);
+  }
+  SetBit(page_id, true);
+  first_free_hints_[instance_index] = page_id + static_cast<page_id_t>(num_instances);
+  return page_id;
+}
+
+auto PageAllocator::AllocateExtent() -> page_id_t {
+  std::scoped_lock<std::mutex> lock(latch_);
+  page_id_t first = first_extent_hint_;
+  while (true) {
+    bool free = true;
+    for (page_id_t page_id = first; page_id < first + EXTENT_SIZE && free; page_id++) {
+      // the bitmap page of a region that does not exist yet is not marked
+      free = !IsBitmapPage(page_id) && !TestBit(page_id);
+    }
+    if (free) {
+      for (page_id_t page_id = first; page_id < first + EXTENT_SIZE; page_id++) {
+        SetBit(page_id, true);
+      }
+      first_extent_hint_ = first + EXTENT_SIZE;
+      return first;
+    }
+    first += EXTENT_SIZE;
+  }
+}
+
+void PageAllocator::DeallocatePage(page_id_t page_id) {
+  if (page_id < 0 || IsBitmapPage(page_id)) {
+    // never allocated
+    return;
+  }
+  std::scoped_lock<std::mutex> lock(latch_);
+  if (!TestBit(page_id)) {
+    return;
+  }
+  SetBit(page_id, false);
+  if (hint_num_instances_ > 0) {
+    page_id_t &hint = first_free_hints_[static_cast<uint32_t>(page_id) % hint_num_instances_];
+    hint = std::min(hint, page_id);
+  }
+  first_extent_hint_ = std::min(first_extent_hint_, page_id - page_id % EXTENT_SIZE);
+}
+
+auto PageAllocator::IsAllocated(page_id_t page_id) -> bool {
+  std::scoped_lock<std::mutex> lock(latch_);
+  return page_id >= 0 && TestBit(page_id);
+}
+
+void PageAllocator::Flush() {
+  std::scoped_lock<std::mutex> lock(latch_);
+  const auto num_bitmap_pages = static_cast<uint32_t>(bitmaps_.size());
+  if (num_bitmap_pages > 0) {
+    uint32_t stored;
+    memcpy(&stored, bitmaps_[0].data_.get() + sizeof(uint32_t), sizeof(uint32_t));
+    if (stored != num_bitmap_pages) {
+      memcpy(bitmaps_[0].data_.get() + sizeof(uint32_t), &num_bitmap_pages, sizeof(uint32_t));
+      bitmaps_[0].dirty_ = true;
+    }
+  }
+  for (size_t region = 0; region < bitmaps_.size(); region++) {
+    if (bitmaps_[region].dirty_) {
+      disk_manager_->WritePage(static_cast<page_id_t>(region) * BITS_PER_BITMAP + 1, bitmaps_[region].data_.get());
+      bitmaps_[region].dirty_ = false;
+    }
+  }
+}
+
+}  // namespace bustub
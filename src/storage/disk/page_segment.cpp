@@ -0,0 +1,26 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// page_segment.cpp
+//
+// Identification: src/storage/disk/page_segment.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/disk/page_segment.h"
+
+namespace bustub {
+
+auto PageSegment::AllocatePage(const std::function<page_id_t()> &allocate_extent) -> page_id_t {
+  std::scoped_lock<std::mutex> lock(latch_);
+  if (next_page_id_ == end_page_id_) {
+    next_page_id_ = allocate_extent();
+    end_page_id_ = next_page_id_ + EXTENT_SIZE;
+  }
+  return next_page_id_++;
+}
+
+}  // namespace bustub
@@ -1,8 +1,12 @@
+#include <algorithm>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "common/config.h"
 #include "common/exception.h"
 #include "common/logger.h"
+#include "common/macros.h"
 #include "common/rid.h"
 #include "storage/index/b_plus_tree.h"
 #include "storage/page/b_plus_tree_page.h"
@@ -20,6 +24,12 @@ BPLUSTREE_TYPE::BPlusTree(std::string name, BufferPoolManager *buffer_pool_manag
       leaf_max_size_(leaf_max_size),
       internal_max_size_(internal_max_size) {}
 
+INDEX_TEMPLATE_ARGUMENTS
+BPLUSTREE_TYPE::~BPlusTree() {
+  std::scoped_lock<std::mutex> lock(pending_deletes_latch_);
+  DeletePendingPages();
+}
+
 /*
  * Helper function to decide whether current b+tree is empty
  */
@@ -35,13 +45,157 @@ auto BPLUSTREE_TYPE::IsEmpty() const -> bool { return root_page_id_ == INVALID_P
  */
 INDEX_TEMPLATE_ARGUMENTS
 auto BPLUSTREE_TYPE::GetValue(const KeyType &key, std::vector<ValueType> *result, Transaction *transaction) -> bool {
-  auto leaf_node = FindLeafPage(key);
+  Page *leaf_page = FindLeafRead(&key);
+  if (leaf_page == nullptr) {
+    return false;
+  }
+  auto leaf_node = reinterpret_cast<LeafPage *>(leaf_page->GetData());
   int index = leaf_node->KeyIndex(key, comparator_);
-  result->emplace_back(leaf_node->ValueAt(index));
-  buffer_pool_manager_->UnpinPage(leaf_node->GetPageId(), false);
+  if (index >= 0) {
+    result->emplace_back(leaf_node->ValueAt(index));
+  }
+  leaf_page->RUnlatch();
+  buffer_pool_manager_->UnpinPage(leaf_page->GetPageId(), false);
   return index >= 0;
 }
 
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::FindLeafRead(const KeyType *key) -> Page * {
+  root_latch_.RLock();
+  if (IsEmpty()) {
+    root_latch_.RUnlock();
+    return nullptr;
+  }
+  Page *page = buffer_pool_manager_->FetchPageReadOnly(root_page_id_);
+  page->RLatch();
+  root_latch_.RUnlock();
+  auto node = reinterpret_cast<BPlusTreePage *>(page->GetData());
+  while (!node->IsLeafPage()) {
+    auto internal_node = reinterpret_cast<InternalPage *>(node);
+    Page *child_page = buffer_pool_manager_->FetchPageReadOnly(
+        key == nullptr ? internal_node->ValueAt(0) : internal_node->FindKey(*key, comparator_));
+    child_page->RLatch();
+    page->RUnlatch();
+    buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+    page = child_page;
+    node = reinterpret_cast<BPlusTreePage *>(page->GetData());
+  }
+  return page;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::FindLeafPage(const KeyType &key) -> LeafPage * {
+  Page *leaf_page = FindLeafRead(&key);
+  if (leaf_page == nullptr) {
+    return nullptr;
+  }
+  leaf_page->RUnlatch();
+  return reinterpret_cast<LeafPage *>(leaf_page->GetData());
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::FindLeafOptimistic(const KeyType &key) -> Page * {
+  root_latch_.RLock();
+  if (IsEmpty()) {
+    root_latch_.RUnlock();
+    return nullptr;
+  }
+  // the type of a page never changes while it is in the tree, so it can be read before the page is latched
+  Page *page = buffer_pool_manager_->FetchPage(root_page_id_);
+  auto node = reinterpret_cast<BPlusTreePage *>(page->GetData());
+  if (node->IsLeafPage()) {
+    page->WLatch();
+  } else {
+    page->RLatch();
+  }
+  root_latch_.RUnlock();
+  while (!node->IsLeafPage()) {
+    auto internal_node = reinterpret_cast<InternalPage *>(node);
+    Page *child_page = buffer_pool_manager_->FetchPage(internal_node->FindKey(key, comparator_));
+    auto child_node = reinterpret_cast<BPlusTreePage *>(child_page->GetData());
+    if (child_node->IsLeafPage()) {
+      child_page->WLatch();
+    } else {
+      child_page->RLatch();
+    }
+    page->RUnlatch();
+    buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+    page = child_page;
+    node = child_node;
+  }
+  return page;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::FindLeafPessimistic(const KeyType &key, OpType op, Transaction *transaction) -> Page * {
+  root_latch_.WLock();
+  transaction->AddIntoPageSet(nullptr);
+  if (IsEmpty()) {
+    return nullptr;
+  }
+  Page *page = buffer_pool_manager_->FetchPage(root_page_id_);
+  page->WLatch();
+  auto node = reinterpret_cast<BPlusTreePage *>(page->GetData());
+  if (IsSafe(node, op)) {
+    ReleaseLatches(transaction, false);
+  }
+  transaction->AddIntoPageSet(page);
+  while (!node->IsLeafPage()) {
+    page = buffer_pool_manager_->FetchPage(reinterpret_cast<InternalPage *>(node)->FindKey(key, comparator_));
+    page->WLatch();
+    node = reinterpret_cast<BPlusTreePage *>(page->GetData());
+    if (IsSafe(node, op)) {
+      ReleaseLatches(transaction, false);
+    }
+    transaction->AddIntoPageSet(page);
+  }
+  return page;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::IsSafe(BPlusTreePage *node, OpType op) -> bool {
+  if (op == OpType::INSERT) {
+    // a leaf splits once it is full, an internal page once it overflows
+    return node->IsLeafPage() ? node->GetSize() + 1 < node->GetMaxSize() : node->GetSize() < node->GetMaxSize();
+  }
+  if (node->IsRootPage()) {
+    // a root leaf is removed with its last key, a root internal page is replaced by its child when it has one left
+    return node->GetSize() > (node->IsLeafPage() ? 1 : 2);
+  }
+  return node->GetSize() > node->GetMinSize();
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::ReleaseLatches(Transaction *transaction, bool is_dirty) {
+  auto page_set = transaction->GetPageSet();
+  for (Page *page : *page_set) {
+    if (page == nullptr) {
+      root_latch_.WUnlock();
+    } else {
+      page->WUnlatch();
+      buffer_pool_manager_->UnpinPage(page->GetPageId(), is_dirty);
+    }
+  }
+  page_set->clear();
+  auto deleted_page_set = transaction->GetDeletedPageSet();
+  if (deleted_page_set->empty() && !has_pending_deletes_) {
+    return;
+  }
+  std::scoped_lock<std::mutex> lock(pending_deletes_latch_);
+  pending_deletes_.insert(pending_deletes_.end(), deleted_page_set->begin(), deleted_page_set->end());
+  deleted_page_set->clear();
+  DeletePendingPages();
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::DeletePendingPages() {
+  // a page still pinned by an iterator stays allocated, so its id cannot be reused before it is deleted here
+  pending_deletes_.erase(std::remove_if(pending_deletes_.begin(), pending_deletes_.end(),
+                                        [&](page_id_t page_id) { return buffer_pool_manager_->DeletePage(page_id); }),
+                         pending_deletes_.end());
+  has_pending_deletes_ = !pending_deletes_.empty();
+}
+
 /*****************************************************************************
  * INSERTION
  *****************************************************************************/
@@ -54,35 +208,177 @@ auto BPLUSTREE_TYPE::GetValue(const KeyType &key, std::vector<ValueType> *result
  */
 INDEX_TEMPLATE_ARGUMENTS
 auto BPLUSTREE_TYPE::Insert(const KeyType &key, const ValueType &value, Transaction *transaction) -> bool {
-  if (IsEmpty()) {
-    auto root_node = reinterpret_cast<LeafPage *>(buffer_pool_manager_->NewPage(&root_page_id_)->GetData());
+  // most inserts do not split the leaf, and only need to write-latch it
+  Page *leaf_page = FindLeafOptimistic(key);
+  if (leaf_page != nullptr) {
+    auto leaf_node = reinterpret_cast<LeafPage *>(leaf_page->GetData());
+    if (IsSafe(leaf_node, OpType::INSERT)) {
+      auto success = leaf_node->Insert(key, value, comparator_);
+      leaf_page->WUnlatch();
+      buffer_pool_manager_->UnpinPage(leaf_page->GetPageId(), success);
+      return success;
+    }
+    leaf_page->WUnlatch();
+    buffer_pool_manager_->UnpinPage(leaf_page->GetPageId(), false);
+  }
+
+  Transaction local_transaction(INVALID_TXN_ID);
+  if (transaction == nullptr) {
+    transaction = &local_transaction;
+  }
+  leaf_page = FindLeafPessimistic(key, OpType::INSERT, transaction);
+  if (leaf_page == nullptr) {
+    auto root_node =
+        reinterpret_cast<LeafPage *>(buffer_pool_manager_->NewPageInSegment(&root_page_id_, &leaf_segment_)->GetData());
     root_node->Init(root_page_id_, INVALID_PAGE_ID, leaf_max_size_);
     UpdateRootPageId(1);
     auto success = static_cast<bool>(root_node->Insert(key, value, comparator_));
     buffer_pool_manager_->UnpinPage(root_node->GetPageId(), true);
+    ReleaseLatches(transaction, true);
     return success;
   }
-  auto leaf_node = FindLeafPage(key);
+  auto leaf_node = reinterpret_cast<LeafPage *>(leaf_page->GetData());
   auto success = leaf_node->Insert(key, value, comparator_);
   if (leaf_node->GetSize() == leaf_node->GetMaxSize()) {
     Split(leaf_node);
   }
-  buffer_pool_manager_->UnpinPage(leaf_node->GetPageId(), true);
+  ReleaseLatches(transaction, true);
   return success;
 }
 
+/*****************************************************************************
+ * BULK LOADING
+ *****************************************************************************/
 INDEX_TEMPLATE_ARGUMENTS
-auto BPLUSTREE_TYPE::FindLeafPage(const KeyType &key) -> LeafPage * {
-  page_id_t cur_node_id = root_page_id_;
-  auto cur_node = reinterpret_cast<BPlusTreePage *>(buffer_pool_manager_->FetchPage(cur_node_id)->GetData());
-  while (!cur_node->IsLeafPage()) {
-    auto cur_internal_node = reinterpret_cast<InternalPage *>(cur_node);
-    auto new_node_id = cur_internal_node->FindKey(key, comparator_);
-    buffer_pool_manager_->UnpinPage(cur_node_id, false);
-    cur_node_id = new_node_id;
-    cur_node = reinterpret_cast<BPlusTreePage *>(buffer_pool_manager_->FetchPage(cur_node_id)->GetData());
-  }
-  return reinterpret_cast<LeafPage *>(cur_node);
+auto BPLUSTREE_TYPE::BulkLoad(const BulkLoadSource &source, double fill_factor) -> bool {
+  root_latch_.WLock();
+  if (!IsEmpty()) {
+    root_latch_.WUnlock();
+    return false;
+  }
+  // a leaf splits once it is full, an internal page once it overflows; see BPlusTreePage::GetMinSize() for the minimums
+  const int leaf_capacity = leaf_max_size_ - 1;
+  const int leaf_min_size = std::max(leaf_max_size_ / 2, 1);
+  const int internal_min_size = (internal_max_size_ - 1) / 2 + 1;
+  auto fill_size = [fill_factor](int min_size, int capacity) {
+    return std::clamp(static_cast<int>(fill_factor * capacity), min_size, capacity);
+  };
+  // the size of the last node of a level once evened out with the one before it, 0 if they fit in one node
+  auto last_size = [](int prev_size, int size, int min_size, int capacity) {
+    if (size >= min_size) {
+      return size;
+    }
+    return prev_size + size <= capacity ? 0 : (prev_size + size) / 2;
+  };
+  const int leaf_fill = fill_size(leaf_min_size, leaf_capacity);
+  const int internal_fill = fill_size(internal_min_size, internal_max_size_);
+
+  // the leaves, left to right; the previous one stays pinned until the last one is known to be large enough
+  std::vector<std::pair<KeyType, page_id_t>> level;
+  LeafPage *prev_leaf = nullptr;
+  LeafPage *leaf = nullptr;
+  KeyType key;
+  ValueType value;
+  while (source(&key, &value)) {
+    if (leaf != nullptr) {
+      const int cmp = comparator_(key, leaf->KeyAt(leaf->GetSize() - 1));
+      BUSTUB_ASSERT(cmp >= 0, "the entries of a bulk load must be sorted");
+      if (cmp == 0) {
+        continue;
+      }
+    }
+    if (leaf == nullptr || leaf->GetSize() == leaf_fill) {
+      page_id_t page_id;
+      auto new_leaf =
+          reinterpret_cast<LeafPage *>(buffer_pool_manager_->NewPageInSegment(&page_id, &leaf_segment_)->GetData());
+      new_leaf->Init(page_id, INVALID_PAGE_ID, leaf_max_size_);
+      if (leaf != nullptr) {
+        leaf->SetNextPageId(page_id);
+      }
+      if (prev_leaf != nullptr) {
+        buffer_pool_manager_->UnpinPage(prev_leaf->GetPageId(), true);
+      }
+      prev_leaf = leaf;
+      leaf = new_leaf;
+      level.emplace_back(key, page_id);
+    }
+    leaf->SetKeyAt(leaf->GetSize(), key);
+    leaf->SetValueAt(leaf->GetSize(), value);
+    leaf->IncreaseSize(1);
+  }
+  if (leaf == nullptr) {
+    root_latch_.WUnlock();
+    return true;
+  }
+  if (prev_leaf != nullptr) {
+    const int size = last_size(prev_leaf->GetSize(), leaf->GetSize(), leaf_min_size, leaf_capacity);
+    if (size == 0) {
+      prev_leaf->MoveFrom(leaf);
+      prev_leaf->SetNextPageId(INVALID_PAGE_ID);
+      level.pop_back();
+      const page_id_t page_id = leaf->GetPageId();
+      buffer_pool_manager_->UnpinPage(page_id, false);
+      buffer_pool_manager_->DeletePage(page_id);
+      leaf = nullptr;
+    } else if (size > leaf->GetSize()) {
+      // the last entries of the previous leaf move to the front of the last one
+      const int moved = size - leaf->GetSize();
+      for (int i = leaf->GetSize() - 1; i >= 0; i--) {
+        leaf->SetKeyAt(i + moved, leaf->KeyAt(i));
+        leaf->SetValueAt(i + moved, leaf->ValueAt(i));
+      }
+      for (int i = 0; i < moved; i++) {
+        leaf->SetKeyAt(i, prev_leaf->KeyAt(prev_leaf->GetSize() - moved + i));
+        leaf->SetValueAt(i, prev_leaf->ValueAt(prev_leaf->GetSize() - moved + i));
+      }
+      leaf->IncreaseSize(moved);
+      prev_leaf->IncreaseSize(-moved);
+      level.back().first = leaf->KeyAt(0);
+    }
+    buffer_pool_manager_->UnpinPage(prev_leaf->GetPageId(), true);
+  }
+  if (leaf != nullptr) {
+    buffer_pool_manager_->UnpinPage(leaf->GetPageId(), true);
+  }
+
+  // the internal pages, one level at a time, each over the first keys and the pages of the level below
+  while (level.size() > 1) {
+    const int num_children = static_cast<int>(level.size());
+    std::vector<int> sizes((num_children + internal_fill - 1) / internal_fill, internal_fill);
+    sizes.back() = num_children - internal_fill * (static_cast<int>(sizes.size()) - 1);
+    if (sizes.size() > 1) {
+      const int size = last_size(sizes[sizes.size() - 2], sizes.back(), internal_min_size, internal_max_size_);
+      sizes[sizes.size() - 2] += sizes.back() - size;
+      sizes.back() = size;
+      if (size == 0) {
+        sizes.pop_back();
+      }
+    }
+    std::vector<std::pair<KeyType, page_id_t>> parents;
+    int pos = 0;
+    for (const int size : sizes) {
+      page_id_t page_id;
+      auto node = reinterpret_cast<InternalPage *>(
+          buffer_pool_manager_->NewPageInSegment(&page_id, &internal_segment_)->GetData());
+      node->Init(page_id, INVALID_PAGE_ID, internal_max_size_);
+      for (int i = 0; i < size; i++) {
+        node->SetKeyAt(i, level[pos + i].first);
+        node->SetValueAt(i, level[pos + i].second);
+        Page *child_page = buffer_pool_manager_->FetchPage(level[pos + i].second);
+        reinterpret_cast<BPlusTreePage *>(child_page->GetData())->SetParentPageId(page_id);
+        buffer_pool_manager_->UnpinPage(child_page->GetPageId(), true);
+      }
+      node->IncreaseSize(size);
+      parents.emplace_back(level[pos].first, page_id);
+      buffer_pool_manager_->UnpinPage(page_id, true);
+      pos += size;
+    }
+    level = std::move(parents);
+  }
+  root_page_id_ = level[0].second;
+  UpdateRootPageId(1);
+  root_latch_.WUnlock();
+  return true;
 }
 
 INDEX_TEMPLATE_ARGUMENTS
@@ -90,14 +386,16 @@ template <typename ClassType>
 auto BPLUSTREE_TYPE::Split(ClassType *origin_node) -> ClassType * {
   // auto origin_node=reinterpret_cast<BPlusTreePage*>(buffer_pool_manager_->FetchPage(origin_node_id)->GetData());
   page_id_t new_node_id;
-  auto new_node = reinterpret_cast<ClassType *>(buffer_pool_manager_->NewPage(&new_node_id)->GetData());
+  PageSegment *segment = origin_node->IsLeafPage() ? &leaf_segment_ : &internal_segment_;
+  auto new_node =
+      reinterpret_cast<ClassType *>(buffer_pool_manager_->NewPageInSegment(&new_node_id, segment)->GetData());
   if (origin_node->IsLeafPage()) {
     auto origin_leaf_node = reinterpret_cast<LeafPage *>(origin_node);
     auto new_leaf_node = reinterpret_cast<LeafPage *>(new_node);
     new_leaf_node->Init(new_node_id, origin_leaf_node->GetParentPageId(), origin_leaf_node->GetMaxSize());
     origin_leaf_node->MoveTo(new_leaf_node);
+    // the parent may split, and move the new leaf under another page
     InsertIntoParent(origin_leaf_node, new_leaf_node->KeyAt(0), new_leaf_node);
-    new_leaf_node->SetParentPageId(origin_leaf_node->GetParentPageId());
     new_leaf_node->SetNextPageId(origin_leaf_node->GetNextPageId());
     origin_leaf_node->SetNextPageId(new_leaf_node->GetPageId());
     buffer_pool_manager_->UnpinPage(new_leaf_node->GetPageId(), true);
@@ -109,7 +407,6 @@ auto BPLUSTREE_TYPE::Split(ClassType *origin_node) -> ClassType * {
   origin_internal_node->MoveTo(new_internal_node, buffer_pool_manager_);
   InsertIntoParent(origin_internal_node, origin_internal_node->KeyAt(origin_internal_node->GetMinSize()),
                    new_internal_node);
-  new_internal_node->SetParentPageId(origin_internal_node->GetParentPageId());
   buffer_pool_manager_->UnpinPage(new_internal_node->GetPageId(), true);
   return reinterpret_cast<ClassType *>(new_internal_node);
 }
@@ -119,7 +416,8 @@ template <typename ClassType>
 void BPLUSTREE_TYPE::InsertIntoParent(ClassType *origin_node, const KeyType &key, ClassType *new_node) {
   if (origin_node->IsRootPage()) {
     page_id_t internal_node_id;
-    auto internal_node = reinterpret_cast<InternalPage *>(buffer_pool_manager_->NewPage(&internal_node_id)->GetData());
+    auto internal_node = reinterpret_cast<InternalPage *>(
+        buffer_pool_manager_->NewPageInSegment(&internal_node_id, &internal_segment_)->GetData());
     internal_node->Init(internal_node_id, INVALID_PAGE_ID, internal_max_size_);  // NOLINT
     internal_node->SetValueAt(0, origin_node->GetPageId());
     internal_node->SetKeyAt(1, key);
@@ -128,6 +426,7 @@ void BPLUSTREE_TYPE::InsertIntoParent(ClassType *origin_node, const KeyType &key
     root_page_id_ = internal_node_id;
     UpdateRootPageId(0);
     origin_node->SetParentPageId(internal_node_id);
+    new_node->SetParentPageId(internal_node_id);
     buffer_pool_manager_->UnpinPage(root_page_id_, true);
     return;
   }
@@ -152,14 +451,37 @@ void BPLUSTREE_TYPE::InsertIntoParent(ClassType *origin_node, const KeyType &key
  */
 INDEX_TEMPLATE_ARGUMENTS
 void BPLUSTREE_TYPE::Remove(const KeyType &key, Transaction *transaction) {
-  auto leaf_node = FindLeafPage(key);
-  DeleteEntry(key, leaf_node);
-  buffer_pool_manager_->UnpinPage(leaf_node->GetPageId(), true);
+  // most removals leave the leaf at least half full, and only need to write-latch it
+  Page *leaf_page = FindLeafOptimistic(key);
+  if (leaf_page == nullptr) {
+    return;
+  }
+  auto leaf_node = reinterpret_cast<LeafPage *>(leaf_page->GetData());
+  const bool present = leaf_node->KeyIndex(key, comparator_) >= 0;
+  const bool safe = IsSafe(leaf_node, OpType::DELETE);
+  if (present && safe) {
+    leaf_node->Delete(key, comparator_);
+  }
+  leaf_page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(leaf_page->GetPageId(), present && safe);
+  if (!present || safe) {
+    return;
+  }
+
+  Transaction local_transaction(INVALID_TXN_ID);
+  if (transaction == nullptr) {
+    transaction = &local_transaction;
+  }
+  leaf_page = FindLeafPessimistic(key, OpType::DELETE, transaction);
+  if (leaf_page != nullptr) {
+    DeleteEntry(key, reinterpret_cast<LeafPage *>(leaf_page->GetData()), transaction);
+  }
+  ReleaseLatches(transaction, true);
 }
 
 INDEX_TEMPLATE_ARGUMENTS
 template <typename ClassType>
-void BPLUSTREE_TYPE::DeleteEntry(const KeyType &key, ClassType *delete_node) {
+void BPLUSTREE_TYPE::DeleteEntry(const KeyType &key, ClassType *delete_node, Transaction *transaction) {
   delete_node->Delete(key, comparator_);
   if (delete_node->IsRootPage() && delete_node->GetSize() == 1 && !delete_node->IsLeafPage()) {
     auto delete_internal_node = reinterpret_cast<InternalPage *>(delete_node);
@@ -169,54 +491,35 @@ void BPLUSTREE_TYPE::DeleteEntry(const KeyType &key, ClassType *delete_node) {
     UpdateRootPageId(0);
     new_root_node->SetParentPageId(INVALID_PAGE_ID);
     buffer_pool_manager_->UnpinPage(new_root_node->GetPageId(), true);
+    transaction->AddIntoDeletedPageSet(delete_node->GetPageId());
+  } else if (delete_node->IsRootPage() && delete_node->GetSize() == 0) {
+    // the last key is gone, and the tree is empty again
+    root_page_id_ = INVALID_PAGE_ID;
+    UpdateRootPageId(0);
+    transaction->AddIntoDeletedPageSet(delete_node->GetPageId());
   } else if (!delete_node->IsRootPage() && delete_node->GetSize() < delete_node->GetMinSize()) {
-    // 获得左边和右边的兄弟节点
+    // merge with or borrow from the left sibling, or from the right one for the leftmost child
     auto parent_page_id = delete_node->GetParentPageId();
     auto parent_node = reinterpret_cast<InternalPage *>(buffer_pool_manager_->FetchPage(parent_page_id)->GetData());
     auto index = parent_node->ValueIndex(delete_node->GetPageId());
-    page_id_t left_sibling_node_id;
-    if (index == 0) {
-      left_sibling_node_id = INVALID_PAGE_ID;
-    } else {
-      left_sibling_node_id = parent_node->ValueAt(index - 1);
-    }
-    ClassType *left_sibling_node = nullptr;
-    if (left_sibling_node_id != INVALID_PAGE_ID) {
-      left_sibling_node =
-          reinterpret_cast<ClassType *>(buffer_pool_manager_->FetchPage(left_sibling_node_id)->GetData());
-    }
-    page_id_t right_sibling_node_id;
-    if (index == parent_node->GetSize() - 1) {
-      right_sibling_node_id = INVALID_PAGE_ID;
-    } else {
-      right_sibling_node_id = parent_node->ValueAt(index + 1);
-    }
-    ClassType *right_sibling_node = nullptr;
-    if (right_sibling_node_id != INVALID_PAGE_ID) {
-      right_sibling_node =
-          reinterpret_cast<ClassType *>(buffer_pool_manager_->FetchPage(right_sibling_node_id)->GetData());
-    }
+    const bool from_left = index > 0;
+    const page_id_t sibling_node_id = parent_node->ValueAt(from_left ? index - 1 : index + 1);
     buffer_pool_manager_->UnpinPage(parent_node->GetPageId(), true);
-    // 判断要合并还是要借
-    auto max_node_size = delete_node->GetMaxSize();
-    if (left_sibling_node != nullptr) {
-      if (delete_node->GetSize() + left_sibling_node->GetSize() < max_node_size) {
-        Merge(left_sibling_node, delete_node);
-      }
-      if (delete_node->GetSize() + left_sibling_node->GetSize() >= max_node_size) {
-        Borrow(left_sibling_node, delete_node);
-      }
-      buffer_pool_manager_->UnpinPage(left_sibling_node->GetPageId(), true);
-    }
-    if (right_sibling_node != nullptr) {
-      if (delete_node->GetSize() + right_sibling_node->GetSize() < max_node_size) {
-        Merge(delete_node, right_sibling_node);
-      }
-      if (delete_node->GetSize() + right_sibling_node->GetSize() >= max_node_size) {
-        Borrow(delete_node, right_sibling_node);
-      }
-      buffer_pool_manager_->UnpinPage(right_sibling_node->GetPageId(), true);
+    // the parent is write-latched, so only an iterator walking the leaves may hold the sibling
+    Page *sibling_page = buffer_pool_manager_->FetchPage(sibling_node_id);
+    sibling_page->WLatch();
+    auto sibling_node = reinterpret_cast<ClassType *>(sibling_page->GetData());
+    ClassType *left_node = from_left ? sibling_node : delete_node;
+    ClassType *right_node = from_left ? delete_node : sibling_node;
+    // a leaf splits once it is full, an internal page once it overflows
+    const int merged_max_size = delete_node->IsLeafPage() ? delete_node->GetMaxSize() - 1 : delete_node->GetMaxSize();
+    if (left_node->GetSize() + right_node->GetSize() <= merged_max_size) {
+      Merge(left_node, right_node, transaction);
+    } else {
+      Borrow(left_node, right_node);
     }
+    sibling_page->WUnlatch();
+    buffer_pool_manager_->UnpinPage(sibling_node_id, true);
   }
 }
 
@@ -249,40 +552,42 @@ void BPLUSTREE_TYPE::Borrow(ClassType *left_node, ClassType *right_node) {
       parent_node->SetKeyAt(index, key);
     }
   } else if (!left_node->IsLeafPage()) {
+    // the separator in the parent moves down to the node that borrows, and the borrowed key moves up in its place
     auto left_internal_node = reinterpret_cast<InternalPage *>(left_node);
     auto right_internal_node = reinterpret_cast<InternalPage *>(right_node);
+    auto index = parent_node->ValueIndex(right_node->GetPageId());
+    auto separator = parent_node->KeyAt(index);
+    page_id_t value;
+    page_id_t new_parent_id;
     if (left_node->GetSize() < min_size) {
       // left <- right
-      auto key = right_internal_node->KeyAt(0);
-      auto value = right_internal_node->ValueAt(0);
-      auto child_node = reinterpret_cast<InternalPage *>(buffer_pool_manager_->FetchPage(value)->GetData());
-      child_node->SetParentPageId(left_internal_node->GetPageId());
-      buffer_pool_manager_->UnpinPage(value, true);
-      right_internal_node->Delete(key, comparator_);
-      left_internal_node->SetKeyAt(left_node->GetSize(), key);
+      value = right_internal_node->ValueAt(0);
+      new_parent_id = left_node->GetPageId();
+      left_internal_node->SetKeyAt(left_node->GetSize(), separator);
       left_internal_node->SetValueAt(left_node->GetSize(), value);
       left_internal_node->IncreaseSize(1);
-      auto index = parent_node->ValueIndex(right_node->GetPageId());
-      parent_node->SetKeyAt(index, right_node->KeyAt(0));
+      parent_node->SetKeyAt(index, right_internal_node->KeyAt(1));
+      right_internal_node->SetValueAt(0, right_internal_node->ValueAt(1));
+      right_internal_node->Delete(right_internal_node->KeyAt(1), comparator_);
     } else {
       // left -> right
-      auto key = left_internal_node->KeyAt(left_node->GetSize() - 1);
-      auto value = left_internal_node->ValueAt(left_node->GetSize() - 1);
-      left_internal_node->Delete(key, comparator_);
-      right_internal_node->Insert(0, key, value);
-      auto child_node = reinterpret_cast<InternalPage *>(buffer_pool_manager_->FetchPage(value)->GetData());
-      child_node->SetParentPageId(right_internal_node->GetPageId());
-      buffer_pool_manager_->UnpinPage(value, true);
-      auto index = parent_node->ValueIndex(right_node->GetPageId());
-      parent_node->SetKeyAt(index, key);
+      value = left_internal_node->ValueAt(left_node->GetSize() - 1);
+      new_parent_id = right_node->GetPageId();
+      parent_node->SetKeyAt(index, left_internal_node->KeyAt(left_node->GetSize() - 1));
+      left_internal_node->IncreaseSize(-1);
+      right_internal_node->Insert(0, separator, right_internal_node->ValueAt(0));
+      right_internal_node->SetValueAt(0, value);
     }
+    auto child_node = reinterpret_cast<BPlusTreePage *>(buffer_pool_manager_->FetchPage(value)->GetData());
+    child_node->SetParentPageId(new_parent_id);
+    buffer_pool_manager_->UnpinPage(value, true);
   }
   buffer_pool_manager_->UnpinPage(parent_node->GetPageId(), true);
 }
 
 INDEX_TEMPLATE_ARGUMENTS
 template <typename ClassType>
-void BPLUSTREE_TYPE::Merge(ClassType *left_node, ClassType *right_node) {
+void BPLUSTREE_TYPE::Merge(ClassType *left_node, ClassType *right_node, Transaction *transaction) {
   auto parent_node =
       reinterpret_cast<InternalPage *>(buffer_pool_manager_->FetchPage(left_node->GetParentPageId())->GetData());
   if (left_node->IsLeafPage()) {
@@ -290,16 +595,20 @@ void BPLUSTREE_TYPE::Merge(ClassType *left_node, ClassType *right_node) {
     auto left_leaf_node = reinterpret_cast<LeafPage *>(left_node);
     auto right_leaf_node = reinterpret_cast<LeafPage *>(right_node);
     left_leaf_node->MoveFrom(right_leaf_node);
+    left_leaf_node->SetNextPageId(right_leaf_node->GetNextPageId());
     int index = parent_node->ValueIndex(right_leaf_node->GetPageId());
-    DeleteEntry(parent_node->KeyAt(index), parent_node);
+    DeleteEntry(parent_node->KeyAt(index), parent_node, transaction);
   } else {
     // left <- right
     auto left_internal_node = reinterpret_cast<InternalPage *>(left_node);
     auto right_internal_node = reinterpret_cast<InternalPage *>(right_node);
-    left_internal_node->MoveFrom(right_internal_node, buffer_pool_manager_);
     int index = parent_node->ValueIndex(right_internal_node->GetPageId());
-    DeleteEntry(parent_node->KeyAt(index), parent_node);
+    // the separator in the parent moves down to the first entry of the right node
+    right_internal_node->SetKeyAt(0, parent_node->KeyAt(index));
+    left_internal_node->MoveFrom(right_internal_node, buffer_pool_manager_);
+    DeleteEntry(parent_node->KeyAt(index), parent_node, transaction);
   }
+  transaction->AddIntoDeletedPageSet(right_node->GetPageId());
   buffer_pool_manager_->UnpinPage(parent_node->GetPageId(), true);
 }
 /*****************************************************************************
@@ -311,33 +620,12 @@ void BPLUSTREE_TYPE::Merge(ClassType *left_node, ClassType *right_node) {
  * @return : index iterator
  */
 INDEX_TEMPLATE_ARGUMENTS
-auto BPLUSTREE_TYPE::FindLeafPage(bool left) -> LeafPage * {
-  page_id_t cur_node_id = root_page_id_;
-  page_id_t new_node_id;
-  if(cur_node_id==INVALID_PAGE_ID){
-    return nullptr;
-  }
-  auto cur_node = reinterpret_cast<BPlusTreePage *>(buffer_pool_manager_->FetchPage(cur_node_id)->GetData());
-  while (!cur_node->IsLeafPage()) {
-    auto cur_internal_node = reinterpret_cast<InternalPage *>(cur_node);
-    if (left) {
-      new_node_id = cur_internal_node->ValueAt(0);
-    } else {
-      new_node_id = cur_internal_node->ValueAt(cur_internal_node->GetSize() - 1);
-    }
-    buffer_pool_manager_->UnpinPage(cur_node_id, false);
-    cur_node_id = new_node_id;
-    cur_node = reinterpret_cast<BPlusTreePage *>(buffer_pool_manager_->FetchPage(cur_node_id)->GetData());
-  }
-  return reinterpret_cast<LeafPage *>(cur_node);
-}
-INDEX_TEMPLATE_ARGUMENTS
 auto BPLUSTREE_TYPE::Begin() -> INDEXITERATOR_TYPE {
-  if (IsEmpty()) {
-    return INDEXITERATOR_TYPE(nullptr, 0);
+  Page *leaf_page = FindLeafRead(nullptr);
+  if (leaf_page == nullptr) {
+    return INDEXITERATOR_TYPE();
   }
-  auto leaf_node = FindLeafPage(true);
-  return INDEXITERATOR_TYPE(leaf_node, 0);
+  return INDEXITERATOR_TYPE(this, leaf_page, 0);
 }
 
 /*
@@ -347,11 +635,17 @@ auto BPLUSTREE_TYPE::Begin() -> INDEXITERATOR_TYPE {
  */
 INDEX_TEMPLATE_ARGUMENTS
 auto BPLUSTREE_TYPE::Begin(const KeyType &key) -> INDEXITERATOR_TYPE {
-  if (IsEmpty()) {
-    return INDEXITERATOR_TYPE(nullptr, 0);
+  Page *leaf_page = FindLeafRead(&key);
+  if (leaf_page == nullptr) {
+    return INDEXITERATOR_TYPE();
   }
-  auto leaf_node = FindLeafPage(key);
-  return INDEXITERATOR_TYPE(leaf_node, leaf_node->KeyIndex(key, comparator_));
+  // start from the first key not less than the given one
+  auto leaf_node = reinterpret_cast<LeafPage *>(leaf_page->GetData());
+  int index = 0;
+  while (index < leaf_node->GetSize() && comparator_(leaf_node->KeyAt(index), key) < 0) {
+    index++;
+  }
+  return INDEXITERATOR_TYPE(this, leaf_page, index, &key);
 }
 
 /*
@@ -360,19 +654,18 @@ auto BPLUSTREE_TYPE::Begin(const KeyType &key) -> INDEXITERATOR_TYPE {
  * @return : index iterator
  */
 INDEX_TEMPLATE_ARGUMENTS
-auto BPLUSTREE_TYPE::End() -> INDEXITERATOR_TYPE {
-  if (IsEmpty()) {
-    return INDEXITERATOR_TYPE(nullptr, 0);
-  }
-  auto leaf_node = FindLeafPage(false);
-  return INDEXITERATOR_TYPE(leaf_node, leaf_node->GetSize());
-}
+auto BPLUSTREE_TYPE::End() -> INDEXITERATOR_TYPE { return INDEXITERATOR_TYPE(); }
 
 /**
  * @return Page id of the root of this tree
  */
 INDEX_TEMPLATE_ARGUMENTS
-auto BPLUSTREE_TYPE::GetRootPageId() -> page_id_t { return root_page_id_; }
+auto BPLUSTREE_TYPE::GetRootPageId() -> page_id_t {
+  root_latch_.RLock();
+  page_id_t root_page_id = root_page_id_;
+  root_latch_.RUnlock();
+  return root_page_id;
+}
 
 /*****************************************************************************
  * UTILITIES AND DEBUG
@@ -388,13 +681,14 @@ auto BPLUSTREE_TYPE::GetRootPageId() -> page_id_t { return root_page_id_; }
 INDEX_TEMPLATE_ARGUMENTS
 void BPLUSTREE_TYPE::UpdateRootPageId(int insert_record) {
   auto *header_page = static_cast<HeaderPage *>(buffer_pool_manager_->FetchPage(HEADER_PAGE_ID));
-  if (insert_record != 0) {
-    // create a new record<index_name + root_page_id> in header_page
-    header_page->InsertRecord(index_name_, root_page_id_);
-  } else {
+  // the header page is shared by all the indexes
+  header_page->WLatch();
+  // create a new record<index_name + root_page_id> in header_page, unless the tree was emptied before
+  if (insert_record == 0 || !header_page->InsertRecord(index_name_, root_page_id_)) {
     // update root_page_id in header_page
     header_page->UpdateRecord(index_name_, root_page_id_);
   }
+  header_page->WUnlatch();
   buffer_pool_manager_->UnpinPage(HEADER_PAGE_ID, true);
 }
 
@@ -404,14 +698,32 @@ void BPLUSTREE_TYPE::UpdateRootPageId(int insert_record) {
  */
 INDEX_TEMPLATE_ARGUMENTS
 void BPLUSTREE_TYPE::InsertFromFile(const std::string &file_name, Transaction *transaction) {
+  std::vector<std::pair<KeyType, ValueType>> entries;
   int64_t key;
   std::ifstream input(file_name);
-  while (input) {
-    input >> key;
-
+  while (input >> key) {
     KeyType index_key;
     index_key.SetFromInteger(key);
-    RID rid(key);
+    entries.emplace_back(index_key, RID(key));
+  }
+  if (IsEmpty()) {
+    std::stable_sort(entries.begin(), entries.end(),
+                     [this](const auto &a, const auto &b) { return comparator_(a.first, b.first) < 0; });
+    auto it = entries.begin();
+    auto source = [&it, &entries](KeyType *key, ValueType *value) {
+      if (it == entries.end()) {
+        return false;
+      }
+      *key = it->first;
+      *value = it->second;
+      ++it;
+      return true;
+    };
+    if (BulkLoad(source)) {
+      return;
+    }
+  }
+  for (const auto &[index_key, rid] : entries) {
     Insert(index_key, rid, transaction);
   }
 }
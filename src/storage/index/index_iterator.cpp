@@ -4,44 +4,130 @@
 #include <cassert>
 
 #include "common/config.h"
+#include "storage/index/b_plus_tree.h"
 #include "storage/index/index_iterator.h"
 
 namespace bustub {
 
-/*
- * NOTE: you can change the destructor/constructor method here
- * set your own input parameters
- */
 INDEX_TEMPLATE_ARGUMENTS
-INDEXITERATOR_TYPE::IndexIterator() { this->leaf_node_ = nullptr; }
+INDEXITERATOR_TYPE::IndexIterator() = default;
+
+INDEX_TEMPLATE_ARGUMENTS
+INDEXITERATOR_TYPE::IndexIterator(BPlusTree<KeyType, ValueType, KeyComparator> *tree, Page *page, int pos,
+                                  const KeyType *start_key)
+    : tree_(tree), buffer_pool_manager_(tree->buffer_pool_manager_), page_(page), pos_(pos) {
+  if (start_key != nullptr) {
+    has_resume_key_ = true;
+    resume_key_ = *start_key;
+  }
+  SkipToEntry();
+}
 
 INDEX_TEMPLATE_ARGUMENTS
-INDEXITERATOR_TYPE::IndexIterator(BPlusTreeLeafPage<KeyType, ValueType, KeyComparator> *leaf_node, int pos)
-    : leaf_node_(leaf_node), pos_(pos) {}
+INDEXITERATOR_TYPE::~IndexIterator() { Release(); }  // NOLINT
 
 INDEX_TEMPLATE_ARGUMENTS
-INDEXITERATOR_TYPE::~IndexIterator() = default;  // NOLINT
+INDEXITERATOR_TYPE::IndexIterator(IndexIterator &&other) noexcept
+    : tree_(other.tree_),
+      buffer_pool_manager_(other.buffer_pool_manager_),
+      page_(other.page_),
+      pos_(other.pos_),
+      has_resume_key_(other.has_resume_key_),
+      resume_after_(other.resume_after_),
+      resume_key_(other.resume_key_) {
+  other.page_ = nullptr;
+  other.pos_ = 0;
+}
 
 INDEX_TEMPLATE_ARGUMENTS
-auto INDEXITERATOR_TYPE::IsEnd() -> bool {
-  return static_cast<bool>(leaf_node_->GetNextPageId() == INVALID_PAGE_ID && pos_ == leaf_node_->GetSize() - 1);
+auto INDEXITERATOR_TYPE::operator=(IndexIterator &&other) noexcept -> INDEXITERATOR_TYPE & {
+  if (this != &other) {
+    Release();
+    tree_ = other.tree_;
+    buffer_pool_manager_ = other.buffer_pool_manager_;
+    page_ = other.page_;
+    pos_ = other.pos_;
+    has_resume_key_ = other.has_resume_key_;
+    resume_after_ = other.resume_after_;
+    resume_key_ = other.resume_key_;
+    other.page_ = nullptr;
+    other.pos_ = 0;
+  }
+  return *this;
 }
 
 INDEX_TEMPLATE_ARGUMENTS
-auto INDEXITERATOR_TYPE::operator*() -> const MappingType & { return leaf_node_->ArrayAt(pos_); }
+auto INDEXITERATOR_TYPE::IsEnd() -> bool { return page_ == nullptr; }
+
+INDEX_TEMPLATE_ARGUMENTS
+auto INDEXITERATOR_TYPE::operator*() -> const MappingType & { return Leaf()->ArrayAt(pos_); }
 
 INDEX_TEMPLATE_ARGUMENTS
 auto INDEXITERATOR_TYPE::operator++() -> INDEXITERATOR_TYPE & {
-  if ((pos_ == leaf_node_->GetSize() - 1 && leaf_node_->GetNextPageId() == INVALID_PAGE_ID) ||
-      pos_ + 1 <= leaf_node_->GetSize() - 1) {
-    pos_++;
-  } else {
-    auto leaf_next_node = reinterpret_cast<BPlusTreeLeafPage<KeyType, ValueType, KeyComparator> *>(
-        buffer_pool_manager_->FetchPage(leaf_node_->GetNextPageId())->GetData());
-    leaf_node_ = leaf_next_node;
+  has_resume_key_ = true;
+  resume_after_ = true;
+  resume_key_ = Leaf()->KeyAt(pos_);
+  pos_++;
+  SkipToEntry();
+  return *this;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto INDEXITERATOR_TYPE::Leaf() -> BPlusTreeLeafPage<KeyType, ValueType, KeyComparator> * {
+  return reinterpret_cast<BPlusTreeLeafPage<KeyType, ValueType, KeyComparator> *>(page_->GetData());
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void INDEXITERATOR_TYPE::SkipToEntry() {
+  while (page_ != nullptr && pos_ >= Leaf()->GetSize()) {
+    const page_id_t next_page_id = Leaf()->GetNextPageId();
+    if (next_page_id == INVALID_PAGE_ID) {
+      Release();
+      return;
+    }
+    Page *next_page = buffer_pool_manager_->FetchPageReadOnly(next_page_id);
+    const bool latched = next_page->TryRLatch();
+    page_->RUnlatch();
+    buffer_pool_manager_->UnpinPage(page_->GetPageId(), false);
+    page_ = nullptr;
+    if (!latched) {
+      // a writer may be moving entries between the two leaves, wait for it and find the place of the scan again
+      next_page->RLatch();
+      next_page->RUnlatch();
+      buffer_pool_manager_->UnpinPage(next_page_id, false);
+      Restart();
+      continue;
+    }
+    page_ = next_page;
     pos_ = 0;
   }
-  return *this;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void INDEXITERATOR_TYPE::Restart() {
+  page_ = tree_->FindLeafRead(has_resume_key_ ? &resume_key_ : nullptr);
+  pos_ = 0;
+  if (page_ == nullptr || !has_resume_key_) {
+    return;
+  }
+  auto *leaf = Leaf();
+  while (pos_ < leaf->GetSize()) {
+    const int cmp = tree_->comparator_(leaf->KeyAt(pos_), resume_key_);
+    if (cmp > 0 || (cmp == 0 && !resume_after_)) {
+      break;
+    }
+    pos_++;
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void INDEXITERATOR_TYPE::Release() {
+  if (page_ != nullptr) {
+    page_->RUnlatch();
+    buffer_pool_manager_->UnpinPage(page_->GetPageId(), false);
+    page_ = nullptr;
+  }
+  pos_ = 0;
 }
 
 template class IndexIterator<GenericKey<4>, RID, GenericComparator<4>>;
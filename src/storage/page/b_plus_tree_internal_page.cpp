@@ -89,7 +89,8 @@ auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::ValueIndex(const ValueType &value) -> int {
 
 INDEX_TEMPLATE_ARGUMENTS
 auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::KeyIndex(const KeyType &key, KeyComparator &comparator) -> int {
-  for (int i = 0; i < GetSize(); i++) {
+  // the key of the first entry is invalid
+  for (int i = 1; i < GetSize(); i++) {
     if (comparator(array_[i].first, key) == 0) {
       return i;
     }
@@ -137,15 +138,16 @@ auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::Delete(const KeyType &key, KeyComparator &c
 INDEX_TEMPLATE_ARGUMENTS
 void B_PLUS_TREE_INTERNAL_PAGE_TYPE::MoveFrom(BPlusTreeInternalPage *other_node, BufferPoolManager *bpm) {
   int size = GetSize();
-  for (int i = 0; i < other_node->GetSize(); i++) {
+  int other_size = other_node->GetSize();
+  for (int i = 0; i < other_size; i++) {
     SetKeyAt(i + size, other_node->KeyAt(i));
     SetValueAt(i + size, other_node->ValueAt(i));
     auto child_node = reinterpret_cast<BPlusTreePage *>(bpm->FetchPage(ValueAt(i + size))->GetData());
     child_node->SetParentPageId(this->GetPageId());
-    IncreaseSize(1);
-    other_node->IncreaseSize(-1);
     bpm->UnpinPage(child_node->GetPageId(), true);
   }
+  IncreaseSize(other_size);
+  other_node->SetSize(0);
 }
 // valuetype for internalNode should be page id_t
 template class BPlusTreeInternalPage<GenericKey<4>, page_id_t, GenericComparator<4>>;
@@ -150,12 +150,14 @@ auto B_PLUS_TREE_LEAF_PAGE_TYPE::Delete(const KeyType &key, KeyComparator &compa
 }
 INDEX_TEMPLATE_ARGUMENTS
 void B_PLUS_TREE_LEAF_PAGE_TYPE::MoveFrom(BPlusTreeLeafPage *other_node) {
-  for (int i = 0; i < other_node->GetSize(); i++) {
-    SetKeyAt(i + this->GetSize(), other_node->KeyAt(i));
-    SetValueAt(i + this->GetSize(), other_node->ValueAt(i));
-    IncreaseSize(1);
-    other_node->IncreaseSize(-1);
+  int size = GetSize();
+  int other_size = other_node->GetSize();
+  for (int i = 0; i < other_size; i++) {
+    SetKeyAt(i + size, other_node->KeyAt(i));
+    SetValueAt(i + size, other_node->ValueAt(i));
   }
+  IncreaseSize(other_size);
+  other_node->SetSize(0);
 }
 
 template class BPlusTreeLeafPage<GenericKey<4>, RID, GenericComparator<4>>;
@@ -24,11 +24,14 @@ auto HeaderPage::InsertRecord(const std::string &name, const page_id_t root_id)
   assert(root_id > INVALID_PAGE_ID);
 
   int record_num = GetRecordCount();
-  int offset = 4 + record_num * 36;
-  // check for duplicate name
-  if (FindRecord(name) != -1) {
+  int offset = HEADER_SIZE + record_num * RECORD_SIZE;
+  // check for duplicate name, and for space
+  if (FindRecord(name) != -1 || record_num >= MAX_RECORDS) {
     return false;
   }
+  if (GetPageSize() == 0) {
+    SetPageSize();
+  }
   // copy record content
   memcpy(GetData() + offset, name.c_str(), (name.length() + 1));
   memcpy((GetData() + offset + 32), &root_id, 4);
@@ -46,8 +49,8 @@ auto HeaderPage::DeleteRecord(const std::string &name) -> bool {
   if (index == -1) {
     return false;
   }
-  int offset = index * 36 + 4;
-  memmove(GetData() + offset, GetData() + offset + 36, (record_num - index - 1) * 36);
+  int offset = HEADER_SIZE + index * RECORD_SIZE;
+  memmove(GetData() + offset, GetData() + offset + RECORD_SIZE, (record_num - index - 1) * RECORD_SIZE);
 
   SetRecordCount(record_num - 1);
   return true;
@@ -61,7 +64,7 @@ auto HeaderPage::UpdateRecord(const std::string &name, const page_id_t root_id)
   if (index == -1) {
     return false;
   }
-  int offset = index * 36 + 4;
+  int offset = HEADER_SIZE + index * RECORD_SIZE;
   // update record content, only root_id
   memcpy((GetData() + offset + 32), &root_id, 4);
 
@@ -76,7 +79,7 @@ auto HeaderPage::GetRootId(const std::string &name, page_id_t *root_id) -> bool
   if (index == -1) {
     return false;
   }
-  int offset = (index + 1) * 36;
+  int offset = HEADER_SIZE + index * RECORD_SIZE + 32;
   *root_id = *reinterpret_cast<page_id_t *>(GetData() + offset);
 
   return true;
@@ -90,11 +93,30 @@ auto HeaderPage::GetRecordCount() -> int { return *reinterpret_cast<int *>(GetDa
 
 void HeaderPage::SetRecordCount(int record_count) { memcpy(GetData(), &record_count, 4); }
 
+// page size
+auto HeaderPage::GetPageSize(const char *data) -> int {
+  uint32_t magic;
+  memcpy(&magic, data + 4, 4);
+  if (magic != MAGIC) {
+    return 0;
+  }
+  int page_size;
+  memcpy(&page_size, data + 8, 4);
+  return page_size;
+}
+
+void HeaderPage::SetPageSize() {
+  const uint32_t magic = MAGIC;
+  const int page_size = BUSTUB_PAGE_SIZE;
+  memcpy(GetData() + 4, &magic, 4);
+  memcpy(GetData() + 8, &page_size, 4);
+}
+
 auto HeaderPage::FindRecord(const std::string &name) -> int {
   int record_num = GetRecordCount();
 
   for (int i = 0; i < record_num; i++) {
-    char *raw_name = reinterpret_cast<char *>(GetData() + (4 + i * 36));
+    char *raw_name = reinterpret_cast<char *>(GetData() + (HEADER_SIZE + i * RECORD_SIZE));
     if (strcmp(raw_name, name.c_str()) == 0) {
       return i;
     }
@@ -0,0 +1,83 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// arc_replacer_test.cpp
+//
+// Identification: test/buffer/arc_replacer_test.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/arc_replacer.h"
+
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+TEST(ARCReplacerTest, SampleTest) {
+  ARCReplacer arc_replacer(4);
+
+  // Scenario: frames 0 to 3 hold pages 100 to 103, seen once each, so they all are in T1.
+  for (frame_id_t fid = 0; fid < 4; ++fid) {
+    arc_replacer.RecordAccess(fid, 100 + fid);
+  }
+  EXPECT_EQ(4, arc_replacer.Size());
+  EXPECT_EQ(0, arc_replacer.GetTargetT1Size());
+
+  // Scenario: the least recently used page of T1 is evicted and remembered in B1.
+  frame_id_t value;
+  ASSERT_TRUE(arc_replacer.Evict(&value));
+  EXPECT_EQ(0, value);
+
+  // Scenario: page 100 comes back while in B1, so T1 was too small. It goes straight to T2.
+  arc_replacer.RecordAccess(0, 100);
+  EXPECT_EQ(1, arc_replacer.GetTargetT1Size());
+
+  // Scenario: T1 holds three frames, over its target, so the victims come from T1 before the page in T2.
+  ASSERT_TRUE(arc_replacer.Evict(&value));
+  EXPECT_EQ(1, value);
+  ASSERT_TRUE(arc_replacer.Evict(&value));
+  EXPECT_EQ(2, value);
+
+  // Scenario: page 101 comes back, then page 100 is evicted from T2 and comes back too, shrinking the target again.
+  arc_replacer.RecordAccess(1, 101);
+  EXPECT_EQ(2, arc_replacer.GetTargetT1Size());
+  arc_replacer.SetEvictable(3, false);
+  arc_replacer.SetEvictable(1, false);
+  ASSERT_TRUE(arc_replacer.Evict(&value));
+  EXPECT_EQ(0, value);
+  arc_replacer.RecordAccess(0, 100);
+  EXPECT_EQ(1, arc_replacer.GetTargetT1Size());
+
+  // Scenario: pinned frames are skipped, and removed frames are forgotten.
+  EXPECT_EQ(1, arc_replacer.Size());
+  arc_replacer.Remove(0);
+  EXPECT_EQ(0, arc_replacer.Size());
+  EXPECT_FALSE(arc_replacer.Evict(&value));
+}
+
+TEST(ARCReplacerTest, ScanResistanceTest) {
+  ARCReplacer arc_replacer(8);
+
+  // Scenario: pages 0 to 3 are accessed twice, so they live in T2.
+  for (frame_id_t fid = 0; fid < 4; ++fid) {
+    arc_replacer.RecordAccess(fid, fid);
+    arc_replacer.RecordAccess(fid, fid);
+  }
+
+  // Scenario: a long scan goes through the four other frames and never evicts a hot page.
+  for (frame_id_t fid = 4; fid < 8; ++fid) {
+    arc_replacer.RecordAccess(fid, 1000 + fid);
+  }
+  for (page_id_t page_id = 2000; page_id < 2100; ++page_id) {
+    frame_id_t victim;
+    ASSERT_TRUE(arc_replacer.Evict(&victim));
+    EXPECT_GE(victim, 4);
+    arc_replacer.RecordAccess(victim, page_id);
+  }
+  EXPECT_EQ(8, arc_replacer.Size());
+}
+
+}  // namespace bustub
@@ -12,15 +12,84 @@
 
 #include "buffer/buffer_pool_manager_instance.h"
 
+#include <atomic>
+#include <chrono>  // NOLINT
 #include <cstdio>
+#include <mutex>  // NOLINT
 #include <random>
 #include <string>
+#include <thread>  // NOLINT
+#include <vector>
 
+#include "buffer/buffer_access_strategy.h"
 #include "buffer/buffer_pool_manager.h"
 #include "gtest/gtest.h"
+#include "recovery/log_manager.h"
+#include "storage/disk/disk_manager_memory.h"
+#include "storage/disk/page_allocator.h"
 
 namespace bustub {
 
+/** A memory-backed disk manager that records the ids of the pages written, in order. */
+class RecordingDiskManager : public DiskManagerMemory {
+ public:
+  explicit RecordingDiskManager(size_t pages) : DiskManagerMemory(pages) {}
+
+  auto GetWrittenPages() -> std::vector<page_id_t> {
+    std::scoped_lock<std::mutex> lock(mutex_);
+    return written_;
+  }
+
+ protected:
+  void OnPageWrite(page_id_t page_id, const char *page_data) override {
+    std::scoped_lock<std::mutex> lock(mutex_);
+    written_.push_back(page_id);
+  }
+
+ private:
+  std::mutex mutex_;
+  std::vector<page_id_t> written_;
+};
+
+/** A memory-backed disk manager that takes a while to write one page the first time. */
+class SlowWriteDiskManager : public DiskManagerMemory {
+ public:
+  SlowWriteDiskManager(size_t pages, page_id_t slow_page_id, std::chrono::milliseconds write_delay)
+      : DiskManagerMemory(pages), slow_page_id_(slow_page_id), write_delay_(write_delay) {}
+
+  /** Set once the slow write has started. */
+  std::atomic<bool> writing_{false};
+
+ protected:
+  void OnPageWrite(page_id_t page_id, const char *page_data) override {
+    if (page_id == slow_page_id_ && !writing_.exchange(true)) {
+      std::this_thread::sleep_for(write_delay_);
+    }
+  }
+
+ private:
+  page_id_t slow_page_id_;
+  std::chrono::milliseconds write_delay_;
+};
+
+/** A memory-backed disk manager that takes a while to read a page, and counts the reads. */
+class SlowDiskManager : public DiskManagerMemory {
+ public:
+  SlowDiskManager(size_t pages, std::chrono::milliseconds read_delay)
+      : DiskManagerMemory(pages), read_delay_(read_delay) {}
+
+  std::atomic<int> num_reads_{0};
+
+ protected:
+  void OnPageRead(page_id_t page_id) override {
+    num_reads_++;
+    std::this_thread::sleep_for(read_delay_);
+  }
+
+ private:
+  std::chrono::milliseconds read_delay_;
+};
+
 // NOLINTNEXTLINE
 // Check whether pages containing terminal characters can be recovered
 TEST(BufferPoolManagerInstanceTest, BinaryDataTest) {
@@ -145,4 +214,637 @@ TEST(BufferPoolManagerInstanceTest, SampleTest) {
   delete disk_manager;
 }
 
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerInstanceTest, HitLatencyDuringMissTest) {
+  const size_t buffer_pool_size = 10;
+  const size_t k = 2;
+  const int num_pages = 50;
+  const auto read_delay = std::chrono::milliseconds(100);
+
+  auto *disk_manager = new SlowDiskManager(num_pages, read_delay);
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager, k);
+
+  // Write every page to disk. Page 0 stays pinned so that it is always a hit.
+  page_id_t page_id_temp;
+  for (int i = 0; i < num_pages; ++i) {
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id_temp));
+    snprintf(bpm->FetchPage(page_id_temp)->GetData(), BUSTUB_PAGE_SIZE, "page %d", page_id_temp);
+    bpm->UnpinPage(page_id_temp, true);
+    if (i > 0) {
+      bpm->UnpinPage(page_id_temp, true);
+    }
+  }
+  disk_manager->num_reads_ = 0;
+
+  // Scenario: a thread misses on cold pages, each of which takes a full read delay.
+  const int num_misses = 5;
+  std::atomic<bool> done{false};
+  std::thread miss_thread([&] {
+    for (int i = 1; i <= num_misses; ++i) {
+      auto *page = bpm->FetchPage(i);
+      if (page == nullptr) {
+        ADD_FAILURE() << "failed to fetch page " << i;
+        break;
+      }
+      EXPECT_EQ(0, strcmp(page->GetData(), ("page " + std::to_string(i)).c_str()));
+      bpm->UnpinPage(i, false);
+    }
+    done = true;
+  });
+
+  // Scenario: hits on a resident page must not wait for the misses in flight.
+  while (disk_manager->num_reads_ == 0) {
+    std::this_thread::yield();
+  }
+  auto max_latency = std::chrono::nanoseconds(0);
+  size_t num_hits = 0;
+  while (!done) {
+    auto start = std::chrono::steady_clock::now();
+    auto *page = bpm->FetchPage(0);
+    max_latency = std::max(max_latency, std::chrono::steady_clock::now() - start);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ(0, strcmp(page->GetData(), "page 0"));
+    bpm->UnpinPage(0, false);
+    num_hits++;
+  }
+  miss_thread.join();
+
+  EXPECT_GT(num_hits, 0);
+  EXPECT_EQ(num_misses, disk_manager->num_reads_);
+  EXPECT_LT(max_latency, read_delay / 2);
+
+  bpm->UnpinPage(0, false);
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerInstanceTest, ConcurrentFetchSamePageTest) {
+  const size_t buffer_pool_size = 4;
+  const size_t k = 2;
+  const int num_threads = 8;
+
+  auto *disk_manager = new SlowDiskManager(16, std::chrono::milliseconds(50));
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager, k);
+
+  // Write page 0 and evict it by creating as many new pages as there are frames.
+  page_id_t page_id_temp;
+  auto *page0 = bpm->NewPage(&page_id_temp);
+  ASSERT_NE(nullptr, page0);
+  snprintf(page0->GetData(), BUSTUB_PAGE_SIZE, "Hello");
+  EXPECT_TRUE(bpm->UnpinPage(0, true));
+  for (size_t i = 0; i < buffer_pool_size; ++i) {
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id_temp));
+    EXPECT_TRUE(bpm->UnpinPage(page_id_temp, false));
+  }
+  disk_manager->num_reads_ = 0;
+
+  // Scenario: concurrent fetchers of the same cold page read it from disk once and share the frame.
+  std::vector<Page *> pages(num_threads);
+  std::vector<std::thread> threads;
+  for (int tid = 0; tid < num_threads; ++tid) {
+    threads.emplace_back([&, tid] { pages[tid] = bpm->FetchPage(0); });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(1, disk_manager->num_reads_);
+  for (auto *page : pages) {
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ(pages[0], page);
+    EXPECT_EQ(0, strcmp(page->GetData(), "Hello"));
+  }
+  EXPECT_EQ(num_threads, pages[0]->GetPinCount());
+  for (int tid = 0; tid < num_threads; ++tid) {
+    EXPECT_TRUE(bpm->UnpinPage(0, false));
+  }
+  EXPECT_FALSE(bpm->UnpinPage(0, false));
+
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerInstanceTest, BackgroundFlusherTest) {
+  const size_t buffer_pool_size = 10;
+  const size_t k = 2;
+
+  auto *disk_manager = new RecordingDiskManager(32);
+  auto *log_manager = new LogManager(disk_manager);
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager, k, log_manager);
+
+  // Fill the buffer pool with unpinned dirty pages, page i having LSN i.
+  page_id_t page_id_temp;
+  for (size_t i = 0; i < buffer_pool_size; ++i) {
+    auto *page = bpm->NewPage(&page_id_temp);
+    ASSERT_NE(nullptr, page);
+    page->SetLSN(page_id_temp);
+    EXPECT_TRUE(bpm->UnpinPage(page_id_temp, true));
+  }
+
+  auto wait_for_background_writes = [&](size_t count) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (bpm->GetBackgroundWriteCount() < count && std::chrono::steady_clock::now() < deadline) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    // give the flusher a chance to write more than it should
+    std::this_thread::sleep_for(bg_flush_interval * 2);
+  };
+
+  // Scenario: with no clean frame, the flusher writes up to the high watermark, but only pages whose LSN is
+  // persistent.
+  enable_logging = true;
+  log_manager->SetPersistentLSN(2);
+  bpm->StartBackgroundFlusher(5, 7);
+  wait_for_background_writes(3);
+  EXPECT_EQ(3U, bpm->GetBackgroundWriteCount());
+
+  // Scenario: once the log catches up, the flusher cleans frames up to the high watermark in page id order.
+  log_manager->SetPersistentLSN(buffer_pool_size);
+  wait_for_background_writes(7);
+  bpm->StopBackgroundFlusher();
+  enable_logging = false;
+  EXPECT_EQ(7U, bpm->GetBackgroundWriteCount());
+  EXPECT_EQ((std::vector<page_id_t>{0, 1, 2, 3, 4, 5, 6}), disk_manager->GetWrittenPages());
+
+  // Scenario: a new page evicts a clean frame, so the foreground does not write anything.
+  EXPECT_NE(nullptr, bpm->NewPage(&page_id_temp));
+  EXPECT_EQ(0U, bpm->GetForegroundWriteCount());
+  EXPECT_TRUE(bpm->UnpinPage(page_id_temp, false));
+
+  // Scenario: explicit flushes count as foreground writes, and only write the dirty pages.
+  bpm->FlushAllPages();
+  EXPECT_EQ(3U, bpm->GetForegroundWriteCount());
+  EXPECT_EQ((std::vector<page_id_t>{0, 1, 2, 3, 4, 5, 6, 7, 8, 9}), disk_manager->GetWrittenPages());
+  EXPECT_EQ(7U, bpm->GetBackgroundWriteCount());
+
+  delete bpm;
+  delete log_manager;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerInstanceTest, PrefetchTest) {
+  const size_t buffer_pool_size = 10;
+  const size_t k = 2;
+  const int num_pages = 30;
+
+  auto *disk_manager = new SlowDiskManager(num_pages, std::chrono::milliseconds(10));
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager, k);
+
+  page_id_t page_id_temp;
+  for (int i = 0; i < num_pages; ++i) {
+    auto *page = bpm->NewPage(&page_id_temp);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "page %d", page_id_temp);
+    EXPECT_TRUE(bpm->UnpinPage(page_id_temp, true));
+  }
+  // Pages 20 to 29 are resident. Keep page 29 pinned, so that prefetching cannot evict it.
+  ASSERT_NE(nullptr, bpm->FetchPage(29));
+  disk_manager->num_reads_ = 0;
+
+  // Scenario: prefetching reads cold pages in the background. Pages that are resident or that were never allocated
+  // are skipped.
+  bpm->PrefetchPages(5, 5);
+  bpm->PrefetchPages(29, 10);
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+  while (bpm->GetPrefetchCount() < 5 && std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  EXPECT_EQ(5U, bpm->GetPrefetchCount());
+  EXPECT_EQ(5, disk_manager->num_reads_);
+
+  // Scenario: prefetched pages are unpinned, and fetching them does not hit the disk again.
+  for (int i = 5; i < 10; ++i) {
+    auto *page = bpm->FetchPage(i);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ(1, page->GetPinCount());
+    EXPECT_EQ(0, strcmp(page->GetData(), ("page " + std::to_string(i)).c_str()));
+    EXPECT_TRUE(bpm->UnpinPage(i, false));
+  }
+  EXPECT_EQ(5, disk_manager->num_reads_);
+  EXPECT_EQ(0, strcmp(bpm->FetchPage(29)->GetData(), "page 29"));
+
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerInstanceTest, AccessStrategyTest) {
+  const size_t buffer_pool_size = 20;
+  const size_t k = 2;
+  const size_t ring_size = 4;
+
+  auto *disk_manager = new SlowDiskManager(128, std::chrono::milliseconds(0));
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager, k);
+
+  // Pages 0 to 39 are cold and on disk, pages 25 to 39 are still resident. Pages 40 to 44 are hot.
+  page_id_t page_id_temp;
+  for (int i = 0; i < 45; ++i) {
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id_temp));
+    EXPECT_TRUE(bpm->UnpinPage(page_id_temp, true));
+  }
+  for (int i = 40; i < 45; ++i) {
+    ASSERT_NE(nullptr, bpm->FetchPage(i));
+    EXPECT_TRUE(bpm->UnpinPage(i, false));
+  }
+  auto expect_resident = [&](page_id_t first, page_id_t last) {
+    const int num_reads = disk_manager->num_reads_;
+    for (page_id_t page_id = first; page_id < last; ++page_id) {
+      ASSERT_NE(nullptr, bpm->FetchPage(page_id));
+      EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+    }
+    EXPECT_EQ(num_reads, disk_manager->num_reads_);
+  };
+
+  // Scenario: a scan through a strategy only evicts ring_size pages from the shared pool, then recycles its ring.
+  BufferAccessStrategy scan(ring_size);
+  for (page_id_t page_id = 0; page_id < 25; ++page_id) {
+    auto *page = bpm->FetchPageWithStrategy(page_id, &scan);
+    ASSERT_NE(nullptr, page);
+    EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+  }
+  EXPECT_EQ(25, disk_manager->num_reads_);
+  expect_resident(25 + ring_size, 45);
+
+  // Scenario: a bulk insert through a strategy recycles its ring as well, writing back its own dirty pages.
+  BufferAccessStrategy insert(ring_size);
+  for (int i = 0; i < 30; ++i) {
+    ASSERT_NE(nullptr, bpm->NewPageWithStrategy(&page_id_temp, &insert));
+    EXPECT_TRUE(bpm->UnpinPage(page_id_temp, true));
+  }
+  expect_resident(25 + 2 * ring_size, 45);
+
+  // Scenario: a pinned page of the ring is not recycled.
+  BufferAccessStrategy pinned(1);
+  ASSERT_NE(nullptr, bpm->FetchPageWithStrategy(0, &pinned));
+  ASSERT_NE(nullptr, bpm->FetchPageWithStrategy(1, &pinned));
+  EXPECT_EQ(1, bpm->FetchPage(0)->GetPinCount() - 1);
+  EXPECT_TRUE(bpm->UnpinPage(0, false));
+  EXPECT_TRUE(bpm->UnpinPage(0, false));
+  EXPECT_TRUE(bpm->UnpinPage(1, false));
+
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerInstanceTest, FrameArenaTest) {
+  const size_t buffer_pool_size = 8;
+  const size_t k = 2;
+
+  for (bool huge_pages : {false, true}) {
+    enable_huge_pages = huge_pages;
+    auto *disk_manager = new DiskManagerMemory(16);
+    auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager, k);
+
+    // Scenario: every frame is page-aligned and the frames are contiguous, whatever backs the arena.
+    page_id_t page_id_temp;
+    auto *first = bpm->NewPage(&page_id_temp);
+    ASSERT_NE(nullptr, first);
+    EXPECT_EQ(0U, reinterpret_cast<uintptr_t>(first->GetData()) % BUSTUB_PAGE_SIZE);
+    for (size_t i = 1; i < buffer_pool_size; ++i) {
+      auto *page = bpm->NewPage(&page_id_temp);
+      ASSERT_NE(nullptr, page);
+      EXPECT_EQ(0U, reinterpret_cast<uintptr_t>(page->GetData()) % BUSTUB_PAGE_SIZE);
+      EXPECT_EQ(first->GetData() + i * BUSTUB_PAGE_SIZE, page->GetData());
+      // a new page is zeroed
+      EXPECT_EQ(0, page->GetData()[BUSTUB_PAGE_SIZE - 1]);
+    }
+
+    delete bpm;
+    delete disk_manager;
+  }
+  enable_huge_pages = false;
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerInstanceTest, ConcurrentHitEvictTest) {
+  const size_t buffer_pool_size = 8;
+  const size_t num_pages = 32;
+  const int num_threads = 4;
+
+  auto *disk_manager = new DiskManagerMemory(num_pages + buffer_pool_size);
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager, 2);
+  page_id_t page_id;
+  for (size_t i = 0; i < num_pages; ++i) {
+    auto *page = bpm->NewPage(&page_id);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "page %d", page_id);
+    EXPECT_TRUE(bpm->UnpinPage(page_id, true));
+  }
+
+  // Scenario: lock-free hits on a few hot pages race with misses that keep remapping the other frames. A hit never
+  // returns a frame that was remapped under it.
+  std::vector<std::thread> threads;
+  for (int tid = 0; tid < num_threads; ++tid) {
+    threads.emplace_back([&, tid] {
+      std::mt19937 gen(tid);
+      for (int i = 0; i < 5000; ++i) {
+        const auto pid = static_cast<page_id_t>(gen() % 2 == 0 ? gen() % 2 : gen() % num_pages);
+        auto *page = bpm->FetchPage(pid);
+        if (page == nullptr) {
+          // every frame is pinned by the other threads
+          continue;
+        }
+        EXPECT_EQ(pid, page->GetPageId());
+        EXPECT_EQ("page " + std::to_string(pid), std::string(page->GetData()));
+        EXPECT_TRUE(bpm->UnpinPage(pid, gen() % 8 == 0));
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  EXPECT_GT(bpm->GetStats().hits_, 0U);
+
+  // Scenario: the buffered unpins reached the replacer, so every frame can be evicted again.
+  for (size_t i = 0; i < buffer_pool_size; ++i) {
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+  }
+  EXPECT_EQ(nullptr, bpm->NewPage(&page_id));
+
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerInstanceTest, StatsTest) {
+  const size_t buffer_pool_size = 3;
+  const size_t k = 2;
+
+  auto *disk_manager = new SlowDiskManager(16, std::chrono::milliseconds(2));
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager, k);
+
+  // Scenario: pages 0, 1 and 2 fill the pool; only page 0 (dirty) can be evicted for page 3.
+  page_id_t page_id_temp;
+  for (size_t i = 0; i < buffer_pool_size; ++i) {
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id_temp));
+  }
+  EXPECT_TRUE(bpm->UnpinPage(0, true));
+  ASSERT_NE(nullptr, bpm->NewPage(&page_id_temp));
+  auto stats = bpm->GetStats();
+  EXPECT_EQ(4U, stats.new_pages_);
+  EXPECT_EQ(1U, stats.dirty_evictions_);
+  EXPECT_EQ(0U, stats.clean_evictions_);
+  EXPECT_EQ(1U, stats.write_latency_.Count());
+
+  // Scenario: fetching page 0 back is a miss that evicts the clean page 3, fetching it again is a hit.
+  EXPECT_TRUE(bpm->UnpinPage(3, false));
+  ASSERT_NE(nullptr, bpm->FetchPage(0));
+  ASSERT_NE(nullptr, bpm->FetchPage(0));
+  stats = bpm->GetStats();
+  EXPECT_EQ(1U, stats.hits_);
+  EXPECT_EQ(1U, stats.misses_);
+  EXPECT_EQ(1U, stats.clean_evictions_);
+  EXPECT_EQ(1U, stats.read_latency_.Count());
+  // the read slept for 2 ms, so it cannot land in a bucket below 2048 us
+  EXPECT_GE(stats.read_latency_.Percentile(50), 2048U);
+  EXPECT_DOUBLE_EQ(0.5, stats.HitRatio());
+
+  // Scenario: counters updated from many threads land in different shards, and none is lost.
+  std::vector<std::thread> threads;
+  for (int tid = 0; tid < 8; ++tid) {
+    threads.emplace_back([&] {
+      for (int i = 0; i < 1000; ++i) {
+        ASSERT_NE(nullptr, bpm->FetchPage(1));
+        EXPECT_TRUE(bpm->UnpinPage(1, false));
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  EXPECT_TRUE(bpm->UnpinPage(0, false));
+  EXPECT_TRUE(bpm->UnpinPage(0, false));
+  EXPECT_TRUE(bpm->DeletePage(0));
+  stats = bpm->GetStats();
+  EXPECT_EQ(8001U, stats.hits_);
+  EXPECT_EQ(1U, stats.deletes_);
+  // the hits and unpins of a resident page do not take the latch, only draining their replacer updates does
+  EXPECT_GT(stats.latch_acquires_, 0U);
+  EXPECT_LT(stats.latch_acquires_, 8000U);
+  EXPECT_LE(stats.latch_contended_, stats.latch_acquires_);
+
+  delete bpm;
+  delete disk_manager;
+}
+
+TEST(BufferPoolManagerInstanceTest, ReplacerTypeTest) {
+  const size_t buffer_pool_size = 4;
+  const size_t num_pages = 32;
+
+  for (auto replacer_type :
+       {ReplacerType::LRU, ReplacerType::CLOCK, ReplacerType::LRU_K, ReplacerType::ARC, ReplacerType::TWO_Q}) {
+    auto *disk_manager = new DiskManagerMemory(num_pages);
+    auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager, 2, nullptr, nullptr, replacer_type);
+
+    // Scenario: more pages than frames are created, so every policy has to evict dirty pages.
+    page_id_t page_id;
+    for (size_t i = 0; i < num_pages; ++i) {
+      auto *page = bpm->NewPage(&page_id);
+      ASSERT_NE(nullptr, page);
+      snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "page %d", page_id);
+      EXPECT_TRUE(bpm->UnpinPage(page_id, true));
+    }
+
+    // Scenario: a skewed read pattern, with a pinned page, reads back what was written.
+    auto *pinned = bpm->FetchPage(0);
+    ASSERT_NE(nullptr, pinned);
+    for (size_t i = 0; i < 4 * num_pages; ++i) {
+      page_id = static_cast<page_id_t>(i % 3 == 0 ? i % num_pages : 1 + i % 2);
+      auto *page = bpm->FetchPage(page_id);
+      ASSERT_NE(nullptr, page);
+      EXPECT_EQ("page " + std::to_string(page_id), std::string(page->GetData()));
+      EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+    }
+    EXPECT_EQ(pinned, bpm->FetchPage(0));
+    EXPECT_TRUE(bpm->UnpinPage(0, false));
+    EXPECT_TRUE(bpm->UnpinPage(0, false));
+
+    // Scenario: every policy follows the pool when it shrinks and grows.
+    for (size_t pool_size : {2, 7, 3}) {
+      ASSERT_TRUE(bpm->Resize(pool_size));
+      for (size_t i = 0; i < 2 * num_pages; ++i) {
+        page_id = static_cast<page_id_t>(i * 7 % num_pages);
+        auto *page = bpm->FetchPage(page_id);
+        ASSERT_NE(nullptr, page);
+        EXPECT_EQ("page " + std::to_string(page_id), std::string(page->GetData()));
+        EXPECT_TRUE(bpm->UnpinPage(page_id, i % 5 == 0));
+      }
+    }
+
+    delete bpm;
+    delete disk_manager;
+  }
+}
+
+TEST(BufferPoolManagerInstanceTest, ResizeTest) {
+  const size_t num_pages = 64;
+
+  auto *disk_manager = new RecordingDiskManager(num_pages);
+  auto *bpm = new BufferPoolManagerInstance(4, disk_manager, 2);
+
+  // Scenario: growing the pool gives room for more pages without evicting the resident ones.
+  page_id_t page_id;
+  for (size_t i = 0; i < 4; ++i) {
+    auto *page = bpm->NewPage(&page_id);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "page %d", page_id);
+    EXPECT_TRUE(bpm->UnpinPage(page_id, true));
+  }
+  ASSERT_TRUE(bpm->Resize(8));
+  EXPECT_EQ(8, bpm->GetPoolSize());
+  for (size_t i = 4; i < 8; ++i) {
+    auto *page = bpm->NewPage(&page_id);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "page %d", page_id);
+    EXPECT_TRUE(bpm->UnpinPage(page_id, true));
+  }
+  EXPECT_TRUE(disk_manager->GetWrittenPages().empty());
+
+  // Scenario: shrinking gives up if a frame to drop stays pinned. Pages 4 and 5 move to the frames freed by deleting
+  // pages 0 and 1, the dirty page 6 is evicted, and page 7 stays in the pool.
+  auto *pinned = bpm->FetchPage(7);
+  ASSERT_EQ(pinned, bpm->GetFrame(7));
+  EXPECT_TRUE(bpm->DeletePage(0));
+  EXPECT_TRUE(bpm->DeletePage(1));
+  const auto resize_timeout = buffer_pool_resize_timeout;
+  buffer_pool_resize_timeout = std::chrono::milliseconds(10);
+  EXPECT_FALSE(bpm->Resize(4));
+  buffer_pool_resize_timeout = resize_timeout;
+  EXPECT_EQ(8, bpm->GetPoolSize());
+  EXPECT_EQ((std::vector<page_id_t>{6}), disk_manager->GetWrittenPages());
+
+  // Scenario: shrinking waits for the pinned frame, and evicts the dirty page 7 once it is unpinned.
+  std::thread unpinner([&] {
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_TRUE(bpm->UnpinPage(7, true));
+  });
+  ASSERT_TRUE(bpm->Resize(4));
+  unpinner.join();
+  EXPECT_EQ(4, bpm->GetPoolSize());
+  EXPECT_EQ((std::vector<page_id_t>{6, 7}), disk_manager->GetWrittenPages());
+  for (page_id = 2; page_id < 8; ++page_id) {
+    auto *page = bpm->FetchPage(page_id);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ("page " + std::to_string(page_id), std::string(page->GetData()));
+    EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+  }
+
+  // Scenario: the pool can shrink to a single frame and grow back into the frames it dropped and beyond.
+  ASSERT_TRUE(bpm->Resize(1));
+  ASSERT_TRUE(bpm->Resize(12));
+  EXPECT_EQ(12, bpm->GetPoolSize());
+  std::vector<Page *> pages;
+  for (page_id = 2; page_id < 8; ++page_id) {
+    pages.push_back(bpm->FetchPage(page_id));
+    ASSERT_NE(nullptr, pages.back());
+    EXPECT_EQ("page " + std::to_string(page_id), std::string(pages.back()->GetData()));
+  }
+  for (size_t i = 0; i < 6; ++i) {
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+  }
+  EXPECT_EQ(nullptr, bpm->NewPage(&page_id));
+
+  delete bpm;
+  delete disk_manager;
+}
+
+TEST(BufferPoolManagerInstanceTest, ConcurrentResizeTest) {
+  const size_t num_pages = 64;
+  const int num_threads = 4;
+
+  auto *disk_manager = new DiskManagerMemory(num_pages);
+  auto *bpm = new BufferPoolManagerInstance(16, disk_manager, 2);
+  page_id_t page_id;
+  for (size_t i = 0; i < num_pages; ++i) {
+    auto *page = bpm->NewPage(&page_id);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "page %d", page_id);
+    EXPECT_TRUE(bpm->UnpinPage(page_id, true));
+  }
+
+  // Scenario: readers always see the right contents while the pool keeps growing and shrinking under them.
+  std::atomic<bool> done{false};
+  std::vector<std::thread> threads;
+  for (int tid = 0; tid < num_threads; ++tid) {
+    threads.emplace_back([&, tid] {
+      std::mt19937 gen(tid);
+      while (!done) {
+        const auto pid = static_cast<page_id_t>(gen() % num_pages);
+        auto *page = bpm->FetchPage(pid);
+        if (page == nullptr) {
+          // every frame is pinned by the other readers
+          continue;
+        }
+        EXPECT_EQ("page " + std::to_string(pid), std::string(page->GetData()));
+        EXPECT_TRUE(bpm->UnpinPage(pid, gen() % 4 == 0));
+      }
+    });
+  }
+  size_t num_shrinks = 0;
+  for (int i = 0; i < 200; ++i) {
+    if (bpm->Resize(i % 2 == 0 ? 8 : 32)) {
+      num_shrinks += i % 2 == 0 ? 1 : 0;
+    }
+  }
+  done = true;
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  EXPECT_GT(num_shrinks, 0U);
+
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerInstanceTest, DeleteDuringWriteBackTest) {
+  auto *disk_manager = new SlowWriteDiskManager(16, 0, std::chrono::milliseconds(200));
+  auto *page_allocator = new PageAllocator(disk_manager);
+  auto *bpm = new BufferPoolManagerInstance(2, disk_manager, 2, nullptr, page_allocator);
+
+  page_id_t old_page_id;
+  Page *page = bpm->NewPage(&old_page_id);
+  ASSERT_NE(nullptr, page);
+  std::snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "old");
+  EXPECT_EQ(true, bpm->UnpinPage(old_page_id, true));
+  page_id_t page_id;
+  ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+  EXPECT_EQ(true, bpm->UnpinPage(page_id, false));
+
+  // Scenario: a page deleted while its eviction is writing it back is only freed once the write is done, so that the
+  // stale write cannot land on the page that reuses its id.
+  std::thread evictor([&] {
+    page_id_t new_page_id;
+    ASSERT_NE(nullptr, bpm->NewPage(&new_page_id));
+    bpm->UnpinPage(new_page_id, false);
+  });
+  while (!disk_manager->writing_) {
+    std::this_thread::yield();
+  }
+  EXPECT_EQ(true, bpm->DeletePage(old_page_id));
+  page = bpm->NewPage(&page_id);
+  ASSERT_NE(nullptr, page);
+  EXPECT_EQ(old_page_id, page_id);
+  std::snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "new");
+  EXPECT_EQ(true, bpm->UnpinPage(page_id, true));
+  bpm->FlushAllPages();
+  evictor.join();
+  char data[BUSTUB_PAGE_SIZE];
+  disk_manager->ReadPage(page_id, data);
+  EXPECT_EQ("new", std::string(data));
+
+  // Scenario: deleting a page that cannot exist succeeds without touching the allocator.
+  EXPECT_EQ(true, bpm->DeletePage(INVALID_PAGE_ID));
+  EXPECT_EQ(true, bpm->DeletePage(1));
+  EXPECT_TRUE(page_allocator->IsAllocated(1));
+
+  delete bpm;
+  delete page_allocator;
+  delete disk_manager;
+}
+
 }  // namespace bustub
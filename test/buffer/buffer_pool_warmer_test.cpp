@@ -0,0 +1,187 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// buffer_pool_warmer_test.cpp
+//
+// Identification: test/buffer/buffer_pool_warmer_test.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/buffer_pool_warmer.h"
+
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "buffer/parallel_buffer_pool_manager.h"
+#include "common/bustub_instance.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager.h"
+#include "storage/disk/page_allocator.h"
+
+namespace bustub {
+
+class BufferPoolWarmerTest : public ::testing::Test {
+ protected:
+  void SetUp() override { RemoveFiles(); }
+
+  void TearDown() override { RemoveFiles(); }
+
+  static void RemoveFiles() {
+    remove("test.db");
+    remove("test.log");
+    remove("test.db.warmup");
+  }
+
+  /** Create a page holding its own id and leave it unpinned. */
+  static auto CreatePage(BufferPoolManager *bpm) -> page_id_t {
+    page_id_t page_id;
+    Page *page = bpm->NewPage(&page_id);
+    EXPECT_NE(nullptr, page);
+    snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "page %d", page_id);
+    bpm->UnpinPage(page_id, true);
+    return page_id;
+  }
+
+  /** Fetch a page, check that it holds its own id and unpin it. */
+  static void CheckPage(BufferPoolManager *bpm, page_id_t page_id) {
+    Page *page = bpm->FetchPage(page_id);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ("page " + std::to_string(page_id), std::string(page->GetData()));
+    bpm->UnpinPage(page_id, false);
+  }
+};
+
+// NOLINTNEXTLINE
+TEST_F(BufferPoolWarmerTest, PlanRunsTest) {
+  // Scenario: duplicates are dropped, short gaps are read through, a long gap starts a new read.
+  auto runs = BufferPoolWarmer::PlanRuns({10, 3, 4, 5, 9, 200, 5, 70}, 8, 4);
+  ASSERT_EQ(3, runs.size());
+  EXPECT_EQ((std::vector<page_id_t>{3, 4, 5, 9, 10}), runs[0]);
+  EXPECT_EQ((std::vector<page_id_t>{70}), runs[1]);
+  EXPECT_EQ((std::vector<page_id_t>{200}), runs[2]);
+
+  // Scenario: consecutive pages are split into reads of at most max_run_pages.
+  std::vector<page_id_t> page_ids;
+  for (page_id_t page_id = 0; page_id < 20; page_id++) {
+    page_ids.push_back(page_id);
+  }
+  runs = BufferPoolWarmer::PlanRuns(page_ids, 8, 0);
+  ASSERT_EQ(3, runs.size());
+  EXPECT_EQ(8, runs[1].size());
+  EXPECT_EQ((std::vector<page_id_t>{16, 17, 18, 19}), runs[2]);
+}
+
+// NOLINTNEXTLINE
+TEST_F(BufferPoolWarmerTest, WarmUpTest) {
+  DiskManager disk_manager("test.db");
+  PageAllocator allocator(&disk_manager);
+  std::set<page_id_t> hot_pages;
+  {
+    auto bpm = std::make_unique<BufferPoolManagerInstance>(20, &disk_manager, 2, nullptr, &allocator);
+    std::vector<page_id_t> page_ids;
+    for (int i = 0; i < 30; i++) {
+      page_ids.push_back(CreatePage(bpm.get()));
+    }
+    // Scenario: the first pages are accessed again, so LRU-K keeps them over the pages created afterwards.
+    for (int i = 0; i < 8; i++) {
+      CheckPage(bpm.get(), page_ids[i]);
+      hot_pages.insert(page_ids[i]);
+    }
+    auto resident = bpm->GetResidentPages();
+    ASSERT_EQ(20, resident.size());
+    EXPECT_EQ(hot_pages, std::set<page_id_t>(resident.begin(), resident.begin() + 8));
+
+    BufferPoolWarmer warmer(bpm.get(), "test.db.warmup");
+    ASSERT_TRUE(warmer.Dump());
+    bpm->FlushAllPages();
+  }
+
+  // Scenario: after a restart with a smaller pool, only the hottest pages are loaded, with a single sequential read.
+  auto bpm = std::make_unique<BufferPoolManagerInstance>(8, &disk_manager, 2, nullptr, &allocator);
+  BufferPoolWarmer warmer(bpm.get(), "test.db.warmup");
+  warmer.StartWarmUp();
+  warmer.WaitForWarmUp();
+  EXPECT_EQ(8, warmer.GetNumPagesLoaded());
+  EXPECT_EQ(1, bpm->GetStats().read_latency_.Count());
+  for (const auto page_id : hot_pages) {
+    CheckPage(bpm.get(), page_id);
+  }
+  EXPECT_EQ(0, bpm->GetStats().misses_);
+
+  // Scenario: warming up a full pool loads nothing, it never evicts a page.
+  BufferPoolWarmer second_warmer(bpm.get(), "test.db.warmup");
+  second_warmer.StartWarmUp();
+  second_warmer.WaitForWarmUp();
+  EXPECT_EQ(0, second_warmer.GetNumPagesLoaded());
+}
+
+// NOLINTNEXTLINE
+TEST_F(BufferPoolWarmerTest, ParallelWarmUpTest) {
+  DiskManager disk_manager("test.db");
+  PageAllocator allocator(&disk_manager);
+  std::vector<page_id_t> page_ids;
+  {
+    auto bpm = std::make_unique<ParallelBufferPoolManager>(2, 8, &disk_manager, 2, nullptr, &allocator);
+    for (int i = 0; i < 16; i++) {
+      page_ids.push_back(CreatePage(bpm.get()));
+    }
+    BufferPoolWarmer warmer(bpm.get(), "test.db.warmup");
+    ASSERT_TRUE(warmer.Dump());
+    bpm->FlushAllPages();
+  }
+
+  // Scenario: the list interleaves the instances, so each of them gets back its share of the hottest pages.
+  auto bpm = std::make_unique<ParallelBufferPoolManager>(2, 4, &disk_manager, 2, nullptr, &allocator);
+  BufferPoolWarmer warmer(bpm.get(), "test.db.warmup");
+  warmer.StartWarmUp();
+  warmer.WaitForWarmUp();
+  EXPECT_EQ(8, warmer.GetNumPagesLoaded());
+  auto resident = bpm->GetResidentPages();
+  ASSERT_EQ(8, resident.size());
+  for (const auto page_id : resident) {
+    CheckPage(bpm.get(), page_id);
+  }
+  EXPECT_EQ(0, bpm->GetStats().misses_);
+}
+
+// NOLINTNEXTLINE
+TEST_F(BufferPoolWarmerTest, BustubInstanceTest) {
+  // Scenario: a database instance saves its resident pages at shutdown and loads them back when it is opened again.
+  std::vector<page_id_t> page_ids;
+  {
+    BustubInstance instance("test.db");
+    BufferPoolManager *bpm = instance.buffer_pool_manager_;
+    ASSERT_NE(nullptr, bpm);
+    for (int i = 0; i < 16; i++) {
+      page_id_t page_id;
+      Page *page = bpm->NewPage(&page_id);
+      ASSERT_NE(nullptr, page);
+      std::snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "page %d", page_id);
+      bpm->UnpinPage(page_id, true);
+      page_ids.push_back(page_id);
+    }
+    bpm->FlushAllPages();
+  }
+  BustubInstance instance("test.db");
+  instance.WaitForWarmUp();
+  BufferPoolManager *bpm = instance.buffer_pool_manager_;
+  const auto resident = bpm->GetResidentPages();
+  const std::set<page_id_t> resident_pages(resident.begin(), resident.end());
+  for (const page_id_t page_id : page_ids) {
+    EXPECT_EQ(1, resident_pages.count(page_id)) << page_id;
+  }
+  Page *page = bpm->FetchPage(page_ids.back());
+  ASSERT_NE(nullptr, page);
+  EXPECT_EQ("page " + std::to_string(page_ids.back()), std::string(page->GetData()));
+  bpm->UnpinPage(page_ids.back(), false);
+}
+
+}  // namespace bustub
@@ -0,0 +1,162 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// compressed_page_cache_test.cpp
+//
+// Identification: test/buffer/compressed_page_cache_test.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/compressed_page_cache.h"
+
+#include <array>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <string>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "buffer/parallel_buffer_pool_manager.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
+
+namespace bustub {
+
+namespace {
+
+/** Fill a page with a compressible pattern derived from its id. */
+void FillPage(page_id_t page_id, char *data) {
+  std::memset(data, 0, BUSTUB_PAGE_SIZE);
+  for (int i = 0; i < 32; i++) {
+    snprintf(data + i * 64, 64, "page %d, record %d", page_id, i);
+  }
+}
+
+}  // namespace
+
+// NOLINTNEXTLINE
+TEST(CompressedPageCacheTest, InsertTakeTest) {
+  CompressedPageCache cache(64 * 1024);
+  std::array<char, BUSTUB_PAGE_SIZE> page;
+  std::array<char, BUSTUB_PAGE_SIZE> out;
+
+  // Scenario: a cached page comes back unchanged, once: the cache is exclusive.
+  FillPage(1, page.data());
+  cache.Insert(1, page.data());
+  ASSERT_TRUE(cache.Take(1, out.data()));
+  EXPECT_EQ(0, std::memcmp(page.data(), out.data(), BUSTUB_PAGE_SIZE));
+  EXPECT_FALSE(cache.Take(1, out.data()));
+
+  // Scenario: an invalidated page is gone, and a page that does not compress is not stored.
+  cache.Insert(2, page.data());
+  cache.Invalidate(2);
+  EXPECT_FALSE(cache.Take(2, out.data()));
+  std::mt19937 gen(42);
+  for (auto &c : page) {
+    c = static_cast<char>(gen());
+  }
+  cache.Insert(3, page.data());
+  EXPECT_FALSE(cache.Take(3, out.data()));
+
+  auto stats = cache.GetStats();
+  EXPECT_EQ(1U, stats.hits_);
+  EXPECT_EQ(3U, stats.misses_);
+  EXPECT_EQ(2U, stats.insertions_);
+  EXPECT_EQ(1U, stats.rejections_);
+  EXPECT_EQ(0U, stats.num_pages_);
+  EXPECT_EQ(0U, stats.used_bytes_);
+  EXPECT_GT(stats.CompressionRatio(), 4.0);
+}
+
+// NOLINTNEXTLINE
+TEST(CompressedPageCacheTest, RingTest) {
+  std::array<char, BUSTUB_PAGE_SIZE> page;
+  std::array<char, BUSTUB_PAGE_SIZE> out;
+  FillPage(0, page.data());
+  size_t page_size;
+  {
+    CompressedPageCache probe(BUSTUB_PAGE_SIZE);
+    probe.Insert(0, page.data());
+    page_size = probe.GetStats().compressed_bytes_;
+  }
+
+  // Scenario: the region holds 10 pages; inserting more drops the oldest ones, whatever was taken out meanwhile.
+  CompressedPageCache cache(10 * page_size + page_size / 2);
+  for (page_id_t page_id = 0; page_id < 10; page_id++) {
+    cache.Insert(page_id, page.data());
+  }
+  EXPECT_TRUE(cache.Take(5, out.data()));
+  for (page_id_t page_id = 10; page_id < 13; page_id++) {
+    cache.Insert(page_id, page.data());
+  }
+  EXPECT_FALSE(cache.Take(0, out.data()));
+  EXPECT_FALSE(cache.Take(2, out.data()));
+  for (page_id_t page_id : {3, 4, 6, 9, 10, 12}) {
+    EXPECT_TRUE(cache.Take(page_id, out.data())) << page_id;
+    EXPECT_EQ(0, std::memcmp(page.data(), out.data(), BUSTUB_PAGE_SIZE));
+  }
+  const auto stats = cache.GetStats();
+  EXPECT_EQ(3U, stats.evictions_);
+  EXPECT_LE(stats.used_bytes_, cache.GetCapacity());
+}
+
+// NOLINTNEXTLINE
+TEST(CompressedPageCacheTest, BufferPoolTest) {
+  const size_t num_pages = 32;
+  DiskManagerMemory disk_manager(num_pages);
+  CompressedPageCache cache(num_pages * BUSTUB_PAGE_SIZE);
+  auto bpm = std::make_unique<ParallelBufferPoolManager>(2, 4, &disk_manager, 2);
+  bpm->SetCompressedPageCache(&cache);
+  page_id_t page_id;
+  for (size_t i = 0; i < num_pages; i++) {
+    Page *page = bpm->NewPage(&page_id);
+    ASSERT_NE(nullptr, page);
+    FillPage(page_id, page->GetData());
+    bpm->UnpinPage(page_id, true);
+  }
+  bpm->FlushAllPages();
+  const auto reads_before = bpm->GetStats().read_latency_.Count();
+
+  // Scenario: once written back, the pages evicted clean are served by the cache instead of the disk.
+  for (int round = 0; round < 3; round++) {
+    for (page_id = 0; page_id < static_cast<page_id_t>(num_pages); page_id++) {
+      Page *page = bpm->FetchPage(page_id);
+      ASSERT_NE(nullptr, page);
+      std::array<char, BUSTUB_PAGE_SIZE> expected;
+      FillPage(page_id, expected.data());
+      ASSERT_EQ(0, std::memcmp(expected.data(), page->GetData(), BUSTUB_PAGE_SIZE)) << page_id;
+      // dirty the pages of the last round: their cached copies must not come back once they are written
+      bpm->UnpinPage(page_id, round == 2 && page_id % 2 == 0);
+    }
+  }
+  EXPECT_GT(cache.GetStats().hits_, 0U);
+  EXPECT_LT(bpm->GetStats().read_latency_.Count() - reads_before, num_pages);
+
+  // Scenario: a page modified after it left the cache is read back with its new contents once evicted dirty.
+  ASSERT_NE(nullptr, bpm->FetchPage(0));
+  EXPECT_TRUE(bpm->UnpinPage(0, false));
+  for (page_id = 1; page_id < static_cast<page_id_t>(num_pages); page_id++) {
+    ASSERT_NE(nullptr, bpm->FetchPage(page_id));
+    bpm->UnpinPage(page_id, false);
+  }
+  Page *page = bpm->FetchPage(0);
+  ASSERT_NE(nullptr, page);
+  snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "rewritten");
+  bpm->UnpinPage(0, true);
+  for (page_id = 1; page_id < static_cast<page_id_t>(num_pages); page_id++) {
+    ASSERT_NE(nullptr, bpm->FetchPage(page_id));
+    bpm->UnpinPage(page_id, false);
+  }
+  page = bpm->FetchPage(0);
+  ASSERT_NE(nullptr, page);
+  EXPECT_EQ("rewritten", std::string(page->GetData()));
+  bpm->UnpinPage(0, false);
+
+  bpm->SetCompressedPageCache(nullptr);
+}
+
+}  // namespace bustub
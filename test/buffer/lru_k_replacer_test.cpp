@@ -97,4 +97,64 @@ TEST(LRUKReplacerTest, SampleTest) {
   lru_replacer.Remove(1);
   ASSERT_EQ(0, lru_replacer.Size());
 }
+
+TEST(LRUKReplacerTest, BackwardKDistanceTest) {
+  LRUKReplacer lru_replacer(4, 2);
+
+  // Scenario: frame 1 is accessed at ts 0, 1 and 4, frame 2 at ts 2 and 3. Frame 1 was touched most recently, but its
+  // second most recent access (ts 1) is older than frame 2's (ts 2), so it has the larger backward 2-distance.
+  lru_replacer.RecordAccess(1);
+  lru_replacer.RecordAccess(1);
+  lru_replacer.RecordAccess(2);
+  lru_replacer.RecordAccess(2);
+  lru_replacer.RecordAccess(1);
+  int value;
+  ASSERT_EQ(true, lru_replacer.Evict(&value));
+  ASSERT_EQ(1, value);
+
+  // Scenario: pinning and unpinning a frame keeps its history; accessing it again re-ranks it.
+  lru_replacer.RecordAccess(3);
+  lru_replacer.RecordAccess(3);
+  lru_replacer.SetEvictable(2, false);
+  lru_replacer.SetEvictable(2, true);
+  ASSERT_EQ(2, lru_replacer.Size());
+  lru_replacer.RecordAccess(2);
+  lru_replacer.RecordAccess(2);
+  ASSERT_EQ(true, lru_replacer.Evict(&value));
+  ASSERT_EQ(3, value);
+  ASSERT_EQ(true, lru_replacer.Evict(&value));
+  ASSERT_EQ(2, value);
+  ASSERT_EQ(false, lru_replacer.Evict(&value));
+
+  // Scenario: a removed frame starts over with an empty history.
+  lru_replacer.RecordAccess(0);
+  lru_replacer.RecordAccess(0);
+  lru_replacer.Remove(0);
+  lru_replacer.RecordAccess(1);
+  lru_replacer.RecordAccess(1);
+  lru_replacer.RecordAccess(0);
+  ASSERT_EQ(true, lru_replacer.Evict(&value));
+  ASSERT_EQ(0, value);
+  ASSERT_EQ(1, lru_replacer.Size());
+}
+
+TEST(LRUKReplacerTest, PriorityOrderTest) {
+  LRUKReplacer lru_replacer(5, 2);
+
+  // Scenario: frames 1 and 2 have two accesses, frames 3 and 4 only one. Frame 4 is pinned, which does not change its
+  // place in the order. The order is the reverse of the eviction order: [2, 1, 4, 3].
+  lru_replacer.RecordAccess(3);
+  lru_replacer.RecordAccess(1);
+  lru_replacer.RecordAccess(4);
+  lru_replacer.RecordAccess(1);
+  lru_replacer.RecordAccess(2);
+  lru_replacer.RecordAccess(2);
+  lru_replacer.SetEvictable(4, false);
+  ASSERT_EQ((std::vector<frame_id_t>{2, 1, 4, 3}), lru_replacer.GetPriorityOrder());
+
+  int value;
+  ASSERT_EQ(true, lru_replacer.Evict(&value));
+  ASSERT_EQ(3, value);
+  ASSERT_EQ((std::vector<frame_id_t>{2, 1, 4}), lru_replacer.GetPriorityOrder());
+}
 }  // namespace bustub
@@ -0,0 +1,193 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// parallel_buffer_pool_manager_test.cpp
+//
+// Identification: test/buffer/parallel_buffer_pool_manager_test.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/parallel_buffer_pool_manager.h"
+
+#include <cstdio>
+#include <set>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(ParallelBufferPoolManagerTest, SampleTest) {
+  const std::string db_name = "test.db";
+  const size_t buffer_pool_size = 5;
+  const size_t num_instances = 5;
+  const size_t k = 5;
+
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new ParallelBufferPoolManager(num_instances, buffer_pool_size, disk_manager, k);
+  EXPECT_EQ(buffer_pool_size * num_instances, bpm->GetPoolSize());
+
+  page_id_t page_id_temp;
+  auto *page0 = bpm->NewPage(&page_id_temp);
+
+  // Scenario: The buffer pool is empty. We should be able to create a new page.
+  ASSERT_NE(nullptr, page0);
+  EXPECT_EQ(0, page_id_temp);
+
+  // Scenario: Once we have a page, we should be able to read and write content.
+  snprintf(page0->GetData(), BUSTUB_PAGE_SIZE, "Hello");
+  EXPECT_EQ(0, strcmp(page0->GetData(), "Hello"));
+
+  // Scenario: We should be able to create new pages until we fill up the buffer pool.
+  std::set<page_id_t> page_ids{page_id_temp};
+  for (size_t i = 1; i < buffer_pool_size * num_instances; ++i) {
+    EXPECT_NE(nullptr, bpm->NewPage(&page_id_temp));
+    page_ids.insert(page_id_temp);
+  }
+  // Round-robin allocation hands out every page id exactly once and fills every instance.
+  EXPECT_EQ(buffer_pool_size * num_instances, page_ids.size());
+
+  // Scenario: Once the buffer pool is full, we should not be able to create any new pages.
+  for (size_t i = 0; i < buffer_pool_size * num_instances; ++i) {
+    EXPECT_EQ(nullptr, bpm->NewPage(&page_id_temp));
+  }
+
+  // Scenario: After unpinning page 0 and creating one new page, page 0 has been written back to disk and its instance
+  // is full again, so it can't be fetched.
+  EXPECT_EQ(true, bpm->UnpinPage(0, true));
+  EXPECT_NE(nullptr, bpm->NewPage(&page_id_temp));
+  EXPECT_EQ(0, page_id_temp % num_instances);
+  EXPECT_EQ(nullptr, bpm->FetchPage(0));
+
+  // Scenario: Once the new page is unpinned, we should be able to fetch the data we wrote a while ago.
+  EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, false));
+  page0 = bpm->FetchPage(0);
+  ASSERT_NE(nullptr, page0);
+  EXPECT_EQ(0, strcmp(page0->GetData(), "Hello"));
+  EXPECT_EQ(true, bpm->UnpinPage(0, false));
+
+  // Shutdown the disk manager and remove the temporary file we created.
+  disk_manager->ShutDown();
+  remove("test.db");
+
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(ParallelBufferPoolManagerTest, ConcurrencyTest) {
+  const size_t num_threads = 8;
+  const size_t num_pages = 200;
+  const size_t num_instances = 4;
+
+  auto *disk_manager = new DiskManagerMemory(num_pages);
+  auto *bpm = new ParallelBufferPoolManager(num_instances, 16, disk_manager, 2);
+
+  std::vector<page_id_t> page_ids(num_pages);
+  for (size_t i = 0; i < num_pages; i++) {
+    auto *page = bpm->NewPage(&page_ids[i]);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "%d", page_ids[i]);
+    EXPECT_EQ(true, bpm->UnpinPage(page_ids[i], true));
+  }
+
+  std::vector<std::thread> threads;
+  for (size_t tid = 0; tid < num_threads; tid++) {
+    threads.emplace_back([&, tid] {
+      for (size_t i = tid; i < 4 * num_pages; i += num_threads) {
+        page_id_t page_id = page_ids[i % num_pages];
+        auto *page = bpm->FetchPage(page_id);
+        ASSERT_NE(nullptr, page);
+        EXPECT_EQ(std::to_string(page_id), std::string(page->GetData()));
+        EXPECT_EQ(true, bpm->UnpinPage(page_id, false));
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  delete bpm;
+  delete disk_manager;
+}
+
+TEST(ParallelBufferPoolManagerTest, ResizeTest) {
+  const size_t num_pages = 64;
+  const size_t num_instances = 4;
+
+  auto *disk_manager = new DiskManagerMemory(num_pages);
+  auto *bpm = new ParallelBufferPoolManager(num_instances, 4, disk_manager, 2);
+  EXPECT_EQ(16, bpm->GetPoolSize());
+
+  std::vector<page_id_t> page_ids(num_pages);
+  for (size_t i = 0; i < num_pages; i++) {
+    auto *page = bpm->NewPage(&page_ids[i]);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "%d", page_ids[i]);
+    EXPECT_EQ(true, bpm->UnpinPage(page_ids[i], true));
+  }
+
+  // Scenario: the frames are spread over the instances, the first ones get the remainder.
+  ASSERT_TRUE(bpm->Resize(42));
+  EXPECT_EQ(42, bpm->GetPoolSize());
+  EXPECT_EQ(11, bpm->GetBufferPoolManager(0)->GetPoolSize());
+  EXPECT_EQ(10, bpm->GetBufferPoolManager(3)->GetPoolSize());
+
+  // Scenario: every page can be pinned at once in a big enough pool, and read back after shrinking.
+  ASSERT_TRUE(bpm->Resize(num_pages));
+  for (auto page_id : page_ids) {
+    ASSERT_NE(nullptr, bpm->FetchPage(page_id));
+  }
+  for (auto page_id : page_ids) {
+    EXPECT_EQ(true, bpm->UnpinPage(page_id, false));
+  }
+  ASSERT_TRUE(bpm->Resize(num_instances));
+  for (auto page_id : page_ids) {
+    auto *page = bpm->FetchPage(page_id);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ(std::to_string(page_id), std::string(page->GetData()));
+    EXPECT_EQ(true, bpm->UnpinPage(page_id, false));
+  }
+
+  delete bpm;
+  delete disk_manager;
+}
+
+TEST(ParallelBufferPoolManagerTest, SegmentTest) {
+  const size_t num_instances = 2;
+  auto *disk_manager = new DiskManagerMemory(8 * EXTENT_SIZE);
+  auto *bpm = new ParallelBufferPoolManager(num_instances, 8, disk_manager, 2);
+
+  // Scenario: the pages of a segment are contiguous and spread over the instances, even though new pages outside the
+  // segment go round-robin over the instances at the same time. No page id is handed out twice.
+  PageSegment segment;
+  std::set<page_id_t> page_ids;
+  page_id_t first;
+  ASSERT_NE(nullptr, bpm->NewPageInSegment(&first, &segment));
+  EXPECT_EQ(true, bpm->UnpinPage(first, true));
+  page_ids.insert(first);
+  page_id_t page_id;
+  for (page_id_t i = 1; i < 2 * EXTENT_SIZE; i++) {
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+    EXPECT_EQ(true, bpm->UnpinPage(page_id, true));
+    EXPECT_TRUE(page_ids.insert(page_id).second);
+    ASSERT_NE(nullptr, bpm->NewPageInSegment(&page_id, &segment));
+    if (i < EXTENT_SIZE) {
+      EXPECT_EQ(first + i, page_id);
+    }
+    EXPECT_EQ(true, bpm->UnpinPage(page_id, true));
+    EXPECT_TRUE(page_ids.insert(page_id).second);
+  }
+
+  delete bpm;
+  delete disk_manager;
+}
+
+}  // namespace bustub
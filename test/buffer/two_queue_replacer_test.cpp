@@ -0,0 +1,83 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// two_queue_replacer_test.cpp
+//
+// Identification: test/buffer/two_queue_replacer_test.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/two_queue_replacer.h"
+
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+TEST(TwoQueueReplacerTest, SampleTest) {
+  // Kin is 2 frames and Kout is 4 pages.
+  TwoQueueReplacer two_queue_replacer(8);
+
+  // Scenario: frames 0 to 3 hold pages 0 to 3, in A1in. Accessing page 0 again is a correlated reference.
+  for (frame_id_t fid = 0; fid < 4; ++fid) {
+    two_queue_replacer.RecordAccess(fid, fid);
+  }
+  two_queue_replacer.RecordAccess(0, 0);
+  EXPECT_EQ(4, two_queue_replacer.Size());
+
+  // Scenario: A1in is a FIFO, so page 0 is evicted first and remembered in A1out.
+  frame_id_t value;
+  ASSERT_TRUE(two_queue_replacer.Evict(&value));
+  EXPECT_EQ(0, value);
+
+  // Scenario: page 0 comes back while in A1out, so it is promoted to Am.
+  two_queue_replacer.RecordAccess(0, 0);
+
+  // Scenario: pages 4 to 7 go to A1in, which is trimmed first while it holds more than Kin frames.
+  for (frame_id_t fid = 4; fid < 8; ++fid) {
+    two_queue_replacer.RecordAccess(fid, fid);
+  }
+  for (frame_id_t expected = 1; expected <= 5; ++expected) {
+    ASSERT_TRUE(two_queue_replacer.Evict(&value));
+    EXPECT_EQ(expected, value);
+  }
+
+  // Scenario: A1in is down to Kin frames, so the victim now comes from Am.
+  ASSERT_TRUE(two_queue_replacer.Evict(&value));
+  EXPECT_EQ(0, value);
+  EXPECT_EQ(2, two_queue_replacer.Size());
+}
+
+TEST(TwoQueueReplacerTest, PinTest) {
+  TwoQueueReplacer two_queue_replacer(4);
+
+  // Scenario: page 10 is promoted to Am in frame 0, pages 11 to 13 fill A1in.
+  two_queue_replacer.RecordAccess(0, 10);
+  frame_id_t value;
+  ASSERT_TRUE(two_queue_replacer.Evict(&value));
+  two_queue_replacer.RecordAccess(0, 10);
+  for (frame_id_t fid = 1; fid < 4; ++fid) {
+    two_queue_replacer.RecordAccess(fid, 10 + fid);
+  }
+
+  // Scenario: when all the frames of A1in are pinned, the victim comes from Am.
+  for (frame_id_t fid = 1; fid < 4; ++fid) {
+    two_queue_replacer.SetEvictable(fid, false);
+  }
+  EXPECT_EQ(1, two_queue_replacer.Size());
+  ASSERT_TRUE(two_queue_replacer.Evict(&value));
+  EXPECT_EQ(0, value);
+  EXPECT_FALSE(two_queue_replacer.Evict(&value));
+
+  // Scenario: unpinned frames become victims again; removed frames are forgotten.
+  two_queue_replacer.SetEvictable(2, true);
+  two_queue_replacer.SetEvictable(3, true);
+  two_queue_replacer.Remove(3);
+  EXPECT_EQ(1, two_queue_replacer.Size());
+  ASSERT_TRUE(two_queue_replacer.Evict(&value));
+  EXPECT_EQ(2, value);
+}
+
+}  // namespace bustub
@@ -10,6 +10,8 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
+#include <random>
 #include <string>
 #include <unordered_set>
 #include <vector>
@@ -688,4 +690,68 @@ TEST(CatalogTest, DISABLED_IndexInteraction3) {
   remove("catalog_test.log");
 }
 
+// Index creation on a populated table sorts the keys, on disk if they do not fit in memory, and bulk loads them
+TEST(CatalogTest, CreateIndexBulkLoadTest) {
+  auto disk_manager = std::make_unique<DiskManager>("catalog_test.db");
+  auto bpm = std::make_unique<BufferPoolManagerInstance>(64, disk_manager.get());
+  page_id_t header_page_id;
+  bpm->NewPage(&header_page_id);
+  auto catalog = std::make_unique<Catalog>(bpm.get(), nullptr, nullptr);
+  auto txn = std::make_unique<Transaction>(0);
+
+  std::vector<Column> columns{};
+  columns.emplace_back("A", TypeId::BIGINT);
+  columns.emplace_back("B", TypeId::INTEGER);
+  Schema schema{columns};
+  auto *table_info = catalog->CreateTable(txn.get(), "foobar", schema);
+  ASSERT_NE(Catalog::NULL_TABLE_INFO, table_info);
+
+  const int num_rows = 2000;
+  std::vector<int64_t> keys;
+  for (int64_t key = 0; key < num_rows; key++) {
+    keys.push_back(key * 3);
+  }
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(1));
+  for (const int64_t key : keys) {
+    RID rid;
+    Tuple tuple({ValueFactory::GetBigIntValue(key), ValueFactory::GetIntegerValue(static_cast<int32_t>(key + 1))},
+                &schema);
+    ASSERT_TRUE(table_info->table_->InsertTuple(tuple, &rid, txn.get()));
+  }
+
+  std::vector<Column> key_columns{};
+  key_columns.emplace_back("A", TypeId::BIGINT);
+  Schema key_schema{key_columns};
+  const size_t sort_memory = index_build_sort_memory;
+  index_build_sort_memory = 4096;
+  auto *index_info = catalog->CreateIndex<BigintKeyType, BigintValueType, BigintComparatorType>(
+      txn.get(), "index1", "foobar", schema, key_schema, {0}, BIGINT_SIZE, BigintHashFunctionType{});
+  index_build_sort_memory = sort_memory;
+  ASSERT_NE(Catalog::NULL_INDEX_INFO, index_info);
+
+  // a scan of the index yields every key in order, each with the RID of its row
+  auto *index = dynamic_cast<BPlusTreeIndex<BigintKeyType, BigintValueType, BigintComparatorType> *>(
+      index_info->index_.get());
+  ASSERT_NE(nullptr, index);
+  int64_t expected_key = 0;
+  for (auto iterator = index->GetBeginIterator(); !iterator.IsEnd(); ++iterator) {
+    Tuple tuple;
+    ASSERT_TRUE(table_info->table_->GetTuple((*iterator).second, &tuple, txn.get()));
+    EXPECT_EQ(expected_key, tuple.GetValue(&schema, 0).GetAs<int64_t>());
+    EXPECT_EQ(expected_key + 1, tuple.GetValue(&schema, 1).GetAs<int32_t>());
+    expected_key += 3;
+  }
+  EXPECT_EQ(num_rows * 3, expected_key);
+
+  // a point lookup finds a row
+  std::vector<RID> rids;
+  Tuple key_tuple({ValueFactory::GetBigIntValue(300)}, &key_schema);
+  index->ScanKey(key_tuple, &rids, txn.get());
+  ASSERT_EQ(1, rids.size());
+
+  bpm->UnpinPage(header_page_id, true);
+  remove("catalog_test.db");
+  remove("catalog_test.log");
+}
+
 }  // namespace bustub
@@ -0,0 +1,88 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// lz_codec_test.cpp
+//
+// Identification: test/common/lz_codec_test.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "common/util/lz_codec.h"
+
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+namespace {
+
+/** Compress and decompress data, checking that it comes back unchanged. @return the compressed size */
+auto RoundTrip(const std::string &data) -> size_t {
+  std::vector<char> compressed(LZCodec::MaxCompressedSize(data.size()));
+  const size_t size = LZCodec::Compress(data.data(), data.size(), compressed.data(), compressed.size());
+  EXPECT_GT(size, 0U);
+  std::string decompressed(data.size(), '\0');
+  EXPECT_EQ(data.size(), LZCodec::Decompress(compressed.data(), size, decompressed.data(), decompressed.size()));
+  EXPECT_EQ(data, decompressed);
+  return size;
+}
+
+}  // namespace
+
+// NOLINTNEXTLINE
+TEST(LZCodecTest, RoundTripTest) {
+  // Scenario: a page of records and free space, like a table page, compresses well.
+  std::string page(4096, '\0');
+  for (int i = 0; i < 60; i++) {
+    snprintf(page.data() + i * 40, 40, "key=%08d,value=customer#%06d", i, i * 7);
+  }
+  EXPECT_LT(RoundTrip(page), page.size() / 4);
+
+  // Scenario: runs of a single byte, whose matches overlap the bytes they produce, and long literal runs.
+  EXPECT_LT(RoundTrip(std::string(10000, 'x')), 100U);
+  std::mt19937 gen(42);
+  std::string random(4096, '\0');
+  for (auto &c : random) {
+    c = static_cast<char>(gen());
+  }
+  EXPECT_LE(RoundTrip(random), LZCodec::MaxCompressedSize(random.size()));
+  RoundTrip(random + random);
+  RoundTrip("abc");
+  RoundTrip("");
+}
+
+// NOLINTNEXTLINE
+TEST(LZCodecTest, BoundsTest) {
+  std::string random(4096, '\0');
+  std::mt19937 gen(7);
+  for (auto &c : random) {
+    c = static_cast<char>(gen());
+  }
+  std::vector<char> compressed(LZCodec::MaxCompressedSize(random.size()));
+
+  // Scenario: data that does not fit in the output is reported rather than written past it.
+  EXPECT_EQ(0U, LZCodec::Compress(random.data(), random.size(), compressed.data(), random.size() / 2));
+
+  // Scenario: a too small output or truncated input is detected, garbled input never overflows the output.
+  const std::string text = std::string(2000, 'a') + "bcd" + std::string(2000, 'a');
+  const size_t size = LZCodec::Compress(text.data(), text.size(), compressed.data(), compressed.size());
+  ASSERT_GT(size, 0U);
+  std::string out(text.size(), '\0');
+  EXPECT_EQ(0U, LZCodec::Decompress(compressed.data(), size, out.data(), out.size() - 1));
+  EXPECT_NE(text.size(), LZCodec::Decompress(compressed.data(), size / 2, out.data(), out.size()));
+  for (size_t i = 0; i < 200; i++) {
+    std::vector<char> garbled(compressed.begin(), compressed.begin() + size);
+    garbled[gen() % size] = static_cast<char>(gen());
+    // whatever it decodes to, it stays within the buffers
+    EXPECT_LE(LZCodec::Decompress(garbled.data(), garbled.size(), out.data(), out.size()), out.size());
+  }
+}
+
+}  // namespace bustub
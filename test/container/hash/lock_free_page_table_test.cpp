@@ -0,0 +1,178 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// lock_free_page_table_test.cpp
+//
+// Identification: test/container/hash/lock_free_page_table_test.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "container/hash/lock_free_page_table.h"
+
+#include <atomic>
+#include <random>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+TEST(LockFreePageTableTest, SampleTest) {
+  LockFreePageTable table(10);
+  EXPECT_EQ(32, table.GetCapacity());
+
+  frame_id_t frame_id;
+  EXPECT_FALSE(table.Find(0, &frame_id));
+  for (page_id_t page_id = 0; page_id < 10; page_id++) {
+    EXPECT_TRUE(table.Insert(page_id, page_id + 100));
+  }
+  for (page_id_t page_id = 0; page_id < 10; page_id++) {
+    ASSERT_TRUE(table.Find(page_id, &frame_id));
+    EXPECT_EQ(page_id + 100, frame_id);
+  }
+  EXPECT_FALSE(table.Find(10, &frame_id));
+
+  EXPECT_TRUE(table.Remove(3));
+  EXPECT_FALSE(table.Remove(3));
+  EXPECT_FALSE(table.Find(3, &frame_id));
+  for (page_id_t page_id = 0; page_id < 10; page_id++) {
+    EXPECT_EQ(page_id != 3, table.Find(page_id, &frame_id));
+  }
+
+  // Scenario: a page can be mapped to another frame once removed.
+  EXPECT_TRUE(table.Insert(3, 7));
+  ASSERT_TRUE(table.Find(3, &frame_id));
+  EXPECT_EQ(7, frame_id);
+}
+
+TEST(LockFreePageTableTest, ChurnTest) {
+  const size_t num_frames = 64;
+  LockFreePageTable table(num_frames);
+
+  // Scenario: a buffer pool cycling through many more pages than it has frames never fills up the table.
+  std::vector<page_id_t> resident(num_frames, INVALID_PAGE_ID);
+  std::mt19937 gen(0);
+  for (page_id_t page_id = 0; page_id < 100000; page_id++) {
+    const frame_id_t victim = static_cast<frame_id_t>(gen() % num_frames);
+    if (resident[victim] != INVALID_PAGE_ID) {
+      ASSERT_TRUE(table.Remove(resident[victim]));
+    }
+    ASSERT_TRUE(table.Insert(page_id, victim));
+    resident[victim] = page_id;
+  }
+  frame_id_t frame_id;
+  for (size_t i = 0; i < num_frames; i++) {
+    if (resident[i] != INVALID_PAGE_ID) {
+      ASSERT_TRUE(table.Find(resident[i], &frame_id));
+      EXPECT_EQ(static_cast<frame_id_t>(i), frame_id);
+    }
+  }
+
+  // Scenario: removes clean up the tombstones of the churn, so the table is all empty again once the pool is.
+  EXPECT_LT(table.GetNumTombstones(), num_frames);
+  for (size_t i = 0; i < num_frames; i++) {
+    if (resident[i] != INVALID_PAGE_ID) {
+      ASSERT_TRUE(table.Remove(resident[i]));
+    }
+  }
+  EXPECT_EQ(0, table.GetNumTombstones());
+  EXPECT_FALSE(table.Find(0, &frame_id));
+}
+
+TEST(LockFreePageTableTest, ConcurrentReadTest) {
+  const size_t num_frames = 128;
+  const int num_readers = 4;
+  LockFreePageTable table(num_frames);
+
+  // Pages 0 to 63 stay put while a writer maps and unmaps pages 1000 and above to the other frames.
+  for (page_id_t page_id = 0; page_id < 64; page_id++) {
+    ASSERT_TRUE(table.Insert(page_id, page_id));
+  }
+  std::atomic<bool> done{false};
+  std::thread writer([&] {
+    for (page_id_t page_id = 1000; page_id < 50000; page_id++) {
+      const auto frame_id = static_cast<frame_id_t>(64 + page_id % 64);
+      table.Insert(page_id, frame_id);
+      if (page_id >= 1064) {
+        table.Remove(page_id - 64);
+      }
+    }
+    done = true;
+  });
+
+  // Scenario: lock-free readers always find the stable pages, and never see a torn mapping.
+  std::vector<std::thread> readers;
+  for (int tid = 0; tid < num_readers; tid++) {
+    readers.emplace_back([&, tid] {
+      std::mt19937 gen(tid);
+      frame_id_t frame_id;
+      while (!done) {
+        const auto page_id = static_cast<page_id_t>(gen() % 64);
+        ASSERT_TRUE(table.Find(page_id, &frame_id));
+        ASSERT_EQ(page_id, frame_id);
+        const auto moving_page_id = static_cast<page_id_t>(1000 + gen() % 49000);
+        if (table.Find(moving_page_id, &frame_id)) {
+          ASSERT_EQ(64 + moving_page_id % 64, frame_id);
+        }
+      }
+    });
+  }
+  writer.join();
+  for (auto &reader : readers) {
+    reader.join();
+  }
+}
+
+TEST(LockFreePageTableTest, ResizeTest) {
+  LockFreePageTable table(16);
+  EXPECT_EQ(32, table.GetCapacity());
+  for (page_id_t page_id = 0; page_id < 16; page_id++) {
+    ASSERT_TRUE(table.Insert(page_id, page_id));
+  }
+  EXPECT_TRUE(table.Remove(5));
+
+  // Scenario: growing rehashes every mapping, and makes room for more.
+  table.Resize(100);
+  EXPECT_EQ(256, table.GetCapacity());
+  frame_id_t frame_id;
+  for (page_id_t page_id = 0; page_id < 16; page_id++) {
+    ASSERT_EQ(page_id != 5, table.Find(page_id, &frame_id));
+  }
+  for (page_id_t page_id = 16; page_id < 100; page_id++) {
+    ASSERT_TRUE(table.Insert(page_id, page_id));
+  }
+
+  // Scenario: shrinking keeps the mappings that are left.
+  for (page_id_t page_id = 8; page_id < 100; page_id++) {
+    table.Remove(page_id);
+  }
+  table.Resize(8);
+  EXPECT_EQ(16, table.GetCapacity());
+  for (page_id_t page_id = 0; page_id < 8; page_id++) {
+    ASSERT_EQ(page_id != 5, table.Find(page_id, &frame_id));
+    EXPECT_TRUE(page_id == 5 || frame_id == page_id);
+  }
+
+  // Scenario: readers keep finding the stable pages while the table is resized under them.
+  std::atomic<bool> done{false};
+  std::thread reader([&] {
+    frame_id_t found;
+    while (!done) {
+      for (page_id_t page_id = 0; page_id < 5; page_id++) {
+        ASSERT_TRUE(table.Find(page_id, &found));
+        ASSERT_EQ(page_id, found);
+      }
+    }
+  });
+  for (size_t i = 0; i < 200; i++) {
+    table.Resize(i % 2 == 0 ? 1000 : 8);
+  }
+  done = true;
+  reader.join();
+}
+
+}  // namespace bustub
@@ -0,0 +1,220 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_bulk_load_test.cpp
+//
+// Identification: test/storage/b_plus_tree_bulk_load_test.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "gtest/gtest.h"
+#include "storage/index/b_plus_tree.h"
+#include "test_util.h"  // NOLINT
+
+namespace bustub {
+
+namespace {
+
+using Tree = BPlusTree<GenericKey<8>, RID, GenericComparator<8>>;
+using LeafPage = BPlusTreeLeafPage<GenericKey<8>, RID, GenericComparator<8>>;
+using InternalPage = BPlusTreeInternalPage<GenericKey<8>, page_id_t, GenericComparator<8>>;
+
+/** Shape of a tree, as found by CheckTree(). */
+struct TreeShape {
+  int height_{0};
+  int leaves_{0};
+  int keys_{0};
+};
+
+/**
+ * Check the invariants of the subtree of a node: the sizes of the nodes and their parents.
+ * @return the height of the subtree
+ */
+auto CheckNode(BufferPoolManager *bpm, page_id_t page_id, page_id_t parent_id, TreeShape *shape) -> int {
+  auto node = reinterpret_cast<BPlusTreePage *>(bpm->FetchPage(page_id)->GetData());
+  EXPECT_EQ(parent_id, node->GetParentPageId());
+  if (parent_id != INVALID_PAGE_ID) {
+    EXPECT_GE(node->GetSize(), node->GetMinSize()) << page_id;
+  }
+  int height = 1;
+  if (node->IsLeafPage()) {
+    auto leaf = reinterpret_cast<LeafPage *>(node);
+    EXPECT_LT(leaf->GetSize(), leaf->GetMaxSize());
+    shape->leaves_++;
+    shape->keys_ += leaf->GetSize();
+  } else {
+    auto internal = reinterpret_cast<InternalPage *>(node);
+    EXPECT_LE(internal->GetSize(), internal->GetMaxSize());
+    EXPECT_GE(internal->GetSize(), 2);
+    for (int i = 0; i < internal->GetSize(); i++) {
+      height = CheckNode(bpm, internal->ValueAt(i), page_id, shape) + 1;
+    }
+  }
+  bpm->UnpinPage(page_id, false);
+  return height;
+}
+
+auto CheckTree(BufferPoolManager *bpm, Tree *tree) -> TreeShape {
+  TreeShape shape;
+  if (!tree->IsEmpty()) {
+    shape.height_ = CheckNode(bpm, tree->GetRootPageId(), INVALID_PAGE_ID, &shape);
+  }
+  return shape;
+}
+
+/** @return a bulk load source over sorted keys, whose values are their keys */
+auto KeySource(const std::vector<int64_t> &keys, size_t *pos) -> Tree::BulkLoadSource {
+  return [&keys, pos](GenericKey<8> *key, RID *rid) {
+    if (*pos == keys.size()) {
+      return false;
+    }
+    key->SetFromInteger(keys[*pos]);
+    rid->Set(0, static_cast<uint32_t>(keys[*pos]));
+    (*pos)++;
+    return true;
+  };
+}
+
+/** @return the keys of a tree, in the order of a scan */
+auto ScanKeys(Tree *tree) -> std::vector<int64_t> {
+  std::vector<int64_t> keys;
+  for (auto iterator = tree->Begin(); iterator != tree->End(); ++iterator) {
+    keys.push_back((*iterator).second.GetSlotNum());
+  }
+  return keys;
+}
+
+}  // namespace
+
+TEST(BPlusTreeTests, BulkLoadTest) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+  auto *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManagerInstance(64, disk_manager);
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+
+  // Scenario: trees of every shape, from a single leaf to a few levels with a last node to even out, at full and at
+  // half fill, are well formed and hold all the keys.
+  int index_id = 0;
+  for (const int num_keys : {0, 1, 4, 5, 6, 7, 22, 23, 100, 1000}) {
+    for (const double fill_factor : {1.0, 0.5}) {
+      std::vector<int64_t> keys;
+      for (int64_t key = 1; key <= num_keys; key++) {
+        keys.push_back(key * 2);
+      }
+      Tree tree("bulk_" + std::to_string(index_id++), bpm, comparator, 5, 5);
+      size_t pos = 0;
+      ASSERT_TRUE(tree.BulkLoad(KeySource(keys, &pos), fill_factor));
+      EXPECT_EQ(keys.size(), pos);
+      auto shape = CheckTree(bpm, &tree);
+      EXPECT_EQ(num_keys, shape.keys_) << num_keys << " keys at " << fill_factor;
+      EXPECT_EQ(keys, ScanKeys(&tree)) << num_keys << " keys at " << fill_factor;
+      if (fill_factor == 1.0 && num_keys >= 4) {
+        // full leaves hold 4 keys, and only the last two may hold fewer
+        EXPECT_LE(shape.leaves_, (num_keys + 3) / 4 + 1);
+      }
+
+      std::vector<RID> rids;
+      GenericKey<8> index_key;
+      for (const int64_t key : keys) {
+        rids.clear();
+        index_key.SetFromInteger(key);
+        EXPECT_TRUE(tree.GetValue(index_key, &rids)) << key;
+        index_key.SetFromInteger(key + 1);
+        EXPECT_FALSE(tree.GetValue(index_key, &rids)) << key + 1;
+      }
+
+      // Scenario: the tree takes inserts and removes after the load, and a second load is refused.
+      RID rid;
+      for (int64_t key = 1; key <= num_keys * 2; key += 2) {
+        index_key.SetFromInteger(key);
+        rid.Set(0, static_cast<uint32_t>(key));
+        EXPECT_TRUE(tree.Insert(index_key, rid));
+      }
+      for (const int64_t key : keys) {
+        index_key.SetFromInteger(key);
+        tree.Remove(index_key);
+      }
+      std::vector<int64_t> odd_keys;
+      for (int64_t key = 1; key <= num_keys * 2; key += 2) {
+        odd_keys.push_back(key);
+      }
+      EXPECT_EQ(odd_keys, ScanKeys(&tree));
+      EXPECT_EQ(num_keys, CheckTree(bpm, &tree).keys_);
+      pos = 0;
+      EXPECT_EQ(num_keys == 0, tree.BulkLoad(KeySource(keys, &pos)));
+    }
+  }
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete bpm;
+  delete disk_manager;
+  remove("test.db");
+  remove("test.log");
+}
+
+TEST(BPlusTreeTests, BulkLoadFillFactorTest) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+  auto *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManagerInstance(64, disk_manager);
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+
+  std::vector<int64_t> keys;
+  for (int64_t key = 1; key <= 20000; key++) {
+    keys.push_back(key);
+  }
+  std::vector<int64_t> shuffled = keys;
+  std::shuffle(shuffled.begin(), shuffled.end(), std::mt19937(1));
+
+  // Scenario: a bulk-loaded tree has fewer leaves than one built by inserts in random order, whose leaves end up about
+  // 70% full, and duplicate keys in the input are loaded once.
+  Tree inserted("inserted", bpm, comparator);
+  GenericKey<8> index_key;
+  RID rid;
+  for (const int64_t key : shuffled) {
+    index_key.SetFromInteger(key);
+    rid.Set(0, static_cast<uint32_t>(key));
+    inserted.Insert(index_key, rid);
+  }
+  std::vector<int64_t> with_duplicates;
+  for (const int64_t key : keys) {
+    with_duplicates.push_back(key);
+    if (key % 10 == 0) {
+      with_duplicates.push_back(key);
+    }
+  }
+  Tree loaded("loaded", bpm, comparator);
+  size_t pos = 0;
+  ASSERT_TRUE(loaded.BulkLoad(KeySource(with_duplicates, &pos)));
+
+  const auto inserted_shape = CheckTree(bpm, &inserted);
+  const auto loaded_shape = CheckTree(bpm, &loaded);
+  EXPECT_EQ(20000, inserted_shape.keys_);
+  EXPECT_EQ(20000, loaded_shape.keys_);
+  EXPECT_EQ(keys, ScanKeys(&loaded));
+  EXPECT_LT(loaded_shape.leaves_ * 4, inserted_shape.leaves_ * 3);
+  EXPECT_LE(loaded_shape.height_, inserted_shape.height_);
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete bpm;
+  delete disk_manager;
+  remove("test.db");
+  remove("test.log");
+}
+
+}  // namespace bustub
@@ -16,6 +16,7 @@
 #include "buffer/buffer_pool_manager_instance.h"
 #include "common/logger.h"
 #include "gtest/gtest.h"
+#include "storage/disk/page_allocator.h"
 #include "storage/index/b_plus_tree.h"
 #include "test_util.h"  // NOLINT
 
@@ -164,4 +165,70 @@ TEST(BPlusTreeTests, DeleteTest2) {
   remove("test.db");
   remove("test.log");
 }
+
+TEST(BPlusTreeTests, PinnedMergeTest) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+
+  auto *disk_manager = new DiskManager("test.db");
+  auto *page_allocator = new PageAllocator(disk_manager);
+  BufferPoolManager *bpm = new BufferPoolManagerInstance(50, disk_manager, LRUK_REPLACER_K, nullptr, page_allocator);
+  auto *transaction = new Transaction(0);
+  page_id_t page_id;
+  ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+  {
+    BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator, 3, 3);
+    GenericKey<8> index_key;
+    RID rid;
+    for (int64_t key = 1; key <= 3; key++) {
+      rid.Set(0, key);
+      index_key.SetFromInteger(key);
+      tree.Insert(index_key, rid, transaction);
+    }
+    Page *root = bpm->FetchPage(tree.GetRootPageId());
+    auto *root_node = reinterpret_cast<BPlusTreeInternalPage<GenericKey<8>, page_id_t, GenericComparator<8>> *>(
+        root->GetData());
+    ASSERT_FALSE(root_node->IsLeafPage());
+    ASSERT_EQ(2, root_node->GetSize());
+    const page_id_t leaves[] = {root_node->ValueAt(0), root_node->ValueAt(1)};
+    bpm->UnpinPage(root->GetPageId(), false);
+
+    // Scenario: a leaf that a merge removes while a reader pins it stays allocated until the pin is gone, and is
+    // deleted by the next operation that releases its latches.
+    for (const page_id_t leaf : leaves) {
+      ASSERT_NE(nullptr, bpm->FetchPage(leaf));
+    }
+    auto root_is_leaf = [&] {
+      Page *page = bpm->FetchPage(tree.GetRootPageId());
+      const bool is_leaf = reinterpret_cast<BPlusTreePage *>(page->GetData())->IsLeafPage();
+      bpm->UnpinPage(page->GetPageId(), false);
+      return is_leaf;
+    };
+    for (int64_t key = 3; !root_is_leaf(); key--) {
+      index_key.SetFromInteger(key);
+      tree.Remove(index_key, transaction);
+    }
+    const page_id_t removed_leaf = leaves[0] == tree.GetRootPageId() ? leaves[1] : leaves[0];
+    EXPECT_TRUE(page_allocator->IsAllocated(removed_leaf));
+    for (const page_id_t leaf : leaves) {
+      bpm->UnpinPage(leaf, false);
+    }
+    EXPECT_TRUE(page_allocator->IsAllocated(removed_leaf));
+    for (int64_t key = 4; key <= 5; key++) {
+      rid.Set(0, key);
+      index_key.SetFromInteger(key);
+      tree.Insert(index_key, rid, transaction);
+    }
+    EXPECT_FALSE(page_allocator->IsAllocated(removed_leaf));
+  }
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete transaction;
+  delete bpm;
+  delete page_allocator;
+  delete disk_manager;
+  remove("test.db");
+  remove("test.log");
+}
+
 }  // namespace bustub
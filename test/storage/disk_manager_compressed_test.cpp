@@ -0,0 +1,347 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// disk_manager_compressed_test.cpp
+//
+// Identification: test/storage/disk_manager_compressed_test.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/disk/disk_manager_compressed.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "common/exception.h"
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+namespace {
+
+/** A page that compresses into the smallest slot. */
+void FillPage(page_id_t page_id, char *data) {
+  std::memset(data, 0, BUSTUB_PAGE_SIZE);
+  snprintf(data, BUSTUB_PAGE_SIZE, "page %d", page_id);
+  data[BUSTUB_PAGE_SIZE - 1] = static_cast<char>(page_id);
+}
+
+/** A page that does not compress and is stored raw. */
+void FillRandomPage(uint32_t seed, char *data) {
+  std::mt19937 gen(seed);
+  for (size_t i = 0; i < BUSTUB_PAGE_SIZE; i += sizeof(uint32_t)) {
+    const uint32_t word = gen();
+    std::memcpy(data + i, &word, sizeof(word));
+  }
+}
+
+void RemoveFiles() {
+  for (const char *file : {"test", "crash"}) {
+    remove((std::string(file) + ".db").c_str());
+    remove((std::string(file) + ".log").c_str());
+    remove((std::string(file) + ".db.map").c_str());
+    remove((std::string(file) + ".db.map.tmp").c_str());
+  }
+}
+
+/** @return false if there is no file to copy */
+auto CopyFile(const std::string &from, const std::string &to) -> bool {
+  std::ifstream in(from, std::ios::binary);
+  if (!in.is_open()) {
+    return false;
+  }
+  std::ofstream out(to, std::ios::binary | std::ios::trunc);
+  out << in.rdbuf();
+  return true;
+}
+
+}  // namespace
+
+class DiskManagerCompressedTest : public ::testing::Test {
+ protected:
+  void SetUp() override { RemoveFiles(); }
+
+  void TearDown() override { RemoveFiles(); };
+};
+
+// NOLINTNEXTLINE
+TEST_F(DiskManagerCompressedTest, ReadWritePageTest) {
+  const int64_t small_slot = DiskManagerCompressed::SLOT_ALIGNMENT;
+  const int64_t raw_slot = BUSTUB_PAGE_SIZE + DiskManagerCompressed::SLOT_ALIGNMENT;
+  char buf[BUSTUB_PAGE_SIZE] = {0};
+  char data[BUSTUB_PAGE_SIZE] = {0};
+  char noise[BUSTUB_PAGE_SIZE];
+  char zeros[BUSTUB_PAGE_SIZE] = {0};
+  FillPage(5, data);
+  FillRandomPage(1, noise);
+  DiskManagerCompressed dm("test.db");
+  EXPECT_EQ("", dm.GetPageFileName());
+
+  // Scenario: a page never written reads as zeros.
+  std::memset(buf, 'x', sizeof(buf));
+  dm.ReadPage(0, buf);
+  EXPECT_EQ(0, std::memcmp(buf, zeros, sizeof(buf)));
+  EXPECT_EQ(0, dm.GetCompressionRatio());
+
+  // Scenario: a page that compresses takes a small slot, one that does not is stored raw.
+  dm.WritePage(5, data);
+  EXPECT_EQ(small_slot, dm.GetDbFileSize());
+  EXPECT_GT(dm.GetCompressionRatio(), 8);
+  dm.WritePage(2, noise);
+  EXPECT_EQ(small_slot + raw_slot, dm.GetDbFileSize());
+  dm.ReadPage(5, buf);
+  EXPECT_EQ(0, std::memcmp(buf, data, sizeof(buf)));
+  dm.ReadPage(2, buf);
+  EXPECT_EQ(0, std::memcmp(buf, noise, sizeof(buf)));
+  dm.ReadPage(3, buf);
+  EXPECT_EQ(0, std::memcmp(buf, zeros, sizeof(buf)));
+
+  // Scenario: a run mixes pages written in adjacent slots, apart, and never.
+  std::vector<char> run(4 * BUSTUB_PAGE_SIZE, 'x');
+  dm.ReadPages(2, 4, run.data());
+  EXPECT_EQ(0, std::memcmp(run.data(), noise, BUSTUB_PAGE_SIZE));
+  EXPECT_EQ(0, std::memcmp(run.data() + BUSTUB_PAGE_SIZE, zeros, BUSTUB_PAGE_SIZE));
+  EXPECT_EQ(0, std::memcmp(run.data() + 2 * BUSTUB_PAGE_SIZE, zeros, BUSTUB_PAGE_SIZE));
+  EXPECT_EQ(0, std::memcmp(run.data() + 3 * BUSTUB_PAGE_SIZE, data, BUSTUB_PAGE_SIZE));
+
+  // Scenario: a batch is written and made durable with a single sync.
+  std::vector<std::vector<char>> pages(3, std::vector<char>(BUSTUB_PAGE_SIZE));
+  for (page_id_t i = 0; i < 3; i++) {
+    FillPage(7 + i, pages[i].data());
+  }
+  dm.WritePages({{9, pages[2].data()}, {7, pages[0].data()}, {8, pages[1].data()}});
+  EXPECT_EQ(1, dm.GetNumSyncs());
+  EXPECT_EQ(5, dm.GetNumWrites());
+  dm.Sync();
+  EXPECT_EQ(1, dm.GetNumSyncs());
+  dm.ReadPages(7, 3, run.data());
+  for (page_id_t i = 0; i < 3; i++) {
+    EXPECT_EQ(0, std::memcmp(run.data() + i * BUSTUB_PAGE_SIZE, pages[i].data(), BUSTUB_PAGE_SIZE));
+  }
+  dm.ShutDown();
+}
+
+// NOLINTNEXTLINE
+TEST_F(DiskManagerCompressedTest, RelocateTest) {
+  const int64_t small_slot = DiskManagerCompressed::SLOT_ALIGNMENT;
+  const int64_t raw_slot = BUSTUB_PAGE_SIZE + DiskManagerCompressed::SLOT_ALIGNMENT;
+  char buf[BUSTUB_PAGE_SIZE];
+  char data[BUSTUB_PAGE_SIZE];
+  auto write_small = [&](DiskManagerCompressed *dm, page_id_t page_id) {
+    FillPage(page_id, data);
+    dm->WritePage(page_id, data);
+  };
+  auto write_noise = [&](DiskManagerCompressed *dm, page_id_t page_id) {
+    FillRandomPage(page_id, data);
+    dm->WritePage(page_id, data);
+  };
+  auto dm = std::make_unique<DiskManagerCompressed>("test.db");
+  for (page_id_t page_id = 0; page_id < 4; page_id++) {
+    write_small(dm.get(), page_id);
+  }
+  EXPECT_EQ(4 * small_slot, dm->GetDbFileSize());
+
+  // Scenario: a page that outgrows its slot moves, and its old slot is not reused before the map is saved.
+  write_noise(dm.get(), 1);
+  EXPECT_EQ(4 * small_slot + raw_slot, dm->GetDbFileSize());
+  write_small(dm.get(), 4);
+  EXPECT_EQ(5 * small_slot + raw_slot, dm->GetDbFileSize());
+
+  // Scenario: once the map is saved, the old slot serves the next page.
+  dm->Sync();
+  write_small(dm.get(), 5);
+  EXPECT_EQ(5 * small_slot + raw_slot, dm->GetDbFileSize());
+
+  // Scenario: a page that shrinks stays in its slot.
+  write_small(dm.get(), 1);
+  EXPECT_EQ(5 * small_slot + raw_slot, dm->GetDbFileSize());
+
+  // two adjacent small slots are left behind
+  write_noise(dm.get(), 2);
+  write_noise(dm.get(), 3);
+  EXPECT_EQ(5 * small_slot + 3 * raw_slot, dm->GetDbFileSize());
+  dm->ShutDown();
+
+  // Scenario: the map is loaded on reopen, and the gap between the slots in use is found again and split.
+  dm = std::make_unique<DiskManagerCompressed>("test.db");
+  for (page_id_t page_id = 0; page_id < 6; page_id++) {
+    if (page_id == 2 || page_id == 3) {
+      FillRandomPage(page_id, data);
+    } else {
+      FillPage(page_id, data);
+    }
+    dm->ReadPage(page_id, buf);
+    EXPECT_EQ(0, std::memcmp(buf, data, BUSTUB_PAGE_SIZE)) << page_id;
+  }
+  write_small(dm.get(), 6);
+  write_small(dm.get(), 7);
+  EXPECT_EQ(5 * small_slot + 3 * raw_slot, dm->GetDbFileSize());
+  write_small(dm.get(), 8);
+  EXPECT_EQ(6 * small_slot + 3 * raw_slot, dm->GetDbFileSize());
+  for (page_id_t page_id = 6; page_id < 9; page_id++) {
+    FillPage(page_id, data);
+    dm->ReadPage(page_id, buf);
+    EXPECT_EQ(0, std::memcmp(buf, data, BUSTUB_PAGE_SIZE)) << page_id;
+  }
+  dm->ShutDown();
+}
+
+// NOLINTNEXTLINE
+TEST_F(DiskManagerCompressedTest, PageMapTest) {
+  char buf[BUSTUB_PAGE_SIZE];
+  char data[BUSTUB_PAGE_SIZE];
+  {
+    DiskManagerCompressed dm("test.db");
+    FillPage(1, data);
+    dm.WritePage(1, data);
+    dm.Sync();
+    // written after the last sync, and not in the saved map
+    FillPage(2, data);
+    dm.WritePage(2, data);
+    EXPECT_EQ(1, dm.GetNumSyncs());
+  }
+
+  // Scenario: the destructor syncs like ShutDown().
+  {
+    DiskManagerCompressed dm("test.db");
+    FillPage(2, data);
+    dm.ReadPage(2, buf);
+    EXPECT_EQ(0, std::memcmp(buf, data, BUSTUB_PAGE_SIZE));
+    dm.ShutDown();
+  }
+
+  // Scenario: a page map of another page size is refused.
+  {
+    std::ofstream map("test.db.map", std::ios::binary | std::ios::trunc);
+    const uint32_t header[4] = {0x4D505442, BUSTUB_PAGE_SIZE * 2, 0, 0};
+    map.write(reinterpret_cast<const char *>(header), sizeof(header));
+  }
+  EXPECT_THROW(DiskManagerCompressed("test.db"), Exception);
+}
+
+// NOLINTNEXTLINE
+TEST_F(DiskManagerCompressedTest, ConcurrentTest) {
+  const int num_threads = 4;
+  const page_id_t pages_per_thread = 64;
+  auto dm = std::make_unique<DiskManagerCompressed>("test.db");
+
+  // Scenario: threads write, rewrite with a larger page, and read back interleaved pages while others sync.
+  std::atomic<int> mismatches{0};
+  std::vector<std::thread> threads;
+  for (int t = 0; t < num_threads; t++) {
+    threads.emplace_back([&, t] {
+      char data[BUSTUB_PAGE_SIZE];
+      char buf[BUSTUB_PAGE_SIZE];
+      for (page_id_t i = 0; i < pages_per_thread; i++) {
+        const page_id_t page_id = i * num_threads + t;
+        FillRandomPage(page_id, data);
+        dm->WritePage(page_id, data);
+        FillPage(page_id, data);
+        dm->WritePage(page_id, data);
+        dm->ReadPage(page_id, buf);
+        if (std::memcmp(buf, data, BUSTUB_PAGE_SIZE) != 0) {
+          mismatches++;
+        }
+        if (i % 16 == 0) {
+          dm->Sync();
+        }
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(0, mismatches);
+
+  // Scenario: the buffer pool works on it unchanged.
+  auto bpm = std::make_unique<BufferPoolManagerInstance>(8, dm.get(), 2);
+  char expected[BUSTUB_PAGE_SIZE];
+  for (page_id_t page_id = 0; page_id < num_threads * pages_per_thread; page_id += 7) {
+    Page *page = bpm->FetchPage(page_id);
+    ASSERT_NE(nullptr, page);
+    FillPage(page_id, expected);
+    EXPECT_EQ(0, std::memcmp(expected, page->GetData(), BUSTUB_PAGE_SIZE)) << page_id;
+    bpm->UnpinPage(page_id, false);
+  }
+  bpm.reset();
+  dm->ShutDown();
+}
+
+// NOLINTNEXTLINE
+TEST_F(DiskManagerCompressedTest, SyncRacesWritesTest) {
+  const int num_threads = 4;
+  const page_id_t pages_per_thread = 256;
+  const page_id_t num_pages = num_threads * pages_per_thread;
+  auto dm = std::make_unique<DiskManagerCompressed>("test.db");
+
+  // Scenario: pages move to larger slots while another thread syncs. After every sync, a copy of the files, as a crash
+  // would leave them, holds a version of every page whose first write was done before the sync began.
+  std::vector<std::atomic<bool>> written(num_pages);
+  std::atomic<int> done{0};
+  std::vector<std::thread> threads;
+  for (int t = 0; t < num_threads; t++) {
+    threads.emplace_back([&, t] {
+      char data[BUSTUB_PAGE_SIZE];
+      for (page_id_t i = 0; i < pages_per_thread; i++) {
+        const page_id_t page_id = i * num_threads + t;
+        FillPage(page_id, data);
+        dm->WritePage(page_id, data);
+        written[page_id] = true;
+        FillRandomPage(page_id, data);
+        dm->WritePage(page_id, data);
+      }
+      done++;
+    });
+  }
+  int lost = 0;
+  char small[BUSTUB_PAGE_SIZE];
+  char raw[BUSTUB_PAGE_SIZE];
+  char buf[BUSTUB_PAGE_SIZE];
+  while (done < num_threads) {
+    std::vector<bool> durable(num_pages);
+    for (page_id_t page_id = 0; page_id < num_pages; page_id++) {
+      durable[page_id] = written[page_id];
+    }
+    dm->Sync();
+    // the slots the saved map points to are not reused before the next sync, whatever the writers do meanwhile
+    CopyFile("test.db", "crash.db");
+    if (!CopyFile("test.db.map", "crash.db.map")) {
+      // no map is saved before the first write
+      EXPECT_EQ(durable.end(), std::find(durable.begin(), durable.end(), true));
+      continue;
+    }
+    DiskManagerCompressed crashed("crash.db");
+    for (page_id_t page_id = 0; page_id < num_pages; page_id++) {
+      if (!durable[page_id]) {
+        continue;
+      }
+      crashed.ReadPage(page_id, buf);
+      FillPage(page_id, small);
+      FillRandomPage(page_id, raw);
+      if (std::memcmp(buf, small, BUSTUB_PAGE_SIZE) != 0 && std::memcmp(buf, raw, BUSTUB_PAGE_SIZE) != 0) {
+        lost++;
+      }
+    }
+    crashed.ShutDown();
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(0, lost);
+  dm->ShutDown();
+}
+
+}  // namespace bustub
@@ -0,0 +1,184 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// disk_manager_memory_test.cpp
+//
+// Identification: test/storage/disk_manager_memory_test.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/disk/disk_manager_memory.h"
+
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+namespace {
+
+void FillPage(page_id_t page_id, char *data) {
+  std::memset(data, 0, BUSTUB_PAGE_SIZE);
+  snprintf(data, BUSTUB_PAGE_SIZE, "page %d", page_id);
+}
+
+/** A disk manager that mirrors the pages written to it on a replica, and fails the writes of one page. */
+class MirroredDiskManager : public DiskManagerMemory {
+ public:
+  MirroredDiskManager(DiskManagerMemory *replica, page_id_t bad_page_id)
+      : DiskManagerMemory(16), replica_(replica), bad_page_id_(bad_page_id) {}
+
+  std::vector<page_id_t> read_page_ids_;
+
+ protected:
+  void OnPageRead(page_id_t page_id) override { read_page_ids_.push_back(page_id); }
+
+  void OnPageWrite(page_id_t page_id, const char *page_data) override {
+    if (page_id == bad_page_id_) {
+      throw std::runtime_error("bad page");
+    }
+    replica_->WritePage(page_id, page_data);
+  }
+
+ private:
+  DiskManagerMemory *replica_;
+  page_id_t bad_page_id_;
+};
+
+}  // namespace
+
+// NOLINTNEXTLINE
+TEST(DiskManagerMemoryTest, GrowTest) {
+  char buf[BUSTUB_PAGE_SIZE];
+  char data[BUSTUB_PAGE_SIZE];
+  char zeros[BUSTUB_PAGE_SIZE] = {0};
+  DiskManagerMemory dm(16);
+  const auto chunk_pages = static_cast<page_id_t>(DiskManagerMemory::CHUNK_PAGES);
+
+  // Scenario: memory is only taken for the chunks written to, however far apart their pages are.
+  EXPECT_EQ(0, dm.GetAllocatedSize());
+  for (const page_id_t page_id : {0, 3, 1000 * chunk_pages + 5}) {
+    FillPage(page_id, data);
+    dm.WritePage(page_id, data);
+  }
+  EXPECT_EQ(2 * DiskManagerMemory::CHUNK_PAGES * BUSTUB_PAGE_SIZE, dm.GetAllocatedSize());
+  for (const page_id_t page_id : {0, 3, 1000 * chunk_pages + 5}) {
+    dm.ReadPage(page_id, buf);
+    FillPage(page_id, data);
+    EXPECT_EQ(0, std::memcmp(buf, data, sizeof(buf))) << page_id;
+  }
+
+  // Scenario: pages never written read as zeros, also in a run spanning a missing chunk.
+  std::memset(buf, 'x', sizeof(buf));
+  dm.ReadPage(500 * chunk_pages, buf);
+  EXPECT_EQ(0, std::memcmp(buf, zeros, sizeof(buf)));
+  std::vector<char> run(3 * BUSTUB_PAGE_SIZE, 'x');
+  dm.ReadPages(chunk_pages - 1, 3, run.data());
+  for (size_t i = 0; i < 3; i++) {
+    EXPECT_EQ(0, std::memcmp(run.data() + i * BUSTUB_PAGE_SIZE, zeros, BUSTUB_PAGE_SIZE));
+  }
+  EXPECT_EQ(2 * DiskManagerMemory::CHUNK_PAGES * BUSTUB_PAGE_SIZE, dm.GetAllocatedSize());
+}
+
+// NOLINTNEXTLINE
+TEST(DiskManagerMemoryTest, HookTest) {
+  char data[BUSTUB_PAGE_SIZE] = {0};
+  std::vector<char> run(3 * BUSTUB_PAGE_SIZE);
+  DiskManagerMemory replica(16);
+  MirroredDiskManager dm(&replica, 13);
+
+  // Scenario: the hooks see every page of a batch, and the requests they make to other disk managers are served too.
+  std::vector<std::pair<page_id_t, const char *>> pages;
+  for (const page_id_t page_id : {4, 2, 3, 9}) {
+    pages.emplace_back(page_id, data);
+  }
+  dm.WritePages(pages);
+  dm.ReadPages(2, 3, run.data());
+  EXPECT_EQ(2, dm.GetStats().writes_);
+  EXPECT_EQ(4, replica.GetStats().writes_);
+  EXPECT_EQ(4, replica.GetNumWrites());
+  EXPECT_EQ(1, dm.GetStats().reads_);
+  EXPECT_EQ((std::vector<page_id_t>{2, 3, 4}), dm.read_page_ids_);
+
+  // Scenario: a hook failing in the middle of a batch leaves the next requests accounted for.
+  pages.emplace_back(13, data);
+  EXPECT_THROW(dm.WritePages(pages), std::runtime_error);
+  dm.ResetStats();
+  replica.ResetStats();
+  dm.WritePage(5, data);
+  EXPECT_EQ(1, dm.GetStats().writes_);
+  EXPECT_EQ(1, replica.GetStats().writes_);
+}
+
+// NOLINTNEXTLINE
+TEST(DiskManagerMemoryTest, LatencyModelTest) {
+  char data[BUSTUB_PAGE_SIZE] = {0};
+  std::vector<char> run(4 * BUSTUB_PAGE_SIZE);
+  DiskLatencyModel model;
+  model.read_latency_ = std::chrono::microseconds(100);
+  model.write_latency_ = std::chrono::microseconds(50);
+  model.seek_latency_ = std::chrono::milliseconds(2);
+  // a page takes a millisecond to transfer
+  model.bandwidth_ = BUSTUB_PAGE_SIZE * 1000;
+  model.sleep_ = false;
+  DiskManagerMemory dm(16, model);
+
+  // Scenario: a request pays a seek unless it follows the previous one, plus its transfer and its latency.
+  dm.ReadPage(0, data);
+  dm.ReadPages(1, 4, run.data());
+  auto stats = dm.GetStats();
+  EXPECT_EQ(2, stats.reads_);
+  EXPECT_EQ(5, stats.pages_read_);
+  EXPECT_EQ(1, stats.seeks_);
+  EXPECT_EQ(std::chrono::microseconds(2000 + 1000 + 100 + 4000 + 100), stats.device_time_);
+
+  // Scenario: a batch of writes is one request per run of consecutive pages. The first run follows the reads.
+  std::vector<std::pair<page_id_t, const char *>> pages;
+  for (const page_id_t page_id : {9, 5, 8, 7}) {
+    pages.emplace_back(page_id, data);
+  }
+  dm.ResetStats();
+  dm.WritePages(pages);
+  stats = dm.GetStats();
+  EXPECT_EQ(2, stats.writes_);
+  EXPECT_EQ(4, stats.pages_written_);
+  EXPECT_EQ(4, dm.GetNumWrites());
+  EXPECT_EQ(1, stats.seeks_);
+  EXPECT_EQ(std::chrono::microseconds(2000 + 4 * 1000 + 2 * 50), stats.device_time_);
+
+  // Scenario: latencies drawn from a distribution are the same from one run to the next with the same seed.
+  model = DiskLatencyModel::Ssd();
+  model.sleep_ = false;
+  std::chrono::nanoseconds device_times[2];
+  for (auto &device_time : device_times) {
+    dm.SetLatencyModel(model);
+    dm.ResetStats();
+    for (page_id_t page_id = 0; page_id < 100; page_id++) {
+      dm.ReadPage(page_id * 7 % 100, data);
+    }
+    device_time = dm.GetStats().device_time_;
+  }
+  EXPECT_EQ(device_times[0], device_times[1]);
+  EXPECT_GT(device_times[0], std::chrono::microseconds(100 * 40));
+  EXPECT_LT(device_times[0], std::chrono::microseconds(100 * 160));
+
+  // Scenario: requests wait for their modeled time, and random reads of a hard disk wait for their seeks.
+  model = DiskLatencyModel::Hdd();
+  dm.SetLatencyModel(model);
+  dm.ResetStats();
+  const auto start = std::chrono::steady_clock::now();
+  for (const page_id_t page_id : {10, 1, 7}) {
+    dm.ReadPage(page_id, data);
+  }
+  EXPECT_GE(std::chrono::steady_clock::now() - start, 3 * model.seek_latency_);
+  EXPECT_EQ(3, dm.GetStats().seeks_);
+}
+
+}  // namespace bustub
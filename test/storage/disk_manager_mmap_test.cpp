@@ -0,0 +1,193 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// disk_manager_mmap_test.cpp
+//
+// Identification: test/storage/disk_manager_mmap_test.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/disk/disk_manager_mmap.h"
+
+#include <sys/stat.h>
+
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+namespace {
+
+void FillPage(page_id_t page_id, char *data) {
+  std::memset(data, 0, BUSTUB_PAGE_SIZE);
+  snprintf(data, BUSTUB_PAGE_SIZE, "page %d", page_id);
+  data[BUSTUB_PAGE_SIZE - 1] = static_cast<char>(page_id);
+}
+
+auto FileSize(const std::string &file_name) -> int64_t {
+  struct stat stat_buf;
+  return stat(file_name.c_str(), &stat_buf) == 0 ? stat_buf.st_size : -1;
+}
+
+}  // namespace
+
+class DiskManagerMmapTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    remove("test.db");
+    remove("test.log");
+  }
+
+  void TearDown() override {
+    remove("test.db");
+    remove("test.log");
+  };
+};
+
+// NOLINTNEXTLINE
+TEST_F(DiskManagerMmapTest, ReadWritePageTest) {
+  const auto pages_per_chunk = static_cast<page_id_t>(DiskManagerMmap::GROW_CHUNK_SIZE / BUSTUB_PAGE_SIZE);
+  char buf[BUSTUB_PAGE_SIZE] = {0};
+  char data[BUSTUB_PAGE_SIZE] = {0};
+  char zeros[BUSTUB_PAGE_SIZE] = {0};
+  auto dm = std::make_unique<DiskManagerMmap>("test.db", false, 4 * DiskManagerMmap::GROW_CHUNK_SIZE);
+
+  // Scenario: an empty file reads as zeros, and the mapping grows by whole chunks with the pages written.
+  std::memset(buf, 'x', sizeof(buf));
+  dm->ReadPage(0, buf);
+  EXPECT_EQ(0, std::memcmp(buf, zeros, sizeof(buf)));
+  EXPECT_EQ(0, dm->GetMappedSize());
+  for (const page_id_t page_id : {0, 5, pages_per_chunk + 1, 2}) {
+    FillPage(page_id, data);
+    dm->WritePage(page_id, data);
+  }
+  EXPECT_EQ((pages_per_chunk + 2) * BUSTUB_PAGE_SIZE, dm->GetDbFileSize());
+  EXPECT_EQ(2 * DiskManagerMmap::GROW_CHUNK_SIZE, dm->GetMappedSize());
+  for (const page_id_t page_id : {0, 5, pages_per_chunk + 1, 2}) {
+    dm->ReadPage(page_id, buf);
+    FillPage(page_id, data);
+    EXPECT_EQ(0, std::memcmp(buf, data, sizeof(buf))) << page_id;
+  }
+  dm->ReadPage(3, buf);
+  EXPECT_EQ(0, std::memcmp(buf, zeros, sizeof(buf)));
+
+  // Scenario: a run spanning the end of the file is zero-filled past it, and a page past the reservation is refused.
+  std::vector<char> run(3 * BUSTUB_PAGE_SIZE, 'x');
+  dm->ReadPages(pages_per_chunk, 3, run.data());
+  FillPage(pages_per_chunk + 1, data);
+  EXPECT_EQ(0, std::memcmp(run.data() + BUSTUB_PAGE_SIZE, data, BUSTUB_PAGE_SIZE));
+  EXPECT_EQ(0, std::memcmp(run.data() + 2 * BUSTUB_PAGE_SIZE, zeros, BUSTUB_PAGE_SIZE));
+  dm->WritePage(4 * pages_per_chunk, data);
+  EXPECT_EQ((pages_per_chunk + 2) * BUSTUB_PAGE_SIZE, dm->GetDbFileSize());
+
+  // Scenario: the writes become durable together, with one msync, and a sync with nothing to do is skipped.
+  EXPECT_EQ(0, dm->GetNumSyncs());
+  dm->Sync();
+  dm->Sync();
+  EXPECT_EQ(1, dm->GetNumSyncs());
+  EXPECT_EQ(4, dm->GetNumWrites());
+
+  // Scenario: the file is truncated to its pages on shutdown, and read back by DiskManager and a new mapping.
+  dm->ShutDown();
+  dm.reset();
+  EXPECT_EQ((pages_per_chunk + 2) * BUSTUB_PAGE_SIZE, FileSize("test.db"));
+  DiskManager reader("test.db");
+  reader.ReadPage(pages_per_chunk + 1, buf);
+  EXPECT_EQ(0, std::memcmp(buf, data, sizeof(buf)));
+  reader.ShutDown();
+  DiskManagerMmap reopened("test.db");
+  EXPECT_EQ((pages_per_chunk + 2) * BUSTUB_PAGE_SIZE, reopened.GetDbFileSize());
+  reopened.ReadPage(5, buf);
+  FillPage(5, data);
+  EXPECT_EQ(0, std::memcmp(buf, data, sizeof(buf)));
+  EXPECT_EQ(nullptr, reopened.GetPageView(5));
+  reopened.ShutDown();
+}
+
+// NOLINTNEXTLINE
+TEST_F(DiskManagerMmapTest, ZeroCopyTest) {
+  const page_id_t num_pages = 64;
+  DiskManagerMmap dm("test.db", true);
+  auto bpm = std::make_unique<BufferPoolManagerInstance>(8, &dm, 2);
+  page_id_t page_id;
+  for (int i = 0; i < num_pages; i++) {
+    Page *page = bpm->NewPage(&page_id);
+    ASSERT_NE(nullptr, page);
+    FillPage(page_id, page->GetData());
+    bpm->UnpinPage(page_id, true);
+  }
+  bpm->FlushAllPages();
+  EXPECT_EQ(nullptr, dm.GetPageView(num_pages));
+
+  // Scenario: a frame holding a page fetched read-only points into the mapping, and sees the writes made to the file.
+  char data[BUSTUB_PAGE_SIZE];
+  Page *page = bpm->FetchPageReadOnly(3);
+  ASSERT_NE(nullptr, page);
+  EXPECT_EQ(dm.GetPageView(3), page->GetData());
+  FillPage(3, data);
+  EXPECT_EQ(0, std::memcmp(data, page->GetData(), BUSTUB_PAGE_SIZE));
+  data[0] = 'P';
+  dm.WritePage(3, data);
+  EXPECT_EQ('P', page->GetData()[0]);
+  bpm->UnpinPage(3, false);
+
+  // Scenario: lent pages come and go through eviction, and new pages get frame memory of their own.
+  char expected[BUSTUB_PAGE_SIZE];
+  for (page_id_t id = num_pages / 2; id >= 0; id--) {
+    page = bpm->FetchPageReadOnly(id);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ(dm.GetPageView(id), page->GetData());
+    FillPage(id, expected);
+    if (id == 3) {
+      expected[0] = 'P';
+    }
+    EXPECT_EQ(0, std::memcmp(expected, page->GetData(), BUSTUB_PAGE_SIZE)) << id;
+    bpm->UnpinPage(id, false);
+  }
+  for (int i = 0; i < 8; i++) {
+    page = bpm->NewPage(&page_id);
+    ASSERT_NE(nullptr, page);
+    EXPECT_NE(dm.GetPageView(page_id), page->GetData());
+    std::snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "new page %d", page_id);
+    bpm->UnpinPage(page_id, true);
+  }
+
+  // Scenario: a page fetched for writing gets a copy of its own, whether it is missed or resident and lent.
+  page = bpm->FetchPage(5);
+  ASSERT_NE(nullptr, page);
+  EXPECT_NE(dm.GetPageView(5), page->GetData());
+  std::snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "written page 5");
+  bpm->UnpinPage(5, true);
+  page = bpm->FetchPageReadOnly(6);
+  ASSERT_NE(nullptr, page);
+  EXPECT_EQ(dm.GetPageView(6), page->GetData());
+  Page *writable = bpm->FetchPage(6);
+  ASSERT_EQ(page, writable);
+  EXPECT_NE(dm.GetPageView(6), writable->GetData());
+  FillPage(6, expected);
+  EXPECT_EQ(0, std::memcmp(expected, writable->GetData(), BUSTUB_PAGE_SIZE));
+  writable->WLatch();
+  std::snprintf(writable->GetData(), BUSTUB_PAGE_SIZE, "written page 6");
+  writable->WUnlatch();
+  bpm->UnpinPage(6, true);
+  bpm->UnpinPage(6, false);
+  bpm->FlushAllPages();
+  EXPECT_EQ("written page 5", std::string(dm.GetPageView(5)));
+  EXPECT_EQ("written page 6", std::string(dm.GetPageView(6)));
+
+  bpm.reset();
+  dm.ReadPage(page_id, data);
+  EXPECT_EQ("new page " + std::to_string(page_id), std::string(data));
+  dm.ShutDown();
+}
+
+}  // namespace bustub
@@ -0,0 +1,157 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// disk_manager_posix_test.cpp
+//
+// Identification: test/storage/disk_manager_posix_test.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/disk/disk_manager_posix.h"
+
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+namespace {
+
+void FillPage(page_id_t page_id, char *data) {
+  std::memset(data, 0, BUSTUB_PAGE_SIZE);
+  snprintf(data, BUSTUB_PAGE_SIZE, "page %d", page_id);
+  data[BUSTUB_PAGE_SIZE - 1] = static_cast<char>(page_id);
+}
+
+}  // namespace
+
+class DiskManagerPosixTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    remove("test.db");
+    remove("test.log");
+  }
+
+  void TearDown() override {
+    remove("test.db");
+    remove("test.log");
+  };
+};
+
+// NOLINTNEXTLINE
+TEST_F(DiskManagerPosixTest, ReadWritePageTest) {
+  char buf[BUSTUB_PAGE_SIZE] = {0};
+  char data[BUSTUB_PAGE_SIZE] = {0};
+  char zeros[BUSTUB_PAGE_SIZE] = {0};
+  DiskManagerPosix dm("test.db");
+  std::strncpy(data, "A test string.", sizeof(data));
+
+  // Scenario: an empty file reads as zeros, and grows with the pages written.
+  std::memset(buf, 'x', sizeof(buf));
+  dm.ReadPage(0, buf);
+  EXPECT_EQ(0, std::memcmp(buf, zeros, sizeof(buf)));
+  dm.WritePage(0, data);
+  dm.WritePage(5, data);
+  EXPECT_EQ(6 * BUSTUB_PAGE_SIZE, dm.GetDbFileSize());
+  dm.WritePage(2, data);
+  EXPECT_EQ(6 * BUSTUB_PAGE_SIZE, dm.GetDbFileSize());
+  dm.ReadPage(5, buf);
+  EXPECT_EQ(0, std::memcmp(buf, data, sizeof(buf)));
+  dm.ReadPage(3, buf);
+  EXPECT_EQ(0, std::memcmp(buf, zeros, sizeof(buf)));
+
+  // Scenario: a run spanning the end of the file is zero-filled past it.
+  std::vector<char> run(4 * BUSTUB_PAGE_SIZE, 'x');
+  dm.ReadPages(4, 4, run.data());
+  EXPECT_EQ(0, std::memcmp(run.data() + BUSTUB_PAGE_SIZE, data, BUSTUB_PAGE_SIZE));
+  for (size_t page = 2; page < 4; page++) {
+    EXPECT_EQ(0, std::memcmp(run.data() + page * BUSTUB_PAGE_SIZE, zeros, BUSTUB_PAGE_SIZE));
+  }
+
+  // Scenario: the writes become durable together, with one sync, and a sync with nothing to do is skipped.
+  EXPECT_EQ(0, dm.GetNumSyncs());
+  dm.Sync();
+  dm.Sync();
+  EXPECT_EQ(1, dm.GetNumSyncs());
+  EXPECT_EQ(3, dm.GetNumWrites());
+
+  // Scenario: a batch grows the file to its last page, and becomes durable with a single sync of its own.
+  char other[BUSTUB_PAGE_SIZE] = {0};
+  std::strncpy(other, "Another string.", sizeof(other));
+  dm.WritePages({{9, other}, {3, other}, {8, data}, {7, other}});
+  EXPECT_EQ(2, dm.GetNumSyncs());
+  EXPECT_EQ(7, dm.GetNumWrites());
+  EXPECT_EQ(10 * BUSTUB_PAGE_SIZE, dm.GetDbFileSize());
+  dm.ReadPages(7, 3, run.data());
+  EXPECT_EQ(0, std::memcmp(run.data(), other, BUSTUB_PAGE_SIZE));
+  EXPECT_EQ(0, std::memcmp(run.data() + BUSTUB_PAGE_SIZE, data, BUSTUB_PAGE_SIZE));
+  EXPECT_EQ(0, std::memcmp(run.data() + 2 * BUSTUB_PAGE_SIZE, other, BUSTUB_PAGE_SIZE));
+  dm.ShutDown();
+
+  // Scenario: the file format is the one of DiskManager, and its size is picked up when reopened.
+  DiskManager reader("test.db");
+  reader.ReadPage(5, buf);
+  EXPECT_EQ(0, std::memcmp(buf, data, sizeof(buf)));
+  reader.ShutDown();
+  DiskManagerPosix reopened("test.db");
+  EXPECT_EQ(10 * BUSTUB_PAGE_SIZE, reopened.GetDbFileSize());
+  reopened.ReadPage(2, buf);
+  EXPECT_EQ(0, std::memcmp(buf, data, sizeof(buf)));
+  reopened.ShutDown();
+}
+
+// NOLINTNEXTLINE
+TEST_F(DiskManagerPosixTest, ConcurrentTest) {
+  const int num_threads = 4;
+  const page_id_t pages_per_thread = 64;
+  auto dm = std::make_unique<DiskManagerPosix>("test.db");
+
+  // Scenario: threads write and read back interleaved pages at the same time.
+  std::atomic<int> mismatches{0};
+  std::vector<std::thread> threads;
+  for (int t = 0; t < num_threads; t++) {
+    threads.emplace_back([&, t] {
+      char data[BUSTUB_PAGE_SIZE];
+      char buf[BUSTUB_PAGE_SIZE];
+      for (page_id_t i = 0; i < pages_per_thread; i++) {
+        const page_id_t page_id = i * num_threads + t;
+        FillPage(page_id, data);
+        dm->WritePage(page_id, data);
+        dm->ReadPage(page_id, buf);
+        if (std::memcmp(buf, data, BUSTUB_PAGE_SIZE) != 0) {
+          mismatches++;
+        }
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(0, mismatches);
+  EXPECT_EQ(num_threads * pages_per_thread * BUSTUB_PAGE_SIZE, dm->GetDbFileSize());
+
+  // Scenario: the buffer pool works on it unchanged.
+  auto bpm = std::make_unique<BufferPoolManagerInstance>(8, dm.get(), 2);
+  char expected[BUSTUB_PAGE_SIZE];
+  for (page_id_t page_id = 0; page_id < num_threads * pages_per_thread; page_id += 7) {
+    Page *page = bpm->FetchPage(page_id);
+    ASSERT_NE(nullptr, page);
+    FillPage(page_id, expected);
+    EXPECT_EQ(0, std::memcmp(expected, page->GetData(), BUSTUB_PAGE_SIZE)) << page_id;
+    bpm->UnpinPage(page_id, false);
+  }
+  bpm.reset();
+  dm->ShutDown();
+}
+
+}  // namespace bustub
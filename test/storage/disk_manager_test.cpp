@@ -11,10 +11,17 @@
 //===----------------------------------------------------------------------===//
 
 #include <cstring>
+#include <new>
+#include <utility>
+#include <vector>
 
+#include "buffer/buffer_pool_manager_instance.h"
 #include "common/exception.h"
 #include "gtest/gtest.h"
 #include "storage/disk/disk_manager.h"
+#include "storage/disk/disk_manager_mmap.h"
+#include "storage/disk/disk_manager_posix.h"
+#include "storage/page/header_page.h"
 
 namespace bustub {
 
@@ -55,6 +62,110 @@ TEST_F(DiskManagerTest, ReadWritePageTest) {
   dm.ShutDown();
 }
 
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, DirectIoTest) {
+  // one aligned page buffer, and one that is deliberately off by a byte
+  alignas(DiskManager::DIRECT_IO_ALIGNMENT) char aligned[BUSTUB_PAGE_SIZE] = {0};
+  char unaligned_storage[BUSTUB_PAGE_SIZE + 1] = {0};
+  char *unaligned = unaligned_storage + 1;
+  char data[BUSTUB_PAGE_SIZE] = {0};
+  std::string db_file("test.db");
+  auto dm = DiskManager(db_file, true);
+  std::strncpy(data, "A test string.", sizeof(data));
+
+  dm.WritePage(0, data);
+  dm.ReadPage(0, aligned);
+  EXPECT_EQ(std::memcmp(aligned, data, sizeof(data)), 0);
+  dm.ReadPage(0, unaligned);
+  EXPECT_EQ(std::memcmp(unaligned, data, sizeof(data)), 0);
+
+  std::memcpy(unaligned, data, sizeof(data));
+  dm.WritePage(3, unaligned);
+  std::memset(aligned, 0, sizeof(aligned));
+  dm.ReadPage(3, aligned);
+  EXPECT_EQ(std::memcmp(aligned, data, sizeof(data)), 0);
+
+  // reading past the end of the file yields a zeroed page
+  dm.ReadPage(10, aligned);
+  for (char c : aligned) {
+    EXPECT_EQ(0, c);
+  }
+
+  dm.ShutDown();
+}
+
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, WritePagesTest) {
+  const std::vector<page_id_t> page_ids{7, 3, 4, 5, 0, 9};
+  // aligned page buffers, one byte more so that the odd ones can be deliberately misaligned
+  auto *buffers = static_cast<char *>(::operator new[]((page_ids.size() + 1) * BUSTUB_PAGE_SIZE,
+                                                       std::align_val_t{DiskManager::DIRECT_IO_ALIGNMENT}));
+  char buf[BUSTUB_PAGE_SIZE];
+  for (const bool direct_io : {false, true}) {
+    remove("test.db");
+    DiskManager dm("test.db", direct_io);
+    std::memset(buf, 'x', sizeof(buf));
+    dm.WritePage(4, buf);
+    // Scenario: the pages are sorted and coalesced into runs, whatever the order and alignment of their buffers.
+    dm.ReadPage(4, buf);
+    std::vector<std::pair<page_id_t, const char *>> pages;
+    for (size_t i = 0; i < page_ids.size(); i++) {
+      char *data = buffers + i * BUSTUB_PAGE_SIZE + i % 2;
+      std::memset(data, 0, BUSTUB_PAGE_SIZE);
+      snprintf(data, BUSTUB_PAGE_SIZE, "page %d", page_ids[i]);
+      pages.emplace_back(page_ids[i], data);
+    }
+    dm.WritePages(pages);
+    EXPECT_EQ(1 + static_cast<int>(page_ids.size()), dm.GetNumWrites());
+    for (const auto &[page_id, data] : pages) {
+      dm.ReadPage(page_id, buf);
+      EXPECT_EQ(0, std::memcmp(buf, data, BUSTUB_PAGE_SIZE)) << page_id << (direct_io ? " O_DIRECT" : "");
+    }
+    dm.ReadPage(8, buf);
+    EXPECT_EQ(0, buf[0]);
+    dm.WritePages({});
+    EXPECT_EQ(1 + static_cast<int>(page_ids.size()), dm.GetNumWrites());
+    dm.ShutDown();
+  }
+  ::operator delete[](buffers, std::align_val_t{DiskManager::DIRECT_IO_ALIGNMENT});
+}
+
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, PageSizeTest) {
+  // Scenario: the header page records the page size with its first record, and the file opens again.
+  {
+    DiskManager dm("test.db");
+    BufferPoolManagerInstance bpm(4, &dm, 2);
+    page_id_t page_id;
+    auto *header_page = static_cast<HeaderPage *>(bpm.NewPage(&page_id));
+    ASSERT_EQ(HEADER_PAGE_ID, page_id);
+    EXPECT_EQ(0, header_page->GetPageSize());
+    EXPECT_TRUE(header_page->InsertRecord("index", 1));
+    EXPECT_EQ(BUSTUB_PAGE_SIZE, header_page->GetPageSize());
+    page_id_t root_id;
+    EXPECT_TRUE(header_page->GetRootId("index", &root_id));
+    EXPECT_EQ(1, root_id);
+    bpm.UnpinPage(HEADER_PAGE_ID, true);
+    bpm.FlushAllPages();
+    dm.ShutDown();
+  }
+  EXPECT_NO_THROW(DiskManager("test.db").ShutDown());
+
+  // Scenario: a file created with another page size is refused by every disk manager.
+  char data[BUSTUB_PAGE_SIZE];
+  {
+    DiskManager dm("test.db");
+    dm.ReadPage(HEADER_PAGE_ID, data);
+    const int other_page_size = BUSTUB_PAGE_SIZE == 4096 ? 8192 : 4096;
+    std::memcpy(data + 8, &other_page_size, sizeof(other_page_size));
+    dm.WritePage(HEADER_PAGE_ID, data);
+    dm.ShutDown();
+  }
+  EXPECT_THROW(DiskManager("test.db"), Exception);
+  EXPECT_THROW(DiskManagerPosix("test.db"), Exception);
+  EXPECT_THROW(DiskManagerMmap("test.db"), Exception);
+}
+
 // NOLINTNEXTLINE
 TEST_F(DiskManagerTest, ReadWriteLogTest) {
   char buf[16] = {0};
@@ -0,0 +1,189 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// disk_scheduler_test.cpp
+//
+// Identification: test/storage/disk_scheduler_test.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/disk/disk_scheduler.h"
+
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <future>  // NOLINT
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
+#include "storage/disk/disk_manager_posix.h"
+
+namespace bustub {
+
+namespace {
+
+void FillPage(page_id_t page_id, char *data) {
+  std::memset(data, 0, BUSTUB_PAGE_SIZE);
+  snprintf(data, BUSTUB_PAGE_SIZE, "page %d", page_id);
+  data[BUSTUB_PAGE_SIZE - 1] = static_cast<char>(page_id);
+}
+
+/** Write pages through the scheduler, then read them back through it and through the disk manager. */
+void ReadWrite(DiskManager *disk_manager, DiskScheduler *scheduler) {
+  const page_id_t num_pages = 64;
+  std::vector<std::vector<char>> pages(num_pages, std::vector<char>(BUSTUB_PAGE_SIZE));
+  std::vector<std::future<bool>> writes;
+  for (page_id_t page_id = 0; page_id < num_pages; page_id++) {
+    FillPage(page_id, pages[page_id].data());
+    writes.push_back(scheduler->ScheduleWrite(page_id, pages[page_id].data()));
+  }
+  for (auto &write : writes) {
+    EXPECT_TRUE(write.get());
+  }
+
+  // Scenario: every read is in flight at once, into unaligned buffers, and sees the data written.
+  std::vector<std::vector<char>> out(num_pages, std::vector<char>(BUSTUB_PAGE_SIZE + 1));
+  std::vector<std::future<bool>> reads;
+  for (page_id_t page_id = num_pages - 1; page_id >= 0; page_id--) {
+    reads.push_back(scheduler->ScheduleRead(page_id, out[page_id].data() + 1));
+  }
+  for (auto &read : reads) {
+    EXPECT_TRUE(read.get());
+  }
+  std::vector<char> direct(BUSTUB_PAGE_SIZE);
+  for (page_id_t page_id = 0; page_id < num_pages; page_id++) {
+    EXPECT_EQ(0, std::memcmp(pages[page_id].data(), out[page_id].data() + 1, BUSTUB_PAGE_SIZE)) << page_id;
+    disk_manager->ReadPage(page_id, direct.data());
+    EXPECT_EQ(0, std::memcmp(pages[page_id].data(), direct.data(), BUSTUB_PAGE_SIZE)) << page_id;
+  }
+
+  // Scenario: a page past the end of the file reads as zeros, and callbacks run once per request.
+  std::vector<char> zeros(BUSTUB_PAGE_SIZE, 0);
+  std::promise<bool> done;
+  scheduler->ScheduleRead(num_pages + 10, out[0].data(), [&](bool success) { done.set_value(success); });
+  EXPECT_TRUE(done.get_future().get());
+  EXPECT_EQ(0, std::memcmp(zeros.data(), out[0].data(), BUSTUB_PAGE_SIZE));
+}
+
+}  // namespace
+
+class DiskSchedulerTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    remove("test.db");
+    remove("test.log");
+  }
+
+  void TearDown() override {
+    remove("test.db");
+    remove("test.log");
+  };
+};
+
+// NOLINTNEXTLINE
+TEST_F(DiskSchedulerTest, ReadWriteTest) {
+  for (const bool direct_io : {false, true}) {
+    for (const auto backend : {DiskScheduler::Backend::IO_URING, DiskScheduler::Backend::THREAD_POOL}) {
+      remove("test.db");
+      DiskManager disk_manager("test.db", direct_io);
+      DiskScheduler scheduler(&disk_manager, 8, backend);
+      if (backend == DiskScheduler::Backend::THREAD_POOL) {
+        EXPECT_EQ(DiskScheduler::Backend::THREAD_POOL, scheduler.GetBackend());
+      }
+      ReadWrite(&disk_manager, &scheduler);
+
+      // Scenario: a read the file rejects, at a negative offset, completes with a failure rather than never.
+      std::vector<char> out(BUSTUB_PAGE_SIZE);
+      EXPECT_FALSE(scheduler.ScheduleRead(-2, out.data()).get());
+      disk_manager.ShutDown();
+    }
+  }
+}
+
+// NOLINTNEXTLINE
+TEST_F(DiskSchedulerTest, DiskManagerMemoryTest) {
+  // Scenario: pages that are not stored in a file go through the disk manager, on the thread pool.
+  DiskManagerMemory disk_manager(128);
+  DiskScheduler scheduler(&disk_manager, 4);
+  EXPECT_EQ(DiskScheduler::Backend::THREAD_POOL, scheduler.GetBackend());
+  ReadWrite(&disk_manager, &scheduler);
+
+  // Scenario: so do the pages of a disk manager that tracks the size of its file.
+  DiskManagerPosix posix("test.db");
+  DiskScheduler posix_scheduler(&posix, 4);
+  EXPECT_EQ(DiskScheduler::Backend::THREAD_POOL, posix_scheduler.GetBackend());
+  ReadWrite(&posix, &posix_scheduler);
+  posix.ShutDown();
+}
+
+// NOLINTNEXTLINE
+TEST_F(DiskSchedulerTest, BufferPoolTest) {
+  const page_id_t num_pages = 256;
+  DiskManager disk_manager("test.db");
+  DiskScheduler scheduler(&disk_manager);
+  auto bpm = std::make_unique<BufferPoolManagerInstance>(32, &disk_manager, 2);
+  bpm->SetDiskScheduler(&scheduler);
+  page_id_t page_id;
+  for (page_id_t i = 0; i < num_pages; i++) {
+    Page *page = bpm->NewPage(&page_id);
+    ASSERT_NE(nullptr, page);
+    FillPage(page_id, page->GetData());
+    bpm->UnpinPage(page_id, true);
+  }
+
+  // Scenario: concurrent misses, whose victims are dirty at first, read the pages back through the scheduler.
+  std::atomic<int> mismatches{0};
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; t++) {
+    threads.emplace_back([&, t] {
+      std::mt19937 gen(t);
+      std::vector<char> expected(BUSTUB_PAGE_SIZE);
+      for (int i = 0; i < 500; i++) {
+        const auto id = static_cast<page_id_t>(gen() % num_pages);
+        Page *page = bpm->FetchPage(id);
+        if (page == nullptr) {
+          continue;
+        }
+        FillPage(id, expected.data());
+        if (std::memcmp(expected.data(), page->GetData(), BUSTUB_PAGE_SIZE) != 0) {
+          mismatches++;
+        }
+        bpm->UnpinPage(id, false);
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(0, mismatches);
+
+  // Scenario: the read-ahead reads its pages in batches, and they come back intact.
+  bpm->PrefetchPages(0, 16);
+  for (int i = 0; i < 100 && bpm->GetPrefetchCount() == 0; i++) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  EXPECT_GT(bpm->GetPrefetchCount(), 0U);
+  std::vector<char> expected(BUSTUB_PAGE_SIZE);
+  for (page_id_t id = 0; id < 16; id++) {
+    Page *page = bpm->FetchPage(id);
+    ASSERT_NE(nullptr, page);
+    FillPage(id, expected.data());
+    EXPECT_EQ(0, std::memcmp(expected.data(), page->GetData(), BUSTUB_PAGE_SIZE)) << id;
+    bpm->UnpinPage(id, false);
+  }
+
+  bpm->SetDiskScheduler(nullptr);
+  bpm.reset();
+  disk_manager.ShutDown();
+}
+
+}  // namespace bustub
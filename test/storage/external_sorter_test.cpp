@@ -0,0 +1,74 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// external_sorter_test.cpp
+//
+// Identification: test/storage/external_sorter_test.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/index/external_sorter.h"
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+namespace {
+
+struct Entry {
+  int32_t key_;
+  int32_t seq_;
+};
+
+auto EntryLess(const Entry &a, const Entry &b) -> bool { return a.key_ < b.key_; }
+
+}  // namespace
+
+// NOLINTNEXTLINE
+TEST(ExternalSorterTest, SortTest) {
+  for (const size_t memory_limit : {size_t{1} << 20, size_t{1000}, size_t{64}}) {
+    // Scenario: entries sort in memory under a large limit, and merge from spilled runs under a small one, stably.
+    ExternalSorter<Entry, decltype(&EntryLess)> sorter(&EntryLess, memory_limit);
+    std::mt19937 gen(1);
+    const int num_entries = 5000;
+    for (int i = 0; i < num_entries; i++) {
+      sorter.Add(Entry{static_cast<int32_t>(gen() % 500), i});
+    }
+    sorter.Finish();
+    if (memory_limit >= num_entries * sizeof(Entry)) {
+      EXPECT_EQ(0, sorter.GetNumRuns());
+    } else {
+      EXPECT_EQ((num_entries + memory_limit / sizeof(Entry) - 1) / (memory_limit / sizeof(Entry)),
+                sorter.GetNumRuns());
+    }
+
+    Entry entry;
+    Entry prev{-1, -1};
+    int count = 0;
+    while (sorter.Next(&entry)) {
+      EXPECT_LE(prev.key_, entry.key_);
+      if (prev.key_ == entry.key_) {
+        EXPECT_LT(prev.seq_, entry.seq_);
+      }
+      prev = entry;
+      count++;
+    }
+    EXPECT_EQ(num_entries, count);
+    EXPECT_FALSE(sorter.Next(&entry));
+  }
+
+  // Scenario: nothing to sort.
+  ExternalSorter<Entry, decltype(&EntryLess)> empty(&EntryLess, 8);
+  empty.Finish();
+  Entry entry;
+  EXPECT_FALSE(empty.Next(&entry));
+}
+
+}  // namespace bustub
@@ -65,7 +65,7 @@ TEST(BPlusTreeConcurrentTestC1, SplitTest) {
   for (int i = 0; i < 4; i++) {
     EXPECT_NE(INVALID_PAGE_ID, leaf_node->GetNextPageId());
     leaf_node = reinterpret_cast<BPlusTreeLeafPage<GenericKey<8>, RID, GenericComparator<8>> *>(
-        bpm->FetchPage(leaf_node->GetNextPageId()));
+        bpm->FetchPage(leaf_node->GetNextPageId())->GetData());
   }
 
   EXPECT_EQ(INVALID_PAGE_ID, leaf_node->GetNextPageId());
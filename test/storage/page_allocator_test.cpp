@@ -0,0 +1,200 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// page_allocator_test.cpp
+//
+// Identification: test/storage/page_allocator_test.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/disk/page_allocator.h"
+
+#include <cstdio>
+#include <memory>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "buffer/parallel_buffer_pool_manager.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager.h"
+
+namespace bustub {
+
+class PageAllocatorTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    remove("test.db");
+    remove("test.log");
+  }
+
+  void TearDown() override {
+    remove("test.db");
+    remove("test.log");
+  };
+};
+
+// NOLINTNEXTLINE
+TEST_F(PageAllocatorTest, ReuseTest) {
+  DiskManager disk_manager("test.db");
+  PageAllocator allocator(&disk_manager);
+
+  // Scenario: page ids are allocated in order, skipping the bitmap page that follows the header page.
+  EXPECT_EQ(HEADER_PAGE_ID, allocator.AllocatePage());
+  for (page_id_t page_id = 2; page_id < 10; page_id++) {
+    EXPECT_EQ(page_id, allocator.AllocatePage());
+  }
+  EXPECT_TRUE(allocator.IsAllocated(1));
+  EXPECT_FALSE(allocator.IsAllocated(10));
+
+  // Scenario: freed pages are reused, lowest page id first.
+  allocator.DeallocatePage(7);
+  allocator.DeallocatePage(3);
+  EXPECT_FALSE(allocator.IsAllocated(3));
+  EXPECT_EQ(3, allocator.AllocatePage());
+  EXPECT_EQ(7, allocator.AllocatePage());
+  EXPECT_EQ(10, allocator.AllocatePage());
+
+  // Scenario: ids that are never allocated cannot be freed.
+  allocator.DeallocatePage(INVALID_PAGE_ID);
+  allocator.DeallocatePage(1);
+  EXPECT_TRUE(allocator.IsAllocated(1));
+
+  // Scenario: the instances of a parallel buffer pool only get the page ids they own.
+  allocator.DeallocatePage(4);
+  allocator.DeallocatePage(5);
+  EXPECT_EQ(5, allocator.AllocatePage(2, 1));
+  EXPECT_EQ(11, allocator.AllocatePage(2, 1));
+  EXPECT_EQ(4, allocator.AllocatePage(2, 0));
+  EXPECT_EQ(12, allocator.AllocatePage(2, 0));
+  allocator.DeallocatePage(5);
+  EXPECT_EQ(5, allocator.AllocatePage(2, 1));
+  EXPECT_EQ(13, allocator.AllocatePage(2, 1));
+
+  disk_manager.ShutDown();
+}
+
+// NOLINTNEXTLINE
+TEST_F(PageAllocatorTest, RegionTest) {
+  DiskManager disk_manager("test.db");
+  PageAllocator allocator(&disk_manager);
+
+  // Scenario: once a region is full, allocation moves on to the next one and skips its bitmap page.
+  const page_id_t next_bitmap_page = PageAllocator::BITS_PER_BITMAP + 1;
+  page_id_t page_id = INVALID_PAGE_ID;
+  while (page_id < PageAllocator::BITS_PER_BITMAP) {
+    page_id = allocator.AllocatePage();
+    EXPECT_FALSE(PageAllocator::IsBitmapPage(page_id));
+  }
+  EXPECT_EQ(PageAllocator::BITS_PER_BITMAP, page_id);
+  EXPECT_TRUE(PageAllocator::IsBitmapPage(next_bitmap_page));
+  EXPECT_EQ(next_bitmap_page + 1, allocator.AllocatePage());
+  EXPECT_TRUE(allocator.IsAllocated(next_bitmap_page));
+
+  disk_manager.ShutDown();
+}
+
+// NOLINTNEXTLINE
+TEST_F(PageAllocatorTest, PersistenceTest) {
+  {
+    DiskManager disk_manager("test.db");
+    auto allocator = std::make_unique<PageAllocator>(&disk_manager);
+    auto bpm = std::make_unique<BufferPoolManagerInstance>(10, &disk_manager, LRUK_REPLACER_K, nullptr,
+                                                           allocator.get());
+    page_id_t page_id;
+    for (int i = 0; i < 20; i++) {
+      ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+      bpm->UnpinPage(page_id, true);
+    }
+    EXPECT_EQ(20, page_id);
+
+    // Scenario: deleting a page through the buffer pool frees it on disk.
+    EXPECT_TRUE(bpm->DeletePage(5));
+    EXPECT_TRUE(bpm->DeletePage(15));
+    EXPECT_FALSE(allocator->IsAllocated(15));
+    bpm->FlushAllPages();
+    bpm.reset();
+    allocator.reset();
+    disk_manager.ShutDown();
+  }
+
+  // Scenario: after a restart, the allocator reuses the freed pages and then continues after the last page.
+  DiskManager disk_manager("test.db");
+  PageAllocator allocator(&disk_manager);
+  BufferPoolManagerInstance bpm(10, &disk_manager, LRUK_REPLACER_K, nullptr, &allocator);
+  page_id_t page_id;
+  for (page_id_t expected : {5, 15, 21}) {
+    ASSERT_NE(nullptr, bpm.NewPage(&page_id));
+    EXPECT_EQ(expected, page_id);
+    bpm.UnpinPage(page_id, false);
+  }
+  disk_manager.ShutDown();
+}
+
+// NOLINTNEXTLINE
+TEST_F(PageAllocatorTest, ExtentTest) {
+  DiskManager disk_manager("test.db");
+  PageAllocator allocator(&disk_manager);
+  BufferPoolManagerInstance bpm(10, &disk_manager, LRUK_REPLACER_K, nullptr, &allocator);
+  page_id_t page_id;
+  ASSERT_NE(nullptr, bpm.NewPage(&page_id));
+  EXPECT_EQ(HEADER_PAGE_ID, page_id);
+  bpm.UnpinPage(page_id, true);
+
+  // Scenario: two segments growing in turns each fill an extent of their own, and move on to a new one when it is
+  // used up. The first extent holds the header page, so it is left to single pages.
+  PageSegment table;
+  PageSegment index;
+  for (page_id_t i = 0; i <= EXTENT_SIZE; i++) {
+    ASSERT_NE(nullptr, bpm.NewPageInSegment(&page_id, &table));
+    EXPECT_EQ(i < EXTENT_SIZE ? EXTENT_SIZE + i : 3 * EXTENT_SIZE, page_id);
+    bpm.UnpinPage(page_id, true);
+    ASSERT_NE(nullptr, bpm.NewPageInSegment(&page_id, &index));
+    EXPECT_EQ(i < EXTENT_SIZE ? 2 * EXTENT_SIZE + i : 4 * EXTENT_SIZE, page_id);
+    bpm.UnpinPage(page_id, true);
+  }
+  ASSERT_NE(nullptr, bpm.NewPage(&page_id));
+  EXPECT_EQ(2, page_id);
+  bpm.UnpinPage(page_id, true);
+
+  // Scenario: the whole extent is allocated at once, and only a fully free extent is handed out again.
+  EXPECT_TRUE(allocator.IsAllocated(4 * EXTENT_SIZE + EXTENT_SIZE - 1));
+  for (page_id_t id = EXTENT_SIZE; id < 2 * EXTENT_SIZE; id++) {
+    allocator.DeallocatePage(id);
+  }
+  allocator.DeallocatePage(2 * EXTENT_SIZE + 1);
+  EXPECT_EQ(EXTENT_SIZE, allocator.AllocateExtent());
+  EXPECT_EQ(5 * EXTENT_SIZE, allocator.AllocateExtent());
+  EXPECT_FALSE(allocator.IsAllocated(2 * EXTENT_SIZE + 1));
+
+  disk_manager.ShutDown();
+}
+
+// NOLINTNEXTLINE
+TEST_F(PageAllocatorTest, ParallelExtentTest) {
+  DiskManager disk_manager("test.db");
+  PageAllocator allocator(&disk_manager);
+  ParallelBufferPoolManager bpm(2, 10, &disk_manager, LRUK_REPLACER_K, nullptr, &allocator);
+  page_id_t page_id;
+  ASSERT_NE(nullptr, bpm.NewPage(&page_id));
+  EXPECT_EQ(HEADER_PAGE_ID, page_id);
+  bpm.UnpinPage(page_id, true);
+
+  // Scenario: the extent of a segment is contiguous, and each of its pages is created by the instance it belongs to.
+  PageSegment segment;
+  for (page_id_t i = 0; i < EXTENT_SIZE; i++) {
+    ASSERT_NE(nullptr, bpm.NewPageInSegment(&page_id, &segment));
+    EXPECT_EQ(EXTENT_SIZE + i, page_id);
+    EXPECT_NE(nullptr, bpm.GetBufferPoolManager(page_id)->FetchPage(page_id));
+    bpm.UnpinPage(page_id, true);
+    bpm.UnpinPage(page_id, true);
+  }
+  ASSERT_NE(nullptr, bpm.NewPageInSegment(&page_id, &segment));
+  EXPECT_EQ(2 * EXTENT_SIZE, page_id);
+  bpm.UnpinPage(page_id, true);
+
+  disk_manager.ShutDown();
+}
+
+}  // namespace bustub
@@ -13,6 +13,7 @@
 #include <algorithm>
 #include <cstdio>
 #include <iostream>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -21,6 +22,8 @@
 #include "logging/common.h"
 #include "storage/table/table_heap.h"
 #include "storage/table/tuple.h"
+#include "storage/disk/disk_manager_memory.h"
+#include "type/value_factory.h"
 
 namespace bustub {
 // NOLINTNEXTLINE
@@ -71,4 +74,108 @@ TEST(TupleTest, DISABLED_TableHeapTest) {
   delete disk_manager;
 }
 
+// NOLINTNEXTLINE
+TEST(TupleTest, TableHeapReadAheadTest) {
+  Column col1{"a", TypeId::VARCHAR, 20};
+  Column col2{"b", TypeId::SMALLINT};
+  Column col3{"c", TypeId::BIGINT};
+  std::vector<Column> cols{col1, col2, col3};
+  Schema schema{cols};
+  Tuple tuple = ConstructTuple(&schema);
+  const int num_tuples = 2000;
+
+  auto *transaction = new Transaction(0);
+  auto *disk_manager = new DiskManagerMemory(256);
+  auto *lock_manager = new LockManager();
+  auto *log_manager = new LogManager(disk_manager);
+  auto *buffer_pool_manager = new BufferPoolManagerInstance(10, disk_manager);
+  auto *table = new TableHeap(buffer_pool_manager, lock_manager, log_manager, transaction);
+  for (int i = 0; i < num_tuples; ++i) {
+    RID rid;
+    ASSERT_TRUE(table->InsertTuple(tuple, &rid, transaction));
+  }
+
+  // Scenario: the table is larger than the buffer pool, so a sequential scan starts on cold pages and reads the
+  // following pages ahead.
+  for (size_t window : {size_t{0}, size_t{TABLE_READ_AHEAD_PAGES}}) {
+    table->SetReadAheadWindow(window);
+    const size_t num_prefetches = buffer_pool_manager->GetPrefetchCount();
+    int count = 0;
+    for (auto itr = table->Begin(transaction); itr != table->End(); ++itr) {
+      count++;
+    }
+    EXPECT_EQ(num_tuples, count);
+    if (window == 0) {
+      EXPECT_EQ(num_prefetches, buffer_pool_manager->GetPrefetchCount());
+    } else {
+      EXPECT_GT(buffer_pool_manager->GetPrefetchCount(), num_prefetches);
+    }
+  }
+
+  delete table;
+  delete buffer_pool_manager;
+  delete log_manager;
+  delete lock_manager;
+  delete disk_manager;
+  delete transaction;
+}
+
+// NOLINTNEXTLINE
+TEST(TupleTest, TableHeapExtentTest) {
+  Column col1{"a", TypeId::VARCHAR, 20};
+  Column col2{"b", TypeId::SMALLINT};
+  Column col3{"c", TypeId::BIGINT};
+  std::vector<Column> cols{col1, col2, col3};
+  Schema schema{cols};
+  Tuple tuple({ValueFactory::GetVarcharValue(std::string(20, 'x')), ValueFactory::GetSmallIntValue(1),
+               ValueFactory::GetBigIntValue(2)},
+              &schema);
+  // about 90 tuples to a page, a bit more than an extent of them
+  const int num_tuples = EXTENT_SIZE * BUSTUB_PAGE_SIZE / 40;
+
+  auto *transaction = new Transaction(0);
+  auto *disk_manager = new DiskManagerMemory(8 * EXTENT_SIZE);
+  auto *lock_manager = new LockManager();
+  auto *log_manager = new LogManager(disk_manager);
+  auto *buffer_pool_manager = new BufferPoolManagerInstance(10, disk_manager);
+  std::vector<std::unique_ptr<TableHeap>> tables;
+  for (int i = 0; i < 2; i++) {
+    tables.push_back(std::make_unique<TableHeap>(buffer_pool_manager, lock_manager, log_manager, transaction));
+  }
+  for (int i = 0; i < num_tuples; ++i) {
+    for (auto &table : tables) {
+      RID rid;
+      ASSERT_TRUE(table->InsertTuple(tuple, &rid, transaction));
+    }
+  }
+
+  // Scenario: two tables growing at the same time each chain runs of consecutive pages, one per extent.
+  for (auto &table : tables) {
+    size_t num_pages = 1;
+    size_t num_runs = 1;
+    page_id_t page_id = table->GetFirstPageId();
+    while (true) {
+      auto *page = static_cast<TablePage *>(buffer_pool_manager->FetchPage(page_id));
+      ASSERT_NE(nullptr, page);
+      const page_id_t next_page_id = page->GetNextPageId();
+      buffer_pool_manager->UnpinPage(page_id, false);
+      if (next_page_id == INVALID_PAGE_ID) {
+        break;
+      }
+      num_pages++;
+      num_runs += next_page_id == page_id + 1 ? 0 : 1;
+      page_id = next_page_id;
+    }
+    EXPECT_GT(num_pages, static_cast<size_t>(EXTENT_SIZE));
+    EXPECT_EQ((num_pages + EXTENT_SIZE - 1) / EXTENT_SIZE, num_runs);
+  }
+
+  tables.clear();
+  delete buffer_pool_manager;
+  delete log_manager;
+  delete lock_manager;
+  delete disk_manager;
+  delete transaction;
+}
+
 }  // namespace bustub
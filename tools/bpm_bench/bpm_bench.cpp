@@ -0,0 +1,116 @@
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "argparse/argparse.hpp"
+#include "buffer/buffer_pool_manager_instance.h"
+#include "buffer/parallel_buffer_pool_manager.h"
+#include "fmt/core.h"
+#include "storage/disk/disk_manager_memory.h"
+
+namespace {
+
+/**
+ * Runs `threads` workers that repeatedly fetch and unpin random pages out of `num_pages` pre-created pages for
+ * `duration_ms` milliseconds.
+ * @return the total number of fetch/unpin pairs completed per second
+ */
+auto RunHitBench(bustub::BufferPoolManager *bpm, const std::vector<bustub::page_id_t> &page_ids, size_t threads,
+                 uint64_t duration_ms) -> double {
+  std::vector<std::thread> workers;
+  std::vector<uint64_t> ops(threads, 0);
+  auto start = std::chrono::steady_clock::now();
+  for (size_t tid = 0; tid < threads; tid++) {
+    workers.emplace_back([&, tid] {
+      std::mt19937 gen(tid);
+      std::uniform_int_distribution<size_t> dis(0, page_ids.size() - 1);
+      auto deadline = start + std::chrono::milliseconds(duration_ms);
+      uint64_t local_ops = 0;
+      while (std::chrono::steady_clock::now() < deadline) {
+        for (int i = 0; i < 64; i++) {
+          auto page_id = page_ids[dis(gen)];
+          auto *page = bpm->FetchPage(page_id);
+          if (page == nullptr) {
+            continue;
+          }
+          bpm->UnpinPage(page_id, false);
+          local_ops++;
+        }
+      }
+      ops[tid] = local_ops;
+    });
+  }
+  for (auto &worker : workers) {
+    worker.join();
+  }
+  auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  uint64_t total = 0;
+  for (auto op : ops) {
+    total += op;
+  }
+  return static_cast<double>(total) / elapsed;
+}
+
+/** Creates `num_pages` pages and leaves them unpinned in the pool. */
+auto PreparePages(bustub::BufferPoolManager *bpm, size_t num_pages) -> std::vector<bustub::page_id_t> {
+  std::vector<bustub::page_id_t> page_ids(num_pages);
+  for (auto &page_id : page_ids) {
+    bpm->NewPage(&page_id);
+    bpm->UnpinPage(page_id, false);
+  }
+  return page_ids;
+}
+
+}  // namespace
+
+// NOLINTNEXTLINE
+auto main(int argc, char **argv) -> int {
+  argparse::ArgumentParser program("bustub-bpm-bench");
+  program.add_argument("--duration")
+      .help("run time of each configuration in ms")
+      .default_value<uint64_t>(1000)
+      .scan<'u', uint64_t>();
+  program.add_argument("--max-threads")
+      .help("largest number of worker threads")
+      .default_value<size_t>(32)
+      .scan<'u', size_t>();
+  program.add_argument("--instances")
+      .help("number of instances of the parallel BPM")
+      .default_value<size_t>(16)
+      .scan<'u', size_t>();
+  program.add_argument("--pool-size").help("total number of frames").default_value<size_t>(4096).scan<'u', size_t>();
+
+  try {
+    program.parse_args(argc, argv);
+  } catch (const std::runtime_error &err) {
+    std::cerr << err.what() << std::endl;
+    std::cerr << program;
+    return 1;
+  }
+
+  auto duration_ms = program.get<uint64_t>("--duration");
+  auto max_threads = program.get<size_t>("--max-threads");
+  auto num_instances = program.get<size_t>("--instances");
+  auto pool_size = program.get<size_t>("--pool-size");
+  // Every page fits in the pool, so the benchmark measures the hit path only.
+  auto num_pages = pool_size;
+
+  fmt::print("hit path: {} frames, {} instances, {} ms per run\n", pool_size, num_instances, duration_ms);
+  fmt::print("{:>8} {:>16} {:>16} {:>8}\n", "threads", "single (op/s)", "parallel (op/s)", "speedup");
+  for (size_t threads = 1; threads <= max_threads; threads *= 2) {
+    auto disk_manager = std::make_unique<bustub::DiskManagerMemory>(num_pages);
+    auto single = std::make_unique<bustub::BufferPoolManagerInstance>(pool_size, disk_manager.get());
+    auto single_ops = RunHitBench(single.get(), PreparePages(single.get(), num_pages), threads, duration_ms);
+
+    auto parallel = std::make_unique<bustub::ParallelBufferPoolManager>(num_instances, pool_size / num_instances,
+                                                                        disk_manager.get());
+    auto parallel_ops = RunHitBench(parallel.get(), PreparePages(parallel.get(), num_pages), threads, duration_ms);
+
+    fmt::print("{:>8} {:>16.0f} {:>16.0f} {:>7.2f}x\n", threads, single_ops, parallel_ops, parallel_ops / single_ops);
+  }
+  return 0;
+}
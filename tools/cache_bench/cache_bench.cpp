@@ -0,0 +1,160 @@
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "argparse/argparse.hpp"
+#include "buffer/access_trace.h"
+#include "buffer/buffer_pool_manager_instance.h"
+#include "buffer/compressed_page_cache.h"
+#include "fmt/core.h"
+#include "storage/disk/disk_manager_memory.h"
+
+namespace {
+
+/** Fill a page like a table page about half full: slotted records up front, free space after. */
+void FillPage(bustub::page_id_t page_id, std::mt19937 *gen, char *data) {
+  const int num_records = 20 + static_cast<int>((*gen)() % 20);
+  for (int i = 0; i < num_records; i++) {
+    snprintf(data + i * 50, 50, "%08d|customer#%09u|%7.2f|%s", page_id * 100 + i,
+             static_cast<unsigned>((*gen)() % 1000000),
+             static_cast<double>((*gen)() % 1000000) / 100, i % 3 == 0 ? "BUILDING" : "MACHINERY");
+  }
+}
+
+/** Zipf-distributed (skew 0.99) accesses to num_pages pages. */
+auto GenerateTrace(size_t length, size_t num_pages) -> std::vector<bustub::page_id_t> {
+  std::vector<double> cdf(num_pages);
+  double sum = 0;
+  for (size_t i = 0; i < num_pages; i++) {
+    sum += 1.0 / std::pow(static_cast<double>(i + 1), 0.99);
+    cdf[i] = sum;
+  }
+  std::mt19937 gen(42);
+  std::uniform_real_distribution<double> dis(0, sum);
+  // scatter the ranks over the pages, so that the hot pages are not all neighbors
+  std::vector<bustub::page_id_t> pages(num_pages);
+  for (size_t i = 0; i < num_pages; i++) {
+    pages[i] = static_cast<bustub::page_id_t>(i);
+  }
+  std::shuffle(pages.begin(), pages.end(), gen);
+  std::vector<bustub::page_id_t> trace;
+  trace.reserve(length);
+  while (trace.size() < length) {
+    trace.push_back(pages[std::lower_bound(cdf.begin(), cdf.end(), dis(gen)) - cdf.begin()]);
+  }
+  return trace;
+}
+
+struct RunResult {
+  double seconds_;
+  bustub::BufferPoolStatsSnapshot pool_;
+  bustub::CompressedPageCacheStats cache_;
+};
+
+/** Create the pages of the trace, then replay it against a buffer pool, with a compressed cache of cache_size bytes. */
+auto Run(const std::vector<bustub::page_id_t> &trace, size_t num_pages, size_t pool_size, size_t cache_size,
+         std::chrono::microseconds read_latency) -> RunResult {
+  bustub::DiskLatencyModel model;
+  model.read_latency_ = read_latency;
+  bustub::DiskManagerMemory disk_manager(num_pages, model);
+  auto bpm = std::make_unique<bustub::BufferPoolManagerInstance>(pool_size, &disk_manager, 2);
+  std::unique_ptr<bustub::CompressedPageCache> cache;
+  std::mt19937 gen(7);
+  bustub::page_id_t page_id;
+  for (size_t i = 0; i < num_pages; i++) {
+    auto *page = bpm->NewPage(&page_id);
+    FillPage(page_id, &gen, page->GetData());
+    bpm->UnpinPage(page_id, true);
+  }
+  bpm->FlushAllPages();
+  // start cold: the replay reads every page at least once
+  bpm = std::make_unique<bustub::BufferPoolManagerInstance>(pool_size, &disk_manager, 2);
+  if (cache_size > 0) {
+    cache = std::make_unique<bustub::CompressedPageCache>(cache_size);
+    bpm->SetCompressedPageCache(cache.get());
+  }
+  const auto start = std::chrono::steady_clock::now();
+  for (const auto access : trace) {
+    if (bpm->FetchPage(access) != nullptr) {
+      bpm->UnpinPage(access, false);
+    }
+  }
+  const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+  RunResult result{elapsed.count(), bpm->GetStats(), {}};
+  if (cache != nullptr) {
+    result.cache_ = cache->GetStats();
+    bpm->SetCompressedPageCache(nullptr);
+  }
+  return result;
+}
+
+}  // namespace
+
+// NOLINTNEXTLINE
+auto main(int argc, char **argv) -> int {
+  argparse::ArgumentParser program("bustub-cache-bench");
+  program.add_argument("--trace")
+      .help("page access trace recorded with \\trace in the shell; a synthetic trace is generated if omitted")
+      .default_value<std::string>("");
+  program.add_argument("--pool-size").help("number of frames").default_value<size_t>(1024).scan<'u', size_t>();
+  program.add_argument("--cache-size")
+      .help("size of the compressed cache, in pages of memory; by default half the buffer pool")
+      .default_value<size_t>(0)
+      .scan<'u', size_t>();
+  program.add_argument("--working-set")
+      .help("number of pages of the synthetic trace; by default twice the buffer pool")
+      .default_value<size_t>(0)
+      .scan<'u', size_t>();
+  program.add_argument("--length")
+      .help("number of accesses of the synthetic trace")
+      .default_value<size_t>(200000)
+      .scan<'u', size_t>();
+  program.add_argument("--read-latency")
+      .help("latency of a disk read, in microseconds")
+      .default_value<size_t>(100)
+      .scan<'u', size_t>();
+
+  try {
+    program.parse_args(argc, argv);
+  } catch (const std::runtime_error &err) {
+    std::cerr << err.what() << std::endl;
+    std::cerr << program;
+    return 1;
+  }
+
+  const auto pool_size = program.get<size_t>("--pool-size");
+  auto cache_pages = program.get<size_t>("--cache-size");
+  if (cache_pages == 0) {
+    cache_pages = pool_size / 2;
+  }
+  const auto read_latency = std::chrono::microseconds(program.get<size_t>("--read-latency"));
+  auto trace_file = program.get<std::string>("--trace");
+  std::vector<bustub::page_id_t> trace;
+  size_t num_pages;
+  if (trace_file.empty()) {
+    num_pages = program.get<size_t>("--working-set") > 0 ? program.get<size_t>("--working-set") : 2 * pool_size;
+    trace = GenerateTrace(program.get<size_t>("--length"), num_pages);
+  } else {
+    trace = bustub::AccessTrace::Load(trace_file);
+    num_pages = trace.empty() ? 0 : *std::max_element(trace.begin(), trace.end()) + 1;
+  }
+  fmt::print("{} accesses to {} pages from {}, {} frames, {} us per disk read\n", trace.size(), num_pages,
+             trace_file.empty() ? "a synthetic trace" : trace_file, pool_size, read_latency.count());
+
+  fmt::print("{:>14} {:>10} {:>10} {:>10} {:>10} {:>8} {:>12}\n", "cache (pages)", "pool hits", "cache hits",
+             "disk reads", "ratio", "time (s)", "op/s");
+  for (size_t cache_size : {static_cast<size_t>(0), cache_pages}) {
+    const auto result = Run(trace, num_pages, pool_size, cache_size * bustub::BUSTUB_PAGE_SIZE, read_latency);
+    fmt::print("{:>14} {:>9.2f}% {:>9.2f}% {:>10} {:>10.2f} {:>8.2f} {:>12.0f}\n", cache_size,
+               100 * result.pool_.HitRatio(), 100 * result.cache_.HitRatio(), result.pool_.read_latency_.Count(),
+               result.cache_.CompressionRatio(), result.seconds_,
+               static_cast<double>(trace.size()) / result.seconds_);
+  }
+  return 0;
+}
@@ -0,0 +1,161 @@
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "argparse/argparse.hpp"
+#include "buffer/buffer_pool_manager_instance.h"
+#include "concurrency/lock_manager.h"
+#include "concurrency/transaction.h"
+#include "fmt/core.h"
+#include "recovery/log_manager.h"
+#include "storage/disk/disk_manager_compressed.h"
+#include "storage/disk/disk_manager_posix.h"
+#include "storage/table/table_heap.h"
+#include "type/value_factory.h"
+
+namespace {
+
+/** Remove a database file, its log file and its page map. */
+void RemoveFiles(const std::string &file) {
+  std::remove(file.c_str());
+  std::remove((file + ".map").c_str());
+  std::remove((file.substr(0, file.rfind('.')) + ".log").c_str());
+}
+
+/** Drop the pages of a file from the OS page cache, so that they are read from the device again. */
+void DropCache(const std::string &file) {
+  const int fd = open(file.c_str(), O_RDONLY);
+  if (fd != -1) {
+    posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+    close(fd);
+  }
+}
+
+struct Storage {
+  const char *name_;
+  std::function<std::unique_ptr<bustub::DiskManager>(const std::string &)> open_;
+  std::function<int64_t(bustub::DiskManager *)> file_size_;
+};
+
+}  // namespace
+
+// NOLINTNEXTLINE
+auto main(int argc, char **argv) -> int {
+  argparse::ArgumentParser program("bustub-compression-bench");
+  program.add_argument("--file").help("database file to create").default_value<std::string>("bustub-compression.db");
+  program.add_argument("--tuples").help("rows of the table").default_value<size_t>(50000).scan<'u', size_t>();
+  program.add_argument("--frames")
+      .help("frames of the buffer pool of the scans")
+      .default_value<size_t>(64)
+      .scan<'u', size_t>();
+  program.add_argument("--rounds").help("scans of the table").default_value<size_t>(3).scan<'u', size_t>();
+
+  try {
+    program.parse_args(argc, argv);
+  } catch (const std::runtime_error &err) {
+    std::cerr << err.what() << std::endl;
+    std::cerr << program;
+    return 1;
+  }
+
+  const auto file = program.get<std::string>("--file");
+  const auto num_tuples = program.get<size_t>("--tuples");
+  const auto frames = program.get<size_t>("--frames");
+  const auto rounds = program.get<size_t>("--rounds");
+
+  const std::vector<Storage> storages = {
+      {"raw pages",
+       [](const std::string &name) { return std::make_unique<bustub::DiskManagerPosix>(name); },
+       [](bustub::DiskManager *dm) { return static_cast<bustub::DiskManagerPosix *>(dm)->GetDbFileSize(); }},
+      {"compressed pages",
+       [](const std::string &name) { return std::make_unique<bustub::DiskManagerCompressed>(name); },
+       [](bustub::DiskManager *dm) { return static_cast<bustub::DiskManagerCompressed *>(dm)->GetDbFileSize(); }},
+  };
+
+  // rows of a typical table: a key, a few repeated values and a comment drawn from a small vocabulary
+  const std::vector<std::string> statuses = {"pending", "shipped", "delivered", "returned"};
+  const std::vector<std::string> words = {"the",  "quick",   "order", "customer", "express", "package",  "regular",
+                                          "deal", "account", "final", "request",  "deposit", "carefully"};
+  bustub::Schema schema({bustub::Column{"id", bustub::TypeId::BIGINT},
+                         bustub::Column{"customer", bustub::TypeId::INTEGER},
+                         bustub::Column{"status", bustub::TypeId::VARCHAR, 16},
+                         bustub::Column{"comment", bustub::TypeId::VARCHAR, 128}});
+  std::vector<bustub::Tuple> tuples;
+  std::mt19937 gen(42);
+  for (size_t i = 0; i < num_tuples; i++) {
+    std::string comment;
+    for (int w = 0; w < 8; w++) {
+      comment += words[gen() % words.size()] + " ";
+    }
+    std::vector<bustub::Value> values = {bustub::ValueFactory::GetBigIntValue(static_cast<int64_t>(i)),
+                                         bustub::ValueFactory::GetIntegerValue(static_cast<int>(gen() % 5000)),
+                                         bustub::ValueFactory::GetVarcharValue(statuses[gen() % 4]),
+                                         bustub::ValueFactory::GetVarcharValue(comment)};
+    tuples.emplace_back(values, &schema);
+  }
+
+  fmt::print("{} rows, scans through {} frames with a cold OS page cache\n", num_tuples, frames);
+  fmt::print("{:<18} {:>10} {:>8} {:>14} {:>14} {:>14}\n", "storage", "file (KB)", "ratio", "flush (MB/s)",
+             "scan (rows/s)", "scan (MB/s)");
+  for (const auto &storage : storages) {
+    RemoveFiles(file);
+    bustub::LockManager lock_manager;
+    bustub::Transaction txn(0);
+    bustub::page_id_t first_page_id;
+    size_t num_pages;
+    double flush_mb_per_s;
+    int64_t file_size;
+    double ratio = 1;
+    {
+      // load with a buffer pool holding the whole table, so that the pages are written by the flush alone
+      auto disk_manager = storage.open_(file);
+      bustub::LogManager log_manager(disk_manager.get());
+      bustub::BufferPoolManagerInstance bpm(num_tuples / 8 + 64, disk_manager.get(), 2);
+      bustub::TableHeap table(&bpm, &lock_manager, &log_manager, &txn);
+      first_page_id = table.GetFirstPageId();
+      bustub::RID rid;
+      for (const auto &tuple : tuples) {
+        table.InsertTuple(tuple, &rid, &txn);
+      }
+      const auto start = std::chrono::steady_clock::now();
+      bpm.FlushAllPages();
+      const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+      num_pages = bpm.GetStats().write_latency_.Count();
+      flush_mb_per_s = static_cast<double>(num_pages * bustub::BUSTUB_PAGE_SIZE) / elapsed / (1 << 20);
+      file_size = storage.file_size_(disk_manager.get());
+      if (auto *compressed = dynamic_cast<bustub::DiskManagerCompressed *>(disk_manager.get()); compressed != nullptr) {
+        ratio = compressed->GetCompressionRatio();
+      }
+      disk_manager->ShutDown();
+    }
+
+    auto disk_manager = storage.open_(file);
+    bustub::LogManager log_manager(disk_manager.get());
+    bustub::BufferPoolManagerInstance bpm(frames, disk_manager.get(), 2);
+    bustub::TableHeap table(&bpm, &lock_manager, &log_manager, first_page_id);
+    size_t scanned = 0;
+    std::chrono::duration<double> elapsed{0};
+    for (size_t round = 0; round < rounds; round++) {
+      DropCache(file);
+      const auto start = std::chrono::steady_clock::now();
+      for (auto it = table.Begin(&txn); it != table.End(); ++it) {
+        scanned++;
+      }
+      elapsed += std::chrono::steady_clock::now() - start;
+    }
+    fmt::print("{:<18} {:>10} {:>8.2f} {:>14.0f} {:>14.0f} {:>14.0f}\n", storage.name_, file_size / 1024, ratio,
+               flush_mb_per_s, static_cast<double>(scanned) / elapsed.count(),
+               static_cast<double>(num_pages * bustub::BUSTUB_PAGE_SIZE * rounds) / elapsed.count() / (1 << 20));
+    disk_manager->ShutDown();
+  }
+  RemoveFiles(file);
+  return 0;
+}
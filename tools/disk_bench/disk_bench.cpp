@@ -0,0 +1,197 @@
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <future>  // NOLINT
+#include <iostream>
+#include <memory>
+#include <new>
+#include <random>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "argparse/argparse.hpp"
+#include "buffer/buffer_pool_manager_instance.h"
+#include "fmt/core.h"
+#include "storage/disk/disk_manager.h"
+#include "storage/disk/disk_manager_posix.h"
+#include "storage/disk/disk_scheduler.h"
+
+namespace {
+
+/** Page buffers aligned for O_DIRECT. */
+class AlignedPages {
+ public:
+  explicit AlignedPages(size_t num_pages)
+      : data_(static_cast<char *>(::operator new[](num_pages * bustub::BUSTUB_PAGE_SIZE,
+                                                     std::align_val_t{bustub::DiskManager::DIRECT_IO_ALIGNMENT}))) {}
+  ~AlignedPages() { ::operator delete[](data_, std::align_val_t{bustub::DiskManager::DIRECT_IO_ALIGNMENT}); }
+  AlignedPages(const AlignedPages &) = delete;
+  auto operator=(const AlignedPages &) -> AlignedPages & = delete;
+
+  auto Get(size_t i) -> char * { return data_ + i * bustub::BUSTUB_PAGE_SIZE; }
+
+ private:
+  char *data_;
+};
+
+/** Random reads of DiskManager::ReadPage() from `threads` threads. @return reads per second */
+auto RunDiskManager(bustub::DiskManager *disk_manager, size_t num_pages, size_t threads,
+                    std::chrono::milliseconds duration) -> double {
+  std::vector<std::thread> workers;
+  std::vector<uint64_t> reads(threads, 0);
+  AlignedPages buffers(threads);
+  const auto start = std::chrono::steady_clock::now();
+  for (size_t tid = 0; tid < threads; tid++) {
+    workers.emplace_back([&, tid] {
+      std::mt19937 gen(tid);
+      while (std::chrono::steady_clock::now() < start + duration) {
+        disk_manager->ReadPage(static_cast<bustub::page_id_t>(gen() % num_pages), buffers.Get(tid));
+        reads[tid]++;
+      }
+    });
+  }
+  uint64_t total = 0;
+  for (size_t tid = 0; tid < threads; tid++) {
+    workers[tid].join();
+    total += reads[tid];
+  }
+  return static_cast<double>(total) / std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+/** Random reads through a scheduler from one thread, keeping its queue full. @return reads per second */
+auto RunScheduler(bustub::DiskScheduler *scheduler, size_t num_pages, std::chrono::milliseconds duration) -> double {
+  const size_t depth = scheduler->GetQueueDepth();
+  AlignedPages buffers(depth);
+  std::vector<std::future<bool>> in_flight(depth);
+  std::mt19937 gen(0);
+  uint64_t total = 0;
+  const auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < depth; i++) {
+    in_flight[i] = scheduler->ScheduleRead(static_cast<bustub::page_id_t>(gen() % num_pages), buffers.Get(i));
+  }
+  while (std::chrono::steady_clock::now() < start + duration) {
+    for (size_t i = 0; i < depth; i++) {
+      in_flight[i].get();
+      total++;
+      in_flight[i] = scheduler->ScheduleRead(static_cast<bustub::page_id_t>(gen() % num_pages), buffers.Get(i));
+    }
+  }
+  const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  for (auto &read : in_flight) {
+    read.get();
+  }
+  return static_cast<double>(total) / elapsed;
+}
+
+/** Random fetches that (almost) always miss a small buffer pool, from `threads` threads. @return fetches per second */
+auto RunBufferPool(bustub::DiskManager *disk_manager, bustub::DiskScheduler *scheduler, size_t num_pages,
+                   size_t threads, std::chrono::milliseconds duration) -> double {
+  bustub::BufferPoolManagerInstance bpm(threads * 4, disk_manager, 2);
+  bpm.SetDiskScheduler(scheduler);
+  std::vector<std::thread> workers;
+  std::vector<uint64_t> fetches(threads, 0);
+  const auto start = std::chrono::steady_clock::now();
+  for (size_t tid = 0; tid < threads; tid++) {
+    workers.emplace_back([&, tid] {
+      std::mt19937 gen(tid);
+      while (std::chrono::steady_clock::now() < start + duration) {
+        const auto page_id = static_cast<bustub::page_id_t>(gen() % num_pages);
+        if (bpm.FetchPage(page_id) != nullptr) {
+          bpm.UnpinPage(page_id, false);
+          fetches[tid]++;
+        }
+      }
+    });
+  }
+  uint64_t total = 0;
+  for (size_t tid = 0; tid < threads; tid++) {
+    workers[tid].join();
+    total += fetches[tid];
+  }
+  const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  bpm.SetDiskScheduler(nullptr);
+  return static_cast<double>(total) / elapsed;
+}
+
+}  // namespace
+
+// NOLINTNEXTLINE
+auto main(int argc, char **argv) -> int {
+  argparse::ArgumentParser program("bustub-disk-bench");
+  program.add_argument("--file").help("database file to create").default_value<std::string>("bustub-disk-bench.db");
+  program.add_argument("--pages").help("size of the file, in pages").default_value<size_t>(16384).scan<'u', size_t>();
+  program.add_argument("--duration")
+      .help("run time of each configuration, in milliseconds")
+      .default_value<size_t>(1000)
+      .scan<'u', size_t>();
+  program.add_argument("--threads")
+      .help("threads issuing synchronous reads")
+      .default_value<size_t>(8)
+      .scan<'u', size_t>();
+  program.add_argument("--direct")
+      .help("bypass the OS page cache with O_DIRECT, to measure the device rather than the system calls")
+      .default_value(false)
+      .implicit_value(true);
+
+  try {
+    program.parse_args(argc, argv);
+  } catch (const std::runtime_error &err) {
+    std::cerr << err.what() << std::endl;
+    std::cerr << program;
+    return 1;
+  }
+
+  const auto file = program.get<std::string>("--file");
+  const auto num_pages = program.get<size_t>("--pages");
+  const auto duration = std::chrono::milliseconds(program.get<size_t>("--duration"));
+  const auto threads = program.get<size_t>("--threads");
+  std::remove(file.c_str());
+  auto disk_manager = std::make_unique<bustub::DiskManager>(file, program.get<bool>("--direct"));
+  {
+    AlignedPages page(1);
+    std::mt19937 gen(42);
+    for (size_t i = 0; i < num_pages; i++) {
+      for (size_t j = 0; j < bustub::BUSTUB_PAGE_SIZE; j += sizeof(uint32_t)) {
+        *reinterpret_cast<uint32_t *>(page.Get(0) + j) = gen();
+      }
+      disk_manager->WritePage(static_cast<bustub::page_id_t>(i), page.Get(0));
+    }
+  }
+  fmt::print("random 4 KiB reads of {} pages, {}\n", num_pages,
+             disk_manager->IsDirectIo() ? "O_DIRECT" : "through the OS page cache");
+
+  fmt::print("{:<32} {:>8} {:>12}\n", "configuration", "depth", "IOPS");
+  for (size_t n : {static_cast<size_t>(1), threads}) {
+    fmt::print("{:<32} {:>8} {:>12.0f}\n", "DiskManager::ReadPage", n,
+               RunDiskManager(disk_manager.get(), num_pages, n, duration));
+  }
+  if (!disk_manager->IsDirectIo()) {
+    bustub::DiskManagerPosix posix(file);
+    for (size_t n : {static_cast<size_t>(1), threads}) {
+      fmt::print("{:<32} {:>8} {:>12.0f}\n", "DiskManagerPosix::ReadPage", n,
+                 RunDiskManager(&posix, num_pages, n, duration));
+    }
+    posix.ShutDown();
+  }
+  for (const auto backend : {bustub::DiskScheduler::Backend::THREAD_POOL, bustub::DiskScheduler::Backend::IO_URING}) {
+    for (size_t depth : {1, 4, 16, 64}) {
+      bustub::DiskScheduler scheduler(disk_manager.get(), depth, backend);
+      if (scheduler.GetBackend() != backend) {
+        fmt::print("io_uring is not supported\n");
+        break;
+      }
+      const auto *name = backend == bustub::DiskScheduler::Backend::IO_URING ? "DiskScheduler (io_uring)"
+                                                                            : "DiskScheduler (thread pool)";
+      fmt::print("{:<32} {:>8} {:>12.0f}\n", name, depth, RunScheduler(&scheduler, num_pages, duration));
+    }
+  }
+  bustub::DiskScheduler scheduler(disk_manager.get());
+  fmt::print("{:<32} {:>8} {:>12.0f}\n", "buffer pool misses", threads,
+             RunBufferPool(disk_manager.get(), nullptr, num_pages, threads, duration));
+  fmt::print("{:<32} {:>8} {:>12.0f}\n", "buffer pool misses, scheduler", threads,
+             RunBufferPool(disk_manager.get(), &scheduler, num_pages, threads, duration));
+  disk_manager->ShutDown();
+  std::remove(file.c_str());
+  std::remove((file.substr(0, file.rfind('.')) + ".log").c_str());
+  return 0;
+}
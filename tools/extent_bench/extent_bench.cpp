@@ -0,0 +1,118 @@
+#include <chrono>  // NOLINT
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "argparse/argparse.hpp"
+#include "buffer/buffer_pool_manager_instance.h"
+#include "concurrency/lock_manager.h"
+#include "concurrency/transaction.h"
+#include "fmt/core.h"
+#include "recovery/log_manager.h"
+#include "storage/disk/disk_manager_memory.h"
+#include "storage/table/table_heap.h"
+#include "type/value_factory.h"
+
+namespace {
+
+/** @return the number of pages of a table, and the number of runs of consecutive pages its page chain is made of */
+auto ChainLayout(bustub::BufferPoolManager *bpm, const bustub::TableHeap &table) -> std::pair<size_t, size_t> {
+  size_t num_pages = 0;
+  size_t num_runs = 0;
+  bustub::page_id_t prev_page_id = bustub::INVALID_PAGE_ID;
+  for (bustub::page_id_t page_id = table.GetFirstPageId(); page_id != bustub::INVALID_PAGE_ID;) {
+    auto *page = static_cast<bustub::TablePage *>(bpm->FetchPage(page_id));
+    const bustub::page_id_t next_page_id = page->GetNextPageId();
+    bpm->UnpinPage(page_id, false);
+    num_pages++;
+    num_runs += page_id == prev_page_id + 1 ? 0 : 1;
+    prev_page_id = page_id;
+    page_id = next_page_id;
+  }
+  return {num_pages, num_runs};
+}
+
+}  // namespace
+
+// NOLINTNEXTLINE
+auto main(int argc, char **argv) -> int {
+  argparse::ArgumentParser program("bustub-extent-bench");
+  program.add_argument("--tables").help("tables loaded at the same time").default_value<size_t>(4).scan<'u', size_t>();
+  program.add_argument("--tuples").help("rows of each table").default_value<size_t>(10000).scan<'u', size_t>();
+  program.add_argument("--pool-size").help("frames of the buffer pool").default_value<size_t>(64).scan<'u', size_t>();
+  program.add_argument("--seek-latency")
+      .help("time the disk takes to seek to a read that does not follow the previous one, in us")
+      .default_value<size_t>(200)
+      .scan<'u', size_t>();
+  program.add_argument("--bandwidth")
+      .help("bandwidth of the disk, in MB/s")
+      .default_value<size_t>(400)
+      .scan<'u', size_t>();
+
+  try {
+    program.parse_args(argc, argv);
+  } catch (const std::runtime_error &err) {
+    std::cerr << err.what() << std::endl;
+    std::cerr << program;
+    return 1;
+  }
+
+  const auto num_tables = program.get<size_t>("--tables");
+  const auto num_tuples = program.get<size_t>("--tuples");
+  const auto pool_size = program.get<size_t>("--pool-size");
+  bustub::DiskLatencyModel model;
+  model.seek_latency_ = std::chrono::microseconds(program.get<size_t>("--seek-latency"));
+  model.bandwidth_ = program.get<size_t>("--bandwidth") << 20;
+
+  // rows of about 100 bytes, 40 to a page
+  const size_t max_pages = (num_tuples / 32 + 2 * bustub::EXTENT_SIZE) * num_tables;
+  bustub::DiskManagerMemory disk_manager(max_pages);
+  bustub::LockManager lock_manager;
+  bustub::LogManager log_manager(&disk_manager);
+  bustub::Transaction txn(0);
+  bustub::Schema schema(
+      {bustub::Column{"id", bustub::TypeId::BIGINT}, bustub::Column{"payload", bustub::TypeId::VARCHAR, 96}});
+  const std::string payload(80, 'x');
+  std::vector<std::unique_ptr<bustub::TableHeap>> tables;
+  {
+    // the tables are loaded in turns, as concurrent inserts into several tables would
+    bustub::BufferPoolManagerInstance bpm(pool_size, &disk_manager, 2);
+    for (size_t i = 0; i < num_tables; i++) {
+      tables.push_back(std::make_unique<bustub::TableHeap>(&bpm, &lock_manager, &log_manager, &txn));
+    }
+    for (size_t i = 0; i < num_tuples; i++) {
+      bustub::Tuple tuple({bustub::ValueFactory::GetBigIntValue(static_cast<int64_t>(i)),
+                           bustub::ValueFactory::GetVarcharValue(payload)},
+                          &schema);
+      for (auto &table : tables) {
+        bustub::RID rid;
+        table->InsertTuple(tuple, &rid, &txn);
+      }
+    }
+    bpm.FlushAllPages();
+    auto [num_pages, num_runs] = ChainLayout(&bpm, *tables[0]);
+    fmt::print("{} tables of {} pages loaded in turns, the first one in {} runs of consecutive pages\n", num_tables,
+               num_pages, num_runs);
+  }
+
+  // scan every table from a cold buffer pool, one after the other
+  disk_manager.SetLatencyModel(model);
+  disk_manager.ResetStats();
+  bustub::BufferPoolManagerInstance bpm(pool_size, &disk_manager, 2);
+  size_t num_rows = 0;
+  const auto start = std::chrono::steady_clock::now();
+  for (auto &table : tables) {
+    bustub::TableHeap reopened(&bpm, &lock_manager, &log_manager, table->GetFirstPageId());
+    for (auto it = reopened.Begin(&txn); it != reopened.End(); ++it) {
+      num_rows++;
+    }
+  }
+  const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  fmt::print("{:<16} {:>12}\n", "rows scanned", num_rows);
+  fmt::print("{:<16} {:>12.0f}\n", "rows/s", static_cast<double>(num_rows) / elapsed);
+  const auto stats = disk_manager.GetStats();
+  fmt::print("{:<16} {:>12}\n", "disk reads", stats.reads_);
+  fmt::print("{:<16} {:>12}\n", "seeks", stats.seeks_);
+  return 0;
+}
@@ -0,0 +1,157 @@
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "argparse/argparse.hpp"
+#include "buffer/buffer_pool_manager_instance.h"
+#include "fmt/core.h"
+#include "storage/disk/disk_manager.h"
+#include "storage/disk/disk_manager_memory.h"
+
+namespace {
+
+/** Keeps the page reads of the benchmark from being optimized away. */
+std::atomic<uint64_t> checksum_sink{0};
+
+/**
+ * Runs `threads` workers that fetch random resident pages and read one cache line of each for `duration_ms`
+ * milliseconds. Touching the frame data of a large pool is what makes the TLB reach of the frame arena matter.
+ * @return the total number of page accesses per second
+ */
+auto RunTouchBench(bustub::BufferPoolManager *bpm, size_t num_pages, size_t threads, uint64_t duration_ms) -> double {
+  std::vector<std::thread> workers;
+  std::vector<uint64_t> ops(threads, 0);
+  auto start = std::chrono::steady_clock::now();
+  for (size_t tid = 0; tid < threads; tid++) {
+    workers.emplace_back([&, tid] {
+      std::mt19937 gen(tid);
+      std::uniform_int_distribution<bustub::page_id_t> page_dis(0, static_cast<bustub::page_id_t>(num_pages) - 1);
+      std::uniform_int_distribution<size_t> offset_dis(0, bustub::BUSTUB_PAGE_SIZE / 64 - 1);
+      auto deadline = start + std::chrono::milliseconds(duration_ms);
+      uint64_t local_ops = 0;
+      uint64_t checksum = 0;
+      while (std::chrono::steady_clock::now() < deadline) {
+        for (int i = 0; i < 64; i++) {
+          auto page_id = page_dis(gen);
+          auto *page = bpm->FetchPage(page_id);
+          if (page == nullptr) {
+            continue;
+          }
+          checksum += static_cast<uint8_t>(page->GetData()[offset_dis(gen) * 64]);
+          bpm->UnpinPage(page_id, false);
+          local_ops++;
+        }
+      }
+      ops[tid] = local_ops;
+      checksum_sink += checksum;
+    });
+  }
+  for (auto &worker : workers) {
+    worker.join();
+  }
+  auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  uint64_t total = 0;
+  for (auto op : ops) {
+    total += op;
+  }
+  return static_cast<double>(total) / elapsed;
+}
+
+/**
+ * Scans `num_pages` pages of `db_file` through a buffer pool of `pool_size` frames `passes` times.
+ * @return the number of pages scanned per second
+ */
+auto RunScanBench(const std::string &db_file, bool direct_io, size_t num_pages, size_t pool_size, size_t passes)
+    -> double {
+  bustub::DiskManager disk_manager(db_file, direct_io);
+  if (direct_io && !disk_manager.IsDirectIo()) {
+    fmt::print("  (O_DIRECT is not supported here, the direct run uses buffered I/O)\n");
+  }
+  bustub::BufferPoolManagerInstance bpm(pool_size, &disk_manager);
+  auto start = std::chrono::steady_clock::now();
+  for (size_t pass = 0; pass < passes; pass++) {
+    for (size_t i = 0; i < num_pages; i++) {
+      auto page_id = static_cast<bustub::page_id_t>(i);
+      if (bpm.FetchPage(page_id) != nullptr) {
+        bpm.UnpinPage(page_id, false);
+      }
+    }
+  }
+  auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  disk_manager.ShutDown();
+  return static_cast<double>(num_pages * passes) / elapsed;
+}
+
+}  // namespace
+
+// NOLINTNEXTLINE
+auto main(int argc, char **argv) -> int {
+  argparse::ArgumentParser program("bustub-frame-bench");
+  program.add_argument("--duration")
+      .help("run time of each configuration in ms")
+      .default_value<uint64_t>(2000)
+      .scan<'u', uint64_t>();
+  program.add_argument("--threads").help("number of worker threads").default_value<size_t>(4).scan<'u', size_t>();
+  program.add_argument("--pool-size")
+      .help("number of frames of the touch benchmark")
+      .default_value<size_t>(65536)
+      .scan<'u', size_t>();
+  program.add_argument("--db-file").help("database file of the scan benchmark").default_value<std::string>("bench.db");
+  program.add_argument("--scan-pages")
+      .help("number of pages of the scan benchmark")
+      .default_value<size_t>(16384)
+      .scan<'u', size_t>();
+
+  try {
+    program.parse_args(argc, argv);
+  } catch (const std::runtime_error &err) {
+    std::cerr << err.what() << std::endl;
+    std::cerr << program;
+    return 1;
+  }
+
+  auto duration_ms = program.get<uint64_t>("--duration");
+  auto threads = program.get<size_t>("--threads");
+  auto pool_size = program.get<size_t>("--pool-size");
+  auto db_file = program.get<std::string>("--db-file");
+  auto scan_pages = program.get<size_t>("--scan-pages");
+
+  fmt::print("resident page access: {} frames, {} threads, {} ms per run\n", pool_size, threads, duration_ms);
+  fmt::print("{:>12} {:>16} {:>10}\n", "arena", "accesses/s", "hugetlb");
+  for (bool huge_pages : {false, true}) {
+    bustub::enable_huge_pages = huge_pages;
+    auto disk_manager = std::make_unique<bustub::DiskManagerMemory>(pool_size);
+    auto bpm = std::make_unique<bustub::BufferPoolManagerInstance>(pool_size, disk_manager.get());
+    bustub::page_id_t page_id;
+    for (size_t i = 0; i < pool_size; i++) {
+      bpm->NewPage(&page_id);
+      bpm->UnpinPage(page_id, false);
+    }
+    auto ops = RunTouchBench(bpm.get(), pool_size, threads, duration_ms);
+    fmt::print("{:>12} {:>16.0f} {:>10}\n", huge_pages ? "huge pages" : "4 KB pages", ops,
+               bpm->GetFrameArena()->IsHugeTlb() ? "yes" : "no");
+  }
+  bustub::enable_huge_pages = false;
+
+  // The pool holds a quarter of the file, so every pass misses on every page.
+  fmt::print("\nrepeated scan of {} pages through {} frames\n", scan_pages, scan_pages / 4);
+  {
+    bustub::DiskManager disk_manager(db_file);
+    std::vector<char> data(bustub::BUSTUB_PAGE_SIZE, 'x');
+    for (size_t i = 0; i < scan_pages; i++) {
+      disk_manager.WritePage(static_cast<bustub::page_id_t>(i), data.data());
+    }
+    disk_manager.ShutDown();
+  }
+  for (bool direct_io : {false, true}) {
+    auto pages_per_sec = RunScanBench(db_file, direct_io, scan_pages, scan_pages / 4, 3);
+    fmt::print("{:>12} {:>16.0f} pages/s\n", direct_io ? "O_DIRECT" : "buffered", pages_per_sec);
+  }
+  std::remove(db_file.c_str());
+  return 0;
+}
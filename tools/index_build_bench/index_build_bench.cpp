@@ -0,0 +1,141 @@
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "argparse/argparse.hpp"
+#include "buffer/buffer_pool_manager_instance.h"
+#include "fmt/core.h"
+#include "storage/disk/disk_manager_memory.h"
+#include "storage/index/b_plus_tree.h"
+#include "storage/index/external_sorter.h"
+#include "test_util.h"  // NOLINT
+
+namespace {
+
+using Key = bustub::GenericKey<8>;
+using Comparator = bustub::GenericComparator<8>;
+using Tree = bustub::BPlusTree<Key, bustub::RID, Comparator>;
+
+struct Entry {
+  Key key_;
+  bustub::RID rid_;
+};
+
+/** Pages of a tree, and keys of its leaves. */
+struct TreeSize {
+  size_t leaves_{0};
+  size_t internals_{0};
+  size_t keys_{0};
+  size_t leaf_capacity_{0};
+};
+
+void MeasureNode(bustub::BufferPoolManager *bpm, bustub::page_id_t page_id, TreeSize *size) {
+  auto *node = reinterpret_cast<bustub::BPlusTreePage *>(bpm->FetchPage(page_id)->GetData());
+  if (node->IsLeafPage()) {
+    size->leaves_++;
+    size->keys_ += node->GetSize();
+    size->leaf_capacity_ += node->GetMaxSize() - 1;
+  } else {
+    size->internals_++;
+    auto *internal = reinterpret_cast<bustub::BPlusTreeInternalPage<Key, bustub::page_id_t, Comparator> *>(node);
+    for (int i = 0; i < internal->GetSize(); i++) {
+      MeasureNode(bpm, internal->ValueAt(i), size);
+    }
+  }
+  bpm->UnpinPage(page_id, false);
+}
+
+}  // namespace
+
+// NOLINTNEXTLINE
+auto main(int argc, char **argv) -> int {
+  argparse::ArgumentParser program("bustub-index-build-bench");
+  program.add_argument("--keys").help("keys of the index").default_value<size_t>(1000000).scan<'u', size_t>();
+  program.add_argument("--frames").help("frames of the buffer pool").default_value<size_t>(4096).scan<'u', size_t>();
+  program.add_argument("--sort-memory")
+      .help("bytes the sort may use before it spills runs to disk")
+      .default_value<size_t>(64 << 20)
+      .scan<'u', size_t>();
+  program.add_argument("--fill-factor")
+      .help("fraction of the pages the bulk load fills")
+      .default_value(double{bustub::INDEX_BUILD_FILL_FACTOR})
+      .scan<'g', double>();
+
+  try {
+    program.parse_args(argc, argv);
+  } catch (const std::runtime_error &err) {
+    std::cerr << err.what() << std::endl;
+    std::cerr << program;
+    return 1;
+  }
+
+  const auto num_keys = program.get<size_t>("--keys");
+  const auto frames = program.get<size_t>("--frames");
+  const auto sort_memory = program.get<size_t>("--sort-memory");
+  const auto fill_factor = program.get<double>("--fill-factor");
+
+  // the keys in the order of the rows of a table, unrelated to the order of the index
+  std::vector<int64_t> keys(num_keys);
+  for (size_t i = 0; i < num_keys; i++) {
+    keys[i] = static_cast<int64_t>(i);
+  }
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(42));
+  auto key_schema = bustub::ParseCreateStatement("a bigint");
+  Comparator comparator(key_schema.get());
+
+  fmt::print("{} keys in random order, {} frames\n", num_keys, frames);
+  fmt::print("{:<12} {:>10} {:>12} {:>8} {:>10} {:>10} {:>10}\n", "build", "time (s)", "keys/s", "runs", "leaves",
+             "internals", "leaf fill");
+  for (const bool bulk_load : {false, true}) {
+    auto disk_manager = std::make_unique<bustub::DiskManagerMemory>(num_keys / 64 + 64);
+    auto bpm = std::make_unique<bustub::BufferPoolManagerInstance>(frames, disk_manager.get());
+    bustub::page_id_t header_page_id;
+    bpm->NewPage(&header_page_id);
+    Tree tree("index", bpm.get(), comparator);
+    size_t num_runs = 0;
+
+    const auto start = std::chrono::steady_clock::now();
+    if (bulk_load) {
+      auto less = [&comparator](const Entry &a, const Entry &b) { return comparator(a.key_, b.key_) < 0; };
+      bustub::ExternalSorter<Entry, decltype(less)> sorter(less, sort_memory);
+      for (const int64_t key : keys) {
+        Entry entry;
+        entry.key_.SetFromInteger(key);
+        entry.rid_ = bustub::RID(key);
+        sorter.Add(entry);
+      }
+      sorter.Finish();
+      num_runs = sorter.GetNumRuns();
+      tree.BulkLoad(
+          [&sorter](Key *key, bustub::RID *rid) {
+            Entry entry;
+            if (!sorter.Next(&entry)) {
+              return false;
+            }
+            *key = entry.key_;
+            *rid = entry.rid_;
+            return true;
+          },
+          fill_factor);
+    } else {
+      Key key;
+      for (const int64_t k : keys) {
+        key.SetFromInteger(k);
+        tree.Insert(key, bustub::RID(k));
+      }
+    }
+    const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    TreeSize size;
+    MeasureNode(bpm.get(), tree.GetRootPageId(), &size);
+    fmt::print("{:<12} {:>10.2f} {:>12.0f} {:>8} {:>10} {:>10} {:>9.0f}%\n", bulk_load ? "bulk load" : "insert",
+               elapsed, static_cast<double>(num_keys) / elapsed, num_runs, size.leaves_, size.internals_,
+               100.0 * static_cast<double>(size.keys_) / static_cast<double>(size.leaf_capacity_));
+    bpm->UnpinPage(header_page_id, true);
+  }
+  return 0;
+}
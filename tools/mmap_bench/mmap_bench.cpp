@@ -0,0 +1,137 @@
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "argparse/argparse.hpp"
+#include "buffer/buffer_pool_manager_instance.h"
+#include "fmt/core.h"
+#include "storage/disk/disk_manager.h"
+#include "storage/disk/disk_manager_mmap.h"
+#include "storage/disk/disk_manager_posix.h"
+
+namespace {
+
+/** Sum the words of a page, so that fetching it has to touch its data. */
+auto Touch(const char *data) -> uint64_t {
+  uint64_t sum = 0;
+  for (size_t i = 0; i < bustub::BUSTUB_PAGE_SIZE; i += 64) {
+    sum += *reinterpret_cast<const uint64_t *>(data + i);
+  }
+  return sum;
+}
+
+/**
+ * Fetch pages from `threads` threads for `duration`, each thread asking `next` for the page to fetch next.
+ * @return fetches per second
+ */
+auto Run(bustub::BufferPoolManagerInstance *bpm, size_t threads, std::chrono::milliseconds duration,
+         const std::function<bustub::page_id_t(size_t tid, uint64_t i, std::mt19937 *gen)> &next) -> double {
+  std::vector<std::thread> workers;
+  std::vector<uint64_t> fetches(threads, 0);
+  std::vector<uint64_t> sums(threads, 0);
+  const auto start = std::chrono::steady_clock::now();
+  for (size_t tid = 0; tid < threads; tid++) {
+    workers.emplace_back([&, tid] {
+      std::mt19937 gen(tid);
+      while (std::chrono::steady_clock::now() < start + duration) {
+        // check the clock every 64 fetches, a scan hit is cheaper than reading it
+        for (int i = 0; i < 64; i++) {
+          const auto page_id = next(tid, fetches[tid], &gen);
+          bustub::Page *page = bpm->FetchPageReadOnly(page_id);
+          if (page != nullptr) {
+            sums[tid] += Touch(page->GetData());
+            bpm->UnpinPage(page_id, false);
+          }
+          fetches[tid]++;
+        }
+      }
+    });
+  }
+  uint64_t total = 0;
+  for (size_t tid = 0; tid < threads; tid++) {
+    workers[tid].join();
+    total += fetches[tid];
+  }
+  return static_cast<double>(total) / std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+}  // namespace
+
+// NOLINTNEXTLINE
+auto main(int argc, char **argv) -> int {
+  argparse::ArgumentParser program("bustub-mmap-bench");
+  program.add_argument("--file").help("database file to create").default_value<std::string>("bustub-mmap-bench.db");
+  program.add_argument("--pages").help("size of the file, in pages").default_value<size_t>(16384).scan<'u', size_t>();
+  program.add_argument("--pool-size")
+      .help("frames of the buffer pool, smaller than the file")
+      .default_value<size_t>(1024)
+      .scan<'u', size_t>();
+  program.add_argument("--duration")
+      .help("run time of each configuration, in milliseconds")
+      .default_value<size_t>(1000)
+      .scan<'u', size_t>();
+  program.add_argument("--threads").help("threads fetching pages").default_value<size_t>(4).scan<'u', size_t>();
+
+  try {
+    program.parse_args(argc, argv);
+  } catch (const std::runtime_error &err) {
+    std::cerr << err.what() << std::endl;
+    std::cerr << program;
+    return 1;
+  }
+
+  const auto file = program.get<std::string>("--file");
+  const auto num_pages = program.get<size_t>("--pages");
+  const auto pool_size = program.get<size_t>("--pool-size");
+  const auto duration = std::chrono::milliseconds(program.get<size_t>("--duration"));
+  const auto threads = program.get<size_t>("--threads");
+  std::remove(file.c_str());
+  {
+    bustub::DiskManager disk_manager(file);
+    std::vector<char> page(bustub::BUSTUB_PAGE_SIZE);
+    std::mt19937 gen(42);
+    for (size_t i = 0; i < num_pages; i++) {
+      for (size_t j = 0; j < bustub::BUSTUB_PAGE_SIZE; j += sizeof(uint32_t)) {
+        *reinterpret_cast<uint32_t *>(page.data() + j) = gen();
+      }
+      disk_manager.WritePage(static_cast<bustub::page_id_t>(i), page.data());
+    }
+    disk_manager.ShutDown();
+  }
+
+  fmt::print("{} pages through a buffer pool of {} frames, {} threads, the file in the OS page cache\n", num_pages,
+             pool_size, threads);
+  fmt::print("{:<24} {:>16} {:>16}\n", "disk manager", "scan pages/s", "lookups/s");
+  const std::vector<std::string> names{"DiskManager", "DiskManagerPosix", "DiskManagerMmap",
+                                       "DiskManagerMmap (0-copy)"};
+  for (size_t config = 0; config < names.size(); config++) {
+    std::unique_ptr<bustub::DiskManager> disk_manager;
+    if (config == 0) {
+      disk_manager = std::make_unique<bustub::DiskManager>(file);
+    } else if (config == 1) {
+      disk_manager = std::make_unique<bustub::DiskManagerPosix>(file);
+    } else {
+      disk_manager = std::make_unique<bustub::DiskManagerMmap>(file, config == 3);
+    }
+    auto bpm = std::make_unique<bustub::BufferPoolManagerInstance>(pool_size, disk_manager.get(), 2);
+    // each thread scans the file from its own starting point, as concurrent sequential scans of a table would
+    const double scan = Run(bpm.get(), threads, duration, [&](size_t tid, uint64_t i, std::mt19937 * /*gen*/) {
+      return static_cast<bustub::page_id_t>((tid * num_pages / threads + i) % num_pages);
+    });
+    const double lookup = Run(bpm.get(), threads, duration, [&](size_t /*tid*/, uint64_t /*i*/, std::mt19937 *gen) {
+      return static_cast<bustub::page_id_t>((*gen)() % num_pages);
+    });
+    fmt::print("{:<24} {:>16.0f} {:>16.0f}\n", names[config], scan, lookup);
+    bpm.reset();
+    disk_manager->ShutDown();
+  }
+  std::remove(file.c_str());
+  std::remove((file.substr(0, file.rfind('.')) + ".log").c_str());
+  return 0;
+}
@@ -0,0 +1,165 @@
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "argparse/argparse.hpp"
+#include "buffer/buffer_pool_manager_instance.h"
+#include "concurrency/lock_manager.h"
+#include "concurrency/transaction.h"
+#include "fmt/core.h"
+#include "recovery/log_manager.h"
+#include "storage/disk/disk_manager_posix.h"
+#include "storage/index/b_plus_tree.h"
+#include "storage/index/generic_key.h"
+#include "storage/table/table_heap.h"
+#include "type/value_factory.h"
+
+namespace {
+
+using Tree = bustub::BPlusTree<bustub::GenericKey<8>, bustub::RID, bustub::GenericComparator<8>>;
+using InternalPage =
+    bustub::BPlusTreeInternalPage<bustub::GenericKey<8>, bustub::page_id_t, bustub::GenericComparator<8>>;
+
+/** Remove a database file and its log file. */
+void RemoveFiles(const std::string &file) {
+  std::remove(file.c_str());
+  std::remove((file.substr(0, file.rfind('.')) + ".log").c_str());
+}
+
+/** @return the number of levels of the tree, following the leftmost child down to a leaf */
+auto TreeHeight(bustub::BufferPoolManager *bpm, bustub::page_id_t root_page_id) -> int {
+  int height = 0;
+  bustub::page_id_t page_id = root_page_id;
+  while (page_id != bustub::INVALID_PAGE_ID) {
+    height++;
+    auto *page = reinterpret_cast<bustub::BPlusTreePage *>(bpm->FetchPage(page_id)->GetData());
+    const bustub::page_id_t child =
+        page->IsLeafPage() ? bustub::INVALID_PAGE_ID : reinterpret_cast<InternalPage *>(page)->ValueAt(0);
+    bpm->UnpinPage(page_id, false);
+    page_id = child;
+  }
+  return height;
+}
+
+}  // namespace
+
+// NOLINTNEXTLINE
+auto main(int argc, char **argv) -> int {
+  argparse::ArgumentParser program("bustub-page-size-bench");
+  program.add_argument("--file").help("database file to create").default_value<std::string>("bustub-page-size.db");
+  program.add_argument("--tuples").help("rows of the scanned table").default_value<size_t>(500000).scan<'u', size_t>();
+  program.add_argument("--keys").help("keys of the B+ tree").default_value<size_t>(500000).scan<'u', size_t>();
+  program.add_argument("--pool-mb")
+      .help("memory of the buffer pool, the same whatever the page size")
+      .default_value<size_t>(16)
+      .scan<'u', size_t>();
+  program.add_argument("--duration")
+      .help("run time of the point lookups, in milliseconds")
+      .default_value<size_t>(2000)
+      .scan<'u', size_t>();
+
+  try {
+    program.parse_args(argc, argv);
+  } catch (const std::runtime_error &err) {
+    std::cerr << err.what() << std::endl;
+    std::cerr << program;
+    return 1;
+  }
+
+  const auto file = program.get<std::string>("--file");
+  const auto num_tuples = program.get<size_t>("--tuples");
+  const auto num_keys = program.get<size_t>("--keys");
+  const size_t pool_size =
+      std::max<size_t>(program.get<size_t>("--pool-mb") * 1024 * 1024 / bustub::BUSTUB_PAGE_SIZE, 16);
+  const auto duration = std::chrono::milliseconds(program.get<size_t>("--duration"));
+  fmt::print("page size {} bytes, buffer pool of {} frames\n", bustub::BUSTUB_PAGE_SIZE, pool_size);
+
+  // Sequential scans of a table larger than the buffer pool.
+  {
+    RemoveFiles(file);
+    bustub::DiskManagerPosix disk_manager(file);
+    bustub::BufferPoolManagerInstance bpm(pool_size, &disk_manager, 2);
+    bustub::LockManager lock_manager;
+    bustub::LogManager log_manager(&disk_manager);
+    bustub::Transaction txn(0);
+    bustub::Schema schema(
+        {bustub::Column{"id", bustub::TypeId::BIGINT}, bustub::Column{"payload", bustub::TypeId::VARCHAR, 64}});
+    bustub::TableHeap table(&bpm, &lock_manager, &log_manager, &txn);
+    const std::string payload(60, 'x');
+    for (size_t i = 0; i < num_tuples; i++) {
+      bustub::Tuple tuple({bustub::ValueFactory::GetBigIntValue(static_cast<int64_t>(i)),
+                           bustub::ValueFactory::GetVarcharValue(payload)},
+                          &schema);
+      bustub::RID rid;
+      table.InsertTuple(tuple, &rid, &txn);
+    }
+    bpm.FlushAllPages();
+    const size_t table_pages = disk_manager.GetDbFileSize() / bustub::BUSTUB_PAGE_SIZE;
+    const int rounds = 3;
+    const auto reads_before = bpm.GetStats().read_latency_.Count();
+    const auto start = std::chrono::steady_clock::now();
+    size_t scanned = 0;
+    for (int round = 0; round < rounds; round++) {
+      for (auto it = table.Begin(&txn); it != table.End(); ++it) {
+        scanned++;
+      }
+    }
+    const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    fmt::print("{:<28} {:>12}\n", "table pages", table_pages);
+    fmt::print("{:<28} {:>12.0f}\n", "scan rows/s", static_cast<double>(scanned) / elapsed);
+    fmt::print("{:<28} {:>12.0f}\n", "scan page reads/round",
+               static_cast<double>(bpm.GetStats().read_latency_.Count() - reads_before) / rounds);
+    disk_manager.ShutDown();
+  }
+
+  // A B+ tree larger than the buffer pool: its height, and random point lookups.
+  {
+    RemoveFiles(file);
+    bustub::DiskManagerPosix disk_manager(file);
+    bustub::BufferPoolManagerInstance bpm(pool_size, &disk_manager, 2);
+    auto key_schema = bustub::Schema({bustub::Column{"key", bustub::TypeId::BIGINT}});
+    bustub::GenericComparator<8> comparator(&key_schema);
+    bustub::page_id_t header_page_id;
+    bpm.NewPage(&header_page_id);
+    bpm.UnpinPage(header_page_id, true);
+    Tree tree("bench", &bpm, comparator);
+    std::vector<int64_t> keys(num_keys);
+    std::iota(keys.begin(), keys.end(), 0);
+    std::shuffle(keys.begin(), keys.end(), std::mt19937(42));
+    bustub::GenericKey<8> index_key;
+    for (const int64_t key : keys) {
+      index_key.SetFromInteger(key);
+      tree.Insert(index_key, bustub::RID(static_cast<bustub::page_id_t>(key >> 16), static_cast<uint32_t>(key)));
+    }
+    bpm.FlushAllPages();
+    fmt::print("{:<28} {:>12}\n", "tree height", TreeHeight(&bpm, tree.GetRootPageId()));
+    fmt::print("{:<28} {:>12}\n", "tree pages", disk_manager.GetDbFileSize() / bustub::BUSTUB_PAGE_SIZE);
+
+    std::mt19937 gen(7);
+    std::vector<bustub::RID> result;
+    size_t lookups = 0;
+    const auto reads_before = bpm.GetStats().read_latency_.Count();
+    const auto start = std::chrono::steady_clock::now();
+    while (std::chrono::steady_clock::now() < start + duration) {
+      for (int i = 0; i < 64; i++) {
+        index_key.SetFromInteger(static_cast<int64_t>(gen() % num_keys));
+        result.clear();
+        tree.GetValue(index_key, &result);
+        lookups++;
+      }
+    }
+    const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    fmt::print("{:<28} {:>12.0f}\n", "point lookups/s", static_cast<double>(lookups) / elapsed);
+    fmt::print("{:<28} {:>12.2f}\n", "page reads/lookup",
+               static_cast<double>(bpm.GetStats().read_latency_.Count() - reads_before) / lookups);
+    disk_manager.ShutDown();
+  }
+  RemoveFiles(file);
+  return 0;
+}
@@ -0,0 +1,164 @@
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "argparse/argparse.hpp"
+#include "buffer/access_trace.h"
+#include "buffer/replacer.h"
+#include "fmt/core.h"
+
+namespace {
+
+/**
+ * Generates a trace of `length` accesses: Zipf-distributed (skew 0.99) lookups into `hot_pages` pages, interrupted
+ * every `scan_every` accesses by a sequential scan of `scan_pages` pages that are never accessed again. This is the
+ * pattern that separates scan-resistant policies from plain LRU.
+ */
+auto GenerateTrace(size_t length, size_t hot_pages, size_t scan_every, size_t scan_pages)
+    -> std::vector<bustub::page_id_t> {
+  std::vector<double> cdf(hot_pages);
+  double sum = 0;
+  for (size_t i = 0; i < hot_pages; i++) {
+    sum += 1.0 / std::pow(static_cast<double>(i + 1), 0.99);
+    cdf[i] = sum;
+  }
+  std::mt19937 gen(42);
+  std::uniform_real_distribution<double> dis(0, sum);
+  std::vector<bustub::page_id_t> trace;
+  trace.reserve(length);
+  auto next_cold_page = static_cast<bustub::page_id_t>(hot_pages);
+  while (trace.size() < length) {
+    if (scan_every > 0 && trace.size() % scan_every == scan_every - 1) {
+      for (size_t i = 0; i < scan_pages && trace.size() < length; i++) {
+        trace.push_back(next_cold_page++);
+      }
+      continue;
+    }
+    auto rank = std::lower_bound(cdf.begin(), cdf.end(), dis(gen)) - cdf.begin();
+    trace.push_back(static_cast<bustub::page_id_t>(rank));
+  }
+  return trace;
+}
+
+/**
+ * Replays a trace against a replacer managing `pool_size` frames, the way the buffer pool manager drives it: every
+ * access records the page and pins the frame for the duration of the access, and a miss takes a free frame or evicts.
+ * @return the hit ratio
+ */
+auto Replay(const std::vector<bustub::page_id_t> &trace, bustub::ReplacerType type, size_t pool_size, size_t k)
+    -> double {
+  auto replacer = bustub::Replacer::Create(type, pool_size, k);
+  std::unordered_map<bustub::page_id_t, bustub::frame_id_t> page_table;
+  std::vector<bustub::page_id_t> frame_pages(pool_size, bustub::INVALID_PAGE_ID);
+  size_t next_free_frame = 0;
+  uint64_t hits = 0;
+  for (auto page_id : trace) {
+    bustub::frame_id_t frame_id;
+    auto it = page_table.find(page_id);
+    if (it != page_table.end()) {
+      hits++;
+      frame_id = it->second;
+    } else {
+      if (next_free_frame < pool_size) {
+        frame_id = static_cast<bustub::frame_id_t>(next_free_frame++);
+      } else if (replacer->Evict(&frame_id)) {
+        page_table.erase(frame_pages[frame_id]);
+      } else {
+        continue;
+      }
+      page_table[page_id] = frame_id;
+      frame_pages[frame_id] = page_id;
+    }
+    replacer->RecordAccess(frame_id, page_id);
+    replacer->SetEvictable(frame_id, false);
+    replacer->SetEvictable(frame_id, true);
+  }
+  return trace.empty() ? 0 : static_cast<double>(hits) / static_cast<double>(trace.size());
+}
+
+}  // namespace
+
+// NOLINTNEXTLINE
+auto main(int argc, char **argv) -> int {
+  argparse::ArgumentParser program("bustub-replacer-bench");
+  program.add_argument("--trace")
+      .help("page access trace recorded with \\trace in the shell; a synthetic trace is generated if omitted")
+      .default_value<std::string>("");
+  program.add_argument("--pool-size")
+      .help("number of frames; by default 1/64, 1/16 and 1/4 of the distinct pages of the trace")
+      .default_value<size_t>(0)
+      .scan<'u', size_t>();
+  program.add_argument("--k").help("k of the LRU-K replacer").default_value<size_t>(2).scan<'u', size_t>();
+  program.add_argument("--length")
+      .help("number of accesses of the synthetic trace")
+      .default_value<size_t>(1000000)
+      .scan<'u', size_t>();
+  program.add_argument("--hot-pages")
+      .help("number of Zipf-distributed pages of the synthetic trace")
+      .default_value<size_t>(16384)
+      .scan<'u', size_t>();
+  program.add_argument("--scan-every")
+      .help("number of accesses between two scans of the synthetic trace, 0 for no scans")
+      .default_value<size_t>(50000)
+      .scan<'u', size_t>();
+  program.add_argument("--scan-pages")
+      .help("number of pages of each scan of the synthetic trace")
+      .default_value<size_t>(4096)
+      .scan<'u', size_t>();
+
+  try {
+    program.parse_args(argc, argv);
+  } catch (const std::runtime_error &err) {
+    std::cerr << err.what() << std::endl;
+    std::cerr << program;
+    return 1;
+  }
+
+  auto trace_file = program.get<std::string>("--trace");
+  auto k = program.get<size_t>("--k");
+  std::vector<bustub::page_id_t> trace;
+  if (trace_file.empty()) {
+    trace = GenerateTrace(program.get<size_t>("--length"), program.get<size_t>("--hot-pages"),
+                          program.get<size_t>("--scan-every"), program.get<size_t>("--scan-pages"));
+  } else {
+    trace = bustub::AccessTrace::Load(trace_file);
+  }
+  size_t distinct_pages = std::unordered_set<bustub::page_id_t>(trace.begin(), trace.end()).size();
+  fmt::print("{} accesses to {} distinct pages from {}\n", trace.size(), distinct_pages,
+             trace_file.empty() ? "a synthetic trace" : trace_file);
+
+  std::vector<size_t> pool_sizes;
+  if (program.get<size_t>("--pool-size") > 0) {
+    pool_sizes.push_back(program.get<size_t>("--pool-size"));
+  } else {
+    for (size_t divisor : {64, 16, 4}) {
+      pool_sizes.push_back(std::max<size_t>(1, distinct_pages / divisor));
+    }
+  }
+
+  const std::vector<std::pair<bustub::ReplacerType, std::string>> policies = {
+      {bustub::ReplacerType::LRU, "LRU"},     {bustub::ReplacerType::CLOCK, "CLOCK"},
+      {bustub::ReplacerType::LRU_K, "LRU-K"}, {bustub::ReplacerType::ARC, "ARC"},
+      {bustub::ReplacerType::TWO_Q, "2Q"},
+  };
+  fmt::print("{:>10}", "frames");
+  for (const auto &[type, name] : policies) {
+    fmt::print(" {:>10}", name);
+  }
+  fmt::print("\n");
+  for (auto pool_size : pool_sizes) {
+    fmt::print("{:>10}", pool_size);
+    for (const auto &[type, name] : policies) {
+      fmt::print(" {:>9.2f}%", 100 * Replay(trace, type, pool_size, k));
+    }
+    fmt::print("\n");
+  }
+  return 0;
+}
@@ -0,0 +1,164 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "argparse/argparse.hpp"
+#include "buffer/buffer_access_strategy.h"
+#include "buffer/buffer_pool_manager_instance.h"
+#include "fmt/core.h"
+#include "storage/disk/disk_manager_memory.h"
+
+namespace {
+
+struct BenchResult {
+  double lookups_per_sec_;
+  double p50_us_;
+  double p99_us_;
+  size_t scanned_pages_;
+};
+
+/**
+ * Runs `lookup_threads` workers doing point lookups on the hot pages while `scan_threads` workers repeatedly scan the
+ * cold pages, with a private ring per scan if `use_strategy` is set.
+ */
+auto RunMixedBench(bustub::BufferPoolManager *bpm, const std::vector<bustub::page_id_t> &hot_pages,
+                   const std::vector<bustub::page_id_t> &cold_pages, size_t lookup_threads, size_t scan_threads,
+                   bool use_strategy, uint64_t duration_ms) -> BenchResult {
+  std::atomic<bool> done{false};
+  std::atomic<size_t> scanned_pages{0};
+  std::vector<std::thread> scanners;
+  for (size_t tid = 0; tid < scan_threads; tid++) {
+    scanners.emplace_back([&] {
+      while (!done) {
+        bustub::BufferAccessStrategy strategy;
+        for (auto page_id : cold_pages) {
+          if (done) {
+            break;
+          }
+          auto *page = bpm->FetchPageWithStrategy(page_id, use_strategy ? &strategy : nullptr);
+          if (page != nullptr) {
+            bpm->UnpinPage(page_id, false);
+            scanned_pages++;
+          }
+        }
+      }
+    });
+  }
+
+  std::vector<std::vector<double>> latencies(lookup_threads);
+  std::vector<std::thread> workers;
+  auto start = std::chrono::steady_clock::now();
+  for (size_t tid = 0; tid < lookup_threads; tid++) {
+    workers.emplace_back([&, tid] {
+      std::mt19937 gen(tid);
+      std::uniform_int_distribution<size_t> dis(0, hot_pages.size() - 1);
+      auto deadline = start + std::chrono::milliseconds(duration_ms);
+      while (std::chrono::steady_clock::now() < deadline) {
+        auto page_id = hot_pages[dis(gen)];
+        auto op_start = std::chrono::steady_clock::now();
+        auto *page = bpm->FetchPage(page_id);
+        if (page == nullptr) {
+          continue;
+        }
+        bpm->UnpinPage(page_id, false);
+        latencies[tid].push_back(
+            std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - op_start).count());
+      }
+    });
+  }
+  for (auto &worker : workers) {
+    worker.join();
+  }
+  auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  done = true;
+  for (auto &scanner : scanners) {
+    scanner.join();
+  }
+
+  std::vector<double> all;
+  for (auto &thread_latencies : latencies) {
+    all.insert(all.end(), thread_latencies.begin(), thread_latencies.end());
+  }
+  std::sort(all.begin(), all.end());
+  auto percentile = [&](double p) { return all.empty() ? 0.0 : all[static_cast<size_t>(p * (all.size() - 1))]; };
+  return {static_cast<double>(all.size()) / elapsed, percentile(0.5), percentile(0.99), scanned_pages};
+}
+
+}  // namespace
+
+// NOLINTNEXTLINE
+auto main(int argc, char **argv) -> int {
+  argparse::ArgumentParser program("bustub-scan-bench");
+  program.add_argument("--duration")
+      .help("run time of each configuration in ms")
+      .default_value<uint64_t>(2000)
+      .scan<'u', uint64_t>();
+  program.add_argument("--pool-size").help("number of frames").default_value<size_t>(1024).scan<'u', size_t>();
+  program.add_argument("--hot-pages")
+      .help("number of pages hit by point lookups")
+      .default_value<size_t>(256)
+      .scan<'u', size_t>();
+  program.add_argument("--scan-pages")
+      .help("number of pages of the scanned table")
+      .default_value<size_t>(4096)
+      .scan<'u', size_t>();
+  program.add_argument("--lookup-threads").default_value<size_t>(4).scan<'u', size_t>();
+  program.add_argument("--scan-threads").default_value<size_t>(2).scan<'u', size_t>();
+  program.add_argument("--read-latency")
+      .help("latency of a disk read in us")
+      .default_value<uint64_t>(100)
+      .scan<'u', uint64_t>();
+  program.add_argument("--disk")
+      .help("device to simulate instead of a fixed read latency: ssd or hdd")
+      .default_value<std::string>("");
+
+  try {
+    program.parse_args(argc, argv);
+  } catch (const std::runtime_error &err) {
+    std::cerr << err.what() << std::endl;
+    std::cerr << program;
+    return 1;
+  }
+
+  auto duration_ms = program.get<uint64_t>("--duration");
+  auto pool_size = program.get<size_t>("--pool-size");
+  auto num_hot_pages = program.get<size_t>("--hot-pages");
+  auto num_scan_pages = program.get<size_t>("--scan-pages");
+  auto lookup_threads = program.get<size_t>("--lookup-threads");
+  auto scan_threads = program.get<size_t>("--scan-threads");
+  auto read_latency = std::chrono::microseconds(program.get<uint64_t>("--read-latency"));
+  auto disk = program.get<std::string>("--disk");
+  bustub::DiskLatencyModel model;
+  model.read_latency_ = read_latency;
+  if (disk == "ssd" || disk == "hdd") {
+    model = disk == "ssd" ? bustub::DiskLatencyModel::Ssd() : bustub::DiskLatencyModel::Hdd();
+  }
+
+  fmt::print("point lookups on {} hot pages, {} scans over {} pages, {} frames, {}\n", num_hot_pages, scan_threads,
+             num_scan_pages, pool_size, disk.empty() ? fmt::format("{} us reads", read_latency.count()) : disk);
+  fmt::print("{:>8} {:>16} {:>12} {:>12} {:>16}\n", "scans", "lookups (op/s)", "p50 (us)", "p99 (us)",
+             "scanned pages");
+  for (bool use_strategy : {false, true}) {
+    auto disk_manager = std::make_unique<bustub::DiskManagerMemory>(num_hot_pages + num_scan_pages, model);
+    auto bpm = std::make_unique<bustub::BufferPoolManagerInstance>(pool_size, disk_manager.get());
+    std::vector<bustub::page_id_t> hot_pages(num_hot_pages);
+    std::vector<bustub::page_id_t> cold_pages(num_scan_pages);
+    for (auto *page_ids : {&cold_pages, &hot_pages}) {
+      for (auto &page_id : *page_ids) {
+        bpm->NewPage(&page_id);
+        bpm->UnpinPage(page_id, false);
+      }
+    }
+    auto result = RunMixedBench(bpm.get(), hot_pages, cold_pages, lookup_threads, scan_threads, use_strategy,
+                                duration_ms);
+    fmt::print("{:>8} {:>16.0f} {:>12.1f} {:>12.1f} {:>16}\n", use_strategy ? "ring" : "shared",
+               result.lookups_per_sec_, result.p50_us_, result.p99_us_, result.scanned_pages_);
+  }
+  return 0;
+}